@@ -15,6 +15,1086 @@
  ************************************************************************************************************
  */
 #include "Can.h"
+#include "Can_Hw.h"
+#include "Can_Cfg.h"
+#include "Can_FilterCfg.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @typedef     Can_TxQueueEntryType
+ * @brief       L-PDU waiting in the software transmit queue. The SDU is copied because the caller's buffer is
+ *              only guaranteed to be valid during Can_Write().
+ */
+typedef struct
+{
+    Can_IdType id;                  /* CAN ID of the L-PDU */
+    uint8 sdu[8];                   /* Copy of the SDU, word aligned for the mailbox fast path */
+    PduIdType swPduHandle;          /* Handle given back in the transmit confirmation */
+    uint8 length;                   /* Data length (0-8 bytes) */
+} Can_TxQueueEntryType;
+
+/**
+ * @typedef     Can_TxQueueType
+ * @brief       Transmit queue of one HTH. Entries are sorted from the lowest to the highest priority so that
+ *              the next frame to send is always the last one and is popped without moving the others.
+ */
+typedef struct
+{
+    Can_TxQueueEntryType Entries[CAN_TX_QUEUE_SIZE];
+    uint8 Count;                    /* Number of queued L-PDUs */
+    uint8 AbortPending;             /* Mask of the mailboxes being aborted for a higher priority L-PDU */
+    uint8 AbortReplace;             /* Mask of the mailboxes being aborted for a newer L-PDU with the same CAN ID */
+} Can_TxQueueType;
+
+/**
+ * @typedef     Can_RxRingType
+ * @brief       Single-producer/single-consumer ring of received frames. Head is only written by the producer
+ *              (FMP interrupts or Can_MainFunction_Read), Tail only by the consumer, so no lock is needed.
+ *              Both are free running, the slot index is taken modulo CAN_RX_RING_SIZE. The FIFO0 and FIFO1
+ *              interrupts must run at the same NVIC priority so that they never preempt each other.
+ */
+typedef struct
+{
+    Can_RxFrameType Slots[CAN_RX_RING_SIZE];
+    volatile uint8 Head;            /* Next slot to be written by the producer */
+    volatile uint8 Tail;            /* Oldest slot not yet released by the consumer */
+    Can_RxOverrunType Overrun;      /* Lost frame counters */
+} Can_RxRingType;
+
+#define CAN_RX_RING_MASK        (CAN_RX_RING_SIZE - 1u)
+
+/**
+ * @typedef     Can_ControllerRuntimeType
+ * @brief       Software state machine of one controller. A transition is pending while Requested differs from
+ *              State. It is completed by Can_MainFunction_Mode() or the SCE interrupt once MSR acknowledges it.
+ */
+typedef struct
+{
+    Can_ControllerStateType State;          /* Last acknowledged state */
+    Can_ControllerStateType Requested;      /* Requested state */
+    uint32 RequestCycles;                   /* DWT cycle count when the transition was requested */
+    uint8 Polls;                            /* Can_MainFunction_Mode() calls since the request */
+    uint8 WakeupPending;                    /* Wakeup detected on the bus, not yet reported by Can_CheckWakeup() */
+    uint8 BusOffPhase;                      /* Step of the bus-off recovery, CAN_BUSOFF_xxx */
+    uint16 BusOffTicks;                     /* Can_MainFunction_BusOff() calls spent in the current step */
+    uint64 BusOffCycles;                    /* Time base when the controller went bus-off */
+    uint8 SelfTest;                         /* TRUE while Can_SelfTest() runs, its frames bypass the gateway */
+} Can_ControllerRuntimeType;
+
+#define CAN_MODE_LATENCY_MAX    4u          /* Latency records, indexed by Can_ControllerStateType */
+
+#define CAN_BUSOFF_NONE         0u          /* On the bus, ticks count towards CAN_BUSOFF_STABLE */
+#define CAN_BUSOFF_WAIT         1u          /* Bus-off, waiting for the backoff delay */
+#define CAN_BUSOFF_INIT         2u          /* INRQ set, waiting for INAK */
+#define CAN_BUSOFF_RECOVERY     3u          /* INRQ cleared, hardware waits for 128 x 11 recessive bits */
+
+/**
+ * @typedef     Can_TimeSyncType
+ * @brief       Relation between the 16-bit TTCM counter of a controller, which counts bit times, and the 64-bit
+ *              CPU cycle time base. Both run from HCLK, so one captured frame fixes the relation for good.
+ */
+typedef struct
+{
+    uint64 AnchorCycles;                    /* Time stamp of the anchor frame in CPU cycles */
+    uint32 CyclesPerBit;                    /* Length of one TTCM count in CPU cycles */
+    uint16 AnchorTime;                      /* TTCM TIME of the anchor frame */
+    uint8 Synced;                           /* TRUE once a frame has given the phase of the TTCM counter */
+} Can_TimeSyncType;
+
+/**
+ * @typedef     Can_TxEgressType
+ * @brief       Last confirmed transmission of a transmit mailbox.
+ */
+typedef struct
+{
+    uint64 TimeStamp;                       /* Start of frame in CPU cycles */
+    PduIdType PduId;                        /* L-PDU handle given to Can_Write() */
+    uint8 Valid;                            /* TRUE once the mailbox has completed a transmission */
+} Can_TxEgressType;
+
+/**
+ * @typedef     Can_BusLoadType
+ * @brief       Bit and time counts at the previous Can_GetBusLoad() call.
+ */
+typedef struct
+{
+    uint64 Cycles;                          /* Time base at the previous call */
+    uint32 Bits;                            /* TxBits + RxBits at the previous call */
+} Can_BusLoadType;
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+/* CAN ID and PDU handle currently pending in each transmit mailbox */
+static Can_IdType Can_TxPendingId[CAN_CONTROLLER_MAX][CAN_TX_MAILBOX_MAX];
+static PduIdType Can_TxPendingPdu[CAN_CONTROLLER_MAX][CAN_TX_MAILBOX_MAX];
+
+/* Software transmit queue of each HTH */
+static Can_TxQueueType Can_TxQueue[CAN_CONTROLLER_MAX];
+
+/* Receive ring of each controller */
+static Can_RxRingType Can_RxRing[CAN_CONTROLLER_MAX];
+
+/* Configuration given to Can_Init() */
+static const Can_ConfigType* Can_ConfigPtr = NULL_PTR;
+
+/* Mode state machine and transition latency of each controller */
+static volatile Can_ControllerRuntimeType Can_Controller[CAN_CONTROLLER_MAX];
+static Can_ModeLatencyType Can_ModeLatency[CAN_CONTROLLER_MAX][CAN_MODE_LATENCY_MAX];
+
+/* 64-bit extension of the DWT cycle counter, the time base of all time stamps */
+static uint32 Can_TimeHigh = 0u;
+static uint32 Can_TimeLast = 0u;
+
+/* TTCM counter phase and last transmission time of each controller */
+static Can_TimeSyncType Can_TimeSync[CAN_CONTROLLER_MAX];
+static Can_TxEgressType Can_TxEgress[CAN_CONTROLLER_MAX][CAN_TX_MAILBOX_MAX];
+
+/* Traffic and error counters, FifoOverrun is taken from the receive ring when they are read */
+static Can_StatisticsType Can_Statistics[CAN_CONTROLLER_MAX];
+static Can_BusLoadType Can_BusLoad[CAN_CONTROLLER_MAX];
+
+/* Bus-off recovery times and backoff of each controller */
+static Can_BusOffRecoveryType Can_BusOffRecovery[CAN_CONTROLLER_MAX];
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Reads the 64-bit time base. It must be called at least once per DWT wrap around (53 s at
+ *              80 MHz), which Can_MainFunction_Mode() guarantees.
+ * @param       void
+ * @return      CPU cycles since the cycle counter was started
+ */
+static uint64 Can_TimeNow(void)
+{
+    uint32 primask = Can_Hw_EnterCritical();
+    uint32 cycles = Can_Hw_GetCycles();
+    uint64 now;
+
+    if (cycles < Can_TimeLast)
+    {
+        Can_TimeHigh++;
+    }
+    Can_TimeLast = cycles;
+    now = ((uint64)Can_TimeHigh << 32) | cycles;
+
+    Can_Hw_ExitCritical(primask);
+
+    return now;
+}
+
+/**
+ * @brief       Takes the bit time of a controller from BTR, the TTCM phase is found again on the next frame
+ * @param       Controller: CAN controller index
+ * @return      void
+ */
+static void Can_TimeSetBitRate(uint8 Controller)
+{
+    Can_TimeSync[Controller].CyclesPerBit = Can_Hw_GetCyclesPerBit(Can_Hw_GetController(Controller));
+    Can_TimeSync[Controller].Synced = FALSE;
+}
+
+/**
+ * @brief       Extends a 16-bit TTCM capture to the 64-bit time base
+ * @details     The number of bit times since the anchor frame is known exactly from the cycle counter, so the
+ *              capture is unwrapped however long ago the previous frame was. The first capture after a bit rate
+ *              change only gives the phase: its time stamp is the time it is read, less the shortest length of
+ *              the frame. Each frame read sooner after its end than the anchor frame refines the phase, so the
+ *              time stamps are late by the stuff bits, the end of frame and the interrupt latency at most.
+ * @param       Controller: CAN controller index
+ * @param       Time: TIME captured in TDTR/RDTR at the start of the frame
+ * @param       MinBits: Shortest duration of the frame up to the point it can be read, Can_Hw_GetFrameBitsMin()
+ * @return      Start of frame in CPU cycles
+ */
+static uint64 Can_TimeCapture(uint8 Controller, uint16 Time, uint32 MinBits)
+{
+    Can_TimeSyncType *sync = &Can_TimeSync[Controller];
+    uint64 now = Can_TimeNow();
+    uint64 elapsed = now - sync->AnchorCycles;
+    uint64 bits;
+    uint64 stamp;
+    uint16 age;
+
+    if (sync->Synced == FALSE)
+    {
+        /* The frame started at least MinBits before it could be read */
+        stamp = (uint64)MinBits * sync->CyclesPerBit;
+        sync->AnchorCycles = (now > stamp) ? (now - stamp) : 0u;
+        sync->AnchorTime = Time;
+        sync->Synced = TRUE;
+        return sync->AnchorCycles;
+    }
+
+    /* Avoid the 64-bit division while frames come in more often than every DWT wrap around */
+    if (elapsed <= 0xFFFFFFFFu)
+    {
+        bits = (uint32)elapsed / sync->CyclesPerBit;
+    }
+    else
+    {
+        bits = elapsed / sync->CyclesPerBit;
+    }
+
+    /* Bit times between the start of the frame and now, modulo the 16-bit counter */
+    age = (uint16)((uint16)(sync->AnchorTime + (uint16)bits) - Time);
+
+    /* The anchor is the time its frame was read, not its start of frame. A capture up to half a counter
+       period after the estimated counter value shows by how much it is late: move it back, so that this
+       frame starts now. Captures are read within 32768 bit times of their frame. */
+    if (age >= 0x8000u)
+    {
+        sync->AnchorCycles -= (uint64)(uint16)(0x10000u - age) * sync->CyclesPerBit;
+        bits += (uint16)(0x10000u - age);
+        age = 0u;
+    }
+
+    stamp = sync->AnchorCycles + ((bits - age) * sync->CyclesPerBit);
+
+    /* Move the anchor forward only, frames confirmed out of order may be older than it */
+    if (stamp > sync->AnchorCycles)
+    {
+        sync->AnchorCycles = stamp;
+        sync->AnchorTime = Time;
+    }
+
+    return stamp;
+}
+
+/**
+ * @brief       Converts a time in CPU cycles to seconds and nanoseconds
+ * @param       Cycles: Time in CPU cycles
+ * @param       TimeStampPtr: Where the time is stored
+ * @return      void
+ */
+static void Can_TimeConvert(uint64 Cycles, Can_TimeStampType* TimeStampPtr)
+{
+    uint32 remainder = (uint32)(Cycles % CAN_CPU_CLOCK_HZ);
+
+    TimeStampPtr->seconds = (uint32)(Cycles / CAN_CPU_CLOCK_HZ);
+    TimeStampPtr->nanoseconds = (uint32)(((uint64)remainder * 1000000000u) / CAN_CPU_CLOCK_HZ);
+}
+
+/**
+ * @brief       Loads an L-PDU into an empty transmit mailbox and remembers what is pending there
+ * @param       Controller: CAN controller index
+ * @param       Mailbox: Index of the empty mailbox
+ * @param       PduInfo: L-PDU to be sent
+ * @return      void
+ */
+static void Can_TxLoadMailbox(uint8 Controller, uint8 Mailbox, const Can_PduType* PduInfo)
+{
+    Can_TxPendingId[Controller][Mailbox] = PduInfo->id;
+    Can_TxPendingPdu[Controller][Mailbox] = PduInfo->swPduHandle;
+    Can_Hw_WriteMailbox(Can_Hw_GetController(Controller), Mailbox, PduInfo);
+}
+
+/**
+ * @brief       Copies the handle and the data of an L-PDU into a queue entry
+ * @param       Entry: Queue entry, its CAN ID is left as it is
+ * @param       PduHandle: PDU handle of the L-PDU
+ * @param       Length: Data length (0-8 bytes)
+ * @param       Sdu: Data of the L-PDU, NULL_PTR for a remote frame
+ * @return      void
+ */
+static void Can_TxQueueFill(Can_TxQueueEntryType* Entry, PduIdType PduHandle, uint8 Length, const uint8* Sdu)
+{
+    uint8 j;
+
+    Entry->swPduHandle = PduHandle;
+    Entry->length = (Length > 8u) ? 8u : Length;
+    for (j = 0u; (Sdu != NULL_PTR) && (j < Entry->length); j++)
+    {
+        Entry->sdu[j] = Sdu[j];
+    }
+}
+
+/**
+ * @brief       Inserts an L-PDU into the transmit queue behind all queued L-PDUs of the same or higher priority
+ * @param       Queue: Transmit queue, must not be full
+ * @param       CanId: CAN ID of the L-PDU
+ * @param       PduHandle: PDU handle of the L-PDU
+ * @param       Length: Data length (0-8 bytes)
+ * @param       Sdu: Data of the L-PDU
+ * @return      Pointer to the inserted entry
+ */
+static Can_TxQueueEntryType* Can_TxQueueInsert(Can_TxQueueType* Queue, Can_IdType CanId, PduIdType PduHandle,
+                                               uint8 Length, const uint8* Sdu)
+{
+    uint32 priority = Can_Hw_GetPriority(CanId);
+    uint8 i = Queue->Count;
+
+    /* Shift up every entry that has to leave before the new one */
+    while ((i > 0u) && (Can_Hw_GetPriority(Queue->Entries[i - 1u].id) <= priority))
+    {
+        Queue->Entries[i] = Queue->Entries[i - 1u];
+        i--;
+    }
+
+    Queue->Entries[i].id = CanId;
+    Can_TxQueueFill(&Queue->Entries[i], PduHandle, Length, Sdu);
+    Queue->Count++;
+
+    return &Queue->Entries[i];
+}
+
+/**
+ * @brief       Looks for a queued L-PDU with a given CAN ID
+ * @param       Queue: Transmit queue of the HTH
+ * @param       CanId: CAN ID to look for
+ * @return      Queue entry, NULL_PTR if no L-PDU with this CAN ID is queued
+ */
+static Can_TxQueueEntryType* Can_TxQueueFind(Can_TxQueueType* Queue, Can_IdType CanId)
+{
+    uint8 i;
+
+    for (i = 0u; i < Queue->Count; i++)
+    {
+        if (Queue->Entries[i].id == CanId)
+        {
+            return &Queue->Entries[i];
+        }
+    }
+
+    return NULL_PTR;
+}
+
+/**
+ * @brief       Aborts the transmit mailbox holding a stale L-PDU with the same CAN ID as a new one
+ * @param       Controller: CAN controller index
+ * @param       CanId: CAN ID of the new L-PDU
+ * @return      TRUE if such a mailbox is being aborted, its L-PDU is reported once the abort has completed
+ */
+static uint8 Can_TxAbortSameId(uint8 Controller, Can_IdType CanId)
+{
+    CAN_TypeDef *CANx = Can_Hw_GetController(Controller);
+    Can_TxQueueType *queue = &Can_TxQueue[Controller];
+    uint32 tsr = CANx->TSR;
+    uint8 mailbox;
+
+    for (mailbox = 0u; mailbox < CAN_TX_MAILBOX_MAX; mailbox++)
+    {
+        if (((tsr & CAN_TSR_TME_MB(mailbox)) == 0u) && (Can_TxPendingId[Controller][mailbox] == CanId))
+        {
+            if ((queue->AbortReplace & (1u << mailbox)) == 0u)
+            {
+                /* The abort completes at once unless the frame is already on the bus, in which case it is sent */
+                queue->AbortReplace |= (uint8)(1u << mailbox);
+                Can_Hw_WriteReg(&CANx->TSR, CAN_TSR_ABRQ_MB(mailbox));
+            }
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief       Counts the mailboxes whose abort is still in progress. Each of them will hand its L-PDU back to
+ *              the queue, so a queue slot is kept free for it.
+ * @param       Queue: Transmit queue
+ * @return      Number of pending aborts
+ */
+static uint8 Can_TxAbortCount(const Can_TxQueueType* Queue)
+{
+    uint8 requeue = (uint8)(Queue->AbortPending & ~Queue->AbortReplace);
+
+    return (uint8)((requeue & 0x01u) + ((requeue >> 1) & 0x01u) + ((requeue >> 2) & 0x01u));
+}
+
+/**
+ * @brief       Handles the mailboxes whose request has completed. A mailbox that was aborted to make room for a
+ *              higher priority L-PDU gives its L-PDU back to the queue.
+ * @param       Controller: CAN controller index
+ * @return      void
+ */
+static void Can_TxProcessCompleted(uint8 Controller)
+{
+    CAN_TypeDef *CANx = Can_Hw_GetController(Controller);
+    Can_TxQueueType *queue = &Can_TxQueue[Controller];
+    uint32 tsr = CANx->TSR;
+    uint32 rqcp;
+    uint32 tir;
+    uint8 mailbox;
+    Can_IdType id;
+    uint8 length;
+    uint8 sdu[8];
+
+    for (mailbox = 0u; mailbox < CAN_TX_MAILBOX_MAX; mailbox++)
+    {
+        rqcp = CAN_TSR_RQCP0 << (8u * mailbox);
+        if ((tsr & rqcp) == 0u)
+        {
+            continue;
+        }
+
+        if ((tsr & (CAN_TSR_TXOK0 << (8u * mailbox))) != 0u)
+        {
+            /* Sent before any abort took effect */
+        }
+        else if ((queue->AbortReplace & (1u << mailbox)) != 0u)
+        {
+            /* Stale, its replacement is already queued */
+            Can_Statistics[Controller].TxCancelled++;
+            if ((Can_ConfigPtr != NULL_PTR) && (Can_ConfigPtr->CancelTxConfirmation != NULL_PTR))
+            {
+                Can_ConfigPtr->CancelTxConfirmation(Can_TxPendingPdu[Controller][mailbox]);
+            }
+        }
+        else if ((queue->AbortPending & (1u << mailbox)) != 0u)
+        {
+            /* Preempted before it reached the bus, queue it again */
+            Can_Hw_ReadMailbox(CANx, mailbox, &id, &length, sdu);
+            (void)Can_TxQueueInsert(queue, id, Can_TxPendingPdu[Controller][mailbox], length, sdu);
+        }
+        else
+        {
+            /* Not aborted by the driver, e.g. NART and an error on the bus */
+        }
+        queue->AbortPending &= (uint8)~(1u << mailbox);
+        queue->AbortReplace &= (uint8)~(1u << mailbox);
+
+        if ((tsr & (CAN_TSR_TXOK0 << (8u * mailbox))) != 0u)
+        {
+            Can_Statistics[Controller].TxFrames++;
+            tir = CANx->sTxMailBox[mailbox].TIR;
+            Can_Statistics[Controller].TxBits += Can_Hw_GetFrameBits(tir & CAN_TI0R_IDE, ((tir & CAN_TI0R_RTR) != 0u) ?
+                                                                     0u : (CANx->sTxMailBox[mailbox].TDTR & CAN_TDT0R_DLC));
+        }
+        if ((tsr & (CAN_TSR_ALST0 << (8u * mailbox))) != 0u)
+        {
+            Can_Statistics[Controller].ArbitrationLost++;
+        }
+
+#if (CAN_TIMESTAMP == CAN_TIMESTAMP_ON)
+        if ((tsr & (CAN_TSR_TXOK0 << (8u * mailbox))) != 0u)
+        {
+            Can_TxEgress[Controller][mailbox].TimeStamp = Can_TimeCapture(Controller, Can_Hw_GetMailboxTime(CANx, mailbox),
+                                                                          Can_Hw_GetFrameBitsMin(tir & CAN_TI0R_IDE, ((tir & CAN_TI0R_RTR) != 0u) ?
+                                                                          0u : (CANx->sTxMailBox[mailbox].TDTR & CAN_TDT0R_DLC)));
+            Can_TxEgress[Controller][mailbox].PduId = Can_TxPendingPdu[Controller][mailbox];
+            Can_TxEgress[Controller][mailbox].Valid = TRUE;
+        }
+#endif
+
+        /* Writing RQCP clears TXOK, ALST and TERR of the mailbox as well */
+        Can_Hw_WriteReg(&CANx->TSR, rqcp);
+    }
+}
+
+/**
+ * @brief       Moves the highest priority queued L-PDUs into the empty mailboxes. When all mailboxes are
+ *              pending and the queue head outranks one of them, the lowest priority mailbox is aborted; the
+ *              transmit mailbox empty interrupt then puts its L-PDU back in the queue and reloads the mailbox.
+ * @param       Controller: CAN controller index
+ * @return      void
+ */
+static void Can_TxRefill(uint8 Controller)
+{
+    CAN_TypeDef *CANx = Can_Hw_GetController(Controller);
+    Can_TxQueueType *queue = &Can_TxQueue[Controller];
+    Can_TxQueueEntryType *head;
+    Can_PduType pdu;
+    uint32 tsr = CANx->TSR;
+    uint8 mailbox;
+    uint8 victim = 0u;
+
+    /* A mailbox being aborted may already be empty: it is not reused before Can_TxProcessCompleted() has
+       handled its RQCP, which the TXRQ of a new request would clear */
+    while ((queue->Count > 0u) && ((tsr & CAN_TSR_TME) != 0u) && ((queue->AbortPending | queue->AbortReplace) == 0u))
+    {
+        /* CODE holds the number of the next empty mailbox as long as one of them is empty */
+        mailbox = (uint8)((tsr & CAN_TSR_CODE) >> CAN_TSR_CODE_Pos);
+        head = &queue->Entries[queue->Count - 1u];
+        pdu.id = head->id;
+        pdu.swPduHandle = head->swPduHandle;
+        pdu.length = head->length;
+        pdu.sdu = head->sdu;
+        Can_TxLoadMailbox(Controller, mailbox, &pdu);
+        queue->Count--;
+        tsr = CANx->TSR;
+    }
+
+    /* One abort at a time, a mailbox being aborted for any reason is about to be free */
+    if ((queue->Count == 0u) || ((tsr & CAN_TSR_TME) != 0u) || ((queue->AbortPending | queue->AbortReplace) != 0u))
+    {
+        return;
+    }
+
+    /* All mailboxes are pending, look for the one holding the lowest priority frame */
+    for (mailbox = 1u; mailbox < CAN_TX_MAILBOX_MAX; mailbox++)
+    {
+        if (Can_Hw_GetPriority(Can_TxPendingId[Controller][mailbox]) > Can_Hw_GetPriority(Can_TxPendingId[Controller][victim]))
+        {
+            victim = mailbox;
+        }
+    }
+
+    head = &queue->Entries[queue->Count - 1u];
+    if ((Can_Hw_GetPriority(head->id) < Can_Hw_GetPriority(Can_TxPendingId[Controller][victim])) &&
+        (queue->Count < CAN_TX_QUEUE_SIZE))
+    {
+        /* The abort completes at once unless the frame is already on the bus, in which case it is sent */
+        queue->AbortPending |= (uint8)(1u << victim);
+        Can_Hw_WriteReg(&CANx->TSR, CAN_TSR_ABRQ_MB(victim));
+    }
+}
+
+/**
+ * @brief       Transmit mailbox empty interrupt service of a CAN controller
+ * @param       Controller: CAN controller index
+ * @return      void
+ */
+static void Can_TxIsr(uint8 Controller)
+{
+    Can_TxProcessCompleted(Controller);
+    Can_TxRefill(Controller);
+}
+
+/**
+ * @brief       Finds the dispatch entry of a received CAN ID. The filter match index of an identifier-list entry
+ *              gives the entry directly, otherwise a binary search over the sorted table takes at most
+ *              CAN_RX_SEARCH_STEPS_MAX steps.
+ * @param       Fifo: Receive FIFO the frame was read from
+ * @param       Fmi: Filter match index reported by the hardware
+ * @param       CanId: Received CAN ID
+ * @return      Dispatch entry, NULL_PTR if the CAN ID is not configured
+ */
+static const Can_RxDispatchType* Can_RxLookup(uint8 Fifo, uint8 Fmi, Can_IdType CanId)
+{
+    uint16 low = 0u;
+    uint16 high = CAN_RX_DISPATCH_COUNT;
+    uint16 mid;
+
+    if ((Fmi < CAN_RX_FMI_MAX) && (Can_RxFmiMap[Fifo][Fmi] != CAN_RX_FMI_SEARCH))
+    {
+        return &Can_RxDispatch[Can_RxFmiMap[Fifo][Fmi]];
+    }
+
+    while (low < high)
+    {
+        mid = (uint16)((low + high) >> 1);
+        if (Can_RxDispatch[mid].Hw.CanId < CanId)
+        {
+            low = (uint16)(mid + 1u);
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    if ((low < CAN_RX_DISPATCH_COUNT) && (Can_RxDispatch[low].Hw.CanId == CanId))
+    {
+        return &Can_RxDispatch[low];
+    }
+
+    return NULL_PTR;
+}
+
+/**
+ * @brief       Moves every pending frame of a receive FIFO into the receive ring and releases the FIFO.
+ *              Frames that do not fit in the ring, or that are not configured, are still released so that the
+ *              FIFO keeps running. A full ring does not stop the gateway, the frame is read into a scratch slot
+ *              and only dropped if the gateway does not consume it.
+ * @param       Controller: CAN controller index
+ * @param       Fifo: Receive FIFO (0 or 1)
+ * @return      void
+ */
+static void Can_RxDrainFifo(uint8 Controller, uint8 Fifo)
+{
+    CAN_TypeDef *CANx = Can_Hw_GetController(Controller);
+    Can_RxRingType *ring = &Can_RxRing[Controller];
+    volatile uint32_t *rfr = Can_Hw_GetFifoReg(CANx, Fifo);
+    const Can_RxDispatchType *dispatch;
+    Can_RxFrameType scratch;
+    Can_RxFrameType *slot;
+    uint32 rir;
+    uint32 pop;
+    uint16 time;
+    uint8 consumed;
+    uint8 head = ring->Head;
+
+    if ((*rfr & CAN_RF0R_FOVR0) != 0u)
+    {
+        ring->Overrun.FifoOverrun[Fifo]++;
+        Can_Hw_WriteReg(rfr, CAN_RF0R_FOVR0 | CAN_RF0R_FULL0);
+    }
+
+    scratch.Pdu.sdu = scratch.Data;
+    while ((*rfr & CAN_RF0R_FMP0) != 0u)
+    {
+        pop = Can_Hw_GetCycles();
+        Can_Statistics[Controller].RxFrames++;
+        rir = CANx->sFIFOMailBox[Fifo].RIR;
+        Can_Statistics[Controller].RxBits += Can_Hw_GetFrameBits(rir & CAN_RI0R_IDE, ((rir & CAN_RI0R_RTR) != 0u) ?
+                                                                 0u : (CANx->sFIFOMailBox[Fifo].RDTR & CAN_RDT0R_DLC));
+
+        slot = ((uint8)(head - ring->Tail) < CAN_RX_RING_SIZE) ? &ring->Slots[head & CAN_RX_RING_MASK] : &scratch;
+        time = Can_Hw_ReadFifo(CANx, Fifo, slot);
+#if (CAN_TIMESTAMP == CAN_TIMESTAMP_ON)
+        slot->TimeStamp = Can_TimeCapture(Controller, time, Can_Hw_GetFrameBitsMin(rir & CAN_RI0R_IDE,
+                                          ((rir & CAN_RI0R_RTR) != 0u) ? 0u : (slot->Pdu.length)));
+#else
+        (void)time;
+        slot->TimeStamp = 0u;
+#endif
+        dispatch = Can_RxLookup(Fifo, slot->Fmi, slot->Pdu.id & ~CAN_ID_REMOTE);
+        if (dispatch != NULL_PTR)
+        {
+            slot->Hrh = dispatch->Hw.Hoh;
+            slot->Pdu.swPduHandle = dispatch->PduId;
+            /* An L-PDU consumed by the gateway leaves the slot to the next frame. The frames of a self-test
+               belong to the test, whatever their CAN ID. */
+            consumed = FALSE;
+            if ((Can_ConfigPtr != NULL_PTR) && (Can_ConfigPtr->RxGateway != NULL_PTR) &&
+                (Can_Controller[Controller].SelfTest == FALSE))
+            {
+                consumed = Can_ConfigPtr->RxGateway(&slot->Pdu, pop);
+            }
+            if (consumed == FALSE)
+            {
+                if (slot != &scratch)
+                {
+                    head++;
+                }
+                else
+                {
+                    ring->Overrun.RingOverflow++;
+                }
+            }
+        }
+        else
+        {
+            /* Accepted by a superset filter only, the slot is simply reused */
+            ring->Overrun.Unwanted++;
+        }
+
+        /* FMP is only updated once RFOM has been cleared by hardware. Should the release not complete, the
+           FMP interrupt is still pending and resumes the drain. */
+        if (Can_Hw_ReleaseFifo(rfr) != E_OK)
+        {
+            break;
+        }
+    }
+
+    /* Publish the slots only once they are completely written */
+    __DMB();
+    ring->Head = head;
+}
+
+/**
+ * @brief       Receive FIFO interrupt service of a CAN controller (FMP and FOV)
+ * @param       Controller: CAN controller index
+ * @param       Fifo: Receive FIFO (0 or 1)
+ * @return      void
+ */
+static void Can_RxIsr(uint8 Controller, uint8 Fifo)
+{
+    Can_RxDrainFifo(Controller, Fifo);
+}
+
+/**
+ * @brief       Checks whether MSR acknowledges a controller state
+ * @param       CANx: CAN register block
+ * @param       State: Controller state to be checked
+ * @return      TRUE if INAK/SLAK match the state
+ */
+static uint8 Can_ModeAcknowledged(const CAN_TypeDef* CANx, Can_ControllerStateType State)
+{
+    uint32 msr = CANx->MSR & (CAN_MSR_INAK | CAN_MSR_SLAK);
+
+    switch (State)
+    {
+        case CAN_CS_STARTED:
+            return (uint8)(msr == 0u);
+        case CAN_CS_STOPPED:
+            return (uint8)(msr == CAN_MSR_INAK);
+        case CAN_CS_SLEEP:
+            return (uint8)(msr == CAN_MSR_SLAK);
+        default:
+            return FALSE;
+    }
+}
+
+/**
+ * @brief       Requests a transition in MCR and starts timing it, the caller holds the critical section
+ * @param       Controller: CAN controller index
+ * @param       Transition: Requested controller state
+ * @return      void
+ */
+static void Can_ModeRequest(uint8 Controller, Can_ControllerStateType Transition)
+{
+    CAN_TypeDef *CANx = Can_Hw_GetController(Controller);
+
+    switch (Transition)
+    {
+        case CAN_CS_STARTED:    /* Leave initialization mode */
+            Can_Hw_WriteReg(&CANx->MCR, CANx->MCR & ~(CAN_MCR_INRQ | CAN_MCR_SLEEP));
+            break;
+        case CAN_CS_STOPPED:    /* Initialization mode, also the way out of sleep mode */
+            Can_Hw_WriteReg(&CANx->MCR, (CANx->MCR & ~CAN_MCR_SLEEP) | CAN_MCR_INRQ);
+            break;
+        case CAN_CS_SLEEP:      /* Sleep mode is entered from initialization mode */
+            Can_Hw_WriteReg(&CANx->MCR, (CANx->MCR & ~CAN_MCR_INRQ) | CAN_MCR_SLEEP);
+            break;
+        default:
+            return;
+    }
+
+    Can_Controller[Controller].Requested = Transition;
+    Can_Controller[Controller].RequestCycles = Can_Hw_GetCycles();
+    Can_Controller[Controller].Polls = 0u;
+}
+
+/**
+ * @brief       Completes a pending transition once MSR acknowledges it, the caller holds the critical section
+ * @param       Controller: CAN controller index
+ * @param       Polled: TRUE when called from Can_MainFunction_Mode(), counts towards the timeout
+ * @return      void
+ */
+static void Can_ModeCheck(uint8 Controller, uint8 Polled)
+{
+    volatile Can_ControllerRuntimeType *runtime = &Can_Controller[Controller];
+    Can_ModeLatencyType *latency;
+    Can_ControllerStateType requested = runtime->Requested;
+
+    if ((runtime->State == requested) || (runtime->State == CAN_CS_UNINIT))
+    {
+        return;
+    }
+
+    latency = &Can_ModeLatency[Controller][requested];
+
+    if (Can_ModeAcknowledged(Can_Hw_GetController(Controller), requested) == TRUE)
+    {
+        latency->LastCycles = Can_Hw_GetCycles() - runtime->RequestCycles;
+        if (latency->LastCycles > latency->MaxCycles)
+        {
+            latency->MaxCycles = latency->LastCycles;
+        }
+        latency->Count++;
+
+        runtime->State = requested;
+        if ((Can_ConfigPtr != NULL_PTR) && (Can_ConfigPtr->ControllerModeIndication != NULL_PTR))
+        {
+            Can_ConfigPtr->ControllerModeIndication(Controller, requested);
+        }
+    }
+    else if (Polled == TRUE)
+    {
+        runtime->Polls++;
+        if (runtime->Polls >= CAN_MAINFUNCTION_MODE_TIMEOUT)
+        {
+            /* Give up, the upper layer sees no indication and may request the transition again */
+            latency->Timeouts++;
+            runtime->Requested = runtime->State;
+        }
+    }
+    else
+    {
+        /* Acknowledge not there yet, left to Can_MainFunction_Mode() */
+    }
+}
+
+/**
+ * @brief       Takes a controller that went bus-off to CAN_CS_STOPPED and starts its recovery. The transmit
+ *              queue and the pending mailboxes are kept, they go out once the controller is back on the bus.
+ * @param       Controller: CAN controller index
+ * @return      void
+ */
+static void Can_BusOffEnter(uint8 Controller)
+{
+    volatile Can_ControllerRuntimeType *runtime = &Can_Controller[Controller];
+    Can_BusOffRecoveryType *recovery = &Can_BusOffRecovery[Controller];
+
+    Can_Statistics[Controller].BusOff++;
+    if (recovery->Consecutive < 0xFFu)
+    {
+        recovery->Consecutive++;
+    }
+
+    /* A pending transition is dropped, the recovery owns the controller until it is back on the bus */
+    runtime->State = CAN_CS_STOPPED;
+    runtime->Requested = CAN_CS_STOPPED;
+    runtime->BusOffCycles = Can_TimeNow();
+    runtime->BusOffTicks = 0u;
+
+    /* With ABOM the hardware starts counting the recessive bits by itself */
+    if ((Can_Hw_GetController(Controller)->MCR & CAN_MCR_ABOM) != 0u)
+    {
+        runtime->BusOffPhase = CAN_BUSOFF_RECOVERY;
+    }
+    else
+    {
+        runtime->BusOffPhase = CAN_BUSOFF_WAIT;
+    }
+
+    if ((Can_ConfigPtr != NULL_PTR) && (Can_ConfigPtr->ControllerBusOff != NULL_PTR))
+    {
+        Can_ConfigPtr->ControllerBusOff(Controller);
+    }
+}
+
+/**
+ * @brief       Advances the bus-off recovery of a controller by one step, the caller holds the critical section
+ * @param       Controller: CAN controller index
+ * @return      void
+ */
+static void Can_BusOffStep(uint8 Controller)
+{
+    CAN_TypeDef *CANx = Can_Hw_GetController(Controller);
+    volatile Can_ControllerRuntimeType *runtime = &Can_Controller[Controller];
+    Can_BusOffRecoveryType *recovery = &Can_BusOffRecovery[Controller];
+    uint32 delay;
+    uint8 i;
+
+    switch (runtime->BusOffPhase)
+    {
+        case CAN_BUSOFF_WAIT:
+            /* Exponential backoff: CAN_BUSOFF_DELAY_MIN doubled for each bus-off since the bus was stable */
+            delay = CAN_BUSOFF_DELAY_MIN;
+            for (i = 1u; (i < recovery->Consecutive) && (delay < CAN_BUSOFF_DELAY_MAX); i++)
+            {
+                delay <<= 1u;
+            }
+            if (delay > CAN_BUSOFF_DELAY_MAX)
+            {
+                delay = CAN_BUSOFF_DELAY_MAX;
+            }
+
+            runtime->BusOffTicks++;
+            if (runtime->BusOffTicks >= delay)
+            {
+                Can_Hw_WriteReg(&CANx->MCR, CANx->MCR | CAN_MCR_INRQ);
+                runtime->BusOffPhase = CAN_BUSOFF_INIT;
+            }
+            break;
+
+        case CAN_BUSOFF_INIT:
+            if ((CANx->MSR & CAN_MSR_INAK) != 0u)
+            {
+                /* Leaving initialization mode starts the 128 x 11 recessive bit sequence */
+                Can_Hw_WriteReg(&CANx->MCR, CANx->MCR & ~CAN_MCR_INRQ);
+                runtime->BusOffPhase = CAN_BUSOFF_RECOVERY;
+            }
+            break;
+
+        case CAN_BUSOFF_RECOVERY:
+            if (((CANx->ESR & CAN_ESR_BOFF) == 0u) && ((CANx->MSR & CAN_MSR_INAK) == 0u))
+            {
+                recovery->LastCycles = (uint32)(Can_TimeNow() - runtime->BusOffCycles);
+                if (recovery->LastCycles > recovery->MaxCycles)
+                {
+                    recovery->MaxCycles = recovery->LastCycles;
+                }
+                recovery->Count++;
+
+                runtime->BusOffPhase = CAN_BUSOFF_NONE;
+                runtime->BusOffTicks = 0u;
+                runtime->State = CAN_CS_STARTED;
+                runtime->Requested = CAN_CS_STARTED;
+                if ((Can_ConfigPtr != NULL_PTR) && (Can_ConfigPtr->ControllerModeIndication != NULL_PTR))
+                {
+                    Can_ConfigPtr->ControllerModeIndication(Controller, CAN_CS_STARTED);
+                }
+            }
+            break;
+
+        default:
+            /* On the bus: forget the backoff once it has been stable long enough */
+            if ((recovery->Consecutive != 0u) && (runtime->State == CAN_CS_STARTED))
+            {
+                runtime->BusOffTicks++;
+                if (runtime->BusOffTicks >= CAN_BUSOFF_STABLE)
+                {
+                    recovery->Consecutive = 0u;
+                    runtime->BusOffTicks = 0u;
+                }
+            }
+            break;
+    }
+}
+
+/**
+ * @brief       Status change and error interrupt of a controller: sleep acknowledge, wakeup, last error code
+ *              and bus-off
+ * @param       Controller: CAN controller index
+ * @return      void
+ */
+static void Can_SceIsr(uint8 Controller)
+{
+    CAN_TypeDef *CANx = Can_Hw_GetController(Controller);
+    uint32 msr = CANx->MSR;
+    uint32 esr;
+    uint8 error;
+
+    if ((msr & CAN_MSR_ERRI) != 0u)
+    {
+        Can_Hw_WriteReg(&CANx->MSR, CAN_MSR_ERRI);
+        esr = CANx->ESR;
+
+        error = Can_Hw_GetLecError(esr);
+        if (error != 0u)
+        {
+            Can_Statistics[Controller].Errors[error]++;
+            /* Park LEC on the software code so that the next error is seen even if it has the same code */
+            Can_Hw_WriteReg(&CANx->ESR, CAN_ESR_LEC);
+        }
+
+        if (((esr & CAN_ESR_BOFF) != 0u) && (Can_Controller[Controller].BusOffPhase == CAN_BUSOFF_NONE))
+        {
+            Can_BusOffEnter(Controller);
+        }
+    }
+
+    if ((msr & CAN_MSR_WKUI) != 0u)
+    {
+        Can_Hw_WriteReg(&CANx->MSR, CAN_MSR_WKUI);
+        Can_Controller[Controller].WakeupPending = TRUE;
+
+        /* A wakeup from the bus takes a sleeping controller to STOPPED, with AWUM it would start on its own */
+        if (Can_Controller[Controller].State == CAN_CS_SLEEP)
+        {
+            Can_ModeRequest(Controller, CAN_CS_STOPPED);
+        }
+    }
+
+    if ((msr & CAN_MSR_SLAKI) != 0u)
+    {
+        Can_Hw_WriteReg(&CANx->MSR, CAN_MSR_SLAKI);
+    }
+
+    Can_ModeCheck(Controller, FALSE);
+}
+
+/**
+ * @brief       Fills the data of a self-test frame, every byte follows from the first one so that the receiver
+ *              checks it without knowing the order in which the frames come back
+ * @param       Sdu: Data of the frame
+ * @param       Length: Data length (0-8 bytes)
+ * @param       Sequence: Number of the frame in the test
+ * @return      void
+ */
+static void Can_SelfTestFill(uint8* Sdu, uint8 Length, uint32 Sequence)
+{
+    uint8 j;
+
+    for (j = 0u; j < Length; j++)
+    {
+        Sdu[j] = (uint8)(Sequence + j);
+    }
+}
+
+/**
+ * @brief       Takes the frames that came back out of the receive ring, checks them and marks their CAN IDs as
+ *              free again. The mailboxes are refilled and the FIFOs drained here as well, so the test also runs
+ *              with the controller interrupts disabled or with CAN_RX_POLLING.
+ * @param       Controller: CAN controller index
+ * @param       Length: Data length of the test frames
+ * @param       Pending: Per dispatch table entry, TRUE while a frame with its CAN ID is on its way
+ * @param       ResultPtr: Received and Corrupted are counted here
+ * @return      Number of frames taken out of the ring
+ */
+static uint32 Can_SelfTestCollect(uint8 Controller, uint8 Length, uint8* Pending, Can_SelfTestResultType* ResultPtr)
+{
+    const Can_RxFrameType *frame;
+    const Can_RxDispatchType *dispatch;
+    uint32 primask;
+    uint32 count = 0u;
+    uint8 fifo;
+    uint8 intact;
+    uint8 j;
+
+    /* Same work as the TX and RX interrupts, masked so that they never run it concurrently */
+    primask = Can_Hw_EnterCritical();
+    Can_TxProcessCompleted(Controller);
+    Can_TxRefill(Controller);
+    for (fifo = 0u; fifo < CAN_RX_FIFO_MAX; fifo++)
+    {
+        Can_RxDrainFifo(Controller, fifo);
+    }
+    Can_Hw_ExitCritical(primask);
+
+    while (Can_GetRxFrame(Controller, &frame) == E_OK)
+    {
+        intact = (uint8)(frame->Pdu.length == Length);
+        for (j = 1u; (intact == TRUE) && (j < Length); j++)
+        {
+            intact = (uint8)(frame->Data[j] == (uint8)(frame->Data[0] + j));
+        }
+        if (intact == FALSE)
+        {
+            ResultPtr->Corrupted++;
+        }
+
+        dispatch = Can_RxLookup(frame->Fifo, frame->Fmi, frame->Pdu.id & ~CAN_ID_REMOTE);
+        if (dispatch != NULL_PTR)
+        {
+            Pending[dispatch - Can_RxDispatch] = FALSE;
+        }
+
+        Can_ReleaseRxFrame(Controller);
+        count++;
+    }
+
+    ResultPtr->Received += count;
+
+    return count;
+}
+
+/**
+ * @brief       Takes a controller from its reset state to initialization mode and programs its bit timing,
+ *              options and acceptance filters
+ * @param       Controller: CAN controller index
+ * @param       Config: Driver configuration
+ * @return      void
+ */
+static void Can_InitController(uint8 Controller, const Can_ConfigType* Config)
+{
+    CAN_TypeDef *CANx = Can_Hw_GetController(Controller);
+    uint32 mcr;
+
+    /* Leave sleep mode (reset state) into initialization mode, bounded so a dead transceiver cannot hang us */
+    Can_Hw_WriteReg(&CANx->MCR, (CANx->MCR & ~CAN_MCR_SLEEP) | CAN_MCR_INRQ);
+    if (Can_Hw_WaitMsr(CANx, CAN_MSR_INAK | CAN_MSR_SLAK, CAN_MSR_INAK) != E_OK)
+    {
+        return; /* Controller stays CAN_CS_UNINIT */
+    }
+
+    /* Bit timing and operating mode, each field is moved to its own BTR position */
+    CANx->BTR = Can_Hw_GetBitTiming(Config);
+    Can_TimeSetBitRate(Controller);
+
+    /* Map each option onto its own MCR bit, INRQ and SLEEP are owned by the mode state machine */
+    mcr = CANx->MCR & ~(CAN_MCR_TTCM | CAN_MCR_ABOM | CAN_MCR_AWUM | CAN_MCR_NART | CAN_MCR_RFLM | CAN_MCR_TXFP);
+#if (CAN_TIMESTAMP == CAN_TIMESTAMP_ON)
+    mcr |= CAN_MCR_TTCM;                                        // TIME capture for the time stamps
+#else
+    mcr |= (Config->CAN_TTCM == ENABLE) ? CAN_MCR_TTCM : 0u;    // Time Triggered Communication Mode
+#endif
+    mcr |= (Config->CAN_ABOM == ENABLE) ? CAN_MCR_ABOM : 0u;    // Automatic bus-off management
+    mcr |= (Config->CAN_AWUM == ENABLE) ? CAN_MCR_AWUM : 0u;    // Automatic Wake-Up
+    mcr |= (Config->CAN_NART == ENABLE) ? CAN_MCR_NART : 0u;    // No Automatic Retransmission
+    mcr |= (Config->CAN_RFLM == ENABLE) ? CAN_MCR_RFLM : 0u;    // Receive FIFO locked mode
+    mcr |= (Config->CAN_TXFP == ENABLE) ? CAN_MCR_TXFP : 0u;    // Transmit FIFO Priority
+    Can_Hw_WriteReg(&CANx->MCR, mcr);
+
+    /* Program the acceptance filters from the generated image, banks must be inactive while they change */
+    Can_Hw_WriteFilters(CANx, &Can_FilterImage);
+
+    /* The controller is left in initialization mode, Can_SetControllerMode(CAN_CS_STARTED) starts it */
+    Can_Controller[Controller].State = CAN_CS_STOPPED;
+    Can_Controller[Controller].Requested = CAN_CS_STOPPED;
+}
 
 /*
  ************************************************************************************************************
@@ -28,50 +1108,58 @@
  */
 void Can_Init(const Can_ConfigType* Config)
 {
-    /* CAN GPIO Init */
-    RCC->AHB2ENR |= RCC_AHB2ENR_GPIOBEN;
-    GPIOB->MODER &= ~(GPIO_MODER_MODE8_Msk | GPIO_MODER_MODE9_Msk);
-	GPIOB->MODER |=   GPIO_MODER_MODE8_1|GPIO_MODER_MODE9_1;
-	GPIOB->PUPDR &= ~(GPIO_PUPDR_PUPD8_Msk | GPIO_PUPDR_PUPD9_Msk);
-	GPIOB->OSPEEDR |= (GPIO_OSPEEDR_OSPEED8_Msk | GPIO_OSPEEDR_OSPEED9_Msk);
-
-	/*Configure PB8 and PB9 to use CAN Bus AF*/
-	GPIOB->AFR[1] &= ~((0xF << GPIO_AFRH_AFSEL8_Pos) | (0xF << GPIO_AFRH_AFSEL9_Pos));
-	GPIOB->AFR[1] |= (CAN_AF << GPIO_AFRH_AFSEL8_Pos) | (CAN_AF << GPIO_AFRH_AFSEL9_Pos);
-
-    /*Enable Clock access to CAN1*/
-	RCC->APB1ENR1 |= RCC_APB1ENR1_CAN1EN;
-
-    /* Enter Initialization mode*/
-    CAN1->MCR |= CAN_MCR_INRQ;
-    /*Wait until CANBus peripheral is in initialization mode*/
-    while (!(CAN1->MSR & CAN_MSR_INAK)){}
-    
-    // Enable CAN1 peripheral
-    CAN1->MCR &= ~CAN_MCR_SLEEP;
-    while ((CAN1->MSR & CAN_MSR_SLAK)!=0U){}
-
-    /*Configure the timing with the following parameters
-	 * Normal mode.
-	 * Loop back mode is disabled.
-	 * Resynchronization jump width to 1 (value - 1).
-	 * Prescale of 5. (value - 1)
-	 * Time quanta segment 1 is 1 (value - 1)
-	 * Time quanta segment 2 is 15 (value - 1)
-	 * Baud is 500kbps
-	 * */
-    CAN1->BTR = Config->CAN_Mode | Config->CAN_Prescaler | Config->CAN_SJW | Config->CAN_BS1 | Config->CAN_BS2;
-
-    CAN1->MCR &= ~Config->CAN_TTCM ;    // Disable Time Triggered Communication Mode
-	CAN1->MCR &= ~Config->CAN_ABOM;     // Disables automatic bus-off management.
-	CAN1->MCR |= Config->CAN_AWUM;      // Enable Automatic Wake-Up
-    CAN1->MCR |= Config->CAN_NART;      // Disable Automatic Retransmission
-	CAN1->MCR &= ~Config->CAN_RFLM;     // Disables automatic retransmission of messages in case of transmission errors.
-    CAN1->MCR &= ~Config->CAN_TXFP;     // Disable Transmit FIFO Priority
-
-    // Leave Initialization mode
-    CAN1->MCR &= ~CAN_MCR_INRQ;
-    while (CAN1->MSR & CAN_MSR_INAK);
+    uint8 controller;
+    uint8 slot;
+
+    Can_ConfigPtr = Config;
+    Can_Hw_EnableCycleCounter();
+
+    /* Reset the transmit queues and the receive rings, each ring slot keeps pointing to its own data */
+    for (controller = 0u; controller < CAN_CONTROLLER_MAX; controller++)
+    {
+        Can_TxQueue[controller].Count = 0u;
+        Can_TxQueue[controller].AbortPending = 0u;
+        Can_TxQueue[controller].AbortReplace = 0u;
+        Can_RxRing[controller].Head = 0u;
+        Can_RxRing[controller].Tail = 0u;
+        Can_RxRing[controller].Overrun.FifoOverrun[0] = 0u;
+        Can_RxRing[controller].Overrun.FifoOverrun[1] = 0u;
+        Can_RxRing[controller].Overrun.RingOverflow = 0u;
+        Can_RxRing[controller].Overrun.Unwanted = 0u;
+        for (slot = 0u; slot < CAN_RX_RING_SIZE; slot++)
+        {
+            Can_RxRing[controller].Slots[slot].Pdu.sdu = Can_RxRing[controller].Slots[slot].Data;
+        }
+
+        Can_Controller[controller].State = CAN_CS_UNINIT;
+        Can_Controller[controller].Requested = CAN_CS_UNINIT;
+        Can_Controller[controller].WakeupPending = FALSE;
+        Can_Controller[controller].BusOffPhase = CAN_BUSOFF_NONE;
+        Can_Controller[controller].BusOffTicks = 0u;
+        Can_Controller[controller].SelfTest = FALSE;
+        Can_BusOffRecovery[controller] = (Can_BusOffRecoveryType){0};
+        Can_Statistics[controller] = (Can_StatisticsType){0};
+        Can_BusLoad[controller].Cycles = 0u;
+        Can_BusLoad[controller].Bits = 0u;
+        for (slot = 0u; slot < CAN_TX_MAILBOX_MAX; slot++)
+        {
+            Can_TxEgress[controller][slot].Valid = FALSE;
+        }
+        for (slot = 0u; slot < CAN_MODE_LATENCY_MAX; slot++)
+        {
+            Can_ModeLatency[controller][slot].LastCycles = 0u;
+            Can_ModeLatency[controller][slot].MaxCycles = 0u;
+            Can_ModeLatency[controller][slot].Count = 0u;
+            Can_ModeLatency[controller][slot].Timeouts = 0u;
+        }
+    }
+
+    Can_Hw_InitPins();
+
+    for (controller = 0u; controller < CAN_CONTROLLER_MAX; controller++)
+    {
+        Can_InitController(controller, Config);
+    }
 }
 
 /**
@@ -104,73 +1192,75 @@ void Spi_GetVersionInfo(Std_VersionInfoType* VersionInfo)
  */
 void Can_DeInit(void)
 {
-    /*Disable Clock access to CAN1*/
-	RCC->APB1ENR1 &= ~RCC_APB1ENR1_CAN1EN;
+    uint8 controller;
+
+    for (controller = 0u; controller < CAN_CONTROLLER_MAX; controller++)
+    {
+        /* Every interrupt enabled by Can_EnableControllerInterrupts(), in IER and in the NVIC */
+        Can_DisableControllerInterrupts(controller);
 
-    /* Disable the selected CANx interrupt */
-    CAN1->IER &= ~(CAN_IT_FMP0 | CAN_IT_TME | CAN_IT_ERR);
+        Can_Controller[controller].State = CAN_CS_UNINIT;
+        Can_Controller[controller].Requested = CAN_CS_UNINIT;
+    }
 
-    /* Disable Clock access to GPIO CAN */
-    RCC->AHB2ENR &= ~RCC_AHB2ENR_GPIOBEN;
+    Can_Hw_DeInitPins();
 }
 
 /**
- * @brief       This service shall set the baud rate configuration of the CAN controller. Depending on
- *              necessary baud rate modifications the controller might have to reset.
+ * @brief       This service shall set the baud rate configuration of the CAN controller. The controller must be
+ *              in CAN_CS_STOPPED, where BTR is writable without waiting for any acknowledge.
  * @param       Controller: CAN controller, whose baud rate shall be set
- * @param       BaudRateConfigID: references a baud rate configuration by ID (see CanController BaudRateConfig
+ * @param       BaudRateConfigID: references a baud rate configuration by ID (see Can_BaudRateConfigs in Can_Cfg.h)
  * @retval      Std_ReturnType: 
- *              E_OK: Service request accepted, setting of (new) baud rate started
- *              E_NOT_OK: Service request not accepted
+ *              E_OK: Service request accepted, the new baud rate is set
+ *              E_NOT_OK: Service request not accepted, unknown ID or the controller is not in CAN_CS_STOPPED
  */
 Std_ReturnType Can_SetBaudrate(uint8 Controller, uint16 BaudRateConfigID)
 {
-    CAN_TypeDef *CANx = NULL; /* Declare pointer for CAN controller */
+    CAN_TypeDef *CANx = Can_Hw_GetController(Controller); /* Declare pointer for CAN controller */
+    const Can_BaudRateConfigType *baudrate = NULL_PTR;
+    uint8 i;
 
-    /* Select the appropriate CAN controller based on the 'Controller' parameter */
-    if (Controller == 0)
-    {                
-        CANx = CAN1; /**< Assign CAN1 to CANx (0 -> CAN1) */
-    }
-    else
+    if (CANx == NULL_PTR)
     {
         return E_NOT_OK; /* Invalid controller, return error */
     }
 
-    /* Disable the CAN controller before configuring */
-    CANx->MCR |= CAN_MCR_INRQ;
-
-    switch (BaudRateConfigID) 
+    /* Look the configuration up in the table computed at build time */
+    for (i = 0u; i < CAN_BAUDRATE_CONFIG_MAX; i++)
     {
-        case 125:  // 125 kbps
-            CAN1->BTR = (20-1) | CAN_SJW_1TQ | CAN_BS1_15TQ | CAN_BS2_2TQ;
-            break;
-
-        case 250:  // 250 kbps
-            CAN1->BTR = (10-1) | CAN_SJW_1TQ | CAN_BS1_15TQ | CAN_BS2_2TQ;
-            break;
-
-        case 500:  // 500 kbps
-            CAN1->BTR = (5-1) | CAN_SJW_1TQ | CAN_BS1_15TQ | CAN_BS2_2TQ;
+        if (Can_BaudRateConfigs[i].BaudRateConfigID == BaudRateConfigID)
+        {
+            baudrate = &Can_BaudRateConfigs[i];
             break;
+        }
+    }
 
-        case 1000:  // 1000 kbps (1 Mbps)
-            CAN1->BTR = (3-1) | CAN_SJW_1TQ | CAN_BS1_12TQ | CAN_BS2_2TQ;
-            break;
+    if (baudrate == NULL_PTR)
+    {
+        return E_NOT_OK; /* Unknown baud rate configuration */
+    }
 
-        default:
-            return E_NOT_OK; 
+    /* BTR can only be written in initialization mode, which CAN_CS_STOPPED already is: nothing to wait for.
+       INAK is still checked, a cancelled bus-off recovery reports STOPPED before the hardware is back in it. */
+    if ((Can_Controller[Controller].State != CAN_CS_STOPPED) ||
+        (Can_Controller[Controller].Requested != CAN_CS_STOPPED) ||
+        ((CANx->MSR & CAN_MSR_INAK) == 0u))
+    {
+        return E_NOT_OK;
     }
 
-    // Leave Initialization mode
-    CAN1->MCR &= ~CAN_MCR_INRQ;
-    while (CAN1->MSR & CAN_MSR_INAK);
+    /* Keep the loop back and silent mode bits */
+    CANx->BTR = (CANx->BTR & (CAN_BTR_LBKM | CAN_BTR_SILM)) | baudrate->BTR;
+    Can_TimeSetBitRate(Controller);
 
     return E_OK;
 }
 
 /**
  * @brief       This function performs software triggered state transitions of the CAN controller State machine.
+ * @details     The transition is only requested here. Its completion is detected by the SCE interrupt (sleep
+ *              acknowledge) or by Can_MainFunction_Mode(), which then call ControllerModeIndication.
  * @param       Controller: CAN controller for which the status shall be changed
  * @param       Transition: Transition value to request new CAN controller state
  * @retval      Std_ReturnType: 
@@ -179,77 +1269,62 @@ Std_ReturnType Can_SetBaudrate(uint8 Controller, uint16 BaudRateConfigID)
  */
 Std_ReturnType Can_SetControllerMode(uint8 Controller, Can_ControllerStateType Transition)
 {
-    CAN_TypeDef *CANx = NULL; /* Declare pointer for CAN controller */
+    CAN_TypeDef *CANx = Can_Hw_GetController(Controller); /* Declare pointer for CAN controller */
     Std_ReturnType status = E_OK; /* Initialize the return status */
+    Can_ControllerStateType state;
+    uint32 primask;
 
-    /* Select the appropriate CAN controller based on the 'Controller' parameter */
-    if (Controller == 0)
-    {                
-        CANx = CAN1; /* Assign CAN1 to CANx (0 -> CAN1) */
-    }
-    else
+    if (CANx == NULL_PTR)
     {
         return E_NOT_OK; /* Invalid controller, return error */
     }
 
-    /* Switch based on the requested controller mode transition */
-    switch (Transition)
-    {
-        case CAN_CS_STARTED: /* Normal mode */
-            /* Enter Initialization Mode */
-            CANx->MCR |= CAN_MCR_INRQ; /**< Request Initialization mode */
-            
-            /* Wait until CAN is in Initialization Mode */
-            while ((CANx->MSR & CAN_MSR_INAK) == 0); /* Wait for INAK flag */
-            
-            /* Exit Initialization Mode to start CAN operation */
-            CANx->MCR &= ~CAN_MCR_INRQ; /* Clear INRQ bit to leave initialization mode */
-            
-            /* Wait until CAN leaves Initialization Mode */
-            while ((CANx->MSR & CAN_MSR_INAK) != 0); /* Wait for INAK flag to be cleared */
-            break;
+    primask = Can_Hw_EnterCritical();
+    state = Can_Controller[Controller].State;
 
-        case CAN_CS_SLEEP: /* Sleep mode */
-            /* Request Sleep Mode */
-            CANx->MCR |= CAN_MCR_SLEEP; /* Set the SLEEP bit to enter Sleep mode */
-            
-            /* Wait for CAN to enter Sleep mode */
-            while ((CANx->MSR & CAN_MSR_SLAK) == 0); /* Wait for SLAK flag to be set */
-            break;
+    /* During a bus-off recovery the controller is restarted by Can_MainFunction_BusOff(). Requesting
+       STOPPED or SLEEP cancels the recovery and leaves the controller in initialization mode. */
+    if (Can_Controller[Controller].BusOffPhase != CAN_BUSOFF_NONE)
+    {
+        if (Transition == CAN_CS_STARTED)
+        {
+            Can_Hw_ExitCritical(primask);
+            return E_NOT_OK;
+        }
+        Can_Controller[Controller].BusOffPhase = CAN_BUSOFF_NONE;
+        Can_Controller[Controller].BusOffTicks = 0u;
+    }
 
-        case CAN_CS_STOPPED: /* Stop mode */
-            /* Enter Initialization Mode first */
-            CANx->MCR |= CAN_MCR_INRQ; /* Request Initialization mode */
-            
-            /* Wait until CAN is in Initialization Mode */
-            while ((CANx->MSR & CAN_MSR_INAK) == 0); /* Wait for INAK flag */
-            
-            /* Request Stop Mode */
-            CANx->MCR |= CAN_MCR_SLEEP; /* Set the SLEEP bit to stop CAN operation */
-            
-            /* Wait for CAN to enter Stop Mode */
-            while ((CANx->MSR & CAN_MSR_SLAK) == 0); /* Wait for SLAK flag */
+    /* Valid transitions: STOPPED <-> STARTED and STOPPED <-> SLEEP */
+    switch (Transition)
+    {
+        case CAN_CS_STARTED:
+        case CAN_CS_SLEEP:
+            if (state != CAN_CS_STOPPED)
+            {
+                status = E_NOT_OK;
+            }
             break;
 
-        case CAN_CS_UNINIT: /* Uninitialized state */
-            /* Disable the CAN controller */
-            CANx->MCR |= CAN_MCR_INRQ; /* Request Initialization mode */
-            
-            /* Wait until CAN is in Initialization Mode */
-            while ((CANx->MSR & CAN_MSR_INAK) == 0); /* Wait for INAK flag */
-            
-            /* Reset the CAN controller to uninitialized state */
-            CANx->MCR |= CAN_MCR_RESET; /* Reset CAN controller */
-            
-            /* Wait for CAN to reset */
-            while ((CANx->MSR & CAN_MSR_INAK) != 0); /* Wait for INAK flag to be cleared */
+        case CAN_CS_STOPPED:
+            if ((state != CAN_CS_STARTED) && (state != CAN_CS_STOPPED) && (state != CAN_CS_SLEEP))
+            {
+                status = E_NOT_OK;
+            }
             break;
 
         default:
-            status = E_NOT_OK; /* Invalid transition state */
+            status = E_NOT_OK; /* CAN_CS_UNINIT is only reached through Can_DeInit() */
             break;
     }
 
+    if (status == E_OK)
+    {
+        Can_ModeRequest(Controller, Transition);
+    }
+
+    Can_Hw_ExitCritical(primask);
+
     return status; /* Return the operation status (E_OK or E_NOT_OK) */
 }
 
@@ -262,37 +1337,42 @@ void Can_DisableControllerInterrupts(uint8 Controller)
 {
     CAN_TypeDef *CANx = NULL; /* Declare pointer for CAN controller */
 
-    /* Select the appropriate CAN controller based on the 'Controller' parameter */
-    if (Controller == 0)
-    {                
-        CANx = CAN1; /* Assign CAN1 to CANx (0 -> CAN1) */
-    }
-    else
+    /* Select the register block of the controller */
+    CANx = Can_Hw_GetController(Controller);
+    if (CANx == NULL_PTR)
     {
         return; /* Invalid controller, do nothing or handle error */
     }
 
-    // Disable CAN1 interrupts by clearing the relevant bits in the CAN_IER register
+    // Disable CANx interrupts by clearing the relevant bits in the CAN_IER register
     CANx->IER &= ~CAN_IT_FMP0;      // FIFO 0 message pending interrupt
     CANx->IER &= ~CAN_IT_FMP1;      // FIFO 1 message pending interrupt
+    CANx->IER &= ~CAN_IT_FOV0;      // FIFO 0 overrun interrupt
+    CANx->IER &= ~CAN_IT_FOV1;      // FIFO 1 overrun interrupt
     CANx->IER &= ~CAN_IT_TME;       // Transmit mailbox empty interrupt
     CANx->IER &= ~ CAN_IT_ERR;      // Error interrupt
+    CANx->IER &= ~CAN_IT_LEC;       // Last error code
+    CANx->IER &= ~CAN_IT_BOF;       // Bus-off
     CANx->IER &= ~CAN_IT_WKU;       // Wakeup interrupt
     CANx->IER &= ~CAN_IT_SLK;       // Sleep interrupt
 
+    NVIC_DisableIRQ(CAN1_TX_IRQn);
+    NVIC_DisableIRQ(CAN1_RX0_IRQn);
+    NVIC_DisableIRQ(CAN1_RX1_IRQn);
+    NVIC_DisableIRQ(CAN1_SCE_IRQn);
+
     /* Clear the pending interrupt flags */
-    CANx->RF0R = CAN_RF0R_FULL0;                                // FIFO 0 message pending interrupt
-    CANx->RF1R = CAN_RF1R_FULL1;                                // FIFO 1 message pending interrupt
+    Can_Hw_WriteReg(&CANx->RF0R, CAN_RF0R_FULL0);              // FIFO 0 message pending interrupt
+    Can_Hw_WriteReg(&CANx->RF1R, CAN_RF1R_FULL1);              // FIFO 1 message pending interrupt
 
-    CANx->TSR = CAN_TSR_RQCP0|CAN_TSR_RQCP1|CAN_TSR_RQCP2;      // Transmit mailbox empty interrupt
+    /* RQCPx are left set on purpose, they are consumed by the transmit queue when interrupts come back */
 
     /*Clear LEC bits */
-    CANx->ESR = 0; 
+    Can_Hw_WriteReg(&CANx->ESR, 0u);
     /* Clear CAN_MSR_ERRI (rc_w1) */
-    CANx->MSR = CAN_MSR_ERRI; ;                                 // Error interrupt
+    Can_Hw_WriteReg(&CANx->MSR, CAN_MSR_ERRI);                  // Error interrupt
 
-    CANx->MSR = CAN_MSR_WKUI;                                   // Wakeup interrupt
-    CANx->MSR = CAN_MSR_SLAKI;                                  // Sleep interrupt
+    /* WKUI and SLAKI are left set as well, the SCE interrupt completes the mode transition when it comes back */
 }
 
 /**
@@ -304,23 +1384,33 @@ void Can_EnableControllerInterrupts(uint8 Controller)
 {
     CAN_TypeDef *CANx = NULL; /* Declare pointer for CAN controller */
 
-    /* Select the appropriate CAN controller based on the 'Controller' parameter */
-    if (Controller == 0)
-    {                
-        CANx = CAN1; /* Assign CAN1 to CANx (0 -> CAN1) */
-    }
-    else
+    /* Select the register block of the controller */
+    CANx = Can_Hw_GetController(Controller);
+    if (CANx == NULL_PTR)
     {
         return; /* Invalid controller, do nothing or handle error */
     }
 
-    // Enable CAN1 interrupts by setting the relevant bits in the CAN_IER register
+    // Enable CANx interrupts by setting the relevant bits in the CAN_IER register
+#if (CAN_RX_PROCESSING == CAN_RX_INTERRUPT)
     CANx->IER |= CAN_IT_FMP0;      // FIFO 0 message pending interrupt
     CANx->IER |= CAN_IT_FMP1;      // FIFO 1 message pending interrupt
+    CANx->IER |= CAN_IT_FOV0;      // FIFO 0 overrun interrupt
+    CANx->IER |= CAN_IT_FOV1;      // FIFO 1 overrun interrupt
+#endif
     CANx->IER |= CAN_IT_TME;       // Transmit mailbox empty interrupt
     CANx->IER |=  CAN_IT_ERR;      // Error interrupt
+    CANx->IER |= CAN_IT_LEC;       // Last error code, counted in the statistics
+    CANx->IER |= CAN_IT_BOF;       // Bus-off
     CANx->IER |= CAN_IT_WKU;       // Wakeup interrupt
     CANx->IER |= CAN_IT_SLK;       // Sleep interrupt
+
+    NVIC_EnableIRQ(CAN1_TX_IRQn);   // Transmit queue refill
+    NVIC_EnableIRQ(CAN1_SCE_IRQn);  // Sleep acknowledge, wakeup and errors
+#if (CAN_RX_PROCESSING == CAN_RX_INTERRUPT)
+    NVIC_EnableIRQ(CAN1_RX0_IRQn);  // FIFO 0 drain
+    NVIC_EnableIRQ(CAN1_RX1_IRQn);  // FIFO 1 drain
+#endif
 }
 
 /**
@@ -332,32 +1422,24 @@ void Can_EnableControllerInterrupts(uint8 Controller)
  */
 Std_ReturnType Can_CheckWakeup(uint8 Controller)
 {
-    CAN_TypeDef *CANx = NULL; /* Declare pointer for CAN controller */
     Std_ReturnType status = E_NOT_OK; /* Initialize the return status to E_NOT_OK */
+    uint32 primask;
 
-    /* Select the appropriate CAN controller based on the 'Controller' parameter */
-    if (Controller == 0)
-    {                
-        CANx = CAN1; /* Assign CAN1 to CANx (0 -> CAN1) */
-    }
-    else
+    if (Can_Hw_GetController(Controller) == NULL_PTR)
     {
         return E_NOT_OK; /* Invalid controller, do nothing or handle error */
     }
 
-    /* Check if the CAN controller is awake (SLAK bit in MSR should be cleared) */
-    if ((CANx->MSR & CAN_MSR_SLAK) == 0) /* SLAK = 0 means CAN is awake */
+    /* Report, once, a wakeup latched by the SCE interrupt */
+    primask = Can_Hw_EnterCritical();
+    if (Can_Controller[Controller].WakeupPending == TRUE)
     {
-        /* Return E_OK if the CAN controller is awake */
-        status = E_OK; 
-        /* Clear Wake-up interrupt flag */
-        CANx->MSR = CAN_MSR_WKUI;
-		
-        /* Return E_OK if the CAN controller is awake */
-		status = E_OK; 
+        Can_Controller[Controller].WakeupPending = FALSE;
+        status = E_OK;
     }
+    Can_Hw_ExitCritical(primask);
 
-    return status; /* Return the status (E_OK if awake, E_NOT_OK if in sleep) */
+    return status; /* Return the status (E_OK if a wakeup was detected) */
 }
 
 /**
@@ -373,12 +1455,9 @@ Std_ReturnType Can_GetControllerErrorState(uint8 ControllerId, Can_ErrorStateTyp
     CAN_TypeDef *CANx = NULL; /* Declare pointer for CAN controller */
     Std_ReturnType status = E_NOT_OK; /* Initialize the return status to E_NOT_OK */
 
-    /* Select the appropriate CAN controller based on the 'Controller' parameter */
-    if (ControllerId == 0)
-    {                
-        CANx = CAN1; /* Assign CAN1 to CANx (0 -> CAN1) */
-    }
-    else
+    /* Select the register block of the controller */
+    CANx = Can_Hw_GetController(ControllerId);
+    if (CANx == NULL_PTR)
     {
         return E_NOT_OK; /* Invalid controller, do nothing or handle error */
     }
@@ -420,41 +1499,19 @@ Std_ReturnType Can_GetControllerErrorState(uint8 ControllerId, Can_ErrorStateTyp
  */
 Std_ReturnType Can_GetControllerMode(uint8 Controller, Can_ControllerStateType *ControllerModePtr)
 {
-    CAN_TypeDef *CANx = NULL; /* Declare pointer for CAN controller */
-
     /* Check if the ControllerModePtr is valid */
     if (ControllerModePtr == NULL)
     {
         return E_NOT_OK; /* Invalid pointer, return error */
     }
 
-    /* Select the appropriate CAN controller based on the Controller parameter */
-    if (Controller == 0)
-    {
-        CANx = CAN1; /* CAN1 selected */
-    }
-    else
+    if (Can_Hw_GetController(Controller) == NULL_PTR)
     {
         return E_NOT_OK; /* Invalid controller ID, return error */
     }
 
-    /* Check the current mode of the selected CAN controller */
-    if (CANx->MCR & CAN_MCR_INRQ) /* Initialization request flag */
-    {
-        *ControllerModePtr = CAN_CS_UNINIT; /* Controller is uninitialized */
-    }
-    else if (CANx->MSR & CAN_MSR_SLAK) /* Sleep acknowledge flag */
-    {
-        *ControllerModePtr = CAN_CS_SLEEP; /* Controller is in sleep mode */
-    }
-    else if (CANx->MSR & CAN_MSR_TXM) /* Transmit mode flag */
-    {
-        *ControllerModePtr = CAN_CS_STARTED; /* Controller is operational */
-    }
-    else
-    {
-        *ControllerModePtr = CAN_CS_STOPPED; /* Controller is stopped */
-    }
+    /* Last acknowledged state, a pending transition is reported once it has completed */
+    *ControllerModePtr = Can_Controller[Controller].State;
 
     return E_OK; /* Return success */
 }
@@ -477,12 +1534,9 @@ Std_ReturnType Can_GetControllerRxErrorCounter(uint8 ControllerId, uint8 *RxErro
         return E_NOT_OK; /* Invalid pointer, return error */
     }
 
-    /* Select the appropriate CAN controller based on the ControllerId */
-    if (ControllerId == 0)
-    {
-        CANx = CAN1; /* CAN1 selected */
-    }
-    else
+    /* Select the register block of the controller */
+    CANx = Can_Hw_GetController(ControllerId);
+    if (CANx == NULL_PTR)
     {
         return E_NOT_OK; /* Invalid controller ID, return error */
     }
@@ -511,12 +1565,9 @@ Std_ReturnType Can_GetControllerTxErrorCounter(uint8 ControllerId, uint8 *TxErro
         return E_NOT_OK; /* Invalid pointer, return error */
     }
 
-    /* Select the appropriate CAN controller based on the ControllerId */
-    if (ControllerId == 0)
-    {
-        CANx = CAN1; /* CAN1 selected */
-    }
-    else
+    /* Select the register block of the controller */
+    CANx = Can_Hw_GetController(ControllerId);
+    if (CANx == NULL_PTR)
     {
         return E_NOT_OK; /* Invalid controller ID, return error */
     }
@@ -529,61 +1580,699 @@ Std_ReturnType Can_GetControllerTxErrorCounter(uint8 ControllerId, uint8 *TxErro
 
 /**
  * @brief     This function is called by CanIf to pass a CAN message to CanDrv for transmission
+ * @details   The L-PDU goes straight into an empty mailbox when nothing is queued. Otherwise it is copied into
+ *            the software queue of the HTH, which is ordered by CAN ID and refilled into the mailboxes from the
+ *            transmit mailbox empty interrupt. A pending L-PDU with the same CAN ID is stale: it is overwritten
+ *            in the queue, or aborted in its mailbox, and reported through CancelTxConfirmation.
  * @param     Hth: information which HW-transmit handle shall be used for transmit
  * @param     PduInfo: Pointer to SDU user memory, Data Length and Identifier.
  * @retval    Std_ReturnType: 
  *            E_OK: Write command has been accepted
  *            E_NOT_OK: development error occurred
+ *            CAN_BUSY: No transmit mailbox and no queue entry was available
 */
 Std_ReturnType Can_Write(Can_HwHandleType Hth, const Can_PduType* PduInfo)
 {
-    CAN_TypeDef *CANx = NULL; /* Declare pointer for CAN controller */
+    CAN_TypeDef *CANx = Can_Hw_GetController(Hth); /* HTH n is served by controller n */
+    Can_TxQueueType *queue;
+    Std_ReturnType status = CAN_BUSY; /* Initialize the return status to CAN_BUSY */
+    Can_TxQueueEntryType *entry;
+    PduIdType stale;
+    uint32 primask;
+    uint32 tsr;
+    uint8 mailbox;
+
+    if ((CANx == NULL_PTR) || (PduInfo == NULL_PTR) ||
+        ((PduInfo->sdu == NULL_PTR) && ((PduInfo->id & CAN_ID_REMOTE) == 0u)))
+    {
+        return E_NOT_OK; /* Invalid HTH or PDU, return error */
+    }
+
+    queue = &Can_TxQueue[Hth];
+
+    primask = Can_Hw_EnterCritical();
+
+    /* Aborted mailboxes must be back in the queue before a mailbox is reused */
+    Can_TxProcessCompleted(Hth);
 
-    /* Select the appropriate CAN controller based on the Hth */
-    if (Hth == 0)
+    /* A queued L-PDU with the same CAN ID is overwritten in place, it keeps its position */
+    entry = Can_TxQueueFind(queue, PduInfo->id);
+    if (entry != NULL_PTR)
     {
-        CANx = CAN1; /* CAN1 selected */
+        stale = entry->swPduHandle;
+        Can_TxQueueFill(entry, PduInfo->swPduHandle, PduInfo->length, PduInfo->sdu);
+        Can_Statistics[Hth].TxCancelled++;
+        if ((Can_ConfigPtr != NULL_PTR) && (Can_ConfigPtr->CancelTxConfirmation != NULL_PTR))
+        {
+            Can_ConfigPtr->CancelTxConfirmation(stale);
+        }
+        Can_Hw_ExitCritical(primask);
+        return E_OK;
     }
-    else
+
+    /* A mailbox with the same CAN ID is aborted, the new L-PDU waits in the queue until the abort has
+       completed so that the two are never pending together. An abort before the frame reached the bus
+       completes at once, the stale L-PDU is then reported here. */
+    if (Can_TxAbortSameId(Hth, PduInfo->id) == TRUE)
     {
-        return E_NOT_OK; /* Invalid controller ID, return error */
+        Can_TxProcessCompleted(Hth);
+    }
+
+    tsr = CANx->TSR;
+    if ((queue->Count == 0u) && ((tsr & CAN_TSR_TME) != 0u) && ((queue->AbortPending | queue->AbortReplace) == 0u))
+    {
+        /* Nothing waiting, skip the copy into the queue */
+        mailbox = (uint8)((tsr & CAN_TSR_CODE) >> CAN_TSR_CODE_Pos);
+        Can_TxLoadMailbox(Hth, mailbox, PduInfo);
+        status = E_OK;
+    }
+    else if ((queue->Count + Can_TxAbortCount(queue)) < CAN_TX_QUEUE_SIZE)
+    {
+        (void)Can_TxQueueInsert(queue, PduInfo->id, PduInfo->swPduHandle, PduInfo->length, PduInfo->sdu);
+        Can_TxRefill(Hth);
+        status = E_OK;
+    }
+
+    Can_Hw_ExitCritical(primask);
+
+    return status;
+}
+
+/**
+ * @brief     Returns the current time of the time base used by the CAN time stamps.
+ * @param     ControllerId: CAN controller, whose time shall be acquired.
+ * @param     timeStampPtr: Pointer to a memory location, where the current time will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Current time available.
+ *            E_NOT_OK: Wrong ControllerId, invalid pointer, or time stamps disabled.
+ */
+Std_ReturnType Can_GetCurrentTime(uint8 ControllerId, Can_TimeStampType* timeStampPtr)
+{
+#if (CAN_TIMESTAMP == CAN_TIMESTAMP_ON)
+    if ((Can_Hw_GetController(ControllerId) == NULL_PTR) || (timeStampPtr == NULL_PTR))
+    {
+        return E_NOT_OK;
+    }
+
+    Can_TimeConvert(Can_TimeNow(), timeStampPtr);
+
+    return E_OK;
+#else
+    (void)ControllerId;
+    (void)timeStampPtr;
+    return E_NOT_OK;
+#endif
+}
+
+/**
+ * @brief     Returns the time at which the last confirmed transmission of an L-PDU started on the bus.
+ * @param     TxPduId: L-PDU handle given to Can_Write().
+ * @param     Hth: Hardware transmit handle the L-PDU was sent on.
+ * @param     timeStampPtr: Pointer to a memory location, where the time stamp will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Time stamp available.
+ *            E_NOT_OK: The L-PDU was not among the last transmissions of each mailbox, or invalid parameter.
+ */
+Std_ReturnType Can_GetEgressTimeStamp(PduIdType TxPduId, Can_HwHandleType Hth, Can_TimeStampType* timeStampPtr)
+{
+    Std_ReturnType status = E_NOT_OK;
+#if (CAN_TIMESTAMP == CAN_TIMESTAMP_ON)
+    uint64 stamp = 0u;
+    uint32 primask;
+    uint8 mailbox;
+
+    if ((Can_Hw_GetController(Hth) == NULL_PTR) || (timeStampPtr == NULL_PTR))
+    {
+        return E_NOT_OK;
+    }
+
+    /* Confirmations are consumed from the TX interrupt, which may also be the context calling this */
+    primask = Can_Hw_EnterCritical();
+    for (mailbox = 0u; mailbox < CAN_TX_MAILBOX_MAX; mailbox++)
+    {
+        if ((Can_TxEgress[Hth][mailbox].Valid == TRUE) && (Can_TxEgress[Hth][mailbox].PduId == TxPduId) &&
+            ((status != E_OK) || (Can_TxEgress[Hth][mailbox].TimeStamp > stamp)))
+        {
+            stamp = Can_TxEgress[Hth][mailbox].TimeStamp;
+            status = E_OK;
+        }
+    }
+    Can_Hw_ExitCritical(primask);
+
+    if (status == E_OK)
+    {
+        Can_TimeConvert(stamp, timeStampPtr);
+    }
+#else
+    (void)TxPduId;
+    (void)Hth;
+    (void)timeStampPtr;
+#endif
+
+    return status;
+}
+
+/**
+ * @brief     Returns the start of frame time of the received L-PDU currently held through Can_GetRxFrame().
+ * @param     Hrh: Hardware receive handle the L-PDU was received on.
+ * @param     timeStampPtr: Pointer to a memory location, where the time stamp will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Time stamp available.
+ *            E_NOT_OK: No frame of this HRH is held, or invalid parameter.
+ */
+Std_ReturnType Can_GetIngressTimeStamp(Can_HwHandleType Hrh, Can_TimeStampType* timeStampPtr)
+{
+#if (CAN_TIMESTAMP == CAN_TIMESTAMP_ON)
+    const Can_RxFrameType *frame;
+    uint8 controller;
+
+    if (timeStampPtr == NULL_PTR)
+    {
+        return E_NOT_OK;
+    }
+
+    /* The held frame is the oldest one of the ring, it stays in place until Can_ReleaseRxFrame() */
+    for (controller = 0u; controller < CAN_CONTROLLER_MAX; controller++)
+    {
+        if ((Can_GetRxFrame(controller, &frame) == E_OK) && (frame->Hrh == Hrh))
+        {
+            Can_TimeConvert(frame->TimeStamp, timeStampPtr);
+            return E_OK;
+        }
+    }
+#else
+    (void)Hrh;
+    (void)timeStampPtr;
+#endif
+
+    return E_NOT_OK;
+}
+
+/**
+ * @brief     Returns the traffic and error counters of a CAN controller.
+ * @param     Controller: CAN controller, whose counters shall be acquired.
+ * @param     StatisticsPtr: Pointer to a memory location, where the counters will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Counters available.
+ *            E_NOT_OK: Wrong Controller, or invalid pointer.
+ */
+Std_ReturnType Can_GetStatistics(uint8 Controller, Can_StatisticsType *StatisticsPtr)
+{
+    if ((Can_Hw_GetController(Controller) == NULL_PTR) || (StatisticsPtr == NULL_PTR))
+    {
+        return E_NOT_OK;
+    }
+
+    /* Every counter is a single 32-bit word with one writer, a plain copy reads each one consistently */
+    *StatisticsPtr = Can_Statistics[Controller];
+    StatisticsPtr->FifoOverrun[0] = Can_RxRing[Controller].Overrun.FifoOverrun[0];
+    StatisticsPtr->FifoOverrun[1] = Can_RxRing[Controller].Overrun.FifoOverrun[1];
+
+    return E_OK;
+}
+
+/**
+ * @brief     Returns the bus load of a CAN controller since the previous call.
+ * @details   The load is the worst case stuffed length of the frames sent and received, over the bit times
+ *            elapsed. Frames rejected by the acceptance filters and error frames are not seen, so it is a lower
+ *            bound unless the filters pass all traffic. The counters wrap after 2^32 bits (71 min at 1 Mbit/s),
+ *            the function must be called more often than that.
+ * @param     Controller: CAN controller, whose bus load shall be acquired.
+ * @param     LoadPtr: Pointer to a memory location, where the bus load in per mille will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Bus load available.
+ *            E_NOT_OK: Wrong Controller, or invalid pointer.
+ */
+Std_ReturnType Can_GetBusLoad(uint8 Controller, uint16 *LoadPtr)
+{
+    Can_BusLoadType *load;
+    uint64 now;
+    uint64 busCycles;
+    uint64 elapsed;
+    uint64 permille;
+    uint32 bits;
+
+    if ((Can_Hw_GetController(Controller) == NULL_PTR) || (LoadPtr == NULL_PTR))
+    {
+        return E_NOT_OK;
+    }
+
+    load = &Can_BusLoad[Controller];
+    now = Can_TimeNow();
+    bits = Can_Statistics[Controller].TxBits + Can_Statistics[Controller].RxBits;
+
+    elapsed = now - load->Cycles;
+    busCycles = (uint64)(uint32)(bits - load->Bits) * Can_TimeSync[Controller].CyclesPerBit;
+    permille = (elapsed == 0u) ? 0u : ((busCycles * 1000u) / elapsed);
+
+    /* Worst case stuffing overestimates, clip at a full bus */
+    *LoadPtr = (uint16)((permille > 1000u) ? 1000u : permille);
+
+    load->Cycles = now;
+    load->Bits = bits;
+
+    return E_OK;
+}
+
+/**
+ * @brief     This function performs the polling of bus-off events and drives the bus-off recovery.
+ * @details   Bus-off is detected by the SCE interrupt, this function only steps through the backoff delay,
+ *            the INRQ toggle and the wait for the 128 x 11 recessive bits. Its period is the unit of the
+ *            CAN_BUSOFF_DELAY_xxx settings.
+ * @param     void
+ * @retval    void
+ */
+void Can_MainFunction_BusOff(void)
+{
+    uint8 controller;
+    uint32 primask;
+
+    for (controller = 0u; controller < CAN_CONTROLLER_MAX; controller++)
+    {
+        primask = Can_Hw_EnterCritical();
+        Can_BusOffStep(controller);
+        Can_Hw_ExitCritical(primask);
+    }
+}
+
+/**
+ * @brief     Returns the duration of the bus-off recoveries of a CAN controller.
+ * @param     Controller: CAN controller, whose recovery times shall be acquired.
+ * @param     RecoveryPtr: Pointer to a memory location, where the recovery times will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Recovery times available.
+ *            E_NOT_OK: Wrong Controller, or invalid pointer.
+ */
+Std_ReturnType Can_GetBusOffRecovery(uint8 Controller, Can_BusOffRecoveryType *RecoveryPtr)
+{
+    uint32 primask;
+
+    if ((Can_Hw_GetController(Controller) == NULL_PTR) || (RecoveryPtr == NULL_PTR))
+    {
+        return E_NOT_OK;
+    }
+
+    primask = Can_Hw_EnterCritical();
+    *RecoveryPtr = Can_BusOffRecovery[Controller];
+    Can_Hw_ExitCritical(primask);
+
+    return E_OK;
+}
+
+/**
+ * @brief     This function performs the polling of CAN controller mode transitions.
+ * @param     void
+ * @retval    void
+ */
+void Can_MainFunction_Mode(void)
+{
+    uint8 controller;
+    uint32 primask;
+
+    /* Keeps the 64-bit time base across DWT wrap arounds */
+    (void)Can_TimeNow();
+
+    for (controller = 0u; controller < CAN_CONTROLLER_MAX; controller++)
+    {
+        primask = Can_Hw_EnterCritical();
+        Can_ModeCheck(controller, TRUE);
+        Can_Hw_ExitCritical(primask);
+    }
+}
+
+/**
+ * @brief     Returns the latency of the transitions into a CAN controller state.
+ * @param     Controller: CAN controller, whose latency shall be acquired.
+ * @param     ControllerMode: Target state of the transitions (CAN_CS_STARTED, CAN_CS_STOPPED or CAN_CS_SLEEP).
+ * @param     LatencyPtr: Pointer to a memory location, where the latency will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Latency available.
+ *            E_NOT_OK: Wrong Controller or ControllerMode, or invalid pointer.
+ */
+Std_ReturnType Can_GetModeLatency(uint8 Controller, Can_ControllerStateType ControllerMode, Can_ModeLatencyType *LatencyPtr)
+{
+    uint32 primask;
+
+    if ((Can_Hw_GetController(Controller) == NULL_PTR) || (LatencyPtr == NULL_PTR) ||
+        (ControllerMode == CAN_CS_UNINIT) || ((uint32)ControllerMode >= CAN_MODE_LATENCY_MAX))
+    {
+        return E_NOT_OK;
+    }
+
+    primask = Can_Hw_EnterCritical();
+    *LatencyPtr = Can_ModeLatency[Controller][ControllerMode];
+    Can_Hw_ExitCritical(primask);
+
+    return E_OK;
+}
+
+/**
+ * @brief     This function performs the polling of RX indications when CAN_RX_PROCESSING is CAN_RX_POLLING.
+ * @param     void
+ * @retval    void
+ */
+void Can_MainFunction_Read(void)
+{
+#if (CAN_RX_PROCESSING == CAN_RX_POLLING)
+    uint8 controller;
+    uint8 fifo;
+
+    for (controller = 0u; controller < CAN_CONTROLLER_MAX; controller++)
+    {
+        for (fifo = 0u; fifo < CAN_RX_FIFO_MAX; fifo++)
+        {
+            Can_RxDrainFifo(controller, fifo);
+        }
+    }
+#endif
+}
+
+/**
+ * @brief     Gives access to the oldest frame of the receive ring without copying it.
+ * @param     Controller: CAN controller the frame was received on.
+ * @param     FramePtr: Pointer to a memory location, where the address of the ring slot will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: A frame is available, it stays valid until Can_ReleaseRxFrame() is called.
+ *            E_NOT_OK: Wrong Controller, or no frame has been received.
+ */
+Std_ReturnType Can_GetRxFrame(uint8 Controller, const Can_RxFrameType** FramePtr)
+{
+    Can_RxRingType *ring;
+    uint8 tail;
+
+    if ((Controller >= CAN_CONTROLLER_MAX) || (FramePtr == NULL_PTR))
+    {
+        return E_NOT_OK; /* Invalid controller or pointer, return error */
+    }
+
+    ring = &Can_RxRing[Controller];
+    tail = ring->Tail;
+    if (tail == ring->Head)
+    {
+        return E_NOT_OK; /* Ring is empty */
+    }
+
+    /* Do not read the slot before Head, which publishes it, has been read */
+    __DMB();
+    *FramePtr = &ring->Slots[tail & CAN_RX_RING_MASK];
+
+    return E_OK;
+}
+
+/**
+ * @brief     Gives the oldest frame of the receive ring back to the driver.
+ * @param     Controller: CAN controller the frame was received on.
+ * @retval    void
+ */
+void Can_ReleaseRxFrame(uint8 Controller)
+{
+    Can_RxRingType *ring;
+
+    if (Controller >= CAN_CONTROLLER_MAX)
+    {
+        return; /* Invalid controller, do nothing */
+    }
+
+    ring = &Can_RxRing[Controller];
+    if (ring->Tail != ring->Head)
+    {
+        /* The consumer is done with the slot before the producer may reuse it */
+        __DMB();
+        ring->Tail = (uint8)(ring->Tail + 1u);
+    }
+}
+
+/**
+ * @brief     Returns the lost frame counters of a CAN controller.
+ * @param     Controller: CAN controller, whose counters shall be acquired.
+ * @param     OverrunPtr: Pointer to a memory location, where the counters will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Counters available.
+ *            E_NOT_OK: Wrong Controller, or invalid pointer.
+ */
+Std_ReturnType Can_GetRxOverrunCounters(uint8 Controller, Can_RxOverrunType *OverrunPtr)
+{
+    if ((Controller >= CAN_CONTROLLER_MAX) || (OverrunPtr == NULL_PTR))
+    {
+        return E_NOT_OK; /* Invalid controller or pointer, return error */
+    }
+
+    *OverrunPtr = Can_RxRing[Controller].Overrun;
+
+    return E_OK;
+}
+
+/**
+ * @brief     Runs a loop back self-test of a CAN controller and measures the driver's latency and throughput.
+ * @details   The controller is switched to ConfigPtr->Mode and taken out of initialization mode, without
+ *            changing its CAN_CS_STOPPED state. The latency phase sends ConfigPtr->Frames frames one at a time
+ *            and times each one from Can_Write() until it is back in the receive ring. The burst phase then
+ *            keeps the transmit queue full for another ConfigPtr->Frames frames and measures the sustained rate.
+ *            Frames use the CAN IDs of the receive dispatch table in turn, one frame per CAN ID at most is on
+ *            its way so that none replaces another. The controller is then taken back to initialization mode
+ *            and its operating mode is restored. Frames left in the receive ring are discarded, the traffic
+ *            shows up in Can_GetStatistics(). The call blocks for the whole test.
+ * @param     Controller: CAN controller to be tested, must be in CAN_CS_STOPPED with nothing left to send.
+ * @param     ConfigPtr: Test mode, frame length, number of frames and timeout.
+ * @param     ResultPtr: Pointer to a memory location, where the measurements will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Every frame came back intact.
+ *            E_NOT_OK: Wrong parameter or controller state, or frames were lost or corrupted.
+ */
+Std_ReturnType Can_SelfTest(uint8 Controller, const Can_SelfTestConfigType* ConfigPtr, Can_SelfTestResultType* ResultPtr)
+{
+    CAN_TypeDef *CANx = Can_Hw_GetController(Controller); /* Declare pointer for CAN controller */
+    Std_ReturnType status = E_NOT_OK;
+    const Can_RxFrameType *frame;
+    uint8 pending[CAN_RX_DISPATCH_COUNT];
+    uint8 sdu[8];
+    Can_PduType pdu;
+    uint64 latencySum = 0u;
+    uint64 start;
+    uint64 last;
+    uint64 now;
+    uint32 primask;
+    uint32 received;
+    uint32 count;
+    uint32 sent;
+    uint32 btr;
+    uint32 i;
+    uint16 next = 0u;
+
+    if ((CANx == NULL_PTR) || (ConfigPtr == NULL_PTR) || (ResultPtr == NULL_PTR) || (ConfigPtr->Length > 8u) ||
+        ((ConfigPtr->Mode & CAN_OPMODE_LOOPBACK) == 0u) || (ConfigPtr->Frames == 0u))
+    {
+        return E_NOT_OK; /* Invalid controller or parameter, return error */
+    }
+
+    /* Only a stopped controller with an empty transmit path may be borrowed, BTR is writable in INAK only */
+    if ((Can_Controller[Controller].State != CAN_CS_STOPPED) ||
+        (Can_Controller[Controller].Requested != CAN_CS_STOPPED) ||
+        (Can_Controller[Controller].BusOffPhase != CAN_BUSOFF_NONE) ||
+        ((CANx->MSR & CAN_MSR_INAK) == 0u) || ((CANx->TSR & CAN_TSR_TME) != CAN_TSR_TME) ||
+        (Can_TxQueue[Controller].Count != 0u))
+    {
+        return E_NOT_OK;
+    }
+
+    *ResultPtr = (Can_SelfTestResultType){0};
+    for (i = 0u; i < CAN_RX_DISPATCH_COUNT; i++)
+    {
+        pending[i] = FALSE;
+    }
+    while (Can_GetRxFrame(Controller, &frame) == E_OK)
+    {
+        Can_ReleaseRxFrame(Controller);
+    }
+
+    btr = CANx->BTR;
+    CANx->BTR = (btr & ~(CAN_BTR_LBKM | CAN_BTR_SILM)) | Can_Hw_GetModeBits(ConfigPtr->Mode);
+    Can_Controller[Controller].SelfTest = TRUE;
+    Can_Hw_WriteReg(&CANx->MCR, CANx->MCR & ~CAN_MCR_INRQ);
+
+    if (Can_Hw_WaitMsr(CANx, CAN_MSR_INAK, 0u) == E_OK)
+    {
+        /* Latency phase: a single frame on its way */
+        for (i = 0u; i < ConfigPtr->Frames; i++)
+        {
+            pdu.id = Can_RxDispatch[next].Hw.CanId;
+            pdu.swPduHandle = Can_RxDispatch[next].PduId;
+            pdu.length = ConfigPtr->Length;
+            pdu.sdu = sdu;
+            Can_SelfTestFill(sdu, ConfigPtr->Length, i);
+
+            start = Can_TimeNow();
+            if (Can_Write(Controller, &pdu) != E_OK)
+            {
+                break;
+            }
+            ResultPtr->Sent++;
+            pending[next] = TRUE;
+            next = (uint16)((next + 1u) % CAN_RX_DISPATCH_COUNT);
+
+            do
+            {
+                Can_Hw_Poll();
+                received = Can_SelfTestCollect(Controller, ConfigPtr->Length, pending, ResultPtr);
+                now = Can_TimeNow();
+            } while ((received == 0u) && ((now - start) < ConfigPtr->TimeoutCycles));
+
+            if (received == 0u)
+            {
+                break; /* Lost, the burst would only wait for it again */
+            }
+            if ((ResultPtr->LatencyMinCycles == 0u) || ((uint32)(now - start) < ResultPtr->LatencyMinCycles))
+            {
+                ResultPtr->LatencyMinCycles = (uint32)(now - start);
+            }
+            if ((uint32)(now - start) > ResultPtr->LatencyMaxCycles)
+            {
+                ResultPtr->LatencyMaxCycles = (uint32)(now - start);
+            }
+            latencySum += now - start;
+        }
+        if (ResultPtr->Received != 0u)
+        {
+            ResultPtr->LatencyAvgCycles = (uint32)(latencySum / ResultPtr->Received);
+        }
+
+        /* Burst phase: as many frames on their way as the queue and the receive ring take, skipped when the
+           latency phase already lost a frame */
+        sent = 0u;
+        received = (i == ConfigPtr->Frames) ? 0u : ConfigPtr->Frames;
+        start = Can_TimeNow();
+        last = start;
+        now = start;
+        while ((received < ConfigPtr->Frames) && ((now - last) < ConfigPtr->TimeoutCycles))
+        {
+            while ((sent < ConfigPtr->Frames) && ((sent - received) < CAN_RX_RING_SIZE) && (pending[next] == FALSE))
+            {
+                pdu.id = Can_RxDispatch[next].Hw.CanId;
+                pdu.swPduHandle = Can_RxDispatch[next].PduId;
+                Can_SelfTestFill(sdu, ConfigPtr->Length, sent);
+                if (Can_Write(Controller, &pdu) != E_OK)
+                {
+                    break; /* Transmit queue full */
+                }
+                ResultPtr->Sent++;
+                sent++;
+                pending[next] = TRUE;
+                next = (uint16)((next + 1u) % CAN_RX_DISPATCH_COUNT);
+            }
+
+            Can_Hw_Poll();
+            count = Can_SelfTestCollect(Controller, ConfigPtr->Length, pending, ResultPtr);
+            now = Can_TimeNow();
+            if (count != 0u)
+            {
+                received += count;
+                last = now;
+            }
+        }
+        ResultPtr->BurstCycles = (uint32)(last - start);
+        if (ResultPtr->BurstCycles != 0u)
+        {
+            ResultPtr->FramesPerSecond = (uint32)(((uint64)received * CAN_CPU_CLOCK_HZ) / ResultPtr->BurstCycles);
+        }
+
+        if ((ResultPtr->Received == (2u * (uint32)ConfigPtr->Frames)) && (ResultPtr->Corrupted == 0u))
+        {
+            status = E_OK;
+        }
+    }
+
+    /* Back to initialization mode, frames that never came back are aborted and dropped */
+    Can_Hw_WriteReg(&CANx->MCR, CANx->MCR | CAN_MCR_INRQ);
+    if (Can_Hw_WaitMsr(CANx, CAN_MSR_INAK, CAN_MSR_INAK) != E_OK)
+    {
+        status = E_NOT_OK;
     }
+    primask = Can_Hw_EnterCritical();
+    Can_Hw_WriteReg(&CANx->TSR, CAN_TSR_ABRQ_MB(0u) | CAN_TSR_ABRQ_MB(1u) | CAN_TSR_ABRQ_MB(2u));
+    Can_TxProcessCompleted(Controller);
+    Can_TxQueue[Controller].Count = 0u;
+    Can_Hw_ExitCritical(primask);
+    CANx->BTR = btr;
+
+    while (Can_GetRxFrame(Controller, &frame) == E_OK)
+    {
+        Can_ReleaseRxFrame(Controller);
+    }
+    Can_Controller[Controller].SelfTest = FALSE;
+
+    return status;
+}
+
+/*
+ ************************************************************************************************************
+ * Interrupt handlers
+ ************************************************************************************************************
+ */
+/**
+ * @brief     CAN1 transmit interrupt, raised when a mailbox request completes (TME)
+ * @param     void
+ * @retval    void
+ */
+void CAN1_TX_IRQHandler(void)
+{
+    Can_TxIsr(CAN_CONTROLLER_0);
+}
+
+/**
+ * @brief     CAN1 FIFO 0 interrupt, raised when a message is pending (FMP0) or lost (FOV0)
+ * @param     void
+ * @retval    void
+ */
+void CAN1_RX0_IRQHandler(void)
+{
+    Can_RxIsr(CAN_CONTROLLER_0, 0u);
+}
+
+/**
+ * @brief     CAN1 FIFO 1 interrupt, raised when a message is pending (FMP1) or lost (FOV1)
+ * @param     void
+ * @retval    void
+ */
+void CAN1_RX1_IRQHandler(void)
+{
+    Can_RxIsr(CAN_CONTROLLER_0, 1u);
+}
+
+/**
+ * @brief       CAN1 status change interrupt: sleep acknowledge and wakeup
+ * @param       void
+ * @return      void
+ */
+void CAN1_SCE_IRQHandler(void)
+{
+    Can_SceIsr(CAN_CONTROLLER_0);
+}
 
-    /* Check for free mailbox */
-    if ((CAN1->TSR & CAN_TSR_TME0) == 0) 
-    {  
-        // Check if Mailbox 0 is free
-        return E_NOT_OK;  
-    }
-
-    /* Configure the Mailbox with the message data */
-   // Clear all previous settings in TIR
-    CAN1->sTxMailBox[0].TIR = 0;
-        
-    // Set the standard identifier
-    CAN1->sTxMailBox[0].TIR |= (PduInfo->id & 0x7FF) << 21;
-        
-    // Clear the IDE bit to ensure Standard ID is used
-    CAN1->sTxMailBox[0].TIR &= ~CAN_TI0R_IDE; // IDE = 0 (Standard ID)
-            
-    // Configure data length
-    CAN1->sTxMailBox[0].TDTR = 0; // Clear TDTR
-    CAN1->sTxMailBox[0].TDTR |= (PduInfo->length & 0x0F); // Set length (0-8 bytes)
-
-	CAN1->sTxMailBox[0].TDLR=
-				((uint32_t)PduInfo->sdu[3] << CAN_TDL0R_DATA3_Pos) |
-				((uint32_t)PduInfo->sdu[2] << CAN_TDL0R_DATA2_Pos) |
-				((uint32_t)PduInfo->sdu[1] << CAN_TDL0R_DATA1_Pos) |
-				((uint32_t)PduInfo->sdu[0] << CAN_TDL0R_DATA0_Pos);
-
-	CAN1->sTxMailBox[0].TDHR=
-				((uint32_t)PduInfo->sdu[7] << CAN_TDH0R_DATA7_Pos) |
-				((uint32_t)PduInfo->sdu[6] << CAN_TDH0R_DATA6_Pos) |
-				((uint32_t)PduInfo->sdu[5] << CAN_TDH0R_DATA5_Pos) |
-				((uint32_t)PduInfo->sdu[4] << CAN_TDH0R_DATA4_Pos);
-	
-	// Set the TXRQ bit to request transmission
-    CAN1->sTxMailBox[0].TIR |= CAN_TI0R_TXRQ;
-
-    return E_OK;  
+#if defined(CAN_HOST_SIM)
+/**
+ * @brief       Interrupt entry of the host simulator, which stands in for the NVIC of every simulated node
+ * @param       Controller: CAN controller index of the node
+ * @param       Line: CAN_SIM_IRQ_TX, CAN_SIM_IRQ_RX0, CAN_SIM_IRQ_RX1 or CAN_SIM_IRQ_SCE
+ * @return      void
+ */
+void Can_Sim_Isr(uint8 Controller, uint8 Line)
+{
+    switch (Line)
+    {
+        case CAN_SIM_IRQ_TX:
+            Can_TxIsr(Controller);
+            break;
+        case CAN_SIM_IRQ_RX0:
+            Can_RxIsr(Controller, 0u);
+            break;
+        case CAN_SIM_IRQ_RX1:
+            Can_RxIsr(Controller, 1u);
+            break;
+        case CAN_SIM_IRQ_SCE:
+            Can_SceIsr(Controller);
+            break;
+        default:
+            break;
+    }
 }
+#endif
@@ -20,8 +20,12 @@
 #include "Std_Types.h"
 #include "ComStack_Types.h"
 #include "Can_GeneralTypes.h"
+#if defined(CAN_HOST_SIM)
+#include "Can_Sim.h"
+#else
 #include "stm32l476xx.h"
 #include "stm32l4xx_hal.h"
+#endif
 
 /*
  ************************************************************************************************************
@@ -29,8 +33,52 @@
  ************************************************************************************************************
  */
 #define CAN_AF ((uint8_t)0x09)
+#define CAN_FILTER_BANK_MAX         14u     /* Filter banks of CAN1 on STM32L476 */
 #define CAN_SJW_1TQ                 (0x00000000U) 
 
+/**
+ * @brief       Operating modes of Can_ConfigType.CAN_Mode and Can_SelfTestConfigType.Mode
+ * @details     The value is the pair SILM:LBKM of BTR. In loop back mode the controller receives its own frames
+ *              and ignores the missing acknowledge, in silent mode it only listens to the bus. Silent loop back
+ *              keeps TX recessive, so it can run with other nodes active on the bus.
+ */
+#define CAN_OPMODE_NORMAL           0u      /* Normal operation on the bus */
+#define CAN_OPMODE_LOOPBACK         1u      /* LBKM: frames are sent on the bus and received back internally */
+#define CAN_OPMODE_SILENT           2u      /* SILM: bus monitoring, no acknowledge and no error frames sent */
+#define CAN_OPMODE_SILENT_LOOPBACK  3u      /* LBKM + SILM: internal loop, disconnected from the bus */
+
+/**
+ * @brief       Bit timing calculator
+ * @details     Derives the BTR value of a baud rate from the CAN kernel clock and a sample point in per mille,
+ *              as constant expressions so that the baud rate table is computed by the compiler. The largest
+ *              number of time quanta (8..25) is chosen for which the prescaler divides the clock exactly and
+ *              BS1 (1..16 tq), BS2 (1..8 tq) place the sample point as close as possible to the target.
+ *              SJW is set to min(4, BS2). CAN_BT_TQ() is 0 when no valid setting exists.
+ */
+#define CAN_BT_BS1(tq, sp)          ((((tq) * (sp)) + 500u) / 1000u - 1u)
+#define CAN_BT_BS2(tq, sp)          ((tq) - 1u - CAN_BT_BS1(tq, sp))
+#define CAN_BT_SJW(tq, sp)          ((CAN_BT_BS2(tq, sp) < 4u) ? CAN_BT_BS2(tq, sp) : 4u)
+#define CAN_BT_VALID(clk, baud, sp, tq) \
+            ((((clk) % ((baud) * (tq))) == 0u) && (((clk) / ((baud) * (tq))) <= 1024u) && \
+             (CAN_BT_BS1(tq, sp) >= 1u) && (CAN_BT_BS1(tq, sp) <= 16u) && \
+             (CAN_BT_BS2(tq, sp) >= 1u) && (CAN_BT_BS2(tq, sp) <= 8u))
+#define CAN_BT_TQ(clk, baud, sp) \
+            (CAN_BT_VALID(clk, baud, sp, 25u) ? 25u : CAN_BT_VALID(clk, baud, sp, 24u) ? 24u : \
+             CAN_BT_VALID(clk, baud, sp, 23u) ? 23u : CAN_BT_VALID(clk, baud, sp, 22u) ? 22u : \
+             CAN_BT_VALID(clk, baud, sp, 21u) ? 21u : CAN_BT_VALID(clk, baud, sp, 20u) ? 20u : \
+             CAN_BT_VALID(clk, baud, sp, 19u) ? 19u : CAN_BT_VALID(clk, baud, sp, 18u) ? 18u : \
+             CAN_BT_VALID(clk, baud, sp, 17u) ? 17u : CAN_BT_VALID(clk, baud, sp, 16u) ? 16u : \
+             CAN_BT_VALID(clk, baud, sp, 15u) ? 15u : CAN_BT_VALID(clk, baud, sp, 14u) ? 14u : \
+             CAN_BT_VALID(clk, baud, sp, 13u) ? 13u : CAN_BT_VALID(clk, baud, sp, 12u) ? 12u : \
+             CAN_BT_VALID(clk, baud, sp, 11u) ? 11u : CAN_BT_VALID(clk, baud, sp, 10u) ? 10u : \
+             CAN_BT_VALID(clk, baud, sp, 9u) ? 9u : CAN_BT_VALID(clk, baud, sp, 8u) ? 8u : 0u)
+#define CAN_BT_BTR_TQ(clk, baud, sp, tq) \
+            (((((clk) / ((baud) * (tq))) - 1u) << CAN_BTR_BRP_Pos) | \
+             ((CAN_BT_BS1(tq, sp) - 1u) << CAN_BTR_TS1_Pos) | \
+             ((CAN_BT_BS2(tq, sp) - 1u) << CAN_BTR_TS2_Pos) | \
+             ((CAN_BT_SJW(tq, sp) - 1u) << CAN_BTR_SJW_Pos))
+#define CAN_BT_BTR(clk, baud, sp)   CAN_BT_BTR_TQ(clk, baud, sp, CAN_BT_TQ(clk, baud, sp))
+
 /** @defgroup CAN_interrupts CAN Interrupts
   * @{
   */
@@ -67,15 +115,15 @@ typedef struct
     uint16 CAN_Prescaler;                   /* Specifies the length of a time quantum.
                                             It ranges from 1 to 1024. */
     uint8 CAN_Mode;                         /* Specifies the CAN operating mode.
-                                            This parameter can be a value of CAN_operating_mode. */
+                                            This parameter can be a value of CAN_OPMODE_xxx. */
     uint8 CAN_SJW;                          /* Specifies the maximum number of time quanta 
                                             the CAN hardware is allowed to lengthen or 
                                             shorten a bit to perform resynchronization.
-                                            This parameter can be a value of CAN_synchronisation_jump_width. */
+                                            It ranges from 1 to 4. */
     uint8 CAN_BS1;                          /* Specifies the number of time quanta in Bit Segment 1.
-                                            This parameter can be a value of CAN_time_quantum_in_bit_segment_1. */
+                                            It ranges from 1 to 16. */
     uint8 CAN_BS2;                          /* Specifies the number of time quanta in Bit Segment 2.
-                                            This parameter can be a value of CAN_time_quantum_in_bit_segment_2. */
+                                            It ranges from 1 to 8. */
     
     FunctionalState CAN_TTCM;               /* Enable or disable the time-triggered communication mode.
                                             This parameter can be set either to ENABLE or DISABLE. */
@@ -89,8 +137,173 @@ typedef struct
                                             This parameter can be set either to ENABLE or DISABLE. */
     FunctionalState CAN_TXFP;               /* Enable or disable the transmit FIFO priority.
                                             This parameter can be set either to ENABLE or DISABLE. */
+    void (*ControllerModeIndication)(uint8 Controller, Can_ControllerStateType ControllerMode);
+                                            /* Called once a requested mode transition has completed,
+                                            from Can_MainFunction_Mode() or the SCE interrupt. May be NULL_PTR. */
+    void (*ControllerBusOff)(uint8 Controller);
+                                            /* Called from the SCE interrupt when the controller goes bus-off.
+                                            The recovery is driven by Can_MainFunction_BusOff(). May be NULL_PTR. */
+    void (*CancelTxConfirmation)(PduIdType TxPduId);
+                                            /* Called when a pending L-PDU is dropped because Can_Write() got a
+                                            newer one with the same CAN ID. Runs from the TX interrupt or from
+                                            Can_Write() with interrupts masked. May be NULL_PTR. */
+    uint8 (*RxGateway)(const Can_PduType* PduInfo, uint32 PopCycles);
+                                            /* Called from the receive drain with each configured L-PDU before
+                                            it is put into the receive ring, also when the ring is full,
+                                            PopCycles being the DWT cycle count when it was taken out of the
+                                            FIFO. Returns TRUE when it consumed the L-PDU, which is then not
+                                            queued. Not called while Can_SelfTest() runs. May be NULL_PTR. */
 } Can_ConfigType;
 
+/**
+ * @typedef     Can_BaudRateConfigType
+ * @brief       Baud rate configuration selectable through Can_SetBaudrate()
+ */
+typedef struct
+{
+    uint16 BaudRateConfigID;                /* ID passed to Can_SetBaudrate() */
+    uint32 BaudRate;                        /* Baud rate in bit/s */
+    uint16 SamplePoint;                     /* Target sample point in per mille */
+    uint32 BTR;                             /* Bit timing register value (BRP, TS1, TS2, SJW) */
+} Can_BaudRateConfigType;
+
+/**
+ * @typedef     Can_FilterImageType
+ * @brief       Register image of the acceptance filter banks. It is generated by Can_FilterGen.py from the list
+ *              of received CAN IDs and written by Can_Init() in one pass.
+ */
+typedef struct
+{
+    uint32 FM1R;                            /* Filter mode: bit n set for identifier-list bank n */
+    uint32 FS1R;                            /* Filter scale: bit n set for 32-bit bank n */
+    uint32 FFA1R;                           /* FIFO assignment: bit n set for bank n assigned to FIFO1 */
+    uint32 FA1R;                            /* Filter activation: bit n set for active bank n */
+    uint8 BankCount;                        /* Number of banks in FR, starting with bank 0 */
+    uint32 FR[CAN_FILTER_BANK_MAX][2];      /* FR1/FR2 of each bank */
+} Can_FilterImageType;
+
+/**
+ * @typedef     Can_RxDispatchType
+ * @brief       Entry of the receive dispatch table generated by Can_FilterGen.py, which maps a received CAN ID
+ *              to the HRH (Hw.Hoh) and the PDU handle it is indicated with. Entries are sorted by Hw.CanId.
+ */
+typedef struct
+{
+    Can_HwType Hw;                          /* CAN ID, HRH and controller of the received L-PDU */
+    PduIdType PduId;                        /* PDU handle reported with the L-PDU */
+} Can_RxDispatchType;
+
+#define CAN_RX_FMI_SEARCH           0xFFFFu /* FMI without direct dispatch entry, the CAN ID is searched */
+
+/**
+ * @typedef     Can_RxFrameType
+ * @brief       Slot of the receive ring. Pdu.sdu points to Data of the same slot, so the consumer reads the
+ *              frame in place until it calls Can_ReleaseRxFrame().
+ */
+typedef struct
+{
+    Can_PduType Pdu;                        /* Received L-PDU, swPduHandle is taken from the dispatch table */
+    uint8 Data[8];                          /* Storage of the SDU */
+    Can_HwHandleType Hrh;                   /* Hardware receive handle of the L-PDU */
+    uint8 Fifo;                             /* Receive FIFO the frame was read from (0 or 1) */
+    uint8 Fmi;                              /* Filter match index reported by the hardware */
+    uint64 TimeStamp;                       /* Start of frame in CPU cycles since Can_Init(), 0 without
+                                            CAN_TIMESTAMP, see Can_GetIngressTimeStamp() */
+} Can_RxFrameType;
+
+/**
+ * @typedef     Can_RxOverrunType
+ * @brief       Lost frame counters of a controller, used to size the receive ring from real traffic.
+ */
+typedef struct
+{
+    uint32 FifoOverrun[2];                  /* Frames lost because FIFO0/FIFO1 was full (FOV0/FOV1) */
+    uint32 RingOverflow;                    /* Frames dropped because the receive ring was full */
+    uint32 Unwanted;                        /* Frames passed by a superset filter but not configured, dropped */
+} Can_RxOverrunType;
+
+/**
+ * @typedef     Can_ModeLatencyType
+ * @brief       Duration of the transitions into one controller state, in CPU cycles counted by DWT CYCCNT from
+ *              the Can_SetControllerMode() request to the detected acknowledge.
+ */
+typedef struct
+{
+    uint32 LastCycles;                      /* Duration of the last completed transition */
+    uint32 MaxCycles;                       /* Longest completed transition */
+    uint32 Count;                           /* Number of completed transitions */
+    uint32 Timeouts;                        /* Transitions given up after CAN_MAINFUNCTION_MODE_TIMEOUT calls */
+} Can_ModeLatencyType;
+
+/**
+ * @typedef     Can_BusOffRecoveryType
+ * @brief       Duration of the bus-off recoveries of a controller, in CPU cycles from the bus-off interrupt to
+ *              the controller being back on the bus, backoff delay included.
+ */
+typedef struct
+{
+    uint32 LastCycles;                      /* Duration of the last recovery */
+    uint32 MaxCycles;                       /* Longest recovery */
+    uint32 Count;                           /* Number of completed recoveries */
+    uint8 Consecutive;                      /* Bus-off events since the bus was last stable, sets the backoff */
+} Can_BusOffRecoveryType;
+
+#define CAN_ERROR_TYPE_MAX          12u     /* Can_ErrorType values are below this bound */
+
+#define CAN_ID_REMOTE               0x20000000u     /* Driver specific Can_IdType flag of a remote frame, its
+                                                       length is sent as DLC but no data */
+#define CAN_ID_STD_MASK             0x000007FFu     /* Identifier bits of a standard Can_IdType */
+#define CAN_ID_EXT_MASK             0x1FFFFFFFu     /* Identifier bits of an extended Can_IdType */
+
+/**
+ * @typedef     Can_StatisticsType
+ * @brief       Traffic and error counters of a controller. Each counter has a single writer (TX interrupt, RX
+ *              drain or SCE interrupt) and is read without locking, so they only ever count up and wrap around:
+ *              take differences between two snapshots instead of resetting them.
+ */
+typedef struct
+{
+    uint32 TxFrames;                        /* Frames sent successfully (TXOK) */
+    uint32 RxFrames;                        /* Frames taken out of the receive FIFOs, wanted or not */
+    uint32 TxBits;                          /* Worst case stuffed length of the sent frames, in bits */
+    uint32 RxBits;                          /* Worst case stuffed length of the received frames, in bits */
+    uint32 ArbitrationLost;                 /* Transmissions completed with ALST, i.e. having lost arbitration */
+    uint32 TxCancelled;                     /* Pending L-PDUs replaced by a newer one with the same CAN ID */
+    uint32 Errors[CAN_ERROR_TYPE_MAX];      /* Last error codes (LEC) seen on the bus, indexed by Can_ErrorType */
+    uint32 FifoOverrun[2];                  /* Frames lost because FIFO0/FIFO1 was full */
+    uint32 BusOff;                          /* Transitions to bus-off */
+} Can_StatisticsType;
+
+/**
+ * @typedef     Can_SelfTestConfigType
+ * @brief       Parameters of Can_SelfTest(). The frames cycle through the CAN IDs of the receive dispatch table,
+ *              so that each one passes the acceptance filters and reaches the receive ring.
+ */
+typedef struct
+{
+    uint8 Mode;                             /* CAN_OPMODE_LOOPBACK or CAN_OPMODE_SILENT_LOOPBACK */
+    uint8 Length;                           /* Data length of the test frames (0-8 bytes) */
+    uint16 Frames;                          /* Frames sent in each of the latency and the burst phase */
+    uint32 TimeoutCycles;                   /* Longest wait for the next frame to come back, in CPU cycles */
+} Can_SelfTestConfigType;
+
+/**
+ * @typedef     Can_SelfTestResultType
+ * @brief       Outcome of Can_SelfTest(). Latencies are taken from the Can_Write() call to the frame being
+ *              available through Can_GetRxFrame(), so they include the whole TX and RX path of the driver.
+ */
+typedef struct
+{
+    uint32 Sent;                            /* Frames accepted by Can_Write() in both phases */
+    uint32 Received;                        /* Frames taken back out of the receive ring in both phases */
+    uint32 Corrupted;                       /* Received frames whose length or data differ from what was sent */
+    uint32 LatencyMinCycles;                /* Shortest round trip of the latency phase */
+    uint32 LatencyMaxCycles;                /* Longest round trip of the latency phase */
+    uint32 LatencyAvgCycles;                /* Mean round trip of the latency phase */
+    uint32 BurstCycles;                     /* Duration of the burst phase */
+    uint32 FramesPerSecond;                 /* Frames received per second during the burst phase */
+} Can_SelfTestResultType;
+
 /*
  ************************************************************************************************************
  * Inline functions
@@ -126,13 +339,13 @@ void Spi_GetVersionInfo(Std_VersionInfoType* VersionInfo);
 void Can_DeInit(void);
 
 /**
- * @brief       This service shall set the baud rate configuration of the CAN controller. Depending on
- *              necessary baud rate modifications the controller might have to reset.
+ * @brief       This service shall set the baud rate configuration of the CAN controller. The controller must be
+ *              in CAN_CS_STOPPED, where BTR is writable without waiting for any acknowledge.
  * @param       Controller: CAN controller, whose baud rate shall be set
- * @param       BaudRateConfigID: references a baud rate configuration by ID (see CanController BaudRateConfig
+ * @param       BaudRateConfigID: references a baud rate configuration by ID (see Can_BaudRateConfigs in Can_Cfg.h)
  * @retval      Std_ReturnType: 
- *              E_OK: Service request accepted, setting of (new) baud rate started
- *              E_NOT_OK: Service request not accepted
+ *              E_OK: Service request accepted, the new baud rate is set
+ *              E_NOT_OK: Service request not accepted, unknown ID or the controller is not in CAN_CS_STOPPED
  */
 Std_ReturnType Can_SetBaudrate(uint8 Controller, uint16 BaudRateConfigID);
 
@@ -216,7 +429,139 @@ Std_ReturnType Can_GetControllerTxErrorCounter(uint8 ControllerId, uint8 *TxErro
  * @retval    Std_ReturnType: 
  *            E_OK: Write command has been accepted
  *            E_NOT_OK: development error occurred
+ *            CAN_BUSY: No transmit mailbox was available
 */
 Std_ReturnType Can_Write(Can_HwHandleType Hth, const Can_PduType* PduInfo);
 
+/**
+ * @brief     Returns the current time of the time base used by the CAN time stamps.
+ * @param     ControllerId: CAN controller, whose time shall be acquired.
+ * @param     timeStampPtr: Pointer to a memory location, where the current time will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Current time available.
+ *            E_NOT_OK: Wrong ControllerId, invalid pointer, or time stamps disabled.
+ */
+Std_ReturnType Can_GetCurrentTime(uint8 ControllerId, Can_TimeStampType* timeStampPtr);
+
+/**
+ * @brief     Returns the time at which the last confirmed transmission of an L-PDU started on the bus.
+ * @param     TxPduId: L-PDU handle given to Can_Write().
+ * @param     Hth: Hardware transmit handle the L-PDU was sent on.
+ * @param     timeStampPtr: Pointer to a memory location, where the time stamp will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Time stamp available.
+ *            E_NOT_OK: The L-PDU was not among the last transmissions of each mailbox, or invalid parameter.
+ */
+Std_ReturnType Can_GetEgressTimeStamp(PduIdType TxPduId, Can_HwHandleType Hth, Can_TimeStampType* timeStampPtr);
+
+/**
+ * @brief     Returns the start of frame time of the received L-PDU currently held through Can_GetRxFrame().
+ * @param     Hrh: Hardware receive handle the L-PDU was received on.
+ * @param     timeStampPtr: Pointer to a memory location, where the time stamp will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Time stamp available.
+ *            E_NOT_OK: No frame of this HRH is held, or invalid parameter.
+ */
+Std_ReturnType Can_GetIngressTimeStamp(Can_HwHandleType Hrh, Can_TimeStampType* timeStampPtr);
+
+/**
+ * @brief     Returns the traffic and error counters of a CAN controller.
+ * @param     Controller: CAN controller, whose counters shall be acquired.
+ * @param     StatisticsPtr: Pointer to a memory location, where the counters will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Counters available.
+ *            E_NOT_OK: Wrong Controller, or invalid pointer.
+ */
+Std_ReturnType Can_GetStatistics(uint8 Controller, Can_StatisticsType *StatisticsPtr);
+
+/**
+ * @brief     Returns the bus load of a CAN controller since the previous call.
+ * @param     Controller: CAN controller, whose bus load shall be acquired.
+ * @param     LoadPtr: Pointer to a memory location, where the bus load in per mille will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Bus load available.
+ *            E_NOT_OK: Wrong Controller, or invalid pointer.
+ */
+Std_ReturnType Can_GetBusLoad(uint8 Controller, uint16 *LoadPtr);
+
+/**
+ * @brief     This function performs the polling of bus-off events and drives the bus-off recovery.
+ * @param     void
+ * @retval    void
+ */
+void Can_MainFunction_BusOff(void);
+
+/**
+ * @brief     Returns the duration of the bus-off recoveries of a CAN controller.
+ * @param     Controller: CAN controller, whose recovery times shall be acquired.
+ * @param     RecoveryPtr: Pointer to a memory location, where the recovery times will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Recovery times available.
+ *            E_NOT_OK: Wrong Controller, or invalid pointer.
+ */
+Std_ReturnType Can_GetBusOffRecovery(uint8 Controller, Can_BusOffRecoveryType *RecoveryPtr);
+
+/**
+ * @brief     This function performs the polling of CAN controller mode transitions.
+ * @param     void
+ * @retval    void
+ */
+void Can_MainFunction_Mode(void);
+
+/**
+ * @brief     Returns the latency of the transitions into a CAN controller state.
+ * @param     Controller: CAN controller, whose latency shall be acquired.
+ * @param     ControllerMode: Target state of the transitions (CAN_CS_STARTED, CAN_CS_STOPPED or CAN_CS_SLEEP).
+ * @param     LatencyPtr: Pointer to a memory location, where the latency will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Latency available.
+ *            E_NOT_OK: Wrong Controller or ControllerMode, or invalid pointer.
+ */
+Std_ReturnType Can_GetModeLatency(uint8 Controller, Can_ControllerStateType ControllerMode, Can_ModeLatencyType *LatencyPtr);
+
+/**
+ * @brief     This function performs the polling of RX indications when CAN_RX_PROCESSING is CAN_RX_POLLING.
+ * @param     void
+ * @retval    void
+ */
+void Can_MainFunction_Read(void);
+
+/**
+ * @brief     Gives access to the oldest frame of the receive ring without copying it.
+ * @param     Controller: CAN controller the frame was received on.
+ * @param     FramePtr: Pointer to a memory location, where the address of the ring slot will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: A frame is available, it stays valid until Can_ReleaseRxFrame() is called.
+ *            E_NOT_OK: Wrong Controller, or no frame has been received.
+ */
+Std_ReturnType Can_GetRxFrame(uint8 Controller, const Can_RxFrameType** FramePtr);
+
+/**
+ * @brief     Gives the oldest frame of the receive ring back to the driver.
+ * @param     Controller: CAN controller the frame was received on.
+ * @retval    void
+ */
+void Can_ReleaseRxFrame(uint8 Controller);
+
+/**
+ * @brief     Returns the lost frame counters of a CAN controller.
+ * @param     Controller: CAN controller, whose counters shall be acquired.
+ * @param     OverrunPtr: Pointer to a memory location, where the counters will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Counters available.
+ *            E_NOT_OK: Wrong Controller, or invalid pointer.
+ */
+Std_ReturnType Can_GetRxOverrunCounters(uint8 Controller, Can_RxOverrunType *OverrunPtr);
+
+/**
+ * @brief     Runs a loop back self-test of a CAN controller and measures the driver's latency and throughput.
+ * @param     Controller: CAN controller to be tested, must be in CAN_CS_STOPPED with nothing left to send.
+ * @param     ConfigPtr: Test mode, frame length, number of frames and timeout.
+ * @param     ResultPtr: Pointer to a memory location, where the measurements will be stored.
+ * @retval    Std_ReturnType: 
+ *            E_OK: Every frame came back intact.
+ *            E_NOT_OK: Wrong parameter or controller state, or frames were lost or corrupted.
+ */
+Std_ReturnType Can_SelfTest(uint8 Controller, const Can_SelfTestConfigType* ConfigPtr, Can_SelfTestResultType* ResultPtr);
+
 #endif /* CAN_H */
\ No newline at end of file
@@ -0,0 +1,146 @@
+/**
+ * @file        Can_Cfg.h
+ * @author      Phuc
+ * @brief       Configuration of CAN
+ * @version     1.0
+ * @date        2025-01-12
+ * 
+ * @copyright   Copyright (c) 2025
+ * 
+ */
+
+#ifndef CAN_CFG_H
+#define CAN_CFG_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Can.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Definition of CAN controllers
+ * @details     Controller n owns the hardware transmit handle (HTH) n.
+ */
+#if defined(CAN_HOST_SIM)
+#define CAN_CONTROLLER_MAX      CAN_SIM_NODE_MAX    /* One controller per simulated node, see Can_Sim.h */
+#else
+#define CAN_CONTROLLER_MAX      1u      /* Only CAN1 is available on STM32L476 */
+#endif
+#define CAN_CONTROLLER_0        0u      /* CAN1 on PB8 (RX) / PB9 (TX) */
+
+/**
+ * @brief       CAN kernel clock
+ * @details     bxCAN runs from PCLK1. SYSCLK 80 MHz with APB1 prescaler 1.
+ */
+#define CAN_APB1_CLOCK_HZ       80000000u
+
+/**
+ * @brief       CPU clock
+ * @details     Clock of the DWT cycle counter, the time base of the CAN time stamps. Must be an integer multiple
+ *              of CAN_APB1_CLOCK_HZ, both come from HCLK so they never drift apart.
+ */
+#define CAN_CPU_CLOCK_HZ        80000000u
+
+#if defined(CAN_HOST_SIM)
+/* The simulator derives the bit time from BTR with its own copy of the clock ratio */
+typedef char Can_SimClockCheck[((CAN_CPU_CLOCK_HZ / CAN_APB1_CLOCK_HZ) == CAN_SIM_CYCLES_PER_CLOCK) ? 1 : -1];
+#endif
+
+/**
+ * @brief       Mode change timeout
+ * @details     Number of MSR polls before a requested INAK/SLAK acknowledge is given up. Entering or leaving
+ *              initialization mode takes up to 11 recessive bits, i.e. 1.1 ms at 10 kbit/s.
+ */
+#define CAN_MODE_TIMEOUT        100000u
+
+/**
+ * @brief       Receive FIFO release timeout
+ * @details     Number of RFxR polls the receive interrupt waits for RFOM to clear after releasing an output
+ *              mailbox, which takes the hardware a few APB1 cycles.
+ */
+#define CAN_RX_RELEASE_TIMEOUT  16u
+
+/**
+ * @brief       Mode transition timeout
+ * @details     Number of Can_MainFunction_Mode() calls a requested transition may stay unacknowledged before it
+ *              is given up and counted as a timeout, e.g. 10 calls of a 10 ms task.
+ */
+#define CAN_MAINFUNCTION_MODE_TIMEOUT   10u
+
+/**
+ * @brief       Bus-off recovery
+ * @details     After a bus-off the controller waits CAN_BUSOFF_DELAY_MIN Can_MainFunction_BusOff() calls before
+ *              it toggles INRQ and the hardware starts counting the 128 x 11 recessive bits. The delay doubles
+ *              with every further bus-off, up to CAN_BUSOFF_DELAY_MAX, and starts again at the minimum once the
+ *              controller has stayed on the bus for CAN_BUSOFF_STABLE calls. With CAN_ABOM the hardware
+ *              recovers on its own and the delay does not apply.
+ */
+#define CAN_BUSOFF_DELAY_MIN    1u
+#define CAN_BUSOFF_DELAY_MAX    64u
+#define CAN_BUSOFF_STABLE       100u
+
+/**
+ * @brief       Baud rate configurations
+ * @details     BTR values are computed by the compiler from CAN_APB1_CLOCK_HZ, a configuration that has no
+ *              exact bit timing at this clock fails the build through CAN_BAUDRATE_CHECK.
+ */
+#define CAN_BAUDRATE_CONFIG(id, baud, sp)   {(id), (baud), (sp), CAN_BT_BTR(CAN_APB1_CLOCK_HZ, (baud), (sp))}
+#define CAN_BAUDRATE_CHECK(id, baud, sp)    typedef char Can_BaudRateCheck_##id[(CAN_BT_TQ(CAN_APB1_CLOCK_HZ, (baud), (sp)) != 0u) ? 1 : -1]
+
+CAN_BAUDRATE_CHECK(125, 125000u, 875u);
+CAN_BAUDRATE_CHECK(250, 250000u, 875u);
+CAN_BAUDRATE_CHECK(500, 500000u, 875u);
+CAN_BAUDRATE_CHECK(800, 800000u, 800u);
+CAN_BAUDRATE_CHECK(1000, 1000000u, 750u);
+
+const Can_BaudRateConfigType Can_BaudRateConfigs[] = 
+{
+    CAN_BAUDRATE_CONFIG(125u, 125000u, 875u),       /* 125 kbps, sample point 87.5 % */
+    CAN_BAUDRATE_CONFIG(250u, 250000u, 875u),       /* 250 kbps, sample point 87.5 % */
+    CAN_BAUDRATE_CONFIG(500u, 500000u, 875u),       /* 500 kbps, sample point 87.5 % */
+    CAN_BAUDRATE_CONFIG(800u, 800000u, 800u),       /* 800 kbps, sample point 80 % */
+    CAN_BAUDRATE_CONFIG(1000u, 1000000u, 750u)      /* 1 Mbps, sample point 75 % */
+};
+
+#define CAN_BAUDRATE_CONFIG_MAX (sizeof(Can_BaudRateConfigs) / sizeof(Can_BaudRateConfigs[0]))
+
+/**
+ * @brief       Software transmit queue
+ * @details     Number of L-PDUs buffered per HTH behind the three hardware mailboxes (1..255).
+ */
+#define CAN_TX_QUEUE_SIZE       16u
+
+/**
+ * @brief       Receive processing
+ * @details     CAN_RX_INTERRUPT drains FIFO0/FIFO1 from the FMP interrupts, CAN_RX_POLLING drains them from
+ *              Can_MainFunction_Read(). Only one of them fills the receive ring.
+ */
+#define CAN_RX_INTERRUPT        0u
+#define CAN_RX_POLLING          1u
+#define CAN_RX_PROCESSING       CAN_RX_INTERRUPT
+
+/**
+ * @brief       Hardware time stamps
+ * @details     CAN_TIMESTAMP_ON forces TTCM so that the start of frame of every sent and received frame is
+ *              captured in TDTR/RDTR TIME and extended to a 64-bit time, CAN_TIMESTAMP_OFF leaves TTCM to
+ *              Can_ConfigType and removes the capture from the interrupts.
+ */
+#define CAN_TIMESTAMP_OFF       0u
+#define CAN_TIMESTAMP_ON        1u
+#define CAN_TIMESTAMP           CAN_TIMESTAMP_ON
+
+/**
+ * @brief       Receive ring
+ * @details     Number of received L-PDUs buffered per controller until the consumer releases them.
+ *              Must be a power of two, at most 128.
+ */
+#define CAN_RX_RING_SIZE        16u
+
+#endif /* CAN_CFG_H */
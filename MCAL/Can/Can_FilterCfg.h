@@ -0,0 +1,90 @@
+/**
+ * @file        Can_FilterCfg.h
+ * @author      Phuc
+ * @brief       Acceptance filters and receive dispatch of CAN, generated by Can_FilterGen.py from Can_RxIds.txt
+ * @version     1.0
+ * @date        2025-01-12
+ * 
+ * @copyright   Copyright (c) 2025
+ * 
+ */
+
+/*
+ * Do not edit, run Can_FilterGen.py again after changing the ID list.
+ *
+ * IDs requested       : 17 standard, 0 extended
+ * Filter banks        : 3 (exact image needs 3)
+ * Unwanted IDs passed : 0
+ * ID lookup           : FMI direct index, else at most 5 binary search steps
+ *
+ *   bank  0  FIFO0  FMI  0  std 0x200
+ *   bank  0  FIFO0  FMI  1  std 0x210
+ *   bank  0  FIFO0  FMI  2  std 0x2F0
+ *   bank  0  FIFO0  FMI  3  std 0x7DF
+ *   bank  1  FIFO1  FMI  0  std 0x7E0
+ *   bank  2  FIFO0  FMI  4  std 0x100/0x7F8
+ *   bank  2  FIFO0  FMI  5  std 0x3A0/0x7FC
+ */
+
+#ifndef CAN_FILTERCFG_H
+#define CAN_FILTERCFG_H
+
+#include "Can.h"
+
+/**
+ * @brief       Register image of the filter banks, written by Can_Init() while FINIT is set
+ */
+const Can_FilterImageType Can_FilterImage = 
+{
+    .FM1R = 0x00000003u,             /* Identifier-list banks */
+    .FS1R = 0x00000000u,             /* 32-bit scale banks */
+    .FFA1R = 0x00000002u,            /* Banks assigned to FIFO1 */
+    .FA1R = 0x00000007u,             /* Active banks */
+    .BankCount = 3u,
+    .FR = 
+    {
+        {0x42004000u, 0xFBE05E00u},
+        {0xFC00FC00u, 0xFC00FC00u},
+        {0xFF182000u, 0xFF987400u}
+    }
+};
+
+/**
+ * @brief       Received CAN IDs with their HRH and PDU handle, sorted by CAN ID
+ */
+#define CAN_RX_DISPATCH_COUNT       17u
+#define CAN_RX_SEARCH_STEPS_MAX     5u
+
+const Can_RxDispatchType Can_RxDispatch[CAN_RX_DISPATCH_COUNT] = 
+{
+    {{0x00000100u, 0u, 0u}, 0u},
+    {{0x00000101u, 0u, 0u}, 1u},
+    {{0x00000102u, 0u, 0u}, 2u},
+    {{0x00000103u, 0u, 0u}, 3u},
+    {{0x00000104u, 0u, 0u}, 4u},
+    {{0x00000105u, 0u, 0u}, 5u},
+    {{0x00000106u, 0u, 0u}, 6u},
+    {{0x00000107u, 0u, 0u}, 7u},
+    {{0x00000200u, 0u, 0u}, 12u},
+    {{0x00000210u, 0u, 0u}, 13u},
+    {{0x000002F0u, 0u, 0u}, 14u},
+    {{0x000003A0u, 0u, 0u}, 8u},
+    {{0x000003A1u, 0u, 0u}, 9u},
+    {{0x000003A2u, 0u, 0u}, 10u},
+    {{0x000003A3u, 0u, 0u}, 11u},
+    {{0x000007DFu, 1u, 0u}, 15u},
+    {{0x000007E0u, 1u, 0u}, 16u}
+};
+
+/**
+ * @brief       Index into Can_RxDispatch for each FIFO and FMI, CAN_RX_FMI_SEARCH for ID/mask entries
+ */
+#define CAN_RX_FMI_MAX              6u
+
+const uint16 Can_RxFmiMap[2][CAN_RX_FMI_MAX] = 
+{
+    {8u, 9u, 10u, 15u, CAN_RX_FMI_SEARCH, CAN_RX_FMI_SEARCH},
+    {16u, 16u, 16u, 16u, CAN_RX_FMI_SEARCH, CAN_RX_FMI_SEARCH}
+};
+
+#endif /* CAN_FILTERCFG_H */
@@ -0,0 +1,413 @@
+#!/usr/bin/env python3
+"""
+@file        Can_FilterGen.py
+@author      Phuc
+@brief       Acceptance filter compiler for the bxCAN of STM32L476
+@version     1.0
+@date        2025-01-12
+
+Reads the CAN IDs received by the ECU and generates Can_FilterCfg.h with the register image of the filter banks
+that Can_Init() writes in one pass, and the table that maps a received CAN ID to its HRH and PDU handle.
+
+Standard IDs are packed into 16-bit banks (4 IDs in identifier-list mode, 2 ID/mask pairs in mask mode) and
+extended IDs into 32-bit banks (2 IDs in identifier-list mode, 1 ID/mask pair in mask mode). IDs are first
+merged into the largest ID/mask pairs that accept nothing but wanted IDs, so the result is exact. When the
+exact image needs more banks than allowed, the pairs whose merge accepts the fewest unwanted frames are merged
+until the image fits, so the result becomes a bounded superset.
+
+Input file, one ID per line, '#' starts a comment. The HRH defaults to 0 and the PDU handle to the line
+number among the IDs:
+    0x123 hrh=0 pdu=4           standard ID
+    0x18FF0010 ext hrh=1 pdu=5  extended ID
+
+The dispatch table is sorted by CAN ID for a binary search. When the hardware reports the filter match index
+(FMI) of an identifier-list entry, the driver uses it as a direct index into the table and skips the search.
+
+Traffic file (optional), the IDs seen on the bus with their frame rate:
+    0x123 100       standard ID, 100 frames/s
+    0x18FF0010 ext 10
+
+Usage:
+    python3 Can_FilterGen.py Can_RxIds.txt [-o Can_FilterCfg.h] [--max-banks N] [--traffic bus.txt]
+"""
+
+import argparse
+import heapq
+import sys
+
+FILTER_BANK_MAX = 14        # CAN1 filter banks on STM32L476
+STD_BITS = 11
+EXT_BITS = 29
+CAN_ID_EXTENDED = 0x80000000  # Most significant bit of Can_IdType for extended IDs
+FMI_SEARCH = 0xFFFF           # FMI of an ID/mask entry, the ID has to be searched
+
+
+class Cube:
+    """ID/mask pair: every ID whose bits under 'care' equal 'value'."""
+
+    def __init__(self, value, care, bits):
+        self.value = value & care
+        self.care = care
+        self.bits = bits
+
+    def size(self):
+        return 1 << (self.bits - bin(self.care).count("1"))
+
+    def contains(self, can_id):
+        return (can_id & self.care) == self.value
+
+    def merge(self, other):
+        care = self.care & other.care & ~(self.value ^ other.value)
+        return Cube(self.value, care, self.bits)
+
+    def is_single(self):
+        return self.care == (1 << self.bits) - 1
+
+    def overlaps(self, other):
+        common = self.care & other.care
+        return (self.value & common) == (other.value & common)
+
+    def minus(self, other):
+        """Disjoint cubes covering the IDs of this cube that 'other' does not accept."""
+        if not self.overlaps(other):
+            return [self]
+        pieces = []
+        value, care = self.value, self.care
+        free = other.care & ~self.care
+        while free:
+            bit = free & -free
+            free &= free - 1
+            # IDs that agree with 'other' on the bits fixed so far but not on this one
+            pieces.append(Cube(value | (~other.value & bit), care | bit, self.bits))
+            value |= other.value & bit
+            care |= bit
+        return pieces
+
+    def __eq__(self, other):
+        return (self.value, self.care) == (other.value, other.care)
+
+    def __hash__(self):
+        return hash((self.value, self.care))
+
+
+def parse_ids(path, with_rate):
+    """Returns {(id, is_ext): rate} from a traffic file, or {(id, is_ext): (hrh, pdu)} from an ID file."""
+    ids = {}
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            fields = line.split("#", 1)[0].split()
+            if not fields:
+                continue
+            can_id = int(fields[0], 0)
+            is_ext = len(fields) > 1 and fields[1].lower() == "ext"
+            rest = fields[2:] if (len(fields) > 1 and fields[1].lower() in ("ext", "std")) else fields[1:]
+            limit = (1 << EXT_BITS) if is_ext else (1 << STD_BITS)
+            if can_id >= limit:
+                sys.exit("%s:%d: ID 0x%X does not fit in %s frame" % (path, lineno, can_id, "an extended" if is_ext else "a standard"))
+            if with_rate:
+                ids[(can_id, is_ext)] = float(rest[0]) if rest else 1.0
+            else:
+                attrs = dict(f.split("=", 1) for f in rest if "=" in f)
+                ids[(can_id, is_ext)] = (int(attrs.get("hrh", "0"), 0), int(attrs.get("pdu", str(len(ids))), 0))
+    return ids
+
+
+def prime_cubes(ids, bits):
+    """All largest ID/mask pairs that only accept IDs of the set (Quine-McCluskey without don't-cares)."""
+    level = {Cube(i, (1 << bits) - 1, bits) for i in ids}
+    primes = set()
+    while level:
+        merged = set()
+        used = set()
+        for cube in level:
+            care = cube.care
+            while care:
+                bit = care & -care
+                care &= care - 1
+                partner = Cube(cube.value ^ bit, cube.care, bits)
+                if partner in level:
+                    merged.add(Cube(cube.value & ~bit, cube.care & ~bit, bits))
+                    used.add(cube)
+                    used.add(partner)
+        primes |= level - used
+        level = merged
+    return primes
+
+
+def exact_cover(ids, bits):
+    """Picks ID/mask pairs where they save filter slots, the rest stays in identifier lists."""
+    uncovered = set(ids)
+    primes = sorted(prime_cubes(ids, bits), key=lambda c: -c.size())
+    cubes = []
+    while uncovered:
+        best = max(primes, key=lambda c: (sum(1 for i in uncovered if c.contains(i)), c.size()), default=None)
+        gain = sum(1 for i in uncovered if best.contains(i)) if best else 0
+        # One mask slot costs as much as two list slots
+        if gain < 3:
+            break
+        cubes.append(best)
+        uncovered = {i for i in uncovered if not best.contains(i)}
+    cubes += [Cube(i, (1 << bits) - 1, bits) for i in sorted(uncovered)]
+    return cubes
+
+
+def pack(cubes, list_per_bank, mask_per_bank):
+    """Splits the entries into identifier-list and mask banks, returns (list banks, mask banks)."""
+    singles = [c for c in cubes if c.is_single()]
+    masks = [c for c in cubes if not c.is_single()]
+    # A free mask slot takes one leftover ID if that saves a list bank
+    spare = (-len(masks)) % mask_per_bank
+    leftover = len(singles) % list_per_bank
+    if spare and leftover and leftover <= spare:
+        masks += singles[-leftover:]
+        singles = singles[:-leftover]
+    lists = [singles[i:i + list_per_bank] for i in range(0, len(singles), list_per_bank)]
+    mask_banks = [masks[i:i + mask_per_bank] for i in range(0, len(masks), mask_per_bank)]
+    return lists, mask_banks
+
+
+def bank_count(std, ext):
+    l16, m16 = pack(std, 4, 2)
+    l32, m32 = pack(ext, 2, 1)
+    return len(l16) + len(m16) + len(l32) + len(m32)
+
+
+def unwanted_cost(cube, wanted, traffic, is_ext):
+    """Rate of accepted but unwanted frames, or their number of IDs when no traffic is known."""
+    if traffic is not None:
+        return sum(r for (i, e), r in traffic.items() if e == is_ext and cube.contains(i) and i not in wanted)
+    return cube.size() - sum(1 for i in wanted if cube.contains(i))
+
+
+def accepted(cubes):
+    """Number of IDs accepted by at least one of the cubes, overlaps counted once."""
+    disjoint = []
+    for cube in cubes:
+        pieces = [cube]
+        for done in disjoint:
+            pieces = [p for piece in pieces for p in piece.minus(done)]
+        disjoint += pieces
+    return sum(c.size() for c in disjoint)
+
+
+def unwanted_total(std, ext, wanted_std, wanted_ext, traffic):
+    """Unwanted IDs accepted by the image, or their rate when traffic is known, each ID counted once."""
+    if traffic is not None:
+        return sum(r for (i, e), r in traffic.items()
+                   if i not in (wanted_ext if e else wanted_std) and any(c.contains(i) for c in (ext if e else std)))
+    return accepted(std) - len(wanted_std) + accepted(ext) - len(wanted_ext)
+
+
+def reduce_to(std, ext, wanted_std, wanted_ext, traffic, max_banks):
+    """Merges entries, cheapest first, until the image fits in max_banks. The cost of merging each pair is
+    computed once and kept in a heap, a merge only adds the pairs of the merged entry."""
+    groups = ((std, wanted_std, False), (ext, wanted_ext, True))
+    # Entries are numbered in list order and a merged entry is appended, so numbers sort as list positions do
+    # and ties go to the first pair in list order
+    serial = [list(range(len(std))), list(range(len(ext)))]
+    next_serial = [len(std), len(ext)]
+    heap = []
+
+    def push(g, a, na, b, nb):
+        _, wanted, is_ext = groups[g]
+        merged = a.merge(b)
+        heapq.heappush(heap, (unwanted_cost(merged, wanted, traffic, is_ext), g, na, nb, merged))
+
+    for g, (cubes, _, _) in enumerate(groups):
+        for a in range(len(cubes)):
+            for b in range(a + 1, len(cubes)):
+                push(g, cubes[a], a, cubes[b], b)
+
+    while bank_count(std, ext) > max_banks:
+        while heap and not (heap[0][2] in serial[heap[0][1]] and heap[0][3] in serial[heap[0][1]]):
+            heapq.heappop(heap)
+        if not heap:
+            sys.exit("error: the IDs cannot be packed into %d filter banks" % max_banks)
+        _, g, _, _, merged = heapq.heappop(heap)
+        cubes = groups[g][0]
+        keep = [n for n, c in enumerate(cubes)
+                if not (c.care & merged.care == merged.care and c.value & merged.care == merged.value)]
+        number = next_serial[g]
+        next_serial[g] += 1
+        cubes[:] = [cubes[n] for n in keep]
+        serial[g] = [serial[g][n] for n in keep]
+        for c, n in zip(cubes, serial[g]):
+            push(g, c, n, merged, number)
+        cubes.append(merged)
+        serial[g].append(number)
+
+
+def std16(value, is_mask):
+    # STID[10:0] in bits 15:5, RTR bit 4, IDE bit 3: data frames with standard ID only
+    return ((value & 0x7FF) << 5) | (0x18 if is_mask else 0)
+
+
+def ext32(value, is_mask):
+    # STID/EXID in bits 31:3, IDE bit 2, RTR bit 1: data frames with extended ID only
+    return ((value & 0x1FFFFFFF) << 3) | (0x6 if is_mask else 0x4)
+
+
+def build_banks(std, ext):
+    """Returns the banks as (mode_list, scale_32, [FR1, FR2], entries, slots)."""
+    banks = []
+    l16, m16 = pack(std, 4, 2)
+    l32, m32 = pack(ext, 2, 1)
+    for group in l16:
+        ids = [c.value for c in group] + [group[0].value] * (4 - len(group))
+        fr = [std16(ids[0], False) | (std16(ids[1], False) << 16), std16(ids[2], False) | (std16(ids[3], False) << 16)]
+        banks.append((True, False, fr, group, 4))
+    for group in m16:
+        pairs = group + [group[0]] * (2 - len(group))
+        fr = [std16(c.value, False) | (std16(c.care, True) << 16) for c in pairs]
+        banks.append((False, False, fr, group, 2))
+    for group in l32:
+        ids = [c.value for c in group] + [group[0].value] * (2 - len(group))
+        banks.append((True, True, [ext32(ids[0], False), ext32(ids[1], False)], group, 2))
+    for group in m32:
+        banks.append((False, True, [ext32(group[0].value, False), ext32(group[0].care, True)], group, 1))
+    return banks
+
+
+def main():
+    parser = argparse.ArgumentParser(description="bxCAN acceptance filter compiler")
+    parser.add_argument("ids", help="file listing the CAN IDs to receive")
+    parser.add_argument("-o", "--output", default="Can_FilterCfg.h", help="generated header")
+    parser.add_argument("--max-banks", type=int, default=FILTER_BANK_MAX, help="filter banks available")
+    parser.add_argument("--traffic", help="file listing the IDs seen on the bus with their frame rate")
+    args = parser.parse_args()
+
+    wanted = parse_ids(args.ids, False)
+    traffic = parse_ids(args.traffic, True) if args.traffic else None
+    wanted_std = {i for (i, e) in wanted if not e}
+    wanted_ext = {i for (i, e) in wanted if e}
+
+    std = exact_cover(wanted_std, STD_BITS)
+    ext = exact_cover(wanted_ext, EXT_BITS)
+    exact_banks = bank_count(std, ext)
+    reduce_to(std, ext, wanted_std, wanted_ext, traffic, min(args.max_banks, FILTER_BANK_MAX))
+    banks = build_banks(std, ext)
+
+    # Dispatch table sorted by Can_IdType, the extended flag sorts extended IDs after standard ones
+    dispatch = sorted(((i | (CAN_ID_EXTENDED if e else 0)), hrh, pdu) for (i, e), (hrh, pdu) in wanted.items())
+    index_of = {key: n for n, (key, _, _) in enumerate(dispatch)}
+    search_steps = max(1, len(dispatch)).bit_length()
+
+    # Spread the banks over both FIFOs, FMI counts the filters of each FIFO in bank order
+    fm1r = fs1r = ffa1r = fa1r = 0
+    fmi_next = [0, 0]
+    fmi_map = [[], []]
+    fmi_lines = []
+    for n, (is_list, is_32, fr, group, slots) in enumerate(banks):
+        fifo = n & 1
+        fm1r |= int(is_list) << n
+        fs1r |= int(is_32) << n
+        ffa1r |= fifo << n
+        fa1r |= 1 << n
+        for k, cube in enumerate(group):
+            fmi = fmi_next[fifo] + k
+            if cube.is_single():
+                what = "0x%X" % cube.value
+            else:
+                what = "0x%X/0x%X" % (cube.value, cube.care)
+            fmi_lines.append(" *   bank %2d  FIFO%d  FMI %2d  %s %s" % (n, fifo, fmi, "ext" if is_32 else "std", what))
+        # Unused slots repeat the first entry of the bank, they never match since a lower FMI wins
+        for k in range(slots):
+            cube = group[k] if k < len(group) else group[0]
+            key = cube.value | (CAN_ID_EXTENDED if is_32 else 0)
+            fmi_map[fifo].append(index_of.get(key, FMI_SEARCH) if cube.is_single() else FMI_SEARCH)
+        fmi_next[fifo] += slots
+    fmi_max = max(1, len(fmi_map[0]), len(fmi_map[1]))
+    for fifo in range(2):
+        fmi_map[fifo] += [FMI_SEARCH] * (fmi_max - len(fmi_map[fifo]))
+
+    report = [
+        "IDs requested       : %d standard, %d extended" % (len(wanted_std), len(wanted_ext)),
+        "Filter banks        : %d (exact image needs %d)" % (len(banks), exact_banks),
+        "Unwanted IDs passed : %d" % unwanted_total(std, ext, wanted_std, wanted_ext, None),
+        "ID lookup           : FMI direct index, else at most %d binary search steps" % search_steps,
+    ]
+    if traffic is not None:
+        total = sum(traffic.values())
+        unwanted = sum(r for (i, e), r in traffic.items() if (i, e) not in wanted)
+        passed = unwanted_total(std, ext, wanted_std, wanted_ext, traffic)
+        report.append("Bus traffic         : %.1f frames/s, %.1f frames/s unwanted" % (total, unwanted))
+        report.append("Unwanted frames/s   : %.1f accepted, %.1f rejected in hardware (%.1f%% of the bus)" %
+                      (passed, unwanted - passed, 100.0 * (unwanted - passed) / total if total else 0.0))
+    print("\n".join(report))
+
+    out = []
+    out.append("/**")
+    out.append(" * @file        %s" % args.output.split("/")[-1])
+    out.append(" * @author      Phuc")
+    out.append(" * @brief       Acceptance filters and receive dispatch of CAN, generated by Can_FilterGen.py from %s" % args.ids.split("/")[-1])
+    out.append(" * @version     1.0")
+    out.append(" * @date        2025-01-12")
+    out.append(" * ")
+    out.append(" * @copyright   Copyright (c) 2025")
+    out.append(" * ")
+    out.append(" */")
+    out.append("")
+    out.append("/*")
+    out.append(" * Do not edit, run Can_FilterGen.py again after changing the ID list.")
+    out.append(" *")
+    for line in report:
+        out.append(" * " + line)
+    out.append(" *")
+    out.extend(fmi_lines)
+    out.append(" */")
+    out.append("")
+    out.append("#ifndef CAN_FILTERCFG_H")
+    out.append("#define CAN_FILTERCFG_H")
+    out.append("")
+    out.append("#include \"Can.h\"")
+    out.append("")
+    out.append("/**")
+    out.append(" * @brief       Register image of the filter banks, written by Can_Init() while FINIT is set")
+    out.append(" */")
+    out.append("const Can_FilterImageType Can_FilterImage = ")
+    out.append("{")
+    out.append("    .FM1R = 0x%08Xu,             /* Identifier-list banks */" % fm1r)
+    out.append("    .FS1R = 0x%08Xu,             /* 32-bit scale banks */" % fs1r)
+    out.append("    .FFA1R = 0x%08Xu,            /* Banks assigned to FIFO1 */" % ffa1r)
+    out.append("    .FA1R = 0x%08Xu,             /* Active banks */" % fa1r)
+    out.append("    .BankCount = %du," % len(banks))
+    out.append("    .FR = ")
+    out.append("    {")
+    for n, (_, _, fr, _, _) in enumerate(banks):
+        out.append("        {0x%08Xu, 0x%08Xu}%s" % (fr[0], fr[1], "," if n + 1 < len(banks) else ""))
+    out.append("    }")
+    out.append("};")
+    out.append("")
+    out.append("/**")
+    out.append(" * @brief       Received CAN IDs with their HRH and PDU handle, sorted by CAN ID")
+    out.append(" */")
+    out.append("#define CAN_RX_DISPATCH_COUNT       %du" % max(1, len(dispatch)))
+    out.append("#define CAN_RX_SEARCH_STEPS_MAX     %du" % search_steps)
+    out.append("")
+    out.append("const Can_RxDispatchType Can_RxDispatch[CAN_RX_DISPATCH_COUNT] = ")
+    out.append("{")
+    if not dispatch:
+        out.append("    {{0xFFFFFFFFu, 0u, 0u}, 0u}     /* No ID is received */")
+    for n, (key, hrh, pdu) in enumerate(dispatch):
+        out.append("    {{0x%08Xu, %du, 0u}, %du}%s" % (key, hrh, pdu, "," if n + 1 < len(dispatch) else ""))
+    out.append("};")
+    out.append("")
+    out.append("/**")
+    out.append(" * @brief       Index into Can_RxDispatch for each FIFO and FMI, CAN_RX_FMI_SEARCH for ID/mask entries")
+    out.append(" */")
+    out.append("#define CAN_RX_FMI_MAX              %du" % fmi_max)
+    out.append("")
+    out.append("const uint16 Can_RxFmiMap[2][CAN_RX_FMI_MAX] = ")
+    out.append("{")
+    for fifo in range(2):
+        cells = ", ".join("CAN_RX_FMI_SEARCH" if v == FMI_SEARCH else "%du" % v for v in fmi_map[fifo])
+        out.append("    {%s}%s" % (cells, "," if fifo == 0 else ""))
+    out.append("};")
+    out.append("")
+    out.append("#endif /* CAN_FILTERCFG_H */")
+    with open(args.output, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
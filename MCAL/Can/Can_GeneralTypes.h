@@ -34,6 +34,9 @@
  */
 typedef uint32 Can_IdType;
 
+#define CAN_ID_EXTENDED     0x80000000u     /* Can_IdType flag of a CAN message with Extended CAN ID */
+#define CAN_ID_FD           0x40000000u     /* Can_IdType flag of a CAN FD frame */
+
 /** 
  * @typedef     Can_PduType
  * @brief       This type unites PduId (swPduHandle), SduLength (length), SduData (sdu), and CanId (id) for any
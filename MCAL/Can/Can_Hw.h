@@ -0,0 +1,526 @@
+/**
+ * @file        Can_Hw.h
+ * @author      Phuc
+ * @brief       bxCAN register access for STM32L476
+ * @version     1.0
+ * @date        2025-01-12
+ * 
+ * @copyright   Copyright (c) 2025
+ * 
+ */
+
+#ifndef CAN_HW_H
+#define CAN_HW_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include <string.h>
+#include "Can.h"
+#include "Can_Cfg.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define CAN_TX_MAILBOX_MAX          3u                                      /* Transmit mailboxes per controller */
+
+#define CAN_TSR_TME_MB(mb)          (CAN_TSR_TME0 << (mb))                  /* Mailbox <mb> empty flag */
+#define CAN_TSR_ABRQ_MB(mb)         (CAN_TSR_ABRQ0 << (8u * (mb)))          /* Mailbox <mb> abort request */
+
+#define CAN_RX_FIFO_MAX             2u                                      /* Receive FIFOs per controller */
+
+/*
+ ************************************************************************************************************
+ * Inline functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Maps a CAN controller index to its register block
+ * @param       Controller: CAN controller index
+ * @return      Pointer to the register block, NULL_PTR if the controller does not exist
+ */
+inline static CAN_TypeDef* Can_Hw_GetController(uint8 Controller)
+{
+#if defined(CAN_HOST_SIM)
+    return Can_Sim_GetRegs(Controller);
+#else
+    if (Controller == 0u)
+    {
+        return CAN1;
+    }
+
+    return NULL_PTR;
+#endif
+}
+
+/**
+ * @brief       Writes a register whose write has a side effect in hardware: MCR, MSR, TSR, RF0R/RF1R, ESR and
+ *              TIxR. Going through here lets the host simulator see each of these writes.
+ * @param       Reg: Register to be written
+ * @param       Value: Value to be written
+ * @return      void
+ */
+inline static void Can_Hw_WriteReg(volatile uint32_t* Reg, uint32 Value)
+{
+#if defined(CAN_HOST_SIM)
+    Can_Sim_WriteReg(Reg, Value);
+#else
+    *Reg = (uint32_t)Value;
+#endif
+}
+
+/**
+ * @brief       Clocks CAN1 and routes it to PB8 (RX) / PB9 (TX)
+ * @param       void
+ * @return      void
+ */
+inline static void Can_Hw_InitPins(void)
+{
+#if !defined(CAN_HOST_SIM)
+    /* CAN GPIO Init */
+    RCC->AHB2ENR |= RCC_AHB2ENR_GPIOBEN;
+    GPIOB->MODER &= ~(GPIO_MODER_MODE8_Msk | GPIO_MODER_MODE9_Msk);
+    GPIOB->MODER |=   GPIO_MODER_MODE8_1|GPIO_MODER_MODE9_1;
+    GPIOB->PUPDR &= ~(GPIO_PUPDR_PUPD8_Msk | GPIO_PUPDR_PUPD9_Msk);
+    GPIOB->OSPEEDR |= (GPIO_OSPEEDR_OSPEED8_Msk | GPIO_OSPEEDR_OSPEED9_Msk);
+
+    /*Configure PB8 and PB9 to use CAN Bus AF*/
+    GPIOB->AFR[1] &= ~((0xF << GPIO_AFRH_AFSEL8_Pos) | (0xF << GPIO_AFRH_AFSEL9_Pos));
+    GPIOB->AFR[1] |= (CAN_AF << GPIO_AFRH_AFSEL8_Pos) | (CAN_AF << GPIO_AFRH_AFSEL9_Pos);
+
+    /*Enable Clock access to CAN1*/
+    RCC->APB1ENR1 |= RCC_APB1ENR1_CAN1EN;
+#endif
+}
+
+/**
+ * @brief       Stops the clocks of CAN1 and of its GPIO port
+ * @param       void
+ * @return      void
+ */
+inline static void Can_Hw_DeInitPins(void)
+{
+#if !defined(CAN_HOST_SIM)
+    /*Disable Clock access to CAN1*/
+    RCC->APB1ENR1 &= ~RCC_APB1ENR1_CAN1EN;
+
+    /* Disable Clock access to GPIO CAN */
+    RCC->AHB2ENR &= ~RCC_AHB2ENR_GPIOBEN;
+#endif
+}
+
+/**
+ * @brief       Marks one iteration of a busy wait on the controller. The host simulator moves the bus forward by
+ *              the time such a poll takes, on the target the register read itself is the delay.
+ * @param       void
+ * @return      void
+ */
+inline static void Can_Hw_Poll(void)
+{
+#if defined(CAN_HOST_SIM)
+    Can_Sim_Run(CAN_SIM_POLL_CYCLES);
+#endif
+}
+
+/**
+ * @brief       Waits, at most CAN_MODE_TIMEOUT polls, until the MSR bits under Mask read Expected
+ * @param       CANx: CAN register block
+ * @param       Mask: MSR bits to be checked, e.g. CAN_MSR_INAK
+ * @param       Expected: Expected value of these bits
+ * @return      E_OK if the bits reached the expected value, E_NOT_OK on timeout
+ */
+inline static Std_ReturnType Can_Hw_WaitMsr(CAN_TypeDef* CANx, uint32 Mask, uint32 Expected)
+{
+    uint32 polls;
+
+    for (polls = 0u; polls < CAN_MODE_TIMEOUT; polls++)
+    {
+        if ((CANx->MSR & Mask) == Expected)
+        {
+            return E_OK;
+        }
+        Can_Hw_Poll();
+    }
+
+    return E_NOT_OK;
+}
+
+/**
+ * @brief       Masks all interrupts so that the mailbox and queue bookkeeping stays consistent with the ISRs
+ * @param       void
+ * @return      Previous PRIMASK value, to be handed back to Can_Hw_ExitCritical()
+ */
+inline static uint32 Can_Hw_EnterCritical(void)
+{
+    uint32 primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+/**
+ * @brief       Restores the interrupt mask saved by Can_Hw_EnterCritical()
+ * @param       primask: Value returned by Can_Hw_EnterCritical()
+ * @return      void
+ */
+inline static void Can_Hw_ExitCritical(uint32 primask)
+{
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief       Starts the DWT cycle counter used to time mode transitions
+ * @param       void
+ * @return      void
+ */
+inline static void Can_Hw_EnableCycleCounter(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief       Reads the DWT cycle counter, differences are correct across one wrap around
+ * @param       void
+ * @return      Current CPU cycle count
+ */
+inline static uint32 Can_Hw_GetCycles(void)
+{
+    return (uint32)DWT->CYCCNT;
+}
+
+/**
+ * @brief       Returns the length of a bit time, the unit of the TTCM TIME counter
+ * @param       CANx: CAN register block
+ * @return      Bit time in CPU cycles
+ */
+inline static uint32 Can_Hw_GetCyclesPerBit(const CAN_TypeDef* CANx)
+{
+    uint32 btr = CANx->BTR;
+    uint32 brp = ((btr & CAN_BTR_BRP) >> CAN_BTR_BRP_Pos) + 1u;
+    uint32 tq = ((btr & CAN_BTR_TS1) >> CAN_BTR_TS1_Pos) + ((btr & CAN_BTR_TS2) >> CAN_BTR_TS2_Pos) + 3u;
+
+    return (CAN_CPU_CLOCK_HZ / CAN_APB1_CLOCK_HZ) * brp * tq;
+}
+
+/**
+ * @brief       Maps an operating mode onto the LBKM and SILM bits of BTR
+ * @param       Mode: CAN_OPMODE_xxx
+ * @return      LBKM and SILM bits of the mode
+ */
+inline static uint32 Can_Hw_GetModeBits(uint8 Mode)
+{
+    return (((Mode & CAN_OPMODE_LOOPBACK) != 0u) ? CAN_BTR_LBKM : 0u) |
+           (((Mode & CAN_OPMODE_SILENT) != 0u) ? CAN_BTR_SILM : 0u);
+}
+
+/**
+ * @brief       Builds the BTR value of a configuration. The segment lengths are given in time quanta and stored
+ *              minus one, the operating mode goes into LBKM and SILM.
+ * @param       Config: Driver configuration
+ * @return      BTR value
+ */
+inline static uint32 Can_Hw_GetBitTiming(const Can_ConfigType* Config)
+{
+    return ((((uint32)Config->CAN_Prescaler - 1u) << CAN_BTR_BRP_Pos) & CAN_BTR_BRP) |
+           ((((uint32)Config->CAN_BS1 - 1u) << CAN_BTR_TS1_Pos) & CAN_BTR_TS1) |
+           ((((uint32)Config->CAN_BS2 - 1u) << CAN_BTR_TS2_Pos) & CAN_BTR_TS2) |
+           ((((uint32)Config->CAN_SJW - 1u) << CAN_BTR_SJW_Pos) & CAN_BTR_SJW) |
+           Can_Hw_GetModeBits(Config->CAN_Mode);
+}
+
+/**
+ * @brief       Returns the worst case length of a data frame on the bus, with the maximum number of stuff bits
+ *              and the 3 bit interframe space: g + 8n + 13 + (g + 8n - 1) / 4, where g is 34 bits for a
+ *              standard and 54 bits for an extended frame and n is the number of data bytes
+ * @param       Extended: Non zero for a 29-bit identifier
+ * @param       Dlc: Data length code, values above 8 carry 8 bytes
+ * @return      Frame length in bits
+ */
+inline static uint32 Can_Hw_GetFrameBits(uint32 Extended, uint32 Dlc)
+{
+    uint32 stuffable = ((Extended != 0u) ? 54u : 34u) + (8u * ((Dlc > 8u) ? 8u : Dlc));
+
+    return stuffable + 13u + ((stuffable - 1u) / 4u);
+}
+
+/**
+ * @brief       Returns the shortest time from the start of a data frame to its completion flag (FMP, TXOK),
+ *              i.e. the frame up to the 6th end of frame bit without any stuff bit: g + 8n + 9, where g is 34 bits
+ *              for a standard and 54 bits for an extended frame and n is the number of data bytes
+ * @param       Extended: Non zero for a 29-bit identifier
+ * @param       Dlc: Data length code, values above 8 carry 8 bytes
+ * @return      Duration in bits
+ */
+inline static uint32 Can_Hw_GetFrameBitsMin(uint32 Extended, uint32 Dlc)
+{
+    return ((Extended != 0u) ? 54u : 34u) + (8u * ((Dlc > 8u) ? 8u : Dlc)) + 9u;
+}
+
+/**
+ * @brief       Maps the last error code of ESR to the AUTOSAR error type
+ * @param       Esr: Value of the ESR register
+ * @return      Can_ErrorType value, 0 when LEC holds no error or the value written by software
+ */
+inline static uint8 Can_Hw_GetLecError(uint32 Esr)
+{
+    static const uint8 Can_Hw_LecMap[8] =
+    {
+        0u,                                 /* 0: no error */
+        CAN_ERROR_CHECK_STUFFING_FAILED,    /* 1: stuff error */
+        CAN_ERROR_CHECK_FORM_FAILED,        /* 2: form error */
+        CAN_ERROR_CHECK_ACK_FAILED,         /* 3: acknowledgment error */
+        CAN_ERROR_BIT_MONITORING0,          /* 4: bit recessive error, a 1 was sent and a 0 read back */
+        CAN_ERROR_BIT_MONITORING1,          /* 5: bit dominant error, a 0 was sent and a 1 read back */
+        CAN_ERROR_CHECK_CRC_FAILED,         /* 6: CRC error */
+        0u                                  /* 7: set by software */
+    };
+
+    return Can_Hw_LecMap[(Esr & CAN_ESR_LEC) >> CAN_ESR_LEC_Pos];
+}
+
+/**
+ * @brief       Returns the arbitration priority of a CAN ID, a lower value wins arbitration on the bus
+ * @details     The key follows the arbitration field bit by bit: base ID, RTR/SRR, IDE, ID extension, RTR.
+ *              A standard frame therefore beats an extended one with the same base ID, and a data frame
+ *              beats a remote frame with the same ID.
+ * @param       CanId: CAN ID of the L-PDU
+ * @return      Arbitration priority
+ */
+inline static uint32 Can_Hw_GetPriority(Can_IdType CanId)
+{
+    uint32 remote = ((CanId & CAN_ID_REMOTE) != 0u) ? 1u : 0u;
+
+    if ((CanId & CAN_ID_EXTENDED) != 0u)
+    {
+        return ((CanId & CAN_ID_EXT_MASK) >> 18) << 21 | (1u << 20) | (1u << 19) |
+               ((CanId & 0x3FFFFu) << 1) | remote;
+    }
+
+    return ((CanId & CAN_ID_STD_MASK) << 21) | (remote << 20);
+}
+
+/**
+ * @brief       Reads back the L-PDU held by a transmit mailbox, e.g. after it has been aborted
+ * @param       CANx: CAN register block
+ * @param       Mailbox: Index of the transmit mailbox
+ * @param       CanIdPtr: Where the CAN ID is stored
+ * @param       LengthPtr: Where the data length is stored
+ * @param       SduPtr: Buffer of 8 bytes where the data is stored
+ * @return      void
+ */
+inline static void Can_Hw_ReadMailbox(CAN_TypeDef* CANx, uint8 Mailbox, Can_IdType* CanIdPtr, uint8* LengthPtr, uint8* SduPtr)
+{
+    CAN_TxMailBox_TypeDef *mailbox = &CANx->sTxMailBox[Mailbox];
+    uint32 tir = mailbox->TIR;
+    uint32 tdlr = mailbox->TDLR;
+    uint32 tdhr = mailbox->TDHR;
+    uint8 i;
+
+    if ((tir & CAN_TI0R_IDE) != 0u)
+    {
+        *CanIdPtr = (Can_IdType)(tir >> CAN_TI0R_EXID_Pos) | CAN_ID_EXTENDED;
+    }
+    else
+    {
+        *CanIdPtr = (Can_IdType)(tir >> CAN_TI0R_STID_Pos);
+    }
+    if ((tir & CAN_TI0R_RTR) != 0u)
+    {
+        *CanIdPtr |= CAN_ID_REMOTE;
+    }
+    *LengthPtr = (uint8)(mailbox->TDTR & CAN_TDT0R_DLC);
+
+    for (i = 0u; i < 4u; i++)
+    {
+        SduPtr[i] = (uint8)(tdlr >> (8u * i));
+        SduPtr[i + 4u] = (uint8)(tdhr >> (8u * i));
+    }
+}
+
+/**
+ * @brief       Fills a transmit mailbox with an L-PDU and requests its transmission
+ * @param       CANx: CAN register block
+ * @param       Mailbox: Index of an empty transmit mailbox
+ * @param       PduInfo: L-PDU to be sent
+ * @return      void
+ */
+inline static void Can_Hw_WriteMailbox(CAN_TypeDef* CANx, uint8 Mailbox, const Can_PduType* PduInfo)
+{
+    CAN_TxMailBox_TypeDef *mailbox = &CANx->sTxMailBox[Mailbox];
+    const uint8 *sdu = PduInfo->sdu;
+    uint8 length = (PduInfo->length > 8u) ? 8u : PduInfo->length;
+    uint8 i;
+    uint32 tdlr = 0u;
+    uint32 tdhr = 0u;
+    uint32 tir;
+
+    // Set the identifier: 29 bits with IDE = 1, or 11 bits with IDE = 0
+    if ((PduInfo->id & CAN_ID_EXTENDED) != 0u)
+    {
+        tir = ((PduInfo->id & CAN_ID_EXT_MASK) << CAN_TI0R_EXID_Pos) | CAN_TI0R_IDE;
+    }
+    else
+    {
+        tir = (PduInfo->id & CAN_ID_STD_MASK) << CAN_TI0R_STID_Pos;
+    }
+
+    // Configure data length (0-8 bytes)
+    mailbox->TDTR = (PduInfo->length & 0x0Fu);
+
+    if ((PduInfo->id & CAN_ID_REMOTE) != 0u)
+    {
+        // Remote frame: DLC only, no data
+        tir |= CAN_TI0R_RTR;
+    }
+    else
+    {
+        // Only the bytes of the SDU are read, whatever its alignment, and the data bytes past the length are
+        // cleared rather than left from the previous frame of the mailbox. Whole words are copied with a
+        // constant size, which compiles to one unaligned load; bxCAN and the core are both little endian.
+        if (length >= 4u)
+        {
+            (void)memcpy(&tdlr, sdu, 4u);
+            if (length == 8u)
+            {
+                (void)memcpy(&tdhr, &sdu[4], 4u);
+            }
+            else
+            {
+                for (i = 4u; i < length; i++)
+                {
+                    tdhr |= (uint32_t)sdu[i] << (8u * (i - 4u));
+                }
+            }
+        }
+        else
+        {
+            for (i = 0u; i < length; i++)
+            {
+                tdlr |= (uint32_t)sdu[i] << (8u * i);
+            }
+        }
+        mailbox->TDLR = tdlr;
+        mailbox->TDHR = tdhr;
+    }
+
+    // Set the TXRQ bit to request transmission, once the mailbox is complete
+    Can_Hw_WriteReg(&mailbox->TIR, tir | CAN_TI0R_TXRQ);
+}
+
+/**
+ * @brief       Releases the output mailbox of a receive FIFO and waits, at most CAN_RX_RELEASE_TIMEOUT polls,
+ *              until the hardware has cleared RFOM
+ * @param       Rfr: RF0R or RF1R
+ * @return      E_OK if the mailbox was released, E_NOT_OK on timeout
+ */
+inline static Std_ReturnType Can_Hw_ReleaseFifo(volatile uint32_t* Rfr)
+{
+    uint32 polls;
+
+    Can_Hw_WriteReg(Rfr, CAN_RF0R_RFOM0);
+    for (polls = 0u; polls < CAN_RX_RELEASE_TIMEOUT; polls++)
+    {
+        if ((*Rfr & CAN_RF0R_RFOM0) == 0u)
+        {
+            return E_OK;
+        }
+        Can_Hw_Poll();
+    }
+
+    return E_NOT_OK;
+}
+
+/**
+ * @brief       Returns the RFxR register of a receive FIFO. RF0R and RF1R share the same bit layout.
+ * @param       CANx: CAN register block
+ * @param       Fifo: Receive FIFO (0 or 1)
+ * @return      Pointer to RF0R or RF1R
+ */
+inline static volatile uint32_t* Can_Hw_GetFifoReg(CAN_TypeDef* CANx, uint8 Fifo)
+{
+    return (Fifo == 0u) ? &CANx->RF0R : &CANx->RF1R;
+}
+
+/**
+ * @brief       Copies the output mailbox of a receive FIFO into a receive ring slot
+ * @param       CANx: CAN register block
+ * @param       Fifo: Receive FIFO (0 or 1)
+ * @param       Frame: Slot to be filled, Frame->Pdu.sdu must point to Frame->Data
+ * @return      TTCM TIME captured at the start of the frame
+ */
+inline static uint16 Can_Hw_ReadFifo(CAN_TypeDef* CANx, uint8 Fifo, Can_RxFrameType* Frame)
+{
+    CAN_FIFOMailBox_TypeDef *mailbox = &CANx->sFIFOMailBox[Fifo];
+    uint32 rdtr = mailbox->RDTR;
+    uint32 rdlr = mailbox->RDLR;
+    uint32 rdhr = mailbox->RDHR;
+    uint32 rir = mailbox->RIR;
+    uint8 i;
+
+    if ((rir & CAN_RI0R_IDE) != 0u)
+    {
+        Frame->Pdu.id = (Can_IdType)(rir >> CAN_RI0R_EXID_Pos) | CAN_ID_EXTENDED;
+    }
+    else
+    {
+        Frame->Pdu.id = (Can_IdType)(rir >> CAN_RI0R_STID_Pos);
+    }
+    if ((rir & CAN_RI0R_RTR) != 0u)
+    {
+        Frame->Pdu.id |= CAN_ID_REMOTE;
+    }
+    Frame->Pdu.length = (uint8)(rdtr & CAN_RDT0R_DLC);
+    Frame->Fifo = Fifo;
+    Frame->Fmi = (uint8)((rdtr & CAN_RDT0R_FMI) >> CAN_RDT0R_FMI_Pos);
+
+    for (i = 0u; i < 4u; i++)
+    {
+        Frame->Data[i] = (uint8)(rdlr >> (8u * i));
+        Frame->Data[i + 4u] = (uint8)(rdhr >> (8u * i));
+    }
+
+    return (uint16)((rdtr & CAN_RDT0R_TIME) >> CAN_RDT0R_TIME_Pos);
+}
+
+/**
+ * @brief       Returns the TTCM TIME captured when a transmit mailbox started sending its frame
+ * @param       CANx: CAN register block
+ * @param       Mailbox: Index of the transmit mailbox, valid once TXOK is set
+ * @return      TTCM TIME captured at the start of the frame
+ */
+inline static uint16 Can_Hw_GetMailboxTime(const CAN_TypeDef* CANx, uint8 Mailbox)
+{
+    return (uint16)((CANx->sTxMailBox[Mailbox].TDTR & CAN_TDT0R_TIME) >> CAN_TDT0R_TIME_Pos);
+}
+
+/**
+ * @brief       Writes the register image of the acceptance filter banks
+ * @param       CANx: CAN register block
+ * @param       Image: Filter image generated by Can_FilterGen.py
+ * @return      void
+ */
+inline static void Can_Hw_WriteFilters(CAN_TypeDef* CANx, const Can_FilterImageType* Image)
+{
+    uint8 bank;
+
+    CANx->FMR |= CAN_FMR_FINIT;
+    CANx->FA1R = 0u;
+
+    CANx->FM1R = Image->FM1R;
+    CANx->FS1R = Image->FS1R;
+    CANx->FFA1R = Image->FFA1R;
+    for (bank = 0u; bank < Image->BankCount; bank++)
+    {
+        CANx->sFilterRegister[bank].FR1 = Image->FR[bank][0];
+        CANx->sFilterRegister[bank].FR2 = Image->FR[bank][1];
+    }
+
+    CANx->FA1R = Image->FA1R;
+    CANx->FMR &= ~CAN_FMR_FINIT;
+}
+
+#endif /* CAN_HW_H */
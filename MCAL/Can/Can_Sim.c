@@ -0,0 +1,1455 @@
+/**
+ * @file        Can_Sim.c
+ * @author      Phuc
+ * @brief       Host simulator of the bxCAN register block: N nodes on one bus, with arbitration, acknowledge,
+ *              acceptance filters, error counters and bit timing
+ * @version     1.0
+ * @date        2025-01-12
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Can.h"
+
+#if defined(CAN_HOST_SIM)
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Model
+ * @details     The bus works frame by frame. When the bus is idle, every node in normal mode with a pending
+ *              mailbox contends, the lowest arbitration key wins (ties go to the lower node index) and the
+ *              losers see ALST. The whole frame is decided at its start of frame and completed at its end:
+ *              its length is the exact stuffed length of its bits including the CRC, at the bit time the
+ *              transmitter derives from its BTR. A receiver with another bit time sees stuff errors and, while
+ *              error active, destroys the frame with its error flag. A frame that no other node acknowledges
+ *              ends in an acknowledgment error. Error counters follow ISO 11898-1 for the transmitter and the
+ *              receivers (+8 / +1 on error, -1 on success, acknowledge exception of an error passive
+ *              transmitter); the secondary rules on error flags are not modelled.
+ *              A node in silent mode, and a disconnected node, sends on a segment of its own that no other node
+ *              sees. The same holds for the loop back self-test (LBKM and SILM).
+ */
+#define CAN_SIM_BUS                 0u                              /* Segment shared by the attached nodes */
+#define CAN_SIM_SEGMENT_MAX         (CAN_SIM_NODE_MAX + 1u)         /* The bus, then one segment per node */
+#define CAN_SIM_PRIVATE(node)       ((uint8)((node) + 1u))          /* Segment only seen by the node itself */
+
+#define CAN_SIM_FIFO_DEPTH          3u
+#define CAN_SIM_MAILBOX_MAX         3u
+#define CAN_SIM_RUN_BITS            11u     /* Consecutive recessive bits that make the bus idle for a node */
+#define CAN_SIM_RECOVERY_RUNS       128u    /* Runs of CAN_SIM_RUN_BITS needed to leave bus-off */
+#define CAN_SIM_SUSPEND_BITS        8u      /* Suspend transmission of an error passive transmitter */
+#define CAN_SIM_TRAILER_BITS        13u     /* CRC delimiter, ACK slot, ACK delimiter, EOF and intermission */
+#define CAN_SIM_ERROR_BITS          17u     /* Error flag, error delimiter and intermission */
+#define CAN_SIM_ISR_PASSES          16u     /* Interrupt rounds at one point in time before giving up */
+
+#define CAN_SIM_LEC_STUFF           1u
+#define CAN_SIM_LEC_FORM            2u
+#define CAN_SIM_LEC_ACK             3u
+#define CAN_SIM_LEC_BIT_RECESSIVE   4u
+
+#define CAN_SIM_RESULT_OK           0u      /* Frame sent and acknowledged */
+#define CAN_SIM_RESULT_ACK          1u      /* No acknowledge */
+#define CAN_SIM_RESULT_ERROR        2u      /* Destroyed by an error flag */
+
+#define CAN_SIM_TSR_MB(flag, mb)    ((flag) << (8u * (mb)))
+#define CAN_SIM_TSR_STATUS          (CAN_TSR_RQCP0 | CAN_TSR_TXOK0 | CAN_TSR_ALST0 | CAN_TSR_TERR0)
+
+/**
+ * @typedef     Can_SimFifoType
+ * @brief       Receive FIFO, Mailbox[0] is the output mailbox mirrored in sFIFOMailBox
+ */
+typedef struct
+{
+    CAN_FIFOMailBox_TypeDef Mailbox[CAN_SIM_FIFO_DEPTH];
+    uint8 Count;
+} Can_SimFifoType;
+
+/**
+ * @typedef     Can_SimNodeType
+ * @brief       State of a node beyond its register block
+ */
+typedef struct
+{
+    CAN_TypeDef Regs;                       /* Register block seen by the driver */
+    Can_SimFifoType Fifo[2];
+    uint32 Sequence[CAN_SIM_MAILBOX_MAX];   /* Order of the transmit requests, for TXFP */
+    uint32 Tec;                             /* Transmit error counter, above 255 means bus-off */
+    uint32 Rec;                             /* Receive error counter */
+    uint32 Runs;                            /* Runs of 11 recessive bits seen while joining or recovering */
+    uint32 InjectErrors;                    /* Transmissions still to fail, see Can_Sim_InjectErrors() */
+    uint64 IdleCycles;                      /* Recessive cycles since the last counted run */
+    uint64 SuspendUntil;                    /* No start of frame before, after a transmission as error passive */
+    uint64 TimeCycles;                      /* Cycles not yet counted by the TTCM counter */
+    uint16 Time;                            /* TTCM counter, one count per bit time */
+    uint8 AbortMask;                        /* Mailboxes whose abort waits for the end of their frame */
+    uint8 Attached;                         /* Connected to the bus */
+    uint8 Joining;                          /* Leaving initialization or sleep mode, waits for 11 recessive bits */
+    uint8 Recovering;                       /* Bus-off recovery sequence running */
+} Can_SimNodeType;
+
+/**
+ * @typedef     Can_SimFrameType
+ * @brief       Frame on a segment, decided at its start of frame and completed at End
+ */
+typedef struct
+{
+    uint64 Start;                           /* Start of frame */
+    uint64 End;                             /* End of the frame or of its error frame, intermission included */
+    uint32 Rir;                             /* Identifier in RIR layout */
+    uint32 Dlc;
+    uint32 Data[2];
+    uint32 Receivers;                       /* Nodes taking part as receivers */
+    uint32 Matched;                         /* Receivers with the bit time of the transmitter */
+    uint16 Time[CAN_SIM_NODE_MAX];          /* TTCM counter of each node at the start of frame */
+    uint8 Busy;
+    uint8 Tx;                               /* Transmitting node */
+    uint8 Mailbox;                          /* Transmit mailbox of the frame */
+    uint8 Result;                           /* CAN_SIM_RESULT_xxx */
+} Can_SimFrameType;
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+
+static Can_SimNodeType Can_Sim_Node[CAN_SIM_NODE_MAX];
+static Can_SimFrameType Can_Sim_Segment[CAN_SIM_SEGMENT_MAX];
+static Can_SimBusStatsType Can_Sim_Stats;
+static uint64 Can_Sim_Now = 0u;
+static uint32 Can_Sim_Sequence = 0u;
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Returns the bit time a node derives from its BTR, the same formula as Can_Hw_GetCyclesPerBit()
+ * @param       Node: Node index
+ * @return      Bit time in CPU cycles
+ */
+static uint64 Can_Sim_CyclesPerBit(uint8 Node)
+{
+    uint32 btr = Can_Sim_Node[Node].Regs.BTR;
+    uint32 brp = ((btr & CAN_BTR_BRP) >> CAN_BTR_BRP_Pos) + 1u;
+    uint32 tq = ((btr & CAN_BTR_TS1) >> CAN_BTR_TS1_Pos) + ((btr & CAN_BTR_TS2) >> CAN_BTR_TS2_Pos) + 3u;
+
+    return (uint64)CAN_SIM_CYCLES_PER_CLOCK * brp * tq;
+}
+
+/**
+ * @brief       Checks whether a node takes part in bus activity: normal mode, not bus-off
+ * @param       Node: Node index
+ * @return      TRUE if the node is on line
+ */
+static uint8 Can_Sim_OnLine(uint8 Node)
+{
+    const CAN_TypeDef *regs = &Can_Sim_Node[Node].Regs;
+
+    return (uint8)(((regs->MSR & (CAN_MSR_INAK | CAN_MSR_SLAK)) == 0u) && ((regs->ESR & CAN_ESR_BOFF) == 0u));
+}
+
+/**
+ * @brief       Returns the segment a node sends on
+ * @param       Node: Node index
+ * @return      CAN_SIM_BUS or the private segment of the node
+ */
+static uint8 Can_Sim_TxSegment(uint8 Node)
+{
+    if ((Can_Sim_Node[Node].Attached == TRUE) && ((Can_Sim_Node[Node].Regs.BTR & CAN_BTR_SILM) == 0u))
+    {
+        return CAN_SIM_BUS;
+    }
+
+    return CAN_SIM_PRIVATE(Node);
+}
+
+/**
+ * @brief       Returns the segment whose idle time a node counts when joining or recovering from bus-off
+ * @param       Node: Node index
+ * @return      CAN_SIM_BUS or the private segment of the node
+ */
+static uint8 Can_Sim_RxSegment(uint8 Node)
+{
+    uint32 btr = Can_Sim_Node[Node].Regs.BTR;
+
+    if ((Can_Sim_Node[Node].Attached == TRUE) && ((btr & (CAN_BTR_LBKM | CAN_BTR_SILM)) != (CAN_BTR_LBKM | CAN_BTR_SILM)))
+    {
+        return CAN_SIM_BUS;
+    }
+
+    return CAN_SIM_PRIVATE(Node);
+}
+
+/**
+ * @brief       Checks whether a node sends or receives the frame currently on a segment
+ * @param       Node: Node index
+ * @return      TRUE if the node is busy with a frame
+ */
+static uint8 Can_Sim_InFrame(uint8 Node)
+{
+    uint8 segment;
+
+    for (segment = 0u; segment < CAN_SIM_SEGMENT_MAX; segment++)
+    {
+        if ((Can_Sim_Segment[segment].Busy == TRUE) &&
+            ((Can_Sim_Segment[segment].Tx == Node) || ((Can_Sim_Segment[segment].Receivers & (1u << Node)) != 0u)))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief       Returns the arbitration key of a mailbox, a lower key wins: base ID, SRR/RTR, IDE, ID extension, RTR
+ * @param       Tir: TIR of the mailbox
+ * @return      Arbitration key
+ */
+static uint32 Can_Sim_Key(uint32 Tir)
+{
+    uint32 rtr = ((Tir & CAN_TI0R_RTR) != 0u) ? 1u : 0u;
+    uint32 exid = Tir >> CAN_TI0R_EXID_Pos;
+
+    if ((Tir & CAN_TI0R_IDE) != 0u)
+    {
+        return ((exid >> 18) << 21) | (1u << 20) | (1u << 19) | ((exid & 0x3FFFFu) << 1) | rtr;
+    }
+
+    return ((Tir >> CAN_TI0R_STID_Pos) << 21) | (rtr << 20);
+}
+
+/**
+ * @brief       Selects the pending mailbox a node sends next: lowest identifier, or oldest request with TXFP
+ * @param       Node: Node index
+ * @return      Mailbox index, CAN_SIM_MAILBOX_MAX if none is pending
+ */
+static uint8 Can_Sim_NextMailbox(uint8 Node)
+{
+    const Can_SimNodeType *node = &Can_Sim_Node[Node];
+    uint8 best = CAN_SIM_MAILBOX_MAX;
+    uint8 mailbox;
+
+    for (mailbox = 0u; mailbox < CAN_SIM_MAILBOX_MAX; mailbox++)
+    {
+        if ((node->Regs.sTxMailBox[mailbox].TIR & CAN_TI0R_TXRQ) == 0u)
+        {
+            continue;
+        }
+        if ((best == CAN_SIM_MAILBOX_MAX) ||
+            (((node->Regs.MCR & CAN_MCR_TXFP) != 0u) ? (node->Sequence[mailbox] < node->Sequence[best]) :
+             (Can_Sim_Key(node->Regs.sTxMailBox[mailbox].TIR) < Can_Sim_Key(node->Regs.sTxMailBox[best].TIR))))
+        {
+            best = mailbox;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief       Updates TSR.CODE: the next empty mailbox, or the lowest priority one when all are pending
+ * @param       Node: Node index
+ * @return      void
+ */
+static void Can_Sim_UpdateCode(uint8 Node)
+{
+    Can_SimNodeType *node = &Can_Sim_Node[Node];
+    uint32 tsr = node->Regs.TSR;
+    uint8 code = 0u;
+    uint8 mailbox;
+
+    if ((tsr & CAN_TSR_TME) != 0u)
+    {
+        while ((tsr & (CAN_TSR_TME0 << code)) == 0u)
+        {
+            code++;
+        }
+    }
+    else
+    {
+        for (mailbox = 1u; mailbox < CAN_SIM_MAILBOX_MAX; mailbox++)
+        {
+            if (((node->Regs.MCR & CAN_MCR_TXFP) != 0u) ? (node->Sequence[mailbox] > node->Sequence[code]) :
+                (Can_Sim_Key(node->Regs.sTxMailBox[mailbox].TIR) > Can_Sim_Key(node->Regs.sTxMailBox[code].TIR)))
+            {
+                code = mailbox;
+            }
+        }
+    }
+
+    node->Regs.TSR = (tsr & ~CAN_TSR_CODE) | ((uint32_t)code << CAN_TSR_CODE_Pos);
+}
+
+/**
+ * @brief       Ends the request of a mailbox: RQCP with the outcome, the mailbox becomes empty
+ * @param       Node: Node index
+ * @param       Mailbox: Mailbox index
+ * @param       Status: TXOK, ALST or TERR of mailbox 0, or 0 for an abort
+ * @return      void
+ */
+static void Can_Sim_CompleteMailbox(uint8 Node, uint8 Mailbox, uint32 Status)
+{
+    Can_SimNodeType *node = &Can_Sim_Node[Node];
+
+    node->Regs.sTxMailBox[Mailbox].TIR &= ~CAN_TI0R_TXRQ;
+    node->Regs.TSR = (node->Regs.TSR & ~CAN_SIM_TSR_MB(CAN_SIM_TSR_STATUS | CAN_TSR_ABRQ0, Mailbox)) |
+                     CAN_SIM_TSR_MB(CAN_TSR_RQCP0 | Status, Mailbox) | (CAN_TSR_TME0 << Mailbox);
+    node->AbortMask &= (uint8)~(1u << Mailbox);
+    Can_Sim_UpdateCode(Node);
+}
+
+/**
+ * @brief       Writes the error counters into ESR, updates the warning, passive and bus-off flags and sets ERRI
+ *              for the flags enabled in IER
+ * @param       Node: Node index
+ * @param       Lec: Last error code written by the hardware, 0 after a successful frame
+ * @return      void
+ */
+static void Can_Sim_UpdateErrors(uint8 Node, uint32 Lec)
+{
+    Can_SimNodeType *node = &Can_Sim_Node[Node];
+    uint32 old = node->Regs.ESR;
+    uint32 esr = old & CAN_ESR_BOFF;
+    uint32 raised;
+    uint32 erri = 0u;
+
+    if (node->Tec > 255u)
+    {
+        esr |= CAN_ESR_BOFF;
+    }
+    if ((node->Tec >= 96u) || (node->Rec >= 96u))
+    {
+        esr |= CAN_ESR_EWGF;
+    }
+    if ((node->Tec > 127u) || (node->Rec > 127u))
+    {
+        esr |= CAN_ESR_EPVF;
+    }
+    esr |= ((node->Tec > 255u) ? 255u : node->Tec) << CAN_ESR_TEC_Pos;
+    esr |= ((node->Rec > 255u) ? 255u : node->Rec) << CAN_ESR_REC_Pos;
+    esr |= Lec << CAN_ESR_LEC_Pos;
+    node->Regs.ESR = esr;
+
+    raised = esr & ~old;
+    erri |= (((raised & CAN_ESR_EWGF) != 0u) && ((node->Regs.IER & CAN_IER_EWGIE) != 0u)) ? 1u : 0u;
+    erri |= (((raised & CAN_ESR_EPVF) != 0u) && ((node->Regs.IER & CAN_IER_EPVIE) != 0u)) ? 1u : 0u;
+    erri |= (((raised & CAN_ESR_BOFF) != 0u) && ((node->Regs.IER & CAN_IER_BOFIE) != 0u)) ? 1u : 0u;
+    erri |= ((Lec != 0u) && ((node->Regs.IER & CAN_IER_LECIE) != 0u)) ? 1u : 0u;
+    if (erri != 0u)
+    {
+        node->Regs.MSR |= CAN_MSR_ERRI;
+    }
+
+    if ((raised & CAN_ESR_BOFF) != 0u)
+    {
+        /* Off the bus, the pending mailboxes wait. With ABOM the recovery starts at once. */
+        node->Joining = FALSE;
+        node->Recovering = ((node->Regs.MCR & CAN_MCR_ABOM) != 0u) ? TRUE : FALSE;
+        node->Runs = 0u;
+        node->IdleCycles = 0u;
+    }
+}
+
+/**
+ * @brief       Applies the mode requested in MCR once the node is not busy with a frame. Entering
+ *              initialization or sleep mode is immediate, leaving them waits for 11 recessive bits.
+ * @param       Node: Node index
+ * @return      void
+ */
+static void Can_Sim_UpdateMode(uint8 Node)
+{
+    Can_SimNodeType *node = &Can_Sim_Node[Node];
+    uint32 mcr = node->Regs.MCR;
+    uint32 msr = node->Regs.MSR;
+
+    if (Can_Sim_InFrame(Node) == TRUE)
+    {
+        return; /* Taken again at the end of the frame */
+    }
+
+    if ((mcr & CAN_MCR_INRQ) != 0u)
+    {
+        /* A bus-off recovery needs initialization mode to be left again */
+        node->Joining = FALSE;
+        node->Recovering = FALSE;
+        node->Regs.MSR = (msr & ~(CAN_MSR_SLAK | CAN_MSR_SLAKI)) | CAN_MSR_INAK;
+    }
+    else if ((mcr & CAN_MCR_SLEEP) != 0u)
+    {
+        node->Joining = FALSE;
+        node->Recovering = FALSE;
+        if ((msr & CAN_MSR_SLAK) == 0u)
+        {
+            node->Regs.MSR = (msr & ~CAN_MSR_INAK) | CAN_MSR_SLAK | CAN_MSR_SLAKI;
+        }
+    }
+    else if (((msr & (CAN_MSR_INAK | CAN_MSR_SLAK)) != 0u) && (node->Joining == FALSE) && (node->Recovering == FALSE))
+    {
+        if ((node->Regs.ESR & CAN_ESR_BOFF) != 0u)
+        {
+            node->Recovering = TRUE;    /* Recovery requested by software, without ABOM */
+        }
+        else
+        {
+            node->Joining = TRUE;
+        }
+        node->Runs = 0u;
+        node->IdleCycles = 0u;
+    }
+    else
+    {
+        /* Normal mode already, or on its way */
+    }
+}
+
+/**
+ * @brief       Completes joining and bus-off recovery once enough runs of recessive bits have been seen
+ * @param       Node: Node index
+ * @return      void
+ */
+static void Can_Sim_CheckRuns(uint8 Node)
+{
+    Can_SimNodeType *node = &Can_Sim_Node[Node];
+
+    if ((node->Recovering == TRUE) && (node->Runs >= CAN_SIM_RECOVERY_RUNS))
+    {
+        node->Recovering = FALSE;
+        node->Tec = 0u;
+        node->Rec = 0u;
+        node->Regs.ESR &= ~CAN_ESR_BOFF;
+        Can_Sim_UpdateErrors(Node, (node->Regs.ESR & CAN_ESR_LEC) >> CAN_ESR_LEC_Pos);
+        node->Regs.MSR &= ~(CAN_MSR_INAK | CAN_MSR_SLAK | CAN_MSR_SLAKI);
+    }
+
+    if ((node->Joining == TRUE) && (node->Runs >= 1u))
+    {
+        node->Joining = FALSE;
+        node->Regs.MSR &= ~(CAN_MSR_INAK | CAN_MSR_SLAK | CAN_MSR_SLAKI);
+    }
+}
+
+/**
+ * @brief       Builds the bits of a frame from start of frame to the end of the CRC and counts them stuffed
+ * @param       Tir: Identifier in TIR layout
+ * @param       Dlc: Data length code
+ * @param       Data: Data bytes 0-3 and 4-7
+ * @param       ControlBits: Where the stuffed length up to the end of the control field is stored
+ * @return      Stuffed length up to the end of the CRC
+ */
+static uint32 Can_Sim_StuffedBits(uint32 Tir, uint32 Dlc, const uint32* Data, uint32* ControlBits)
+{
+    uint8 bits[128];
+    uint32 count = 0u;
+    uint32 control;
+    uint32 exid = Tir >> CAN_TI0R_EXID_Pos;
+    uint32 rtr = ((Tir & CAN_TI0R_RTR) != 0u) ? 1u : 0u;
+    uint32 bytes = (rtr != 0u) ? 0u : ((Dlc > 8u) ? 8u : Dlc);
+    uint32 crc = 0u;
+    uint32 stuffed = 0u;
+    uint32 run = 0u;
+    uint8 last = 2u;
+    uint32 i;
+    sint32 b;
+
+    bits[count++] = 0u;                                     /* SOF */
+    if ((Tir & CAN_TI0R_IDE) != 0u)
+    {
+        for (b = 28; b >= 18; b--)
+        {
+            bits[count++] = (uint8)((exid >> b) & 1u);
+        }
+        bits[count++] = 1u;                                 /* SRR */
+        bits[count++] = 1u;                                 /* IDE */
+        for (b = 17; b >= 0; b--)
+        {
+            bits[count++] = (uint8)((exid >> b) & 1u);
+        }
+        bits[count++] = (uint8)rtr;
+        bits[count++] = 0u;                                 /* r1 */
+    }
+    else
+    {
+        for (b = 10; b >= 0; b--)
+        {
+            bits[count++] = (uint8)((Tir >> (CAN_TI0R_STID_Pos + (uint32)b)) & 1u);
+        }
+        bits[count++] = (uint8)rtr;
+        bits[count++] = 0u;                                 /* IDE */
+    }
+    bits[count++] = 0u;                                     /* r0 */
+    for (b = 3; b >= 0; b--)
+    {
+        bits[count++] = (uint8)((Dlc >> b) & 1u);
+    }
+    control = count;
+    for (i = 0u; i < bytes; i++)
+    {
+        for (b = 7; b >= 0; b--)
+        {
+            bits[count++] = (uint8)((Data[i / 4u] >> ((8u * (i % 4u)) + (uint32)b)) & 1u);
+        }
+    }
+
+    /* CRC-15, x^15 + x^14 + x^10 + x^8 + x^7 + x^4 + x^3 + 1 */
+    for (i = 0u; i < count; i++)
+    {
+        if ((bits[i] ^ ((crc >> 14) & 1u)) != 0u)
+        {
+            crc = ((crc << 1) & 0x7FFFu) ^ 0x4599u;
+        }
+        else
+        {
+            crc = (crc << 1) & 0x7FFFu;
+        }
+    }
+    for (b = 14; b >= 0; b--)
+    {
+        bits[count++] = (uint8)((crc >> b) & 1u);
+    }
+
+    /* A stuff bit follows every 5 equal bits and starts the next run itself */
+    *ControlBits = control;
+    for (i = 0u; i < count; i++)
+    {
+        if (bits[i] == last)
+        {
+            run++;
+        }
+        else
+        {
+            last = bits[i];
+            run = 1u;
+        }
+        stuffed++;
+        if (run == 5u)
+        {
+            stuffed++;
+            last = (uint8)(last ^ 1u);
+            run = 1u;
+        }
+        if (i + 1u == control)
+        {
+            *ControlBits = stuffed;
+        }
+    }
+
+    return stuffed;
+}
+
+/**
+ * @brief       Runs the acceptance filters of a node over a received identifier. Among the matching filters,
+ *              32-bit ones win over 16-bit ones, identifier lists over masks, then the lower filter number.
+ *              Filter numbers count the banks of each FIFO in bank order, active or not.
+ * @param       Node: Node index
+ * @param       Rir: Identifier in RIR layout
+ * @param       FifoPtr: Where the FIFO of the matching filter is stored
+ * @param       FmiPtr: Where the filter match index is stored
+ * @return      TRUE if a filter accepts the identifier
+ */
+static uint8 Can_Sim_Filter(uint8 Node, uint32 Rir, uint8* FifoPtr, uint8* FmiPtr)
+{
+    const CAN_TypeDef *regs = &Can_Sim_Node[Node].Regs;
+    uint32 word = Rir & ~1u;
+    uint32 half = ((Rir >> CAN_RI0R_STID_Pos) << 5) | (((Rir & CAN_RI0R_RTR) != 0u) ? 0x10u : 0u) |
+                  (((Rir & CAN_RI0R_IDE) != 0u) ? 0x08u : 0u) | ((Rir >> 18) & 0x7u);
+    uint32 number[2] = {0u, 0u};
+    uint32 best = 0xFFFFFFFFu;
+    uint32 rank;
+    uint32 fr[4];
+    uint32 slots;
+    uint32 fifo;
+    uint32 k;
+    uint8 match;
+    uint8 bank;
+
+    if ((regs->FMR & CAN_FMR_FINIT) != 0u)
+    {
+        return FALSE;   /* Reception is off while the filters are being written */
+    }
+
+    for (bank = 0u; bank < CAN_FILTER_BANK_MAX; bank++)
+    {
+        uint32 bit = 1u << bank;
+        uint32 list = ((regs->FM1R & bit) != 0u) ? 1u : 0u;
+        uint32 wide = ((regs->FS1R & bit) != 0u) ? 1u : 0u;
+
+        fifo = ((regs->FFA1R & bit) != 0u) ? 1u : 0u;
+        slots = (wide != 0u) ? (1u + list) : (2u + (2u * list));
+        fr[0] = regs->sFilterRegister[bank].FR1 & 0xFFFFu;
+        fr[1] = regs->sFilterRegister[bank].FR1 >> 16;
+        fr[2] = regs->sFilterRegister[bank].FR2 & 0xFFFFu;
+        fr[3] = regs->sFilterRegister[bank].FR2 >> 16;
+
+        for (k = 0u; ((regs->FA1R & bit) != 0u) && (k < slots); k++)
+        {
+            if (wide != 0u)
+            {
+                match = (list != 0u) ?
+                        (uint8)(word == ((((k == 0u) ? regs->sFilterRegister[bank].FR1 : regs->sFilterRegister[bank].FR2)) & ~1u)) :
+                        (uint8)(((word ^ regs->sFilterRegister[bank].FR1) & regs->sFilterRegister[bank].FR2 & ~1u) == 0u);
+            }
+            else
+            {
+                /* 16-bit list: FR1 low, FR1 high, FR2 low, FR2 high. 16-bit mask: ID/mask in FR1, then FR2. */
+                match = (list != 0u) ? (uint8)(half == fr[k]) : (uint8)(((half ^ fr[2u * k]) & fr[(2u * k) + 1u]) == 0u);
+            }
+
+            rank = ((((1u - wide) << 1) | (1u - list)) << 16) | (number[fifo] + k);
+            if ((match == TRUE) && (rank < best))
+            {
+                best = rank;
+                *FifoPtr = (uint8)fifo;
+                *FmiPtr = (uint8)(number[fifo] + k);
+            }
+        }
+        number[fifo] += slots;
+    }
+
+    return (uint8)(best != 0xFFFFFFFFu);
+}
+
+/**
+ * @brief       Refreshes RFxR and the output mailbox of a receive FIFO
+ * @param       Node: Node index
+ * @param       Fifo: Receive FIFO (0 or 1)
+ * @return      void
+ */
+static void Can_Sim_UpdateFifo(uint8 Node, uint8 Fifo)
+{
+    Can_SimNodeType *node = &Can_Sim_Node[Node];
+    volatile uint32_t *rfr = (Fifo == 0u) ? &node->Regs.RF0R : &node->Regs.RF1R;
+
+    *rfr = (*rfr & (CAN_RF0R_FULL0 | CAN_RF0R_FOVR0)) | node->Fifo[Fifo].Count;
+    node->Regs.sFIFOMailBox[Fifo] = node->Fifo[Fifo].Mailbox[0];
+}
+
+/**
+ * @brief       Stores a received frame in the FIFO of the filter that accepts it
+ * @param       Node: Receiving node
+ * @param       Frame: Frame on the segment
+ * @return      void
+ */
+static void Can_Sim_Receive(uint8 Node, const Can_SimFrameType* Frame)
+{
+    Can_SimNodeType *node = &Can_Sim_Node[Node];
+    Can_SimFifoType *fifo;
+    CAN_FIFOMailBox_TypeDef *slot;
+    volatile uint32_t *rfr;
+    uint8 index;
+    uint8 fmi;
+
+    if (Can_Sim_Filter(Node, Frame->Rir, &index, &fmi) == FALSE)
+    {
+        return;
+    }
+
+    fifo = &node->Fifo[index];
+    rfr = (index == 0u) ? &node->Regs.RF0R : &node->Regs.RF1R;
+    if (fifo->Count == CAN_SIM_FIFO_DEPTH)
+    {
+        /* Overrun: the new frame is lost in locked mode, otherwise it replaces the last one */
+        *rfr |= CAN_RF0R_FOVR0;
+        if ((node->Regs.MCR & CAN_MCR_RFLM) != 0u)
+        {
+            return;
+        }
+        slot = &fifo->Mailbox[CAN_SIM_FIFO_DEPTH - 1u];
+    }
+    else
+    {
+        slot = &fifo->Mailbox[fifo->Count];
+        fifo->Count++;
+        if (fifo->Count == CAN_SIM_FIFO_DEPTH)
+        {
+            *rfr |= CAN_RF0R_FULL0;
+        }
+    }
+
+    slot->RIR = Frame->Rir;
+    slot->RDTR = Frame->Dlc | ((uint32_t)fmi << CAN_RDT0R_FMI_Pos) | ((uint32_t)Frame->Time[Node] << CAN_RDT0R_TIME_Pos);
+    slot->RDLR = Frame->Data[0];
+    slot->RDHR = Frame->Data[1];
+    Can_Sim_UpdateFifo(Node, index);
+}
+
+/**
+ * @brief       Starts the next frame on an idle segment, if any node there has a pending mailbox
+ * @param       Segment: Segment index
+ * @return      TRUE if a frame was started
+ */
+static uint8 Can_Sim_StartFrame(uint8 Segment)
+{
+    Can_SimFrameType *frame = &Can_Sim_Segment[Segment];
+    Can_SimNodeType *node;
+    CAN_TxMailBox_TypeDef *mailbox;
+    uint8 candidate[CAN_SIM_NODE_MAX];
+    uint8 contenders = 0u;
+    uint8 winner = CAN_SIM_NODE_MAX;
+    uint32 key = 0u;
+    uint32 active = 0u;
+    uint32 acknowledge = 0u;
+    uint32 controlBits;
+    uint32 bits;
+    uint64 cyclesPerBit;
+    uint8 n;
+
+    if (frame->Busy == TRUE)
+    {
+        return FALSE;
+    }
+
+    for (n = 0u; n < CAN_SIM_NODE_MAX; n++)
+    {
+        candidate[n] = CAN_SIM_MAILBOX_MAX;
+        node = &Can_Sim_Node[n];
+        if ((Can_Sim_TxSegment(n) != Segment) || (Can_Sim_OnLine(n) == FALSE) || (node->SuspendUntil > Can_Sim_Now))
+        {
+            continue;
+        }
+        candidate[n] = Can_Sim_NextMailbox(n);
+        if (candidate[n] == CAN_SIM_MAILBOX_MAX)
+        {
+            continue;
+        }
+        contenders++;
+        if ((winner == CAN_SIM_NODE_MAX) || (Can_Sim_Key(node->Regs.sTxMailBox[candidate[n]].TIR) < key))
+        {
+            winner = n;
+            key = Can_Sim_Key(node->Regs.sTxMailBox[candidate[n]].TIR);
+        }
+    }
+
+    if (winner == CAN_SIM_NODE_MAX)
+    {
+        return FALSE;
+    }
+
+    /* The losers keep their request, or give it up without automatic retransmission */
+    if (contenders > 1u)
+    {
+        Can_Sim_Stats.Arbitrations++;
+    }
+    for (n = 0u; n < CAN_SIM_NODE_MAX; n++)
+    {
+        if ((candidate[n] == CAN_SIM_MAILBOX_MAX) || (n == winner))
+        {
+            continue;
+        }
+        Can_Sim_Stats.ArbitrationLosses++;
+        node = &Can_Sim_Node[n];
+        if (((node->Regs.MCR & CAN_MCR_NART) != 0u) || ((node->AbortMask & (1u << candidate[n])) != 0u))
+        {
+            Can_Sim_CompleteMailbox(n, candidate[n], CAN_TSR_ALST0);
+        }
+        else
+        {
+            node->Regs.TSR = (node->Regs.TSR & ~CAN_SIM_TSR_MB(CAN_TSR_TERR0, candidate[n])) |
+                             CAN_SIM_TSR_MB(CAN_TSR_ALST0, candidate[n]);
+        }
+    }
+
+    node = &Can_Sim_Node[winner];
+    mailbox = &node->Regs.sTxMailBox[candidate[winner]];
+    frame->Busy = TRUE;
+    frame->Start = Can_Sim_Now;
+    frame->Tx = winner;
+    frame->Mailbox = candidate[winner];
+    frame->Rir = mailbox->TIR & ~CAN_TI0R_TXRQ;
+    frame->Dlc = mailbox->TDTR & CAN_TDT0R_DLC;
+    frame->Data[0] = ((frame->Rir & CAN_TI0R_RTR) != 0u) ? 0u : mailbox->TDLR;
+    frame->Data[1] = ((frame->Rir & CAN_TI0R_RTR) != 0u) ? 0u : mailbox->TDHR;
+    frame->Receivers = 0u;
+    frame->Matched = 0u;
+    cyclesPerBit = Can_Sim_CyclesPerBit(winner);
+
+    /* Start of frame: TIME capture, wakeup of sleeping nodes, end of the recessive runs */
+    for (n = 0u; n < CAN_SIM_NODE_MAX; n++)
+    {
+        frame->Time[n] = Can_Sim_Node[n].Time;
+        if (Can_Sim_RxSegment(n) != Segment)
+        {
+            continue;
+        }
+        Can_Sim_Node[n].IdleCycles = 0u;
+        if ((Can_Sim_Node[n].Regs.MSR & CAN_MSR_SLAK) != 0u)
+        {
+            Can_Sim_Node[n].Regs.MSR |= CAN_MSR_WKUI;
+            if ((Can_Sim_Node[n].Regs.MCR & CAN_MCR_AWUM) != 0u)
+            {
+                Can_Sim_Node[n].Regs.MCR &= ~CAN_MCR_SLEEP;
+                Can_Sim_UpdateMode(n);
+            }
+        }
+    }
+    mailbox->TDTR = (mailbox->TDTR & ~CAN_TDT0R_TIME) | ((uint32_t)frame->Time[winner] << CAN_TDT0R_TIME_Pos);
+
+    /* Receivers on the bus, the transmitter itself in loop back mode */
+    for (n = 0u; (Segment == CAN_SIM_BUS) && (n < CAN_SIM_NODE_MAX); n++)
+    {
+        if ((n == winner) || (Can_Sim_OnLine(n) == FALSE) || (Can_Sim_Node[n].Attached == FALSE) ||
+            ((Can_Sim_Node[n].Regs.BTR & CAN_BTR_LBKM) != 0u))
+        {
+            continue;
+        }
+        frame->Receivers |= 1u << n;
+        if (Can_Sim_CyclesPerBit(n) == cyclesPerBit)
+        {
+            frame->Matched |= 1u << n;
+        }
+        else if (((Can_Sim_Node[n].Regs.ESR & CAN_ESR_EPVF) == 0u) && ((Can_Sim_Node[n].Regs.BTR & CAN_BTR_SILM) == 0u))
+        {
+            active |= 1u << n;  /* Sends an active error flag */
+        }
+        else
+        {
+            /* Error passive or silent, the frame goes on */
+        }
+        if (((frame->Matched & (1u << n)) != 0u) && ((Can_Sim_Node[n].Regs.BTR & CAN_BTR_SILM) == 0u))
+        {
+            acknowledge |= 1u << n; /* Silent receivers take the frame but never acknowledge it */
+        }
+    }
+
+    bits = Can_Sim_StuffedBits(frame->Rir, frame->Dlc, frame->Data, &controlBits);
+    if (node->InjectErrors > 0u)
+    {
+        node->InjectErrors--;
+        frame->Result = CAN_SIM_RESULT_ERROR;
+    }
+    else if (active != 0u)
+    {
+        frame->Result = CAN_SIM_RESULT_ERROR;
+    }
+    else if (((node->Regs.BTR & CAN_BTR_LBKM) == 0u) && (acknowledge == 0u))
+    {
+        frame->Result = CAN_SIM_RESULT_ACK;
+    }
+    else
+    {
+        frame->Result = CAN_SIM_RESULT_OK;
+    }
+
+    switch (frame->Result)
+    {
+        case CAN_SIM_RESULT_OK:
+            bits += CAN_SIM_TRAILER_BITS;
+            break;
+        case CAN_SIM_RESULT_ACK:
+            bits += 2u + CAN_SIM_ERROR_BITS;    /* Error flag from the ACK delimiter on */
+            break;
+        default:
+            bits = controlBits + CAN_SIM_ERROR_BITS;
+            break;
+    }
+    frame->End = Can_Sim_Now + (bits * cyclesPerBit);
+
+    return TRUE;
+}
+
+/**
+ * @brief       Completes the frame on a segment: outcome of the transmit mailbox, reception, error counters
+ *              and the mode requests that waited for the frame
+ * @param       Segment: Segment index
+ * @return      void
+ */
+static void Can_Sim_EndFrame(uint8 Segment)
+{
+    Can_SimFrameType *frame = &Can_Sim_Segment[Segment];
+    Can_SimNodeType *tx = &Can_Sim_Node[frame->Tx];
+    uint8 mailbox = frame->Mailbox;
+    uint32 txLec;
+    uint32 rxLec;
+    uint8 n;
+
+    frame->Busy = FALSE;
+    if (Segment == CAN_SIM_BUS)
+    {
+        Can_Sim_Stats.BusyCycles += frame->End - frame->Start;
+    }
+
+    if (frame->Result == CAN_SIM_RESULT_OK)
+    {
+        Can_Sim_Stats.Frames++;
+        if (tx->Tec > 0u)
+        {
+            tx->Tec--;
+        }
+        Can_Sim_CompleteMailbox(frame->Tx, mailbox, CAN_TSR_TXOK0);
+        Can_Sim_UpdateErrors(frame->Tx, 0u);
+        if ((tx->Regs.BTR & CAN_BTR_LBKM) != 0u)
+        {
+            Can_Sim_Receive(frame->Tx, frame);
+        }
+    }
+    else
+    {
+        Can_Sim_Stats.ErrorFrames++;
+        txLec = (frame->Result == CAN_SIM_RESULT_ACK) ? CAN_SIM_LEC_ACK : CAN_SIM_LEC_BIT_RECESSIVE;
+        /* An error passive transmitter that misses the acknowledge keeps its counter */
+        if ((frame->Result != CAN_SIM_RESULT_ACK) || ((tx->Regs.ESR & CAN_ESR_EPVF) == 0u))
+        {
+            tx->Tec += 8u;
+        }
+        if (((tx->Regs.MCR & CAN_MCR_NART) != 0u) || ((tx->AbortMask & (1u << mailbox)) != 0u))
+        {
+            Can_Sim_CompleteMailbox(frame->Tx, mailbox, CAN_TSR_TERR0);
+        }
+        else
+        {
+            tx->Regs.TSR = (tx->Regs.TSR & ~CAN_SIM_TSR_MB(CAN_TSR_ALST0, mailbox)) | CAN_SIM_TSR_MB(CAN_TSR_TERR0, mailbox);
+        }
+        Can_Sim_UpdateErrors(frame->Tx, txLec);
+    }
+
+    if (((tx->Regs.ESR & CAN_ESR_EPVF) != 0u) && ((tx->Regs.ESR & CAN_ESR_BOFF) == 0u))
+    {
+        tx->SuspendUntil = frame->End + (CAN_SIM_SUSPEND_BITS * Can_Sim_CyclesPerBit(frame->Tx));
+    }
+
+    for (n = 0u; n < CAN_SIM_NODE_MAX; n++)
+    {
+        if ((frame->Receivers & (1u << n)) == 0u)
+        {
+            continue;
+        }
+        if ((frame->Result == CAN_SIM_RESULT_OK) && ((frame->Matched & (1u << n)) != 0u))
+        {
+            if (Can_Sim_Node[n].Rec > 127u)
+            {
+                Can_Sim_Node[n].Rec = 120u;
+            }
+            else if (Can_Sim_Node[n].Rec > 0u)
+            {
+                Can_Sim_Node[n].Rec--;
+            }
+            else
+            {
+                /* Error free */
+            }
+            Can_Sim_Receive(n, frame);
+            Can_Sim_UpdateErrors(n, 0u);
+        }
+        else if ((frame->Result == CAN_SIM_RESULT_ACK) && ((frame->Matched & (1u << n)) != 0u) &&
+                 ((tx->Regs.ESR & CAN_ESR_EPVF) != 0u))
+        {
+            /* Silent receiver of an error passive transmitter: its passive error flag is not seen */
+        }
+        else
+        {
+            rxLec = ((frame->Matched & (1u << n)) != 0u) ?
+                    ((frame->Result == CAN_SIM_RESULT_ACK) ? CAN_SIM_LEC_FORM : CAN_SIM_LEC_STUFF) : CAN_SIM_LEC_STUFF;
+            if (Can_Sim_Node[n].Rec < 255u)
+            {
+                Can_Sim_Node[n].Rec++;
+            }
+            Can_Sim_UpdateErrors(n, rxLec);
+        }
+    }
+
+    /* The frame ends with 11 recessive bits, ACK delimiter, end of frame and intermission */
+    for (n = 0u; n < CAN_SIM_NODE_MAX; n++)
+    {
+        if (Can_Sim_RxSegment(n) == Segment)
+        {
+            Can_Sim_Node[n].Runs++;
+            Can_Sim_Node[n].IdleCycles = 0u;
+        }
+        if ((n == frame->Tx) || ((frame->Receivers & (1u << n)) != 0u))
+        {
+            Can_Sim_UpdateMode(n);
+        }
+        Can_Sim_CheckRuns(n);
+    }
+}
+
+/**
+ * @brief       Returns the next point in time something happens: the end of a frame, a node completing a run
+ *              of recessive bits, the end of a transmission suspend
+ * @param       Limit: Latest point in time of interest
+ * @return      Next point in time, at most Limit
+ */
+static uint64 Can_Sim_NextEvent(uint64 Limit)
+{
+    uint64 next = Limit;
+    uint64 run;
+    uint8 segment;
+    uint8 n;
+
+    for (segment = 0u; segment < CAN_SIM_SEGMENT_MAX; segment++)
+    {
+        if ((Can_Sim_Segment[segment].Busy == TRUE) && (Can_Sim_Segment[segment].End < next))
+        {
+            next = Can_Sim_Segment[segment].End;
+        }
+    }
+
+    for (n = 0u; n < CAN_SIM_NODE_MAX; n++)
+    {
+        if (((Can_Sim_Node[n].Joining == TRUE) || (Can_Sim_Node[n].Recovering == TRUE)) &&
+            (Can_Sim_Segment[Can_Sim_RxSegment(n)].Busy == FALSE))
+        {
+            run = (CAN_SIM_RUN_BITS * Can_Sim_CyclesPerBit(n)) - Can_Sim_Node[n].IdleCycles;
+            if (Can_Sim_Now + run < next)
+            {
+                next = Can_Sim_Now + run;
+            }
+        }
+        if ((Can_Sim_Node[n].SuspendUntil > Can_Sim_Now) && (Can_Sim_Node[n].SuspendUntil < next))
+        {
+            next = Can_Sim_Node[n].SuspendUntil;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief       Moves the simulated time forward, with no frame starting or ending in between
+ * @param       Time: New point in time
+ * @return      void
+ */
+static void Can_Sim_Advance(uint64 Time)
+{
+    Can_SimNodeType *node;
+    uint64 elapsed = Time - Can_Sim_Now;
+    uint64 cyclesPerBit;
+    uint8 n;
+
+    for (n = 0u; n < CAN_SIM_NODE_MAX; n++)
+    {
+        node = &Can_Sim_Node[n];
+        cyclesPerBit = Can_Sim_CyclesPerBit(n);
+
+        node->TimeCycles += elapsed;
+        node->Time = (uint16)(node->Time + (node->TimeCycles / cyclesPerBit));
+        node->TimeCycles %= cyclesPerBit;
+
+        if (((node->Joining == TRUE) || (node->Recovering == TRUE)) &&
+            (Can_Sim_Segment[Can_Sim_RxSegment(n)].Busy == FALSE))
+        {
+            node->IdleCycles += elapsed;
+            while (node->IdleCycles >= (CAN_SIM_RUN_BITS * cyclesPerBit))
+            {
+                node->IdleCycles -= CAN_SIM_RUN_BITS * cyclesPerBit;
+                node->Runs++;
+            }
+        }
+    }
+
+    Can_Sim_Now = Time;
+    Cmsis_Sim_Dwt.CYCCNT = (uint32_t)Can_Sim_Now;
+}
+
+/**
+ * @brief       Checks whether an interrupt line of a node is raised
+ * @param       Node: Node index
+ * @param       Line: CAN_SIM_IRQ_xxx
+ * @return      TRUE if one of the flags of the line is set and enabled in IER
+ */
+static uint8 Can_Sim_IrqPending(uint8 Node, uint8 Line)
+{
+    const CAN_TypeDef *regs = &Can_Sim_Node[Node].Regs;
+    uint32 ier = regs->IER;
+    uint32 rfr;
+
+    switch (Line)
+    {
+        case CAN_SIM_IRQ_TX:
+            return (uint8)(((ier & CAN_IER_TMEIE) != 0u) &&
+                           ((regs->TSR & (CAN_TSR_RQCP0 | CAN_SIM_TSR_MB(CAN_TSR_RQCP0, 1u) | CAN_SIM_TSR_MB(CAN_TSR_RQCP0, 2u))) != 0u));
+        case CAN_SIM_IRQ_RX0:
+        case CAN_SIM_IRQ_RX1:
+            rfr = (Line == CAN_SIM_IRQ_RX0) ? regs->RF0R : regs->RF1R;
+            ier >>= (Line == CAN_SIM_IRQ_RX0) ? 0u : 3u;    /* FMPIE1, FFIE1, FOVIE1 follow FOVIE0 */
+            return (uint8)((((ier & CAN_IER_FMPIE0) != 0u) && ((rfr & CAN_RF0R_FMP0) != 0u)) ||
+                           (((ier & CAN_IER_FFIE0) != 0u) && ((rfr & CAN_RF0R_FULL0) != 0u)) ||
+                           (((ier & CAN_IER_FOVIE0) != 0u) && ((rfr & CAN_RF0R_FOVR0) != 0u)));
+        case CAN_SIM_IRQ_SCE:
+            return (uint8)((((ier & CAN_IER_ERRIE) != 0u) && ((regs->MSR & CAN_MSR_ERRI) != 0u)) ||
+                           (((ier & CAN_IER_WKUIE) != 0u) && ((regs->MSR & CAN_MSR_WKUI) != 0u)) ||
+                           (((ier & CAN_IER_SLKIE) != 0u) && ((regs->MSR & CAN_MSR_SLAKI) != 0u)));
+        default:
+            return FALSE;
+    }
+}
+
+/**
+ * @brief       Raises the pending interrupts of all nodes, again as long as handlers leave flags set, at most
+ *              CAN_SIM_ISR_PASSES times so that a handler that never clears its flag cannot hang the simulation
+ * @param       void
+ * @return      void
+ */
+static void Can_Sim_Deliver(void)
+{
+    uint8 pass;
+    uint8 raised = TRUE;
+    uint8 n;
+    uint8 line;
+
+    for (pass = 0u; (pass < CAN_SIM_ISR_PASSES) && (raised == TRUE) && (Cmsis_Sim_Primask == 0u); pass++)
+    {
+        raised = FALSE;
+        for (n = 0u; n < CAN_SIM_NODE_MAX; n++)
+        {
+            for (line = 0u; line < CAN_SIM_IRQ_MAX; line++)
+            {
+                if (Can_Sim_IrqPending(n, line) == TRUE)
+                {
+                    raised = TRUE;
+                    Can_Sim_Isr(n, line);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief       Handles everything that happens at the current point in time: ends of frames, interrupts and
+ *              starts of frames, the latter two until no new frame starts
+ * @param       void
+ * @return      void
+ */
+static void Can_Sim_Step(void)
+{
+    uint8 started = TRUE;
+    uint8 segment;
+    uint8 n;
+
+    for (segment = 0u; segment < CAN_SIM_SEGMENT_MAX; segment++)
+    {
+        if ((Can_Sim_Segment[segment].Busy == TRUE) && (Can_Sim_Segment[segment].End <= Can_Sim_Now))
+        {
+            Can_Sim_EndFrame(segment);
+        }
+    }
+    for (n = 0u; n < CAN_SIM_NODE_MAX; n++)
+    {
+        Can_Sim_CheckRuns(n);
+    }
+
+    while (started == TRUE)
+    {
+        Can_Sim_Deliver();
+        started = FALSE;
+        for (segment = 0u; segment < CAN_SIM_SEGMENT_MAX; segment++)
+        {
+            started |= Can_Sim_StartFrame(segment);
+        }
+    }
+}
+
+/**
+ * @brief       Decodes a register address into its node
+ * @param       Reg: Register address
+ * @param       OffsetPtr: Where the byte offset of the register in its block is stored
+ * @return      Node index, CAN_SIM_NODE_MAX if the address is not in a register block
+ */
+static uint8 Can_Sim_FindNode(volatile uint32_t* Reg, uintptr_t* OffsetPtr)
+{
+    uintptr_t address = (uintptr_t)Reg;
+    uintptr_t base;
+    uint8 n;
+
+    for (n = 0u; n < CAN_SIM_NODE_MAX; n++)
+    {
+        base = (uintptr_t)&Can_Sim_Node[n].Regs;
+        if ((address >= base) && (address < (base + sizeof(CAN_TypeDef))))
+        {
+            *OffsetPtr = address - base;
+            return n;
+        }
+    }
+
+    return CAN_SIM_NODE_MAX;
+}
+
+/**
+ * @brief       Applies a write to TSR: RQCPx clears the status of mailbox x, ABRQx aborts its request. A frame
+ *              already on the bus is not aborted, its abort takes effect only if it fails.
+ * @param       Node: Node index
+ * @param       Value: Value written
+ * @return      void
+ */
+static void Can_Sim_WriteTsr(uint8 Node, uint32 Value)
+{
+    Can_SimNodeType *node = &Can_Sim_Node[Node];
+    const Can_SimFrameType *frame;
+    uint8 mailbox;
+    uint8 segment;
+    uint8 onBus;
+
+    for (mailbox = 0u; mailbox < CAN_SIM_MAILBOX_MAX; mailbox++)
+    {
+        if ((Value & CAN_SIM_TSR_MB(CAN_TSR_RQCP0, mailbox)) != 0u)
+        {
+            node->Regs.TSR &= ~CAN_SIM_TSR_MB(CAN_SIM_TSR_STATUS, mailbox);
+        }
+        else
+        {
+            node->Regs.TSR &= ~(Value & CAN_SIM_TSR_MB(CAN_SIM_TSR_STATUS, mailbox));
+        }
+
+        if (((Value & CAN_SIM_TSR_MB(CAN_TSR_ABRQ0, mailbox)) == 0u) ||
+            ((node->Regs.sTxMailBox[mailbox].TIR & CAN_TI0R_TXRQ) == 0u))
+        {
+            continue;
+        }
+
+        onBus = FALSE;
+        for (segment = 0u; segment < CAN_SIM_SEGMENT_MAX; segment++)
+        {
+            frame = &Can_Sim_Segment[segment];
+            if ((frame->Busy == TRUE) && (frame->Tx == Node) && (frame->Mailbox == mailbox))
+            {
+                onBus = TRUE;
+            }
+        }
+        if (onBus == TRUE)
+        {
+            node->AbortMask |= (uint8)(1u << mailbox);
+            node->Regs.TSR |= CAN_SIM_TSR_MB(CAN_TSR_ABRQ0, mailbox);
+        }
+        else
+        {
+            Can_Sim_CompleteMailbox(Node, mailbox, 0u);
+        }
+    }
+}
+
+/**
+ * @brief       Applies a write to RFxR: RFOM releases the output mailbox, FULL and FOVR are cleared by writing 1
+ * @param       Node: Node index
+ * @param       Fifo: Receive FIFO (0 or 1)
+ * @param       Value: Value written
+ * @return      void
+ */
+static void Can_Sim_WriteRfr(uint8 Node, uint8 Fifo, uint32 Value)
+{
+    Can_SimFifoType *fifo = &Can_Sim_Node[Node].Fifo[Fifo];
+    volatile uint32_t *rfr = (Fifo == 0u) ? &Can_Sim_Node[Node].Regs.RF0R : &Can_Sim_Node[Node].Regs.RF1R;
+    uint8 i;
+
+    *rfr &= ~(Value & (CAN_RF0R_FULL0 | CAN_RF0R_FOVR0));
+
+    if (((Value & CAN_RF0R_RFOM0) != 0u) && (fifo->Count > 0u))
+    {
+        for (i = 1u; i < fifo->Count; i++)
+        {
+            fifo->Mailbox[i - 1u] = fifo->Mailbox[i];
+        }
+        fifo->Count--;
+    }
+
+    Can_Sim_UpdateFifo(Node, Fifo);
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets every node to the bxCAN reset state (sleep mode, filters in initialization), attaches
+ *              them all to the bus and sets the simulated time to 0. Call it before Can_Init().
+ * @param       void
+ * @return      void
+ */
+void Can_Sim_Init(void)
+{
+    static const Can_SimNodeType reset = {0};
+    static const Can_SimFrameType idle = {0};
+    Can_SimNodeType *node;
+    uint8 n;
+
+    for (n = 0u; n < CAN_SIM_SEGMENT_MAX; n++)
+    {
+        Can_Sim_Segment[n] = idle;
+    }
+
+    for (n = 0u; n < CAN_SIM_NODE_MAX; n++)
+    {
+        node = &Can_Sim_Node[n];
+        *node = reset;
+        node->Regs.MCR = 0x00010002u;                           /* DBF, SLEEP */
+        node->Regs.MSR = 0x00000C02u;                           /* SLAK, RX, SAMP */
+        node->Regs.TSR = CAN_TSR_TME;
+        node->Regs.BTR = 0x01230000u;
+        node->Regs.FMR = 0x2A1C0E01u;                           /* FINIT, CAN2SB = 14 */
+        node->Attached = TRUE;
+        node->Time = (uint16)(n * 0x2F1Bu);                     /* Each node with its own counter phase */
+    }
+
+    Can_Sim_Stats = (Can_SimBusStatsType){0};
+    Can_Sim_Now = 0u;
+    Can_Sim_Sequence = 0u;
+    Cmsis_Sim_Dwt.CYCCNT = 0u;
+    Cmsis_Sim_Primask = 0u;
+}
+
+/**
+ * @brief       Returns the register block of a node
+ * @param       Node: Node index, the CAN controller index of the driver
+ * @return      Register block, NULL_PTR if the node does not exist
+ */
+CAN_TypeDef* Can_Sim_GetRegs(uint8 Node)
+{
+    if (Node >= CAN_SIM_NODE_MAX)
+    {
+        return NULL_PTR;
+    }
+
+    return &Can_Sim_Node[Node].Regs;
+}
+
+/**
+ * @brief       Applies a register write with its hardware side effects
+ * @param       Reg: Register of one of the nodes
+ * @param       Value: Value written by the driver
+ * @return      void
+ */
+void Can_Sim_WriteReg(volatile uint32_t* Reg, uint32 Value)
+{
+    Can_SimNodeType *node;
+    uintptr_t offset;
+    uint8 n = Can_Sim_FindNode(Reg, &offset);
+    uint8 mailbox;
+
+    if (n == CAN_SIM_NODE_MAX)
+    {
+        *Reg = (uint32_t)Value;
+        return;
+    }
+    node = &Can_Sim_Node[n];
+
+    if (offset == offsetof(CAN_TypeDef, MCR))
+    {
+        node->Regs.MCR = Value & ~CAN_MCR_RESET;
+        Can_Sim_UpdateMode(n);
+    }
+    else if (offset == offsetof(CAN_TypeDef, MSR))
+    {
+        node->Regs.MSR &= ~(Value & (CAN_MSR_ERRI | CAN_MSR_WKUI | CAN_MSR_SLAKI));
+    }
+    else if (offset == offsetof(CAN_TypeDef, TSR))
+    {
+        Can_Sim_WriteTsr(n, Value);
+    }
+    else if (offset == offsetof(CAN_TypeDef, RF0R))
+    {
+        Can_Sim_WriteRfr(n, 0u, Value);
+    }
+    else if (offset == offsetof(CAN_TypeDef, RF1R))
+    {
+        Can_Sim_WriteRfr(n, 1u, Value);
+    }
+    else if (offset == offsetof(CAN_TypeDef, ESR))
+    {
+        node->Regs.ESR = (node->Regs.ESR & ~CAN_ESR_LEC) | (Value & CAN_ESR_LEC);
+    }
+    else if ((offset >= offsetof(CAN_TypeDef, sTxMailBox)) && (offset < offsetof(CAN_TypeDef, sFIFOMailBox)) &&
+             (((offset - offsetof(CAN_TypeDef, sTxMailBox)) % sizeof(CAN_TxMailBox_TypeDef)) == 0u))
+    {
+        /* TIR: a full mailbox ignores writes, TXRQ makes an empty one pending and, as in RM0351, clears the
+           RQCP, TXOK, ALST and TERR flags left by its previous request */
+        mailbox = (uint8)((offset - offsetof(CAN_TypeDef, sTxMailBox)) / sizeof(CAN_TxMailBox_TypeDef));
+        if ((node->Regs.TSR & (CAN_TSR_TME0 << mailbox)) != 0u)
+        {
+            node->Regs.sTxMailBox[mailbox].TIR = Value;
+            if ((Value & CAN_TI0R_TXRQ) != 0u)
+            {
+                node->Regs.TSR &= ~((CAN_TSR_TME0 << mailbox) | CAN_SIM_TSR_MB(CAN_SIM_TSR_STATUS, mailbox));
+                node->Sequence[mailbox] = ++Can_Sim_Sequence;
+                Can_Sim_UpdateCode(n);
+            }
+        }
+    }
+    else
+    {
+        *Reg = (uint32_t)Value;
+    }
+}
+
+/**
+ * @brief       Advances the simulated time
+ * @param       Cycles: CPU cycles to simulate
+ * @return      void
+ */
+void Can_Sim_Run(uint64 Cycles)
+{
+    uint64 end = Can_Sim_Now + Cycles;
+
+    for (;;)
+    {
+        Can_Sim_Step();
+        if (Can_Sim_Now >= end)
+        {
+            break;
+        }
+        Can_Sim_Advance(Can_Sim_NextEvent(end));
+    }
+}
+
+/**
+ * @brief       Returns the simulated time
+ * @param       void
+ * @return      CPU cycles since Can_Sim_Init()
+ */
+uint64 Can_Sim_GetTime(void)
+{
+    return Can_Sim_Now;
+}
+
+/**
+ * @brief       Connects a node to the bus or disconnects it
+ * @param       Node: Node index
+ * @param       Attached: TRUE to connect, FALSE to disconnect
+ * @return      void
+ */
+void Can_Sim_SetAttached(uint8 Node, uint8 Attached)
+{
+    if (Node < CAN_SIM_NODE_MAX)
+    {
+        Can_Sim_Node[Node].Attached = (Attached == FALSE) ? FALSE : TRUE;
+    }
+}
+
+/**
+ * @brief       Makes the next transmissions of a node fail with a bit error
+ * @param       Node: Node index
+ * @param       Count: Number of transmissions that fail
+ * @return      void
+ */
+void Can_Sim_InjectErrors(uint8 Node, uint32 Count)
+{
+    if (Node < CAN_SIM_NODE_MAX)
+    {
+        Can_Sim_Node[Node].InjectErrors = Count;
+    }
+}
+
+/**
+ * @brief       Returns the activity of the bus
+ * @param       StatsPtr: Where the counters are stored
+ * @return      void
+ */
+void Can_Sim_GetBusStats(Can_SimBusStatsType* StatsPtr)
+{
+    if (StatsPtr != NULL_PTR)
+    {
+        *StatsPtr = Can_Sim_Stats;
+    }
+}
+
+#endif /* CAN_HOST_SIM */
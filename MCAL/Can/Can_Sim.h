@@ -0,0 +1,296 @@
+/**
+ * @file        Can_Sim.h
+ * @author      Phuc
+ * @brief       Host simulator of the bxCAN register block, for building the CAN driver on a PC
+ * @version     1.0
+ * @date        2025-01-12
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef CAN_SIM_H
+#define CAN_SIM_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include "Std_Types.h"
+#include "Cmsis_Sim.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Host build
+ * @details     Compiling Can.c and Can_Sim.c with CAN_HOST_SIM defined replaces the device headers by this file.
+ *              Each CAN controller of the driver becomes a node on a simulated bus: its register block is plain
+ *              memory, the writes that have a side effect in hardware go through Can_Sim_WriteReg(), and
+ *              Can_Sim_Run() moves the bus forward and raises the interrupts of the nodes. Time is counted in
+ *              CPU cycles and only advances in Can_Sim_Run(), so the driver code itself takes no time and two
+ *              runs with the same calls give the same result.
+ */
+#ifndef CAN_SIM_NODE_MAX
+#define CAN_SIM_NODE_MAX            4u      /* Simulated nodes, i.e. CAN_CONTROLLER_MAX of the host build */
+#endif
+
+#define CAN_SIM_CYCLES_PER_CLOCK    1u      /* CPU cycles per CAN kernel clock, checked against Can_Cfg.h */
+#define CAN_SIM_POLL_CYCLES         8u      /* CPU cycles of one driver busy wait iteration, see Can_Hw_Poll() */
+
+/* Interrupt lines of a node, passed to Can_Sim_Isr() */
+#define CAN_SIM_IRQ_TX              0u      /* Transmit mailbox empty (RQCPx with TMEIE) */
+#define CAN_SIM_IRQ_RX0             1u      /* FIFO 0 pending, full or overrun */
+#define CAN_SIM_IRQ_RX1             2u      /* FIFO 1 pending, full or overrun */
+#define CAN_SIM_IRQ_SCE             3u      /* Error, wakeup and sleep acknowledge */
+#define CAN_SIM_IRQ_MAX             4u
+
+/**
+ * @typedef     Can_SimBusStatsType
+ * @brief       Activity of the simulated bus since Can_Sim_Init()
+ */
+typedef struct
+{
+    uint32 Frames;                          /* Frames sent without error */
+    uint32 ErrorFrames;                     /* Frames ended by an error or acknowledgment error */
+    uint32 Arbitrations;                    /* Frames started with more than one node contending */
+    uint32 ArbitrationLosses;               /* Contending frames that lost arbitration */
+    uint64 BusyCycles;                      /* CPU cycles during which the bus carried a frame */
+} Can_SimBusStatsType;
+
+/* bxCAN register block, same layout as stm32l476xx.h */
+typedef struct
+{
+    __IO uint32_t TIR;
+    __IO uint32_t TDTR;
+    __IO uint32_t TDLR;
+    __IO uint32_t TDHR;
+} CAN_TxMailBox_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t RIR;
+    __IO uint32_t RDTR;
+    __IO uint32_t RDLR;
+    __IO uint32_t RDHR;
+} CAN_FIFOMailBox_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t FR1;
+    __IO uint32_t FR2;
+} CAN_FilterRegister_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t MCR;
+    __IO uint32_t MSR;
+    __IO uint32_t TSR;
+    __IO uint32_t RF0R;
+    __IO uint32_t RF1R;
+    __IO uint32_t IER;
+    __IO uint32_t ESR;
+    __IO uint32_t BTR;
+    uint32_t RESERVED0[88];
+    CAN_TxMailBox_TypeDef sTxMailBox[3];
+    CAN_FIFOMailBox_TypeDef sFIFOMailBox[2];
+    uint32_t RESERVED1[12];
+    __IO uint32_t FMR;
+    __IO uint32_t FM1R;
+    uint32_t RESERVED2;
+    __IO uint32_t FS1R;
+    uint32_t RESERVED3;
+    __IO uint32_t FFA1R;
+    uint32_t RESERVED4;
+    __IO uint32_t FA1R;
+    uint32_t RESERVED5[8];
+    CAN_FilterRegister_TypeDef sFilterRegister[28];
+} CAN_TypeDef;
+
+#define CAN_MCR_INRQ                (0x1UL << 0)
+#define CAN_MCR_SLEEP               (0x1UL << 1)
+#define CAN_MCR_TXFP                (0x1UL << 2)
+#define CAN_MCR_RFLM                (0x1UL << 3)
+#define CAN_MCR_NART                (0x1UL << 4)
+#define CAN_MCR_AWUM                (0x1UL << 5)
+#define CAN_MCR_ABOM                (0x1UL << 6)
+#define CAN_MCR_TTCM                (0x1UL << 7)
+#define CAN_MCR_RESET               (0x1UL << 15)
+
+#define CAN_MSR_INAK                (0x1UL << 0)
+#define CAN_MSR_SLAK                (0x1UL << 1)
+#define CAN_MSR_ERRI                (0x1UL << 2)
+#define CAN_MSR_WKUI                (0x1UL << 3)
+#define CAN_MSR_SLAKI               (0x1UL << 4)
+
+#define CAN_TSR_RQCP0               (0x1UL << 0)
+#define CAN_TSR_TXOK0               (0x1UL << 1)
+#define CAN_TSR_ALST0               (0x1UL << 2)
+#define CAN_TSR_TERR0               (0x1UL << 3)
+#define CAN_TSR_ABRQ0               (0x1UL << 7)
+#define CAN_TSR_CODE_Pos            24U
+#define CAN_TSR_CODE                (0x3UL << CAN_TSR_CODE_Pos)
+#define CAN_TSR_TME_Pos             26U
+#define CAN_TSR_TME                 (0x7UL << CAN_TSR_TME_Pos)
+#define CAN_TSR_TME0                (0x1UL << 26)
+
+#define CAN_RF0R_FMP0               (0x3UL << 0)
+#define CAN_RF0R_FULL0              (0x1UL << 3)
+#define CAN_RF0R_FOVR0              (0x1UL << 4)
+#define CAN_RF0R_RFOM0              (0x1UL << 5)
+#define CAN_RF1R_FMP1               (0x3UL << 0)
+#define CAN_RF1R_FULL1              (0x1UL << 3)
+#define CAN_RF1R_FOVR1              (0x1UL << 4)
+#define CAN_RF1R_RFOM1              (0x1UL << 5)
+
+#define CAN_IER_TMEIE               (0x1UL << 0)
+#define CAN_IER_FMPIE0              (0x1UL << 1)
+#define CAN_IER_FFIE0               (0x1UL << 2)
+#define CAN_IER_FOVIE0              (0x1UL << 3)
+#define CAN_IER_FMPIE1              (0x1UL << 4)
+#define CAN_IER_FFIE1               (0x1UL << 5)
+#define CAN_IER_FOVIE1              (0x1UL << 6)
+#define CAN_IER_EWGIE               (0x1UL << 8)
+#define CAN_IER_EPVIE               (0x1UL << 9)
+#define CAN_IER_BOFIE               (0x1UL << 10)
+#define CAN_IER_LECIE               (0x1UL << 11)
+#define CAN_IER_ERRIE               (0x1UL << 15)
+#define CAN_IER_WKUIE               (0x1UL << 16)
+#define CAN_IER_SLKIE               (0x1UL << 17)
+
+#define CAN_ESR_EWGF                (0x1UL << 0)
+#define CAN_ESR_EPVF                (0x1UL << 1)
+#define CAN_ESR_BOFF                (0x1UL << 2)
+#define CAN_ESR_LEC_Pos             4U
+#define CAN_ESR_LEC                 (0x7UL << CAN_ESR_LEC_Pos)
+#define CAN_ESR_TEC_Pos             16U
+#define CAN_ESR_TEC                 (0xFFUL << CAN_ESR_TEC_Pos)
+#define CAN_ESR_REC_Pos             24U
+#define CAN_ESR_REC                 (0xFFUL << CAN_ESR_REC_Pos)
+
+#define CAN_BTR_BRP_Pos             0U
+#define CAN_BTR_BRP                 (0x3FFUL << CAN_BTR_BRP_Pos)
+#define CAN_BTR_TS1_Pos             16U
+#define CAN_BTR_TS1                 (0xFUL << CAN_BTR_TS1_Pos)
+#define CAN_BTR_TS2_Pos             20U
+#define CAN_BTR_TS2                 (0x7UL << CAN_BTR_TS2_Pos)
+#define CAN_BTR_SJW_Pos             24U
+#define CAN_BTR_SJW                 (0x3UL << CAN_BTR_SJW_Pos)
+#define CAN_BTR_LBKM                (0x1UL << 30)
+#define CAN_BTR_SILM                (0x1UL << 31)
+
+#define CAN_TI0R_TXRQ               (0x1UL << 0)
+#define CAN_TI0R_RTR                (0x1UL << 1)
+#define CAN_TI0R_IDE                (0x1UL << 2)
+#define CAN_TI0R_EXID_Pos           3U
+#define CAN_TI0R_STID_Pos           21U
+#define CAN_TDT0R_DLC               (0xFUL << 0)
+#define CAN_TDT0R_TIME_Pos          16U
+#define CAN_TDT0R_TIME              (0xFFFFUL << CAN_TDT0R_TIME_Pos)
+#define CAN_TDL0R_DATA0_Pos         0U
+#define CAN_TDL0R_DATA1_Pos         8U
+#define CAN_TDL0R_DATA2_Pos         16U
+#define CAN_TDL0R_DATA3_Pos         24U
+#define CAN_TDH0R_DATA4_Pos         0U
+#define CAN_TDH0R_DATA5_Pos         8U
+#define CAN_TDH0R_DATA6_Pos         16U
+#define CAN_TDH0R_DATA7_Pos         24U
+
+#define CAN_RI0R_RTR                (0x1UL << 1)
+#define CAN_RI0R_IDE                (0x1UL << 2)
+#define CAN_RI0R_EXID_Pos           3U
+#define CAN_RI0R_STID_Pos           21U
+#define CAN_RDT0R_DLC               (0xFUL << 0)
+#define CAN_RDT0R_FMI_Pos           8U
+#define CAN_RDT0R_FMI               (0xFFUL << CAN_RDT0R_FMI_Pos)
+#define CAN_RDT0R_TIME_Pos          16U
+#define CAN_RDT0R_TIME              (0xFFFFUL << CAN_RDT0R_TIME_Pos)
+
+#define CAN_FMR_FINIT               (0x1UL << 0)
+
+/*
+ ************************************************************************************************************
+ * Functions declaration
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets every node to the bxCAN reset state (sleep mode, filters in initialization), attaches
+ *              them all to the bus and sets the simulated time to 0. Call it before Can_Init().
+ * @param       void
+ * @return      void
+ */
+void Can_Sim_Init(void);
+
+/**
+ * @brief       Returns the register block of a node
+ * @param       Node: Node index, the CAN controller index of the driver
+ * @return      Register block, NULL_PTR if the node does not exist
+ */
+CAN_TypeDef* Can_Sim_GetRegs(uint8 Node);
+
+/**
+ * @brief       Applies a register write with its hardware side effects: mode requests in MCR, write-1-to-clear
+ *              flags in MSR, TSR and RFxR, mailbox abort (ABRQ) and release (RFOM), transmit request (TXRQ),
+ *              LEC in ESR. Other registers are written directly by the driver.
+ * @param       Reg: Register of one of the nodes
+ * @param       Value: Value written by the driver
+ * @return      void
+ */
+void Can_Sim_WriteReg(volatile uint32_t* Reg, uint32 Value);
+
+/**
+ * @brief       Advances the simulated time. Frames are arbitrated, sent, acknowledged and filtered into the
+ *              receive FIFOs, error counters are updated, and the interrupts of the nodes are raised through
+ *              Can_Sim_Isr() in node order whenever their flags are set and enabled in IER.
+ * @details     The DWT cycle counter wraps every 2^32 cycles: Can_MainFunction_Mode() has to be called at least
+ *              that often, as on the target.
+ * @param       Cycles: CPU cycles to simulate
+ * @return      void
+ */
+void Can_Sim_Run(uint64 Cycles);
+
+/**
+ * @brief       Returns the simulated time
+ * @param       void
+ * @return      CPU cycles since Can_Sim_Init()
+ */
+uint64 Can_Sim_GetTime(void);
+
+/**
+ * @brief       Connects a node to the bus or disconnects it, e.g. to simulate a broken wire. A disconnected
+ *              node sees an idle bus and gets no acknowledge for its frames.
+ * @param       Node: Node index
+ * @param       Attached: TRUE to connect, FALSE to disconnect
+ * @return      void
+ */
+void Can_Sim_SetAttached(uint8 Node, uint8 Attached);
+
+/**
+ * @brief       Makes the next transmissions of a node fail with a bit error, e.g. to drive it bus-off
+ * @param       Node: Node index
+ * @param       Count: Number of transmissions that fail
+ * @return      void
+ */
+void Can_Sim_InjectErrors(uint8 Node, uint32 Count);
+
+/**
+ * @brief       Returns the activity of the bus
+ * @param       StatsPtr: Where the counters are stored
+ * @return      void
+ */
+void Can_Sim_GetBusStats(Can_SimBusStatsType* StatsPtr);
+
+/**
+ * @brief       Interrupt entry of the driver, provided by Can.c in the host build
+ * @param       Controller: CAN controller index of the node
+ * @param       Line: CAN_SIM_IRQ_TX, CAN_SIM_IRQ_RX0, CAN_SIM_IRQ_RX1 or CAN_SIM_IRQ_SCE
+ * @return      void
+ */
+void Can_Sim_Isr(uint8 Controller, uint8 Line);
+
+#endif /* CAN_SIM_H */
@@ -0,0 +1,240 @@
+/**
+ * @file        CanLinGw.c
+ * @author      Phuc
+ * @brief       CAN to LIN signal gateway source file
+ * @version     1.0
+ * @date        2025-01-15
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "CanLinGw.h"
+#include "CanLinGw_Cfg.h"
+#include "Lin_Hw.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @typedef     CanLinGw_BufferType
+ * @brief       Response of a LIN frame. The gateway merges signals into Word, the LIN driver sends Byte, which
+ *              is the same memory in little endian byte order.
+ */
+typedef union
+{
+    uint64 Word;
+    uint8 Byte[8];
+} CanLinGw_BufferType;
+
+/**
+ * @typedef     CanLinGw_FrameStateType
+ * @brief       Double buffered response of a LIN frame. The gateway builds the next response in the back buffer
+ *              and publishes it by flipping Front, so the buffer handed to Lin_SendFrame() does not change
+ *              until the frame is updated a second time.
+ */
+typedef struct
+{
+    CanLinGw_BufferType Buffer[2];
+    volatile uint8 Front;                   /* Buffer holding the latest response */
+} CanLinGw_FrameStateType;
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+/* Response of each LIN frame */
+static CanLinGw_FrameStateType CanLinGw_FrameState[CANLINGW_FRAME_COUNT];
+
+/* Time from the FIFO pop to the LIN buffer update */
+static CanLinGw_LatencyType CanLinGw_Latency;
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Reads a CAN payload as a little endian word, bytes beyond the data length are left as received
+ *              since no route reads them
+ * @param       Sdu: Data of the L-PDU, 8 bytes
+ * @return      Payload word
+ */
+static uint64 CanLinGw_ReadPayload(const uint8* Sdu)
+{
+    uint32 low = (uint32)Sdu[0] | ((uint32)Sdu[1] << 8) | ((uint32)Sdu[2] << 16) | ((uint32)Sdu[3] << 24);
+    uint32 high = (uint32)Sdu[4] | ((uint32)Sdu[5] << 8) | ((uint32)Sdu[6] << 16) | ((uint32)Sdu[7] << 24);
+
+    return ((uint64)high << 32) | low;
+}
+
+/**
+ * @brief       Publishes the next response of a LIN frame
+ * @param       Frame: Index of the LIN frame
+ * @param       Word: Response built from the current one
+ * @return      void
+ */
+static void CanLinGw_Publish(uint8 Frame, uint64 Word)
+{
+    CanLinGw_FrameStateType *state = &CanLinGw_FrameState[Frame];
+    uint8 back = (uint8)(state->Front ^ 1u);
+
+    state->Buffer[back].Word = Word;
+    state->Front = back;
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Clears the LIN frame buffers and the latency counters.
+ * @param       void
+ * @retval      void
+ */
+void CanLinGw_Init(void)
+{
+    uint8 frame;
+
+    for (frame = 0u; frame < CANLINGW_FRAME_COUNT; frame++)
+    {
+        CanLinGw_FrameState[frame].Buffer[0].Word = 0u;
+        CanLinGw_FrameState[frame].Buffer[1].Word = 0u;
+        CanLinGw_FrameState[frame].Front = 0u;
+    }
+
+    CanLinGw_Latency = (CanLinGw_LatencyType){0};
+}
+
+/**
+ * @brief       Routes the signals of a received CAN L-PDU into their LIN frames.
+ * @details     The routes of the L-PDU are found by its PDU handle in CanLinGw_RouteIndex, without any search.
+ *              Each signal is moved by the shift and the mask computed by CanLinGw_Gen.py, straight from the
+ *              receive ring slot into the LIN response. Routes of the same LIN frame are consecutive, so every
+ *              LIN frame is published once per CAN frame.
+ * @param       PduInfo: Received L-PDU, swPduHandle selects the routes
+ * @param       PopCycles: DWT cycle count when the frame was taken out of its receive FIFO
+ * @retval      uint8:
+ *              TRUE: The L-PDU is routed and consumed
+ *              FALSE: The L-PDU has no route, or is too short for all of them, and is left to the receive ring
+ */
+uint8 CanLinGw_RxIndication(const Can_PduType* PduInfo, uint32 PopCycles)
+{
+    const CanLinGw_RouteType *route;
+    const CanLinGw_RouteType *end;
+    uint64 payload;
+    uint64 moved;
+    uint64 word = 0u;
+    uint8 frame = 0xFFu;
+
+    if ((PduInfo == NULL_PTR) || (PduInfo->swPduHandle >= CANLINGW_PDU_MAX) ||
+        (CanLinGw_RouteIndex[PduInfo->swPduHandle] == CanLinGw_RouteIndex[PduInfo->swPduHandle + 1u]))
+    {
+        return FALSE;
+    }
+
+    route = &CanLinGw_Routes[CanLinGw_RouteIndex[PduInfo->swPduHandle]];
+    end = &CanLinGw_Routes[CanLinGw_RouteIndex[PduInfo->swPduHandle + 1u]];
+    payload = CanLinGw_ReadPayload(PduInfo->sdu);
+
+    for (; route < end; route++)
+    {
+        if (PduInfo->length < route->MinLength)
+        {
+            CanLinGw_Latency.ShortFrames++;
+            continue;
+        }
+
+        if (route->Frame != frame)
+        {
+            if (frame != 0xFFu)
+            {
+                CanLinGw_Publish(frame, word);
+            }
+            frame = route->Frame;
+            word = CanLinGw_FrameState[frame].Buffer[CanLinGw_FrameState[frame].Front].Word;
+        }
+
+        moved = (route->Left == TRUE) ? (payload << route->Shift) : (payload >> route->Shift);
+        word = (word & ~route->Mask) | (moved & route->Mask);
+    }
+
+    if (frame == 0xFFu)
+    {
+        return FALSE; /* Every route skipped, nothing was routed */
+    }
+    CanLinGw_Publish(frame, word);
+
+    /* Runs in the receive interrupt only, the counters have a single writer */
+    CanLinGw_Latency.LastCycles = Lin_Hw_GetCycles() - PopCycles;
+    if (CanLinGw_Latency.LastCycles > CanLinGw_Latency.MaxCycles)
+    {
+        CanLinGw_Latency.MaxCycles = CanLinGw_Latency.LastCycles;
+    }
+    CanLinGw_Latency.Count++;
+
+    return TRUE;
+}
+
+/**
+ * @brief       Sends a gateway LIN frame with its current response.
+ * @details     The SDU pointer points into the published buffer, which stays unchanged until the frame is
+ *              updated twice more. A LIN frame takes less than 10 ms, so CAN signals routed into it must not
+ *              come faster than that.
+ * @param       Frame: Index of the LIN frame in the generated configuration
+ * @retval      Std_ReturnType:
+ *              E_OK: Send command has been accepted
+ *              E_NOT_OK: Unknown frame, or the LIN driver did not accept the command
+ */
+Std_ReturnType CanLinGw_SendFrame(uint8 Frame)
+{
+    const CanLinGw_FrameConfigType *config;
+    Lin_PduType pdu;
+
+    if (Frame >= CANLINGW_FRAME_COUNT)
+    {
+        return E_NOT_OK;
+    }
+
+    config = &CanLinGw_Frames[Frame];
+    pdu.Pid = config->Pid;
+    pdu.Cs = config->Cs;
+    pdu.Drc = LIN_FRAMERESPONSE_TX;
+    pdu.Dl = config->Dl;
+    pdu.SduPtr = CanLinGw_FrameState[Frame].Buffer[CanLinGw_FrameState[Frame].Front].Byte;
+
+    return Lin_SendFrame(config->Channel, &pdu);
+}
+
+/**
+ * @brief       Returns the latency of the gateway.
+ * @param       LatencyPtr: Pointer to a memory location, where the latency will be stored.
+ * @retval      Std_ReturnType:
+ *              E_OK: Latency available.
+ *              E_NOT_OK: Invalid pointer.
+ */
+Std_ReturnType CanLinGw_GetLatency(CanLinGw_LatencyType* LatencyPtr)
+{
+    uint32 primask;
+
+    if (LatencyPtr == NULL_PTR)
+    {
+        return E_NOT_OK;
+    }
+
+    /* The receive interrupt updates the counters one after the other, the copy must not be split by it */
+    primask = Lin_Hw_EnterCritical();
+    *LatencyPtr = CanLinGw_Latency;
+    Lin_Hw_ExitCritical(primask);
+
+    return E_OK;
+}
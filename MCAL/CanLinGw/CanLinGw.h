@@ -0,0 +1,109 @@
+/**
+ * @file        CanLinGw.h
+ * @author      Phuc
+ * @brief       CAN to LIN signal gateway header file
+ * @version     1.0
+ * @date        2025-01-15
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef CANLINGW_H
+#define CANLINGW_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Can.h"
+#include "Lin.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @typedef     CanLinGw_FrameConfigType
+ * @brief       LIN frame fed by the gateway, its response is built in place from the routed CAN signals
+ */
+typedef struct
+{
+    Lin_FramePidType Pid;                   /* Frame identifier (0..0x3F), the parity is added by the LIN driver */
+    Lin_FrameCsModelType Cs;                /* Checksum model of the frame */
+    Lin_FrameDlType Dl;                     /* Response length (1-8 bytes) */
+    uint8 Channel;                          /* LIN channel the frame is sent on */
+} CanLinGw_FrameConfigType;
+
+/**
+ * @typedef     CanLinGw_RouteType
+ * @brief       Signal copied from a CAN L-PDU into a LIN frame, generated by CanLinGw_Gen.py. Both payloads are
+ *              read as 64-bit little endian words, so a signal is moved by a single shift and masked into place.
+ */
+typedef struct
+{
+    uint64 Mask;                            /* Bits of the signal in the LIN frame */
+    uint8 Shift;                            /* Distance in bits between the signal in the CAN and the LIN frame */
+    uint8 Left;                             /* TRUE when the signal sits higher in the LIN frame than in the CAN frame */
+    uint8 MinLength;                        /* Smallest CAN data length that carries the whole signal */
+    uint8 Frame;                            /* Index of the LIN frame in CanLinGw_Frames */
+} CanLinGw_RouteType;
+
+/**
+ * @typedef     CanLinGw_LatencyType
+ * @brief       Time from taking a routed CAN frame out of its receive FIFO until its last LIN frame has been
+ *              updated, in CPU cycles counted by DWT CYCCNT.
+ */
+typedef struct
+{
+    uint32 LastCycles;                      /* Latency of the last routed CAN frame */
+    uint32 MaxCycles;                       /* Longest latency */
+    uint32 Count;                           /* Number of routed CAN frames */
+    uint32 ShortFrames;                     /* Routes skipped because the CAN frame was too short to carry them */
+} CanLinGw_LatencyType;
+
+/*
+ ************************************************************************************************************
+ * Functions declaration
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Clears the LIN frame buffers and the latency counters.
+ * @param       void
+ * @retval      void
+ */
+void CanLinGw_Init(void);
+
+/**
+ * @brief       Routes the signals of a received CAN L-PDU into their LIN frames. Meant to be set as
+ *              Can_ConfigType.RxGateway, it runs in the CAN receive interrupt.
+ * @param       PduInfo: Received L-PDU, swPduHandle selects the routes
+ * @param       PopCycles: DWT cycle count when the frame was taken out of its receive FIFO
+ * @retval      uint8:
+ *              TRUE: The L-PDU is routed and consumed
+ *              FALSE: The L-PDU has no route, or is too short for all of them, and is left to the receive ring
+ */
+uint8 CanLinGw_RxIndication(const Can_PduType* PduInfo, uint32 PopCycles);
+
+/**
+ * @brief       Sends a gateway LIN frame with its current response, the SDU pointer given to Lin_SendFrame()
+ *              points straight into the frame buffer.
+ * @param       Frame: Index of the LIN frame in the generated configuration
+ * @retval      Std_ReturnType:
+ *              E_OK: Send command has been accepted
+ *              E_NOT_OK: Unknown frame, or the LIN driver did not accept the command
+ */
+Std_ReturnType CanLinGw_SendFrame(uint8 Frame);
+
+/**
+ * @brief       Returns the latency of the gateway.
+ * @param       LatencyPtr: Pointer to a memory location, where the latency will be stored.
+ * @retval      Std_ReturnType:
+ *              E_OK: Latency available.
+ *              E_NOT_OK: Invalid pointer.
+ */
+Std_ReturnType CanLinGw_GetLatency(CanLinGw_LatencyType* LatencyPtr);
+
+#endif /* CANLINGW_H */
@@ -0,0 +1,64 @@
+/**
+ * @file        CanLinGw_Cfg.h
+ * @author      Phuc
+ * @brief       Routing table of the CAN to LIN gateway, generated by CanLinGw_Gen.py from CanLinGw_Routes.txt
+ * @version     1.0
+ * @date        2025-01-15
+ * 
+ * @copyright   Copyright (c) 2025
+ * 
+ */
+
+/*
+ * Do not edit, run CanLinGw_Gen.py again after changing the routes.
+ *
+ * LIN frames          : 3
+ * Routes              : 8 from 7 CAN PDUs
+ */
+
+#ifndef CANLINGW_CFG_H
+#define CANLINGW_CFG_H
+
+#include "CanLinGw.h"
+
+/**
+ * @brief       LIN frames fed by the gateway, sorted by frame identifier
+ */
+#define CANLINGW_FRAME_COUNT        3u
+
+const CanLinGw_FrameConfigType CanLinGw_Frames[CANLINGW_FRAME_COUNT] = 
+{
+    {0x10u, LIN_ENHANCED_CS, 4u, 0u},
+    {0x20u, LIN_ENHANCED_CS, 2u, 0u},
+    {0x21u, LIN_ENHANCED_CS, 3u, 0u}
+};
+
+/**
+ * @brief       Routed signals, grouped by CAN PDU handle and LIN frame
+ */
+#define CANLINGW_ROUTE_COUNT        8u
+
+const CanLinGw_RouteType CanLinGw_Routes[CANLINGW_ROUTE_COUNT] = 
+{
+    {0x00000000000000FFu, 0u, FALSE, 1u, 0u},            /* pdu 8: 0x3A0 0:8 -> 0x10 0 */
+    {0x000000000000FF00u, 8u, TRUE, 1u, 0u},             /* pdu 9: 0x3A1 0:8 -> 0x10 8 */
+    {0x0000000000FF0000u, 16u, TRUE, 1u, 0u},            /* pdu 10: 0x3A2 0:8 -> 0x10 16 */
+    {0x00000000FF000000u, 24u, TRUE, 1u, 0u},            /* pdu 11: 0x3A3 0:8 -> 0x10 24 */
+    {0x000000000000000Fu, 4u, FALSE, 1u, 1u},            /* pdu 12: 0x200 4:4 -> 0x20 0 */
+    {0x00000000000007F0u, 4u, FALSE, 2u, 1u},            /* pdu 12: 0x200 8:7 -> 0x20 4 */
+    {0x000000000000F800u, 5u, FALSE, 3u, 1u},            /* pdu 13: 0x210 16:5 -> 0x20 11 */
+    {0x0000000000FFFFFFu, 0u, FALSE, 3u, 2u}             /* pdu 14: 0x2F0 0:24 -> 0x21 0 */
+};
+
+/**
+ * @brief       First route of each CAN PDU handle, the routes of PDU n end where those of PDU n + 1 start
+ */
+#define CANLINGW_PDU_MAX            15u
+
+const uint16 CanLinGw_RouteIndex[CANLINGW_PDU_MAX + 1u] = 
+{
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 1u, 2u, 3u, 4u, 6u, 7u, 8u
+};
+
+#endif /* CANLINGW_CFG_H */
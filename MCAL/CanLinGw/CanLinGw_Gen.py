@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+"""
+@file        CanLinGw_Gen.py
+@author      Phuc
+@brief       Routing table compiler of the CAN to LIN signal gateway
+@version     1.0
+@date        2025-01-15
+
+Reads the LIN frames fed by the gateway and the CAN signals routed into them, and generates CanLinGw_Cfg.h with
+the frame table, the route table and an index from the CAN PDU handle to its routes.
+
+Both payloads are handled as 64-bit little endian words. For every route the mask of the signal in the LIN
+frame and the shift that moves it there from the CAN frame are computed here, so that CanLinGw_RxIndication()
+only shifts, masks and merges. Routes are grouped by CAN PDU handle, and within one PDU by LIN frame, so that
+each LIN frame is published once per CAN frame.
+
+Input file, '#' starts a comment:
+    frame 0x10 dl=4 ch=0 cs=enhanced                LIN frame 0x10, 4 bytes, channel 0
+    route 0x3A0 bit=0 len=8 -> 0x10 bit=8           bits 0..7 of CAN 0x3A0 into bits 8..15 of LIN 0x10
+    route 0x18FF0010 ext bit=16 len=16 -> 0x10 bit=16
+
+The PDU handle of each CAN ID is taken from the ID list of Can_FilterGen.py, so only received IDs can be routed.
+
+Usage:
+    python3 CanLinGw_Gen.py CanLinGw_Routes.txt [-o CanLinGw_Cfg.h] [--can-ids ../Can/Can_RxIds.txt]
+"""
+
+import argparse
+import sys
+
+STD_BITS = 11
+EXT_BITS = 29
+LIN_FRAME_ID_MAX = 0x3F
+
+
+def parse_can_ids(path):
+    """Returns {(id, is_ext): pdu} from the CAN ID list, with the defaults of Can_FilterGen.py."""
+    pdus = {}
+    with open(path) as f:
+        for line in f:
+            fields = line.split("#", 1)[0].split()
+            if not fields:
+                continue
+            is_ext = len(fields) > 1 and fields[1].lower() == "ext"
+            rest = fields[2:] if (len(fields) > 1 and fields[1].lower() in ("ext", "std")) else fields[1:]
+            attrs = dict(f.split("=", 1) for f in rest if "=" in f)
+            pdus[(int(fields[0], 0), is_ext)] = int(attrs.get("pdu", str(len(pdus))), 0)
+    return pdus
+
+
+def parse_routes(path, pdus):
+    """Returns ({frame id: (dl, ch, cs)}, [(pdu, frame id, src bit, length, dst bit, line)])."""
+    frames = {}
+    routes = []
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            fields = line.split("#", 1)[0].split()
+            if not fields:
+                continue
+            where = "%s:%d" % (path, lineno)
+            if fields[0] == "frame":
+                frame_id = int(fields[1], 0)
+                attrs = dict(a.split("=", 1) for a in fields[2:] if "=" in a)
+                dl = int(attrs.get("dl", "8"), 0)
+                cs = attrs.get("cs", "enhanced").lower()
+                if frame_id > LIN_FRAME_ID_MAX or not 1 <= dl <= 8 or cs not in ("enhanced", "classic"):
+                    sys.exit("%s: invalid LIN frame" % where)
+                frames[frame_id] = (dl, int(attrs.get("ch", "0"), 0), cs)
+            elif fields[0] == "route" and "->" in fields:
+                arrow = fields.index("->")
+                src, dst = fields[1:arrow], fields[arrow + 1:]
+                can_id = int(src[0], 0)
+                is_ext = len(src) > 1 and src[1].lower() == "ext"
+                attrs = dict(a.split("=", 1) for a in src[1:] if "=" in a)
+                src_bit = int(attrs["bit"], 0)
+                length = int(attrs["len"], 0)
+                frame_id = int(dst[0], 0)
+                dst_bit = int(dict(a.split("=", 1) for a in dst[1:] if "=" in a)["bit"], 0)
+                if (can_id, is_ext) not in pdus:
+                    sys.exit("%s: CAN ID 0x%X is not received, add it to the CAN ID list" % (where, can_id))
+                if frame_id not in frames:
+                    sys.exit("%s: LIN frame 0x%X is not declared before its routes" % (where, frame_id))
+                if length < 1 or src_bit + length > 64 or dst_bit + length > 8 * frames[frame_id][0]:
+                    sys.exit("%s: signal does not fit in the CAN or the LIN frame" % where)
+                routes.append((pdus[(can_id, is_ext)], frame_id, src_bit, length, dst_bit, "%s0x%X %d:%d -> 0x%X %d" %
+                               ("ext " if is_ext else "", can_id, src_bit, length, frame_id, dst_bit)))
+            else:
+                sys.exit("%s: expected 'frame' or 'route'" % where)
+    return frames, routes
+
+
+def check_overlaps(routes):
+    """Two routes writing the same LIN bits would depend on the order of the CAN frames."""
+    owner = {}
+    for pdu, frame_id, _, length, dst_bit, text in routes:
+        for bit in range(dst_bit, dst_bit + length):
+            if (frame_id, bit) in owner:
+                sys.exit("error: '%s' overlaps '%s'" % (text, owner[(frame_id, bit)]))
+            owner[(frame_id, bit)] = text
+
+
+def main():
+    parser = argparse.ArgumentParser(description="CAN to LIN gateway routing table compiler")
+    parser.add_argument("routes", help="file listing the LIN frames and the routed signals")
+    parser.add_argument("-o", "--output", default="CanLinGw_Cfg.h", help="generated header")
+    parser.add_argument("--can-ids", default="../Can/Can_RxIds.txt", help="CAN ID list of Can_FilterGen.py")
+    args = parser.parse_args()
+
+    pdus = parse_can_ids(args.can_ids)
+    frames, routes = parse_routes(args.routes, pdus)
+    check_overlaps(routes)
+
+    frame_ids = sorted(frames)
+    frame_index = {frame_id: n for n, frame_id in enumerate(frame_ids)}
+    routes.sort(key=lambda r: (r[0], frame_index[r[1]], r[4]))
+    pdu_max = max([r[0] for r in routes] + [0]) + 1
+
+    # Routes of PDU n are CanLinGw_Routes[CanLinGw_RouteIndex[n] .. CanLinGw_RouteIndex[n + 1] - 1]
+    route_index = []
+    for pdu in range(pdu_max + 1):
+        route_index.append(sum(1 for r in routes if r[0] < pdu))
+
+    report = [
+        "LIN frames          : %d" % len(frames),
+        "Routes              : %d from %d CAN PDUs" % (len(routes), len({r[0] for r in routes})),
+    ]
+    print("\n".join(report))
+
+    out = []
+    out.append("/**")
+    out.append(" * @file        %s" % args.output.split("/")[-1])
+    out.append(" * @author      Phuc")
+    out.append(" * @brief       Routing table of the CAN to LIN gateway, generated by CanLinGw_Gen.py from %s" % args.routes.split("/")[-1])
+    out.append(" * @version     1.0")
+    out.append(" * @date        2025-01-15")
+    out.append(" * ")
+    out.append(" * @copyright   Copyright (c) 2025")
+    out.append(" * ")
+    out.append(" */")
+    out.append("")
+    out.append("/*")
+    out.append(" * Do not edit, run CanLinGw_Gen.py again after changing the routes.")
+    out.append(" *")
+    for line in report:
+        out.append(" * " + line)
+    out.append(" */")
+    out.append("")
+    out.append("#ifndef CANLINGW_CFG_H")
+    out.append("#define CANLINGW_CFG_H")
+    out.append("")
+    out.append("#include \"CanLinGw.h\"")
+    out.append("")
+    out.append("/**")
+    out.append(" * @brief       LIN frames fed by the gateway, sorted by frame identifier")
+    out.append(" */")
+    out.append("#define CANLINGW_FRAME_COUNT        %du" % max(1, len(frame_ids)))
+    out.append("")
+    out.append("const CanLinGw_FrameConfigType CanLinGw_Frames[CANLINGW_FRAME_COUNT] = ")
+    out.append("{")
+    if not frame_ids:
+        out.append("    {0x00u, LIN_ENHANCED_CS, 1u, 0u}     /* No frame is fed */")
+    for n, frame_id in enumerate(frame_ids):
+        dl, ch, cs = frames[frame_id]
+        out.append("    {0x%02Xu, %s, %du, %du}%s" % (frame_id, "LIN_ENHANCED_CS" if cs == "enhanced" else "LIN_CLASSIC_CS",
+                                                   dl, ch, "," if n + 1 < len(frame_ids) else ""))
+    out.append("};")
+    out.append("")
+    out.append("/**")
+    out.append(" * @brief       Routed signals, grouped by CAN PDU handle and LIN frame")
+    out.append(" */")
+    out.append("#define CANLINGW_ROUTE_COUNT        %du" % max(1, len(routes)))
+    out.append("")
+    out.append("const CanLinGw_RouteType CanLinGw_Routes[CANLINGW_ROUTE_COUNT] = ")
+    out.append("{")
+    if not routes:
+        out.append("    {0x0000000000000000u, 0u, FALSE, 0u, 0u}     /* No signal is routed */")
+    for n, (pdu, frame_id, src_bit, length, dst_bit, text) in enumerate(routes):
+        mask = ((1 << length) - 1) << dst_bit
+        left = dst_bit > src_bit
+        cell = "{0x%016Xu, %du, %s, %du, %du}%s" % (mask, abs(dst_bit - src_bit), "TRUE" if left else "FALSE",
+                                                  (src_bit + length + 7) // 8, frame_index[frame_id],
+                                                  "," if n + 1 < len(routes) else "")
+        out.append("    %-52s /* pdu %d: %s */" % (cell, pdu, text))
+    out.append("};")
+    out.append("")
+    out.append("/**")
+    out.append(" * @brief       First route of each CAN PDU handle, the routes of PDU n end where those of PDU n + 1 start")
+    out.append(" */")
+    out.append("#define CANLINGW_PDU_MAX            %du" % pdu_max)
+    out.append("")
+    out.append("const uint16 CanLinGw_RouteIndex[CANLINGW_PDU_MAX + 1u] = ")
+    out.append("{")
+    for n in range(0, len(route_index), 8):
+        cells = ", ".join("%du" % v for v in route_index[n:n + 8])
+        out.append("    %s%s" % (cells, "," if n + 8 < len(route_index) else ""))
+    out.append("};")
+    out.append("")
+    out.append("#endif /* CANLINGW_CFG_H */")
+    with open(args.output, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
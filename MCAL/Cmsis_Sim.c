@@ -0,0 +1,26 @@
+/**
+ * @file        Cmsis_Sim.c
+ * @author      Phuc
+ * @brief       Host model of the CMSIS core registers shared by the CAN and LIN simulators
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Cmsis_Sim.h"
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+DWT_Type Cmsis_Sim_Dwt;
+CoreDebug_Type Cmsis_Sim_CoreDebug;
+uint32_t Cmsis_Sim_Primask = 0u;
@@ -0,0 +1,154 @@
+/**
+ * @file        Cmsis_Sim.h
+ * @author      Phuc
+ * @brief       Host model of the CMSIS core and device definitions shared by the CAN and LIN simulators
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef CMSIS_SIM_H
+#define CMSIS_SIM_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include <stdint.h>
+#include <string.h>
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Host build
+ * @details     Included by Can_Sim.h (CAN_HOST_SIM) and Lin_Sim.h (LIN_HOST_SIM) in place of the CMSIS core and
+ *              device headers, so that both drivers and the modules between them build together, e.g. the CAN to
+ *              LIN gateway. A single DWT cycle counter and PRIMASK are seen by both: each simulator sets CYCCNT
+ *              to its own simulated time while it runs and raises no interrupt while PRIMASK is set.
+ */
+#define __IO                        volatile
+#define __I                         volatile const
+
+typedef enum
+{
+    DISABLE = 0,
+    ENABLE = !DISABLE
+} FunctionalState;
+
+/* Interrupt lines of STM32L476 used by the drivers */
+typedef enum
+{
+    DMA1_Channel1_IRQn = 11,
+    DMA1_Channel2_IRQn = 12,
+    DMA1_Channel3_IRQn = 13,
+    DMA1_Channel4_IRQn = 14,
+    DMA1_Channel5_IRQn = 15,
+    DMA1_Channel6_IRQn = 16,
+    DMA1_Channel7_IRQn = 17,
+    CAN1_TX_IRQn = 19,
+    CAN1_RX0_IRQn = 20,
+    CAN1_RX1_IRQn = 21,
+    CAN1_SCE_IRQn = 22,
+    USART1_IRQn = 37,
+    USART2_IRQn = 38,
+    USART3_IRQn = 39,
+    UART4_IRQn = 52,
+    UART5_IRQn = 53,
+    TIM7_IRQn = 55,
+    DMA2_Channel1_IRQn = 56,
+    DMA2_Channel2_IRQn = 57,
+    DMA2_Channel3_IRQn = 58,
+    DMA2_Channel4_IRQn = 59,
+    DMA2_Channel5_IRQn = 60,
+    DMA2_Channel6_IRQn = 68,
+    DMA2_Channel7_IRQn = 69,
+    LPUART1_IRQn = 70
+} IRQn_Type;
+
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk      (0x1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (0x1UL << 24)
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+extern DWT_Type Cmsis_Sim_Dwt;              /* Cycle counter, follows the simulated time */
+extern CoreDebug_Type Cmsis_Sim_CoreDebug;
+extern uint32_t Cmsis_Sim_Primask;          /* Interrupts are not raised while it is set */
+
+#define DWT                         (&Cmsis_Sim_Dwt)
+#define CoreDebug                   (&Cmsis_Sim_CoreDebug)
+
+/*
+ ************************************************************************************************************
+ * Inline functions
+ ************************************************************************************************************
+ */
+static inline uint32_t __get_PRIMASK(void)
+{
+    return Cmsis_Sim_Primask;
+}
+
+static inline void __set_PRIMASK(uint32_t priMask)
+{
+    Cmsis_Sim_Primask = priMask;
+}
+
+static inline void __disable_irq(void)
+{
+    Cmsis_Sim_Primask = 1u;
+}
+
+static inline void __enable_irq(void)
+{
+    Cmsis_Sim_Primask = 0u;
+}
+
+static inline void __DMB(void)
+{
+}
+
+static inline uint32_t __UNALIGNED_UINT32_READ(const void* addr)
+{
+    uint32_t value;
+
+    (void)memcpy(&value, addr, sizeof(value));
+    return value;
+}
+
+/* Interrupt enables are taken from the peripheral registers alone, the NVIC is always open */
+static inline void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    (void)IRQn;
+    (void)priority;
+}
+
+static inline void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+static inline void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+#endif /* CMSIS_SIM_H */
@@ -15,46 +15,768 @@
  ************************************************************************************************************
  */
 #include "Lin.h"
+#include "Lin_Hw.h"
 
 /*
  ************************************************************************************************************
  * Types and Defines
  ************************************************************************************************************
  */
-/* Define the maximum number of LIN channels */
-#define MAX_LIN_CHANNELS 2    /* Maximum number of LIN channels. */
-
-/* Structure for LIN Channel Configuration */
-typedef struct {
-    uint32 Lin_BaudRate;                        /* Baud rate for the LIN channel. */
-    FunctionalState LinChannelWakeupSupport;    /* Wake-up support (ENABLE/DISABLE). */
-    uint8 Lin_ChannelID;                        /* ID of the LIN channel. */
-    GPIO_TypeDef* Lin_Port;                     /* GPIO port for the LIN channel. */
-    uint16 Lin_TxPin;                           /* Tx pin of the LIN channel. */
-    uint16 Lin_RxPin;                           /* Rx pin of the LIN channel. */
-} LinChannelConfigType;
-
-/* Array to store the state of each LIN channel */
-Lin_StatusType LinChannelState[MAX_LIN_CHANNELS] = {
-    LIN_CH_SLEEP,    // Initial state for each channel
-    LIN_CH_SLEEP     // State for the second channel if needed
+/* Progress of the frame on a channel */
+#define LIN_FRAME_IDLE      0u      /* No frame in progress */
+#define LIN_FRAME_BYTES     1u      /* Header and response handed to the transmit DMA channel */
+#define LIN_FRAME_LAST      2u      /* Last byte written into TDR, the TC interrupt is enabled */
+#define LIN_FRAME_RESPONSE  3u      /* Header sent, the receive DMA channel captures the response */
+#define LIN_FRAME_HEADER    4u      /* Break detected by a slave, the receive DMA channel captures sync and PID */
+
+/* Unit without a LIN channel */
+#define LIN_CHANNEL_NONE    0xFFu
+
+/* Frame identifier without an entry in the slave frames of a channel */
+#define LIN_SLAVE_FRAME_NONE    0xFFu
+
+/* One slave frame per frame identifier at most, so that every index stays below LIN_SLAVE_FRAME_NONE */
+#define LIN_SLAVE_FRAMES_MAX    64u
+
+/* Sync field, PID, up to 8 data bytes and the checksum; the break is requested with SBKRQ */
+#define LIN_FRAME_BYTES_MAX 11u
+
+/* Longest response of Dl bytes and the checksum in bit times, 1.4 times its nominal length (LIN 2.x
+ * TResponse_Maximum). It is counted from the stop bit of the PID in CPU cycles, see ResponseLimit. */
+#define LIN_RESPONSE_TIMEOUT_BITS(dl)   (14u * ((uint32)(dl) + 1u))
+
+/* Inter-byte timeout of the response in bit times. The receiver timeout restarts after every character
+ * received, so it only ends a response that stops: silence for the whole response or a byte gap this long. */
+#define LIN_INTERBYTE_TIMEOUT_BITS(dl)  LIN_RESPONSE_TIMEOUT_BITS(dl)
+
+/* Go-to-sleep command: master request frame with its first data byte at 0 */
+#define LIN_MASTER_REQUEST_ID   0x3Cu
+
+/* Protected identifiers of eight consecutive frame identifiers */
+#define LIN_PID_ROW(id)     LIN_PID((id) + 0u), LIN_PID((id) + 1u), LIN_PID((id) + 2u), LIN_PID((id) + 3u), \
+                            LIN_PID((id) + 4u), LIN_PID((id) + 5u), LIN_PID((id) + 6u), LIN_PID((id) + 7u)
+
+/**
+ * @typedef     Lin_FrameType
+ * @brief       Frame being sent on a channel. Lin_SendFrame() prepares every byte, one DMA transfer sends
+ *              them and a second one captures the response of an RX frame, so a frame costs two or three
+ *              interrupts whatever its length. While the bytes are sent, the receive DMA channel reads them
+ *              back from the bus into Echo.
+ */
+typedef struct
+{
+    uint8 Bytes[LIN_FRAME_BYTES_MAX];       /* Sync field, PID, copied response and checksum */
+    uint8 Count;                            /* Number of bytes in Bytes */
+    uint8 Echo[LIN_FRAME_BYTES_MAX + 1u];   /* Read back of the break, as a 0x00 byte, and of the bytes sent */
+    uint8 First;                            /* First byte of Bytes sent, 2 for the response of a slave */
+    uint8 Break;                            /* 1 if the frame starts with a break, 0 otherwise */
+    uint8 Dl;                               /* Length of the response to receive */
+    volatile uint8 Phase;                   /* LIN_FRAME_xxx */
+    Lin_StatusType Done;                    /* Channel status once the header or the whole frame has been sent */
+    uint8 Seed;                             /* PID for the enhanced checksum, 0 for the classic one */
+    const Lin_PduType *Slave;               /* Slave frame receiving the response, NULL_PTR otherwise */
+    uint32 Cycles;                          /* CPU time spent on the frame so far */
+    uint32 Interrupts;                      /* Interrupts taken by the frame so far */
+    uint32 ResponseStart;                   /* Cycle count at the stop bit of the PID of an RX frame */
+    uint32 ResponseLimit;                   /* TResponse_Maximum of that response in CPU cycles */
+} Lin_FrameType;
+
+/**
+ * @typedef     Lin_WakeupStateType
+ * @brief       Wakeup of a channel, from its detection to the first frame after it
+ */
+typedef struct
+{
+    uint32 Start;                           /* Cycle count of the wakeup */
+    uint8 Timed;                            /* TRUE until the first correct frame after the wakeup */
+    volatile uint8 Detected;                /* TRUE from a wakeup detected on the bus to Lin_CheckWakeup() */
+} Lin_WakeupStateType;
+
+/* Array to store the state of each LIN channel, LIN_NOT_OK until the channel is initialized */
+volatile Lin_StatusType LinChannelState[MAX_LIN_CHANNELS];
+
+/* Array to store the data for each LIN channel */
+uint8 LinChannelData[MAX_LIN_CHANNELS][9]; // Response of up to 8 bytes followed by its checksum, written by DMA
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+/* Protected identifier of each frame identifier, computed by the compiler */
+static const uint8 Lin_PidTable[64] =
+{
+    LIN_PID_ROW(0x00u), LIN_PID_ROW(0x08u), LIN_PID_ROW(0x10u), LIN_PID_ROW(0x18u),
+    LIN_PID_ROW(0x20u), LIN_PID_ROW(0x28u), LIN_PID_ROW(0x30u), LIN_PID_ROW(0x38u)
+};
+
+/* Frame in progress on each channel */
+static Lin_FrameType Lin_Frame[MAX_LIN_CHANNELS];
+
+/* LIN channel of each USART unit, for its interrupt handlers; LIN_CHANNEL_NONE when unused */
+static uint8 Lin_UnitChannel[LIN_HW_UNIT_MAX] =
+{
+    LIN_CHANNEL_NONE, LIN_CHANNEL_NONE, LIN_CHANNEL_NONE, LIN_CHANNEL_NONE, LIN_CHANNEL_NONE, LIN_CHANNEL_NONE
 };
 
-/* Array to store configuration for each LIN channel */
-LinChannelConfigType LinChannelConfig[MAX_LIN_CHANNELS] = {
+/* CPU time of the frames of each channel */
+static Lin_CpuTimeType Lin_CpuTime[MAX_LIN_CHANNELS];
+
+/* Read back errors of each channel */
+static Lin_ReadbackErrorType Lin_ReadbackErrors[MAX_LIN_CHANNELS];
+
+/* Wakeup of each channel */
+static Lin_WakeupStateType Lin_WakeupState[MAX_LIN_CHANNELS];
+
+/* Time from the wakeups of each channel to their first frame */
+static Lin_WakeupLatencyType Lin_WakeupLatency[MAX_LIN_CHANNELS];
+
+/* Frames of each slave channel, NULL_PTR for a master channel */
+static const Lin_PduType *Lin_SlaveFrames[MAX_LIN_CHANNELS];
+
+/* Entry of each frame identifier in the slave frames of a channel, LIN_SLAVE_FRAME_NONE if it has none */
+static uint8 Lin_SlaveIndex[MAX_LIN_CHANNELS][64];
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Computes the checksum of a response with two word loads instead of a byte loop. The bytes of
+ *              both words are added pairwise into 16-bit lanes, which cannot overflow, and the carries are
+ *              folded back once at the end: the end-around carry sum does not depend on the order of the
+ *              additions, so the result is the same as adding and folding byte by byte.
+ * @param       Data: Response, 8 bytes must be readable, the bytes after Dl are masked out
+ * @param       Dl: Response length (1-8 bytes)
+ * @param       Seed: PID for the enhanced checksum, 0 for the classic one
+ * @return      Inverted sum with carry of the seed and the response
+ */
+static uint8 Lin_Checksum(const uint8* Data, uint8 Dl, uint8 Seed)
+{
+    uint32 low = __UNALIGNED_UINT32_READ(&Data[0]);
+    uint32 high = __UNALIGNED_UINT32_READ(&Data[4]);
+    uint32 sum;
+
+    /* Little endian: byte n of the response is byte n of the 64-bit word high:low */
+    if (Dl < 4u)
     {
-        .Lin_BaudRate = 19200,              /* Baud rate for the LIN channel. */
-        .LinChannelWakeupSupport = ENABLE,  /* Wake-up support. */
-        .Lin_ChannelID = 0,                 /* ID of the LIN channel. */
-        .Lin_Port = GPIOA,                  /* GPIO port used for the LIN channel. */
-        .Lin_TxPin = LL_GPIO_PIN_2,            /* Tx pin of the LIN channel. */
-        .Lin_RxPin = LL_GPIO_PIN_3            /* Rx pin of the LIN channel. */
+        low &= (1uL << (8u * Dl)) - 1u;
+        high = 0u;
+    }
+    else if (Dl < 8u)
+    {
+        high &= (1uL << (8u * (Dl - 4u))) - 1u;
     }
-    // Add more channel configurations if needed
-};
 
-/* Array to store the data for each LIN channel */
-uint8 LinChannelData[MAX_LIN_CHANNELS][8]; // Assuming a maximum of 8 bytes per channel
+    sum = (low & 0x00FF00FFu) + ((low >> 8) & 0x00FF00FFu) + (high & 0x00FF00FFu) + ((high >> 8) & 0x00FF00FFu);
+    sum = (sum & 0xFFFFu) + (sum >> 16) + Seed;
+
+    /* At most 9 * 0xFF: the first fold leaves at most 0xFF + 8, the second one at most 0xFF */
+    sum = (sum & 0xFFu) + (sum >> 8);
+    sum = (sum & 0xFFu) + (sum >> 8);
+
+    return (uint8)~sum;
+}
+
+/**
+ * @brief       Checks the slave frames of a configuration: at most one per frame identifier
+ * @param       Config: Configuration of a slave channel
+ * @return      Std_ReturnType
+ *              E_OK: No frames, or at most 64 frames with distinct identifiers
+ *              E_NOT_OK: More than 64 frames, or two frames with the same identifier
+ */
+static Std_ReturnType Lin_CheckSlaveFrames(const Lin_ConfigType *Config)
+{
+    uint32 seen[2] = {0u, 0u};
+    uint8 id;
+    uint8 i;
+
+    if (Config->Lin_SlaveFrames == NULL_PTR)
+    {
+        return E_OK;
+    }
+    if (Config->Lin_SlaveFrameCount > LIN_SLAVE_FRAMES_MAX)
+    {
+        return E_NOT_OK;
+    }
+
+    for (i = 0u; i < Config->Lin_SlaveFrameCount; i++)
+    {
+        id = Config->Lin_SlaveFrames[i].Pid & 0x3Fu;
+        if ((seen[id >> 5] & (1uL << (id & 0x1Fu))) != 0u)
+        {
+            return E_NOT_OK;
+        }
+        seen[id >> 5] |= 1uL << (id & 0x1Fu);
+    }
+
+    return E_OK;
+}
+
+/**
+ * @brief       Stops the frame in progress on a channel, called with interrupts masked
+ * @param       Channel: LIN channel index
+ * @param       USARTx: USART of the channel
+ * @return      void
+ */
+static void Lin_AbortFrame(uint8 Channel, USART_TypeDef* USARTx)
+{
+    const Lin_Hw_DmaType *dma = Lin_Hw_GetDma(Channel);
+
+    Lin_Hw_DisableTxIrq(USARTx);
+    Lin_Hw_DisableRxIrq(USARTx);
+    Lin_Hw_StopDma(dma, dma->TxChannel);
+    Lin_Hw_StopDma(dma, dma->RxChannel);
+    Lin_Frame[Channel].Phase = LIN_FRAME_IDLE;
+}
+
+/**
+ * @brief       Puts a channel to sleep, with the wakeup from Stop mode armed if the channel supports wakeup
+ * @param       Channel: LIN channel index
+ * @return      void
+ */
+static void Lin_EnterSleep(uint8 Channel)
+{
+    LinChannelState[Channel] = LIN_CH_SLEEP;
+    if (LinChannelConfig[Channel].LinChannelWakeupSupport == ENABLE)
+    {
+        Lin_Hw_ArmWakeup(Lin_Hw_GetUnit(Channel));
+    }
+}
+
+/**
+ * @brief       Wakes a channel up and starts timing the wakeup until its first correct frame
+ * @param       Channel: LIN channel index
+ * @param       Start: Cycle count of the wakeup
+ * @return      void
+ */
+static void Lin_LeaveSleep(uint8 Channel, uint32 Start)
+{
+    Lin_Hw_DisarmWakeup(Lin_Hw_GetUnit(Channel));
+    LinChannelState[Channel] = LIN_OPERATIONAL;
+    Lin_WakeupState[Channel].Start = Start;
+    Lin_WakeupState[Channel].Timed = TRUE;
+}
+
+/**
+ * @brief       Ends the frame of a channel and records its CPU time
+ * @param       Channel: LIN channel index
+ * @param       Status: Final channel status
+ * @param       Entry: Cycle count at the entry of the current interrupt
+ * @return      void
+ */
+static void Lin_CompleteFrame(uint8 Channel, Lin_StatusType Status, uint32 Entry)
+{
+    Lin_FrameType *frame = &Lin_Frame[Channel];
+    Lin_CpuTimeType *cpu = &Lin_CpuTime[Channel];
+
+    frame->Phase = LIN_FRAME_IDLE;
+    LinChannelState[Channel] = Status;
+
+    if (Status == LIN_CH_SLEEP)
+    {
+        Lin_EnterSleep(Channel);
+    }
+    else if ((Lin_WakeupState[Channel].Timed == TRUE) && ((Status == LIN_TX_OK) || (Status == LIN_RX_OK)))
+    {
+        Lin_WakeupState[Channel].Timed = FALSE;
+        Lin_WakeupLatency[Channel].LastCycles = Lin_Hw_GetCycles() - Lin_WakeupState[Channel].Start;
+        if (Lin_WakeupLatency[Channel].LastCycles > Lin_WakeupLatency[Channel].MaxCycles)
+        {
+            Lin_WakeupLatency[Channel].MaxCycles = Lin_WakeupLatency[Channel].LastCycles;
+        }
+        Lin_WakeupLatency[Channel].Count++;
+    }
+    else
+    {
+        /* No wakeup being timed, or a frame which does not end it */
+    }
+
+    cpu->LastCycles = frame->Cycles + (Lin_Hw_GetCycles() - Entry);
+    if (cpu->LastCycles > cpu->MaxCycles)
+    {
+        cpu->MaxCycles = cpu->LastCycles;
+    }
+    cpu->Interrupts = frame->Interrupts + 1u;
+    cpu->Count++;
+}
+
+/**
+ * @brief       Starts reading back the bytes of a frame from its first byte sent
+ * @param       Channel: LIN channel index
+ * @param       First: First byte of Bytes sent
+ * @param       Break: 1 if a break is sent before it, 0 otherwise
+ * @return      void
+ */
+static void Lin_StartEcho(uint8 Channel, uint8 First, uint8 Break)
+{
+    Lin_FrameType *frame = &Lin_Frame[Channel];
+
+    frame->First = First;
+    frame->Break = Break;
+    Lin_Hw_FlushRx(Lin_Hw_GetUsart(Channel));
+    Lin_Hw_StartEcho(Lin_Hw_GetDma(Channel), frame->Echo, (uint32)Break + frame->Count - First);
+}
+
+/**
+ * @brief       Compares the bytes read back from the bus with the bytes sent
+ * @param       Channel: LIN channel index
+ * @param       Complete: TRUE once every byte must have been read back, a missing one is a mismatch; FALSE to
+ *              check the bytes read back so far
+ * @return      LIN_TX_OK if they match, LIN_TX_HEADER_ERROR if the first mismatch is in the break, the sync
+ *              field or the PID, LIN_TX_ERROR if it is in the response
+ */
+static Lin_StatusType Lin_CheckEcho(uint8 Channel, uint8 Complete)
+{
+    const Lin_Hw_DmaType *dma = Lin_Hw_GetDma(Channel);
+    const Lin_FrameType *frame = &Lin_Frame[Channel];
+    uint32 expected = (uint32)frame->Break + frame->Count - frame->First;
+    uint32 received = expected - LL_DMA_GetDataLength(dma->Dma, dma->RxChannel);
+    uint32 k;
+    uint32 index;
+
+    if (Complete == FALSE)
+    {
+        expected = received;
+    }
+
+    for (k = 0u; k < expected; k++)
+    {
+        /* Index in Bytes of the byte read back, the break comes before Bytes[0] */
+        index = frame->First + k - frame->Break;
+        if ((k >= received) || (frame->Echo[k] != ((k < frame->Break) ? 0x00u : frame->Bytes[index])))
+        {
+            return ((k < frame->Break) || (index < 2u)) ? LIN_TX_HEADER_ERROR : LIN_TX_ERROR;
+        }
+    }
+
+    return LIN_TX_OK;
+}
+
+/**
+ * @brief       Aborts a frame whose read back differs from the bytes sent. The go-to-sleep command still puts
+ *              the channel to sleep.
+ * @param       Channel: LIN channel index
+ * @param       USARTx: USART of the channel
+ * @param       Error: LIN_TX_HEADER_ERROR or LIN_TX_ERROR
+ * @param       Entry: Cycle count at the entry of the current interrupt
+ * @return      void
+ */
+static void Lin_AbortEcho(uint8 Channel, USART_TypeDef* USARTx, Lin_StatusType Error, uint32 Entry)
+{
+    if (Error == LIN_TX_HEADER_ERROR)
+    {
+        Lin_ReadbackErrors[Channel].HeaderErrors++;
+    }
+    else
+    {
+        Lin_ReadbackErrors[Channel].ResponseErrors++;
+    }
+
+    Lin_AbortFrame(Channel, USARTx);
+    Lin_CompleteFrame(Channel, (Lin_Frame[Channel].Done == LIN_CH_SLEEP) ? LIN_CH_SLEEP : Error, Entry);
+}
+
+/**
+ * @brief       Starts a frame: requests the break and hands the sync field, the PID and the response to the
+ *              transmit DMA channel. The sync field waits in TDR until the break has been sent. A frame still
+ *              in progress is aborted.
+ * @param       Channel: LIN channel index
+ * @param       Pid: Frame identifier (0..0x3F), the parity is added here
+ * @param       Sdu: Response to send, NULL_PTR to send the header only
+ * @param       Cs: Checksum model of the response, diagnostic frames always use the classic one
+ * @param       Dl: Response length (1-8 bytes)
+ * @param       Done: Channel status once the frame has been sent, LIN_RX_NO_RESPONSE to receive Dl bytes
+ * @return      Std_ReturnType
+ *              E_OK: Frame started
+ *              E_NOT_OK: Channel does not exist or invalid length
+ */
+static Std_ReturnType Lin_StartFrame(uint8 Channel, uint8 Pid, Lin_FrameCsModelType Cs, const uint8* Sdu,
+                                     uint8 Dl, Lin_StatusType Done)
+{
+    USART_TypeDef *USARTx = Lin_Hw_GetUsart(Channel);
+    Lin_FrameType *frame = &Lin_Frame[Channel];
+    uint32 start = Lin_Hw_GetCycles();
+    uint32 primask;
+    uint8 i;
+
+    if ((USARTx == NULL_PTR) || (Dl == 0u) || (Dl > 8u))
+    {
+        return E_NOT_OK;
+    }
+
+    primask = Lin_Hw_EnterCritical();
+
+    Lin_AbortFrame(Channel, USARTx);
+
+    frame->Bytes[0] = SYNC_FIELD;
+    frame->Bytes[1] = Lin_PidTable[Pid & 0x3Fu];
+    frame->Seed = ((Cs == LIN_ENHANCED_CS) && ((Pid & 0x3Fu) < LIN_MASTER_REQUEST_ID)) ? frame->Bytes[1] : 0u;
+    frame->Count = 2u;
+    if (Sdu != NULL_PTR)
+    {
+        /* The SDU is only valid during the call, the response is sent from the copy */
+        for (i = 0u; i < Dl; i++)
+        {
+            frame->Bytes[2u + i] = Sdu[i];
+        }
+        frame->Bytes[2u + Dl] = Lin_Checksum(&frame->Bytes[2], Dl, frame->Seed);
+        frame->Count = (uint8)(3u + Dl);
+    }
+    frame->Dl = Dl;
+    frame->Done = Done;
+    frame->Interrupts = 0u;
+    frame->Phase = LIN_FRAME_BYTES;
+    LinChannelState[Channel] = LIN_TX_BUSY;
+
+    if (Done == LIN_RX_NO_RESPONSE)
+    {
+        LL_USART_SetRxTimeout(USARTx, LIN_INTERBYTE_TIMEOUT_BITS(Dl));
+    }
+
+    Lin_StartEcho(Channel, 0u, 1u);
+    LL_USART_RequestBreakSending(USARTx);
+    Lin_Hw_StartDma(Lin_Hw_GetDma(Channel), Lin_Hw_GetDma(Channel)->TxChannel, frame->Bytes, frame->Count);
+    frame->Cycles = Lin_Hw_GetCycles() - start;
+
+    Lin_Hw_ExitCritical(primask);
+
+    return E_OK;
+}
+
+/**
+ * @brief       Transmit DMA interrupt of a channel: the last byte is in TDR, waits for it to leave the USART.
+ *              The bytes read back so far are checked, a mismatch aborts the frame at once.
+ * @param       Channel: LIN channel index
+ * @return      void
+ */
+static void Lin_DmaTxIsr(uint8 Channel)
+{
+    const Lin_Hw_DmaType *dma;
+    Lin_FrameType *frame;
+    Lin_StatusType echo;
+    uint32 entry = Lin_Hw_GetCycles();
+
+    if (Channel >= MAX_LIN_CHANNELS)
+    {
+        return;
+    }
+    dma = Lin_Hw_GetDma(Channel);
+    frame = &Lin_Frame[Channel];
+
+    if ((Lin_Hw_DmaCompleted(dma, dma->TxChannel) == TRUE) && (frame->Phase == LIN_FRAME_BYTES))
+    {
+        /* The DMA write of the last byte has cleared TC, which rises again once the byte has been sent */
+        LL_DMA_DisableChannel(dma->Dma, dma->TxChannel);
+        echo = Lin_CheckEcho(Channel, FALSE);
+        if (echo != LIN_TX_OK)
+        {
+            Lin_AbortEcho(Channel, Lin_Hw_GetUsart(Channel), echo, entry);
+            return;
+        }
+        LL_USART_EnableIT_TC(Lin_Hw_GetUsart(Channel));
+        frame->Phase = LIN_FRAME_LAST;
+        frame->Interrupts++;
+        frame->Cycles += Lin_Hw_GetCycles() - entry;
+    }
+}
+
+/**
+ * @brief       Starts the deadline of the response of an RX frame, at the stop bit of its PID
+ * @param       Channel: LIN channel index
+ * @return      void
+ */
+static void Lin_StartResponse(uint8 Channel)
+{
+    Lin_FrameType *frame = &Lin_Frame[Channel];
+
+    frame->ResponseStart = Lin_Hw_GetCycles();
+    frame->ResponseLimit = LIN_RESPONSE_TIMEOUT_BITS(frame->Dl) *
+                           (LIN_CPU_CLOCK_HZ / LinChannelConfig[Channel].Lin_BaudRate);
+}
+
+/**
+ * @brief       Checks whether the response of an RX frame has outlasted its TResponse_Maximum
+ * @param       Channel: LIN channel index
+ * @param       Now: Cycle count to check
+ * @return      TRUE if the deadline has passed
+ */
+static uint8 Lin_ResponseLate(uint8 Channel, uint32 Now)
+{
+    return ((Now - Lin_Frame[Channel].ResponseStart) > Lin_Frame[Channel].ResponseLimit) ? TRUE : FALSE;
+}
+
+/**
+ * @brief       Stops the receive DMA channel and the receive interrupts of a response not completed
+ * @param       Channel: LIN channel index
+ * @param       USARTx: USART of the channel
+ * @return      LIN_RX_NO_RESPONSE if no byte has arrived and no error is flagged, LIN_RX_ERROR otherwise
+ */
+static Lin_StatusType Lin_StopResponse(uint8 Channel, USART_TypeDef* USARTx)
+{
+    const Lin_Hw_DmaType *dma = Lin_Hw_GetDma(Channel);
+    uint32 missing;
+    uint8 error = Lin_Hw_RxError(USARTx);
+
+    Lin_Hw_DisableRxIrq(USARTx);
+    LL_DMA_DisableChannel(dma->Dma, dma->RxChannel);
+    missing = LL_DMA_GetDataLength(dma->Dma, dma->RxChannel);
+    Lin_Hw_FlushRx(USARTx);
+    LL_USART_ClearFlag_RTO(USARTx);
+
+    /* Silence is no response, a short, late or corrupted response is an error */
+    return ((error == FALSE) && (missing == Lin_Frame[Channel].Dl + 1u)) ? LIN_RX_NO_RESPONSE : LIN_RX_ERROR;
+}
+
+/**
+ * @brief       Ends the response of an RX frame before the receive DMA channel has completed, on a receiver
+ *              timeout or a receive error
+ * @param       Channel: LIN channel index
+ * @param       USARTx: USART of the channel
+ * @param       Entry: Cycle count at the entry of the current interrupt
+ * @return      void
+ */
+static void Lin_AbortResponse(uint8 Channel, USART_TypeDef* USARTx, uint32 Entry)
+{
+    Lin_CompleteFrame(Channel, Lin_StopResponse(Channel, USARTx), Entry);
+}
+
+/**
+ * @brief       LIN break seen by a slave channel: a frame still in progress is cut by the master, and the
+ *              receive DMA channel captures the sync field and the PID of the new header into Bytes
+ * @param       Channel: LIN channel index
+ * @param       USARTx: USART of the channel
+ * @param       Entry: Cycle count at the entry of the current interrupt
+ * @return      void
+ */
+static void Lin_SlaveBreak(uint8 Channel, USART_TypeDef* USARTx, uint32 Entry)
+{
+    const Lin_Hw_DmaType *dma = Lin_Hw_GetDma(Channel);
+    Lin_FrameType *frame = &Lin_Frame[Channel];
+
+    if (frame->Phase == LIN_FRAME_RESPONSE)
+    {
+        Lin_AbortResponse(Channel, USARTx, Entry);
+        Entry = Lin_Hw_GetCycles();
+    }
+    else if (frame->Phase != LIN_FRAME_IDLE)
+    {
+        Lin_AbortFrame(Channel, USARTx);
+        LinChannelState[Channel] = LIN_TX_ERROR;
+    }
+
+    /* RDR holds the break as a 0x00 byte with a framing error */
+    Lin_Hw_FlushRx(USARTx);
+    Lin_Hw_StartDma(dma, dma->RxChannel, frame->Bytes, 2u);
+    frame->Slave = NULL_PTR;
+    frame->Phase = LIN_FRAME_HEADER;
+
+    /* Bus activity wakes a sleeping slave up */
+    if (LinChannelState[Channel] == LIN_CH_SLEEP)
+    {
+        LinChannelState[Channel] = LIN_OPERATIONAL;
+    }
+
+    frame->Interrupts = 1u;
+    frame->Cycles = Lin_Hw_GetCycles() - Entry;
+}
+
+/**
+ * @brief       Header received by a slave channel: the response of its entry in the slave frames is handed to
+ *              the transmit DMA channel, or the receive DMA channel is armed for it, while the stop bit of the
+ *              PID is still on the bus. Frames without an entry are left to the other nodes.
+ * @param       Channel: LIN channel index
+ * @param       Entry: Cycle count at the entry of the current interrupt
+ * @return      void
+ */
+static void Lin_SlaveHeader(uint8 Channel, uint32 Entry)
+{
+    USART_TypeDef *USARTx = Lin_Hw_GetUsart(Channel);
+    const Lin_Hw_DmaType *dma = Lin_Hw_GetDma(Channel);
+    Lin_FrameType *frame = &Lin_Frame[Channel];
+    const Lin_PduType *slave;
+    uint8 pid = frame->Bytes[1];
+    uint8 index = Lin_SlaveIndex[Channel][pid & 0x3Fu];
+    uint8 i;
+
+    LL_DMA_DisableChannel(dma->Dma, dma->RxChannel);
+
+    if ((frame->Bytes[0] != SYNC_FIELD) || (Lin_PidTable[pid & 0x3Fu] != pid))
+    {
+        Lin_CompleteFrame(Channel, LIN_TX_HEADER_ERROR, Entry);
+        return;
+    }
+    if (index == LIN_SLAVE_FRAME_NONE)
+    {
+        frame->Phase = LIN_FRAME_IDLE;
+        return;
+    }
+
+    slave = &Lin_SlaveFrames[Channel][index];
+    frame->Dl = slave->Dl;
+    frame->Seed = ((slave->Cs == LIN_ENHANCED_CS) && ((pid & 0x3Fu) < LIN_MASTER_REQUEST_ID)) ? pid : 0u;
+
+    if (slave->Drc == LIN_FRAMERESPONSE_TX)
+    {
+        /* The response follows the header in Bytes, as on a master channel */
+        for (i = 0u; i < slave->Dl; i++)
+        {
+            frame->Bytes[2u + i] = slave->SduPtr[i];
+        }
+        frame->Bytes[2u + slave->Dl] = Lin_Checksum(&frame->Bytes[2], slave->Dl, frame->Seed);
+        frame->Count = (uint8)(3u + slave->Dl);
+        frame->Done = LIN_TX_OK;
+        frame->Phase = LIN_FRAME_BYTES;
+        LinChannelState[Channel] = LIN_TX_BUSY;
+        Lin_StartEcho(Channel, 2u, 0u);
+        Lin_Hw_StartDma(dma, dma->TxChannel, &frame->Bytes[2], (uint32)slave->Dl + 1u);
+    }
+    else
+    {
+        LL_USART_SetRxTimeout(USARTx, LIN_INTERBYTE_TIMEOUT_BITS(slave->Dl));
+        Lin_Hw_StartDma(dma, dma->RxChannel, LinChannelData[Channel], (uint32)slave->Dl + 1u);
+        Lin_Hw_EnableRxIrq(USARTx);
+        Lin_StartResponse(Channel);
+        frame->Slave = slave;
+        frame->Done = LIN_RX_OK;
+        frame->Phase = LIN_FRAME_RESPONSE;
+        LinChannelState[Channel] = LIN_RX_NO_RESPONSE;
+    }
+
+    frame->Interrupts++;
+    frame->Cycles += Lin_Hw_GetCycles() - Entry;
+}
+
+/**
+ * @brief       USART interrupt of a channel. When the last byte has been sent, a TX frame is complete and an
+ *              RX frame arms the receive DMA channel for its response and checksum, once the read back of the
+ *              bytes sent has been checked. While the response is
+ *              received, a receiver timeout or a receive error ends it. On a slave channel, a LIN break starts
+ *              the capture of the next header. On a sleeping channel, a start bit wakes the channel up.
+ * @param       Channel: LIN channel index
+ * @return      void
+ */
+static void Lin_Isr(uint8 Channel)
+{
+    USART_TypeDef *USARTx;
+    const Lin_Hw_DmaType *dma;
+    Lin_FrameType *frame;
+    Lin_StatusType echo;
+    uint32 entry = Lin_Hw_GetCycles();
+
+    if (Channel >= MAX_LIN_CHANNELS)
+    {
+        return;
+    }
+    USARTx = Lin_Hw_GetUsart(Channel);
+    dma = Lin_Hw_GetDma(Channel);
+    frame = &Lin_Frame[Channel];
+
+    if ((LL_USART_IsEnabledIT_WKUP(USARTx) != 0u) && (LL_USART_IsActiveFlag_WKUP(USARTx) != 0u))
+    {
+        /* The pulse or the break waking the bus up is received as a 0x00 byte, flushed by the next frame */
+        Lin_LeaveSleep(Channel, entry);
+        Lin_WakeupState[Channel].Detected = TRUE;
+    }
+    else if ((Lin_SlaveFrames[Channel] != NULL_PTR) && (LL_USART_IsActiveFlag_LBD(USARTx) != 0u))
+    {
+        LL_USART_ClearFlag_LBD(USARTx);
+        Lin_SlaveBreak(Channel, USARTx, entry);
+    }
+    else if ((frame->Phase == LIN_FRAME_LAST) && (LL_USART_IsActiveFlag_TC(USARTx) != 0u))
+    {
+        /* The last byte has been read back half a bit before TC */
+        LL_USART_DisableIT_TC(USARTx);
+        LL_DMA_DisableChannel(dma->Dma, dma->RxChannel);
+        echo = Lin_CheckEcho(Channel, TRUE);
+        if (echo != LIN_TX_OK)
+        {
+            Lin_AbortEcho(Channel, USARTx, echo, entry);
+        }
+        else if (frame->Done == LIN_RX_NO_RESPONSE)
+        {
+            /* RDR holds the echo of the PID, the slave starts its response after the stop bit */
+            Lin_Hw_FlushRx(USARTx);
+            Lin_Hw_StartDma(dma, dma->RxChannel, LinChannelData[Channel], frame->Dl + 1u);
+            Lin_Hw_EnableRxIrq(USARTx);
+            Lin_StartResponse(Channel);
+            frame->Phase = LIN_FRAME_RESPONSE;
+            LinChannelState[Channel] = LIN_RX_NO_RESPONSE;
+            frame->Interrupts++;
+            frame->Cycles += Lin_Hw_GetCycles() - entry;
+        }
+        else
+        {
+            Lin_CompleteFrame(Channel, frame->Done, entry);
+        }
+    }
+    else if ((frame->Phase == LIN_FRAME_RESPONSE) &&
+             ((LL_USART_IsActiveFlag_RTO(USARTx) != 0u) || (Lin_Hw_RxError(USARTx) == TRUE)))
+    {
+        Lin_AbortResponse(Channel, USARTx, entry);
+    }
+    else
+    {
+        /* Nothing in progress, e.g. an interrupt left pending by an aborted frame */
+        Lin_Hw_DisableTxIrq(USARTx);
+        Lin_Hw_DisableRxIrq(USARTx);
+    }
+}
+
+/**
+ * @brief       Receive DMA interrupt of a channel: the response and its checksum are in LinChannelData,
+ *              the checksum is verified once over the whole response. On a slave channel, a correct response
+ *              is copied to its slave frame, and the end of a header selects the response.
+ * @param       Channel: LIN channel index
+ * @return      void
+ */
+static void Lin_DmaRxIsr(uint8 Channel)
+{
+    const Lin_Hw_DmaType *dma;
+    Lin_FrameType *frame;
+    uint8 *data;
+    uint8 i;
+    uint32 entry = Lin_Hw_GetCycles();
+
+    if (Channel >= MAX_LIN_CHANNELS)
+    {
+        return;
+    }
+    dma = Lin_Hw_GetDma(Channel);
+    frame = &Lin_Frame[Channel];
+    data = LinChannelData[Channel];
+
+    if (Lin_Hw_DmaCompleted(dma, dma->RxChannel) == FALSE)
+    {
+        return;
+    }
+
+    if (frame->Phase == LIN_FRAME_HEADER)
+    {
+        Lin_SlaveHeader(Channel, entry);
+    }
+    else if (frame->Phase == LIN_FRAME_RESPONSE)
+    {
+        LL_DMA_DisableChannel(dma->Dma, dma->RxChannel);
+        Lin_Hw_DisableRxIrq(Lin_Hw_GetUsart(Channel));
+        /* The receiver timeout only ends a response that stops, a slow one is caught here */
+        if ((Lin_ResponseLate(Channel, entry) == TRUE) ||
+            (Lin_Checksum(data, frame->Dl, frame->Seed) != data[frame->Dl]))
+        {
+            Lin_CompleteFrame(Channel, LIN_RX_ERROR, entry);
+            return;
+        }
+        if (frame->Slave != NULL_PTR)
+        {
+            for (i = 0u; i < frame->Dl; i++)
+            {
+                frame->Slave->SduPtr[i] = data[i];
+            }
+        }
+        Lin_CompleteFrame(Channel, LIN_RX_OK, entry);
+    }
+}
 
 /*
  ************************************************************************************************************
@@ -63,57 +785,118 @@ uint8 LinChannelData[MAX_LIN_CHANNELS][8]; // Assuming a maximum of 8 bytes per
  */
 /**
  * @brief       Initializes the LIN module.
+ * @details     Initializes the channel Config->Lin_Channel at the baud rate and on the USART, pins and DMA channels
+ *              given by its entry in LinChannelConfig; call it once per channel. Channels on LPUART1 are refused, it has neither
+ *              LIN break generation and detection nor a receiver timeout.
+ *              A slave channel (Lin_Mode LIN_MODE_SLAVE) answers the headers of the master from the frames of
+ *              Config->Lin_SlaveFrames, indexed here by frame identifier. Entries with an invalid length or a TX
+ *              entry without SduPtr are left out. A slave configuration with more than 64 frames or with two
+ *              frames of the same identifier is refused.
  * @param       Config: Pointer to LIN driver configuration set.
  * @return      void
  */
 void Lin_Init(const Lin_ConfigType *Config)
 {
+    const LinChannelConfigType *channel;
+    const Lin_Hw_UnitType *unit;
+    USART_TypeDef *USARTx;
+    LL_USART_InitTypeDef USART_InitStruct = {0};
+    LL_GPIO_InitTypeDef GPIO_InitStruct = {0};
+    const Lin_PduType *slave;
+    uint8 i;
+
     /* Check if the configuration is valid */
-    if (Config == NULL_PTR) 
+    if ((Config == NULL_PTR) || (Config->Lin_Channel >= MAX_LIN_CHANNELS) ||
+        (LinChannelConfig[Config->Lin_Channel].Lin_HwUnit >= LIN_HW_LPUART1) ||
+        ((Config->Lin_Mode == LIN_MODE_SLAVE) && (Lin_CheckSlaveFrames(Config) != E_OK)))
     {
         return; /* Return if the configuration is invalid */
     }
 
-    /* Activate clock for GPIOA used for communicate LIN */
-    LL_AHB2_GRP1_EnableClock(LL_AHB2_GRP1_PERIPH_GPIOA);
-
-    LL_USART_InitTypeDef USART_InitStruct = {0};
-
-    LL_GPIO_InitTypeDef GPIO_InitStruct = {0};
-
-    LL_RCC_SetUSARTClockSource(LL_RCC_USART2_CLKSOURCE_PCLK1);
+    channel = &LinChannelConfig[Config->Lin_Channel];
+    unit = Lin_Hw_GetUnit(Config->Lin_Channel);
+    USARTx = unit->Usart;
 
     /* Peripheral clock enable */
-    LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_USART2);
-
-    LL_AHB2_GRP1_EnableClock(LL_AHB2_GRP1_PERIPH_GPIOA);
-    /**USART2 GPIO Configuration
-    PA2   ------> USART2_TX
-    PA3   ------> USART2_RX
-    */
-    GPIO_InitStruct.Pin = LL_GPIO_PIN_2|LL_GPIO_PIN_3;
+    Lin_Hw_EnableClock(channel->Lin_HwUnit);
+    Lin_Hw_EnableGpioClock(channel->Lin_Port);
+
+    /* TX and RX pins of the channel */
+    GPIO_InitStruct.Pin = channel->Lin_TxPin | channel->Lin_RxPin;
     GPIO_InitStruct.Mode = LL_GPIO_MODE_ALTERNATE;
     GPIO_InitStruct.Speed = LL_GPIO_SPEED_FREQ_VERY_HIGH;
     GPIO_InitStruct.OutputType = LL_GPIO_OUTPUT_PUSHPULL;
     GPIO_InitStruct.Pull = LL_GPIO_PULL_NO;
-    GPIO_InitStruct.Alternate = LL_GPIO_AF_7;
-    LL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+    GPIO_InitStruct.Alternate = channel->Lin_Alternate;
+    LL_GPIO_Init(channel->Lin_Port, &GPIO_InitStruct);
 
-    /* USER CODE BEGIN USART2_Init 1 */
-
-    /* USER CODE END USART2_Init 1 */
-    USART_InitStruct.BaudRate = Config->Lin_BaudRate;
+    USART_InitStruct.BaudRate = channel->Lin_BaudRate;
     USART_InitStruct.DataWidth = LL_USART_DATAWIDTH_8B;
     USART_InitStruct.StopBits = LL_USART_STOPBITS_1;
     USART_InitStruct.Parity = LL_USART_PARITY_NONE;
     USART_InitStruct.TransferDirection = LL_USART_DIRECTION_TX_RX;
     USART_InitStruct.OverSampling = LL_USART_OVERSAMPLING_16;
-    LL_USART_Init(USART2, &USART_InitStruct);
-    LL_USART_SetLINBrkDetectionLen(USART2, LL_USART_LINBREAK_DETECT_10B);
-    LL_USART_DisableDMADeactOnRxErr(USART2);
-    LL_USART_ConfigLINMode(USART2);
-    LL_USART_Enable(USART2);
-    LL_USART_EnableLIN(USART2);
+    LL_USART_Init(USARTx, &USART_InitStruct);
+    LL_USART_SetLINBrkDetectionLen(USARTx, LL_USART_LINBREAK_DETECT_10B);
+    LL_USART_DisableDMADeactOnRxErr(USARTx);
+    LL_USART_SetWKUPType(USARTx, LL_USART_WAKEUP_ON_STARTBIT);
+    LL_USART_ConfigLINMode(USARTx);
+    LL_USART_Enable(USARTx);
+    LL_USART_EnableLIN(USARTx);
+
+    /* Header and response are moved by DMA, the USART only signals the end of the transmission */
+    Lin_Hw_InitDmaChannel(&unit->Dma, unit->Dma.TxChannel, LL_DMA_DIRECTION_MEMORY_TO_PERIPH,
+                          LL_USART_DMA_GetRegAddr(USARTx, LL_USART_DMA_REG_DATA_TRANSMIT));
+    Lin_Hw_InitDmaChannel(&unit->Dma, unit->Dma.RxChannel, LL_DMA_DIRECTION_PERIPH_TO_MEMORY,
+                          LL_USART_DMA_GetRegAddr(USARTx, LL_USART_DMA_REG_DATA_RECEIVE));
+    LL_USART_EnableDMAReq_TX(USARTx);
+    LL_USART_EnableDMAReq_RX(USARTx);
+
+    /* The receiver timeout bounds the slave response, its length is set per frame */
+    LL_USART_EnableRxTimeout(USARTx);
+
+    /* A slave is driven by the break of every header, LBDF is raised at the end of the break */
+    Lin_SlaveFrames[Config->Lin_Channel] = NULL_PTR;
+    for (i = 0u; i < 64u; i++)
+    {
+        Lin_SlaveIndex[Config->Lin_Channel][i] = LIN_SLAVE_FRAME_NONE;
+    }
+    if ((Config->Lin_Mode == LIN_MODE_SLAVE) && (Config->Lin_SlaveFrames != NULL_PTR))
+    {
+        for (i = 0u; i < Config->Lin_SlaveFrameCount; i++)
+        {
+            slave = &Config->Lin_SlaveFrames[i];
+            if ((slave->Dl >= 1u) && (slave->Dl <= 8u) && (slave->Drc != LIN_FRAMERESPONSE_IGNORE) &&
+                (slave->SduPtr != NULL_PTR))
+            {
+                Lin_SlaveIndex[Config->Lin_Channel][slave->Pid & 0x3Fu] = i;
+            }
+        }
+        Lin_SlaveFrames[Config->Lin_Channel] = Config->Lin_SlaveFrames;
+        LL_USART_ClearFlag_LBD(USARTx);
+        LL_USART_EnableIT_LBD(USARTx);
+    }
+    else
+    {
+        LL_USART_DisableIT_LBD(USARTx);
+    }
+
+    Lin_Hw_EnableCycleCounter();
+    Lin_Frame[Config->Lin_Channel].Phase = LIN_FRAME_IDLE;
+    Lin_Frame[Config->Lin_Channel].Slave = NULL_PTR;
+    Lin_CpuTime[Config->Lin_Channel] = (Lin_CpuTimeType){0};
+    Lin_WakeupState[Config->Lin_Channel] = (Lin_WakeupStateType){0};
+    Lin_WakeupLatency[Config->Lin_Channel] = (Lin_WakeupLatencyType){0};
+    Lin_ReadbackErrors[Config->Lin_Channel] = (Lin_ReadbackErrorType){0};
+    Lin_UnitChannel[channel->Lin_HwUnit] = Config->Lin_Channel;
+    Lin_EnterSleep(Config->Lin_Channel);
+
+    NVIC_SetPriority(unit->IRQn, LIN_IRQ_PRIORITY);
+    NVIC_SetPriority(unit->Dma.TxIRQn, LIN_IRQ_PRIORITY);
+    NVIC_SetPriority(unit->Dma.RxIRQn, LIN_IRQ_PRIORITY);
+    NVIC_EnableIRQ(unit->IRQn);
+    NVIC_EnableIRQ(unit->Dma.TxIRQn);
+    NVIC_EnableIRQ(unit->Dma.RxIRQn);
 }
 
 /**
@@ -125,16 +908,16 @@ void Lin_Init(const Lin_ConfigType *Config)
  */
 Std_ReturnType Lin_CheckWakeup(uint8 Channel)
 {
-     if (Channel != 0) 
-     {
+    if (Channel >= MAX_LIN_CHANNELS)
+    {
         return E_NOT_OK; // Invalid channel
     }
 
-    if (LL_USART_IsActiveFlag_WKUP(USART2)) 
+    /* The USART interrupt has already woken the channel up */
+    if (Lin_WakeupState[Channel].Detected == TRUE)
     {
-        /* Clear the wake-up flag */
-        LL_USART_ClearFlag_WKUP(USART2);
-        
+        Lin_WakeupState[Channel].Detected = FALSE;
+
         /* Return E_OK if wakeup was detected */
         return E_OK;
     }
@@ -177,18 +960,32 @@ void Lin_GetVersionInfo(Std_VersionInfoType *versioninfo)
  */
 Std_ReturnType Lin_SendFrame(uint8 Channel, const Lin_PduType *PduInfoPtr)
 {
-    if (PduInfoPtr == NULL_PTR)
+    if ((PduInfoPtr == NULL_PTR) || (Channel >= MAX_LIN_CHANNELS))
     {
         return E_NOT_OK;
     }
 
-    LIN_SendBreak();
-    LIN_SendSync();
-    LIN_SendID(PduInfoPtr->Pid);
-    LIN_SendData(PduInfoPtr->SduPtr, PduInfoPtr->Dl);
-    LIN_SendChecksum(PduInfoPtr->SduPtr, PduInfoPtr->Dl);
+    /* A sleeping channel has to be woken up first, an uninitialized one stays at LIN_NOT_OK, and only the
+     * master sends headers */
+    if ((LinChannelState[Channel] == LIN_CH_SLEEP) || (LinChannelState[Channel] == LIN_NOT_OK) ||
+        (Lin_SlaveFrames[Channel] != NULL_PTR))
+    {
+        return E_NOT_OK;
+    }
 
-    return E_OK;
+    if (PduInfoPtr->Drc == LIN_FRAMERESPONSE_TX)
+    {
+        if (PduInfoPtr->SduPtr == NULL_PTR)
+        {
+            return E_NOT_OK;
+        }
+        return Lin_StartFrame(Channel, PduInfoPtr->Pid, PduInfoPtr->Cs, PduInfoPtr->SduPtr, PduInfoPtr->Dl,
+                              LIN_TX_OK);
+    }
+
+    /* Header only, the response comes from a slave */
+    return Lin_StartFrame(Channel, PduInfoPtr->Pid, PduInfoPtr->Cs, NULL_PTR, PduInfoPtr->Dl,
+                          (PduInfoPtr->Drc == LIN_FRAMERESPONSE_RX) ? LIN_RX_NO_RESPONSE : LIN_TX_OK);
 }
 
 /**
@@ -200,28 +997,17 @@ Std_ReturnType Lin_SendFrame(uint8 Channel, const Lin_PduType *PduInfoPtr)
  */
 Std_ReturnType Lin_GoToSleep(uint8 Channel)
 {
+    static const uint8 goToSleep[8] = {0x00u, 0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu};
+
     // Check the validity of the Channel
-    if (Channel >= MAX_LIN_CHANNELS)
+    if ((Channel >= MAX_LIN_CHANNELS) || (LinChannelState[Channel] == LIN_NOT_OK) ||
+        (Lin_SlaveFrames[Channel] != NULL_PTR))
     {
-        return E_NOT_OK; // Invalid Channel
+        return E_NOT_OK; // Invalid Channel, or a slave which does not send headers
     }
 
-    // Send the "go-to-sleep" signal by transmitting the Break field and sending the sleep ID frame
-    LIN_SendBreak(); // Transmit Break field to signal sleep
-
-    // Wait for the transmission to complete
-    while (!LL_USART_IsActiveFlag_TC(USART2));
-
-    uint8 LIN_GO_TO_SLEEP = 0xFF;
-    LIN_SendData(&LIN_GO_TO_SLEEP, 1); // Transmit frame with sleep ID
-
-    // Wait for the transmission to complete
-    while (!LL_USART_IsActiveFlag_TC(USART2));
-
-    // Set the LIN channel state to sleep mode
-    LinChannelState[Channel] = LIN_CH_SLEEP;
-
-    return E_OK; // Sleep command executed successfully
+    // Send the go-to-sleep command as a master request frame, the channel sleeps once it has been sent
+    return Lin_StartFrame(Channel, LIN_MASTER_REQUEST_ID, LIN_CLASSIC_CS, goToSleep, 8u, LIN_CH_SLEEP);
 }
 
 /**
@@ -234,26 +1020,21 @@ Std_ReturnType Lin_GoToSleep(uint8 Channel)
  */
 Std_ReturnType Lin_GoToSleepInternal(uint8 Channel)
 {
+    USART_TypeDef *USARTx = Lin_Hw_GetUsart(Channel);
+    uint32 primask;
+
     // Check if the Channel is valid
-    if (Channel >= MAX_LIN_CHANNELS)
+    if ((USARTx == NULL_PTR) || (LinChannelState[Channel] == LIN_NOT_OK))
     {
         return E_NOT_OK; // Return error if channel is invalid
     }
 
-    // Send the "go-to-sleep" signal by transmitting the Break field and sending the sleep ID
-    LIN_SendBreak(); // Transmit Break field to signal sleep mode
-
-    // Wait for the transmission to complete
-    while (!LL_USART_IsActiveFlag_TC(USART2));
-
-    // Update the LIN channel state to sleep mode
-    LinChannelState[Channel] = LIN_CH_SLEEP;
-
-    // Activate wake-up detection if necessary
-    if (LinChannelConfig[Channel].LinChannelWakeupSupport == ENABLE)
-    {
-        // Enable wake-up detection mode, which could be through interrupts or bus monitoring
-    }
+    // Stop any frame in progress and update the LIN channel state to sleep mode, with the wake-up
+    // detection armed in Stop mode if the channel supports it
+    primask = Lin_Hw_EnterCritical();
+    Lin_AbortFrame(Channel, USARTx);
+    Lin_EnterSleep(Channel);
+    Lin_Hw_ExitCritical(primask);
 
     return E_OK; // Return `E_OK` if the process is successful
 }
@@ -267,27 +1048,29 @@ Std_ReturnType Lin_GoToSleepInternal(uint8 Channel)
  */
 Std_ReturnType Lin_Wakeup(uint8 Channel)
 {
+    uint32 primask;
+
      // Check if the Channel is valid
     if (Channel >= MAX_LIN_CHANNELS)
     {
         return E_NOT_OK; // Return error if Channel is invalid
     }
 
-    // Check the channel state; it must be LIN_CH_SLEEP to continue
+    // Check the channel state; it must be LIN_CH_SLEEP to continue, a wakeup from the bus may come first
+    primask = Lin_Hw_EnterCritical();
     if (LinChannelState[Channel] != LIN_CH_SLEEP)
     {
+        Lin_Hw_ExitCritical(primask);
         return E_NOT_OK; // Return error if the channel is not in sleep state
     }
 
-    // Send a wake-up signal by transmitting a dominant bit
-		uint8 dominantBit = 0x80;
-    LIN_SendData(&dominantBit, 1); // Transmit byte with dominant bit 0b10000000
+    // Update the channel state to LIN_CH_OPERATIONAL, the wake-up detection is disarmed before the echo of
+    // the pulse reaches RX
+    Lin_LeaveSleep(Channel, Lin_Hw_GetCycles());
 
-    // Wait for the transmission to complete
-    while (!LL_USART_IsActiveFlag_TC(USART2));
-
-    // Update the channel state to LIN_CH_OPERATIONAL
-    LinChannelState[Channel] = LIN_OPERATIONAL;
+    // Send a wake-up signal by transmitting a dominant pulse, no frame is in progress while sleeping
+    LL_USART_TransmitData8(Lin_Hw_GetUsart(Channel), 0x80u); // Byte 0b10000000, 8 dominant bits with the start bit
+    Lin_Hw_ExitCritical(primask);
 
     return E_OK; // Return `E_OK` if successful
 }
@@ -301,13 +1084,27 @@ Std_ReturnType Lin_Wakeup(uint8 Channel)
  */
 Std_ReturnType Lin_WakeupInternal(uint8 Channel)
 {
+    // Check if the Channel is valid
+    if ((Channel >= MAX_LIN_CHANNELS) || (LinChannelState[Channel] == LIN_NOT_OK))
+    {
+        return E_NOT_OK;
+    }
+
+    // A channel still sleeping stops waiting for a wakeup from the bus
+    if (LinChannelState[Channel] == LIN_CH_SLEEP)
+    {
+        Lin_Hw_DisarmWakeup(Lin_Hw_GetUnit(Channel));
+    }
+    LinChannelState[Channel] = LIN_OPERATIONAL;
+
     return E_OK;
 }
 
 /**
  * @brief       Gets the status of the LIN driver
  * @param       Channel: LIN channel to be addressed
- * @param       Lin_SduPtr: Pointer to pointer to a shadow buffer or memory mapped LIN
+ * @param       Lin_SduPtr: Pointer to pointer to a shadow buffer or memory mapped LIN, set to the received
+ *              response on LIN_RX_OK and to NULL_PTR otherwise
  * @return      Lin_StatusType
  *              LIN_NOT_OK: Development or production error occurred
  *              LIN_TX_OK: Successful transmission
@@ -325,6 +1122,7 @@ Std_ReturnType Lin_WakeupInternal(uint8 Channel)
  *              - Framing error
  *              - Overrun error
  *              - Checksum error or Short response
+ *              - Response longer than TResponse_Maximum
  *              LIN_RX_NO_RESPONSE: No response byte has been received so far
  *              LIN_OPERATIONAL: Normal operation; the related LIN channel
  *              is woken up from the LIN_CH_SLEEP and no data has been sent.
@@ -345,13 +1143,31 @@ Lin_StatusType Lin_GetStatus (uint8 Channel, const uint8** Lin_SduPtr)
         return LIN_NOT_OK; // Return error if Channel is invalid
     }
 
+    // A response still running past TResponse_Maximum is cut off here, between two of its bytes
+    uint32 primask = Lin_Hw_EnterCritical();
+    if ((Lin_Frame[Channel].Phase == LIN_FRAME_RESPONSE) &&
+        (Lin_ResponseLate(Channel, Lin_Hw_GetCycles()) == TRUE))
+    {
+        LinChannelState[Channel] = Lin_StopResponse(Channel, Lin_Hw_GetUsart(Channel));
+        Lin_Frame[Channel].Phase = LIN_FRAME_IDLE;
+    }
+    Lin_Hw_ExitCritical(primask);
+
     // Retrieve the current status from hardware or a status variable
     Lin_StatusType currentStatus = LinChannelState[Channel];
 
-    // If the status is LIN_RX_OK or LIN_TX_OK, update Lin_SduPtr
-    if (currentStatus == LIN_RX_OK || currentStatus == LIN_TX_OK)
+    // While the response is captured, the DMA counter tells whether a byte has arrived
+    if ((currentStatus == LIN_RX_NO_RESPONSE) && (Lin_Frame[Channel].Phase == LIN_FRAME_RESPONSE) &&
+        (LL_DMA_GetDataLength(Lin_Hw_GetDma(Channel)->Dma, Lin_Hw_GetDma(Channel)->RxChannel) <=
+         Lin_Frame[Channel].Dl))
+    {
+        currentStatus = LIN_RX_BUSY;
+    }
+
+    // If the status is LIN_RX_OK, update Lin_SduPtr
+    if (currentStatus == LIN_RX_OK)
     {
-        *Lin_SduPtr = LinChannelData[Channel]; // LinChannelData is the data region containing the SDU
+        *Lin_SduPtr = LinChannelData[Channel]; // Response written by DMA, valid until the next frame is started
     }
     else
     {
@@ -360,3 +1176,278 @@ Lin_StatusType Lin_GetStatus (uint8 Channel, const uint8** Lin_SduPtr)
 
     return currentStatus; // Return the current status of the LIN channel
 }
+
+/**
+ * @brief       Returns the CPU time spent on the frames of a channel.
+ * @param       Channel: LIN channel to be addressed
+ * @param       CpuTimePtr: Pointer to a memory location, where the CPU time will be stored.
+ * @return      Std_ReturnType
+ *              E_OK: CPU time available
+ *              E_NOT_OK: Invalid channel or pointer
+ */
+Std_ReturnType Lin_GetCpuTime(uint8 Channel, Lin_CpuTimeType *CpuTimePtr)
+{
+    uint32 primask;
+
+    if ((Channel >= MAX_LIN_CHANNELS) || (CpuTimePtr == NULL_PTR))
+    {
+        return E_NOT_OK;
+    }
+
+    primask = Lin_Hw_EnterCritical();
+    *CpuTimePtr = Lin_CpuTime[Channel];
+    Lin_Hw_ExitCritical(primask);
+
+    return E_OK;
+}
+
+/**
+ * @brief       Enters Stop 1 mode while every initialized channel sleeps with its wakeup armed, and returns
+ *              once an interrupt has woken the core up.
+ * @details     The check and the entry run with interrupts masked, a wakeup raised in between ends the Stop
+ *              mode at once. The core restarts on the wakeup clock selected by RCC_CFGR STOPWUCK, the
+ *              application restores its own system clock; the LIN baud rate does not depend on it.
+ * @param       void
+ * @return      Std_ReturnType
+ *              E_OK: The core has been in Stop mode
+ *              E_NOT_OK: No channel can wake the core up, or a channel is awake
+ */
+Std_ReturnType Lin_EnterStopMode(void)
+{
+    uint32 primask;
+    uint8 armed = FALSE;
+    uint8 channel;
+
+    primask = Lin_Hw_EnterCritical();
+
+    for (channel = 0u; channel < MAX_LIN_CHANNELS; channel++)
+    {
+        if (LinChannelState[channel] == LIN_NOT_OK)
+        {
+            continue;
+        }
+        if (LinChannelState[channel] != LIN_CH_SLEEP)
+        {
+            Lin_Hw_ExitCritical(primask);
+            return E_NOT_OK;
+        }
+        if (LinChannelConfig[channel].LinChannelWakeupSupport == ENABLE)
+        {
+            armed = TRUE;
+        }
+    }
+
+    if (armed == FALSE)
+    {
+        Lin_Hw_ExitCritical(primask);
+        return E_NOT_OK;
+    }
+
+    Lin_Hw_EnterStop();
+    Lin_Hw_ExitCritical(primask);
+
+    return E_OK;
+}
+
+/**
+ * @brief       Returns the time from the wakeups of a channel to its first frame.
+ * @param       Channel: LIN channel to be addressed
+ * @param       LatencyPtr: Pointer to a memory location, where the latency will be stored.
+ * @return      Std_ReturnType
+ *              E_OK: Latency available
+ *              E_NOT_OK: Invalid channel or pointer
+ */
+Std_ReturnType Lin_GetWakeupLatency(uint8 Channel, Lin_WakeupLatencyType *LatencyPtr)
+{
+    uint32 primask;
+
+    if ((Channel >= MAX_LIN_CHANNELS) || (LatencyPtr == NULL_PTR))
+    {
+        return E_NOT_OK;
+    }
+
+    primask = Lin_Hw_EnterCritical();
+    *LatencyPtr = Lin_WakeupLatency[Channel];
+    Lin_Hw_ExitCritical(primask);
+
+    return E_OK;
+}
+
+/**
+ * @brief       Returns the read back errors of a channel.
+ * @param       Channel: LIN channel to be addressed
+ * @param       ErrorPtr: Pointer to a memory location, where the error counters will be stored.
+ * @return      Std_ReturnType
+ *              E_OK: Counters available
+ *              E_NOT_OK: Invalid channel or pointer
+ */
+Std_ReturnType Lin_GetReadbackErrors(uint8 Channel, Lin_ReadbackErrorType *ErrorPtr)
+{
+    uint32 primask;
+
+    if ((Channel >= MAX_LIN_CHANNELS) || (ErrorPtr == NULL_PTR))
+    {
+        return E_NOT_OK;
+    }
+
+    primask = Lin_Hw_EnterCritical();
+    *ErrorPtr = Lin_ReadbackErrors[Channel];
+    Lin_Hw_ExitCritical(primask);
+
+    return E_OK;
+}
+
+/*
+ ************************************************************************************************************
+ * Interrupt handlers
+ ************************************************************************************************************
+ */
+/**
+ * @brief       USART1 interrupt, raised on TC, receiver timeout, receive errors, break and wakeup of its LIN channel
+ * @param       void
+ * @return      void
+ */
+void USART1_IRQHandler(void)
+{
+    Lin_Isr(Lin_UnitChannel[LIN_HW_USART1]);
+}
+
+/**
+ * @brief       USART2 interrupt, raised on TC, receiver timeout, receive errors, break and wakeup of its LIN channel
+ * @param       void
+ * @return      void
+ */
+void USART2_IRQHandler(void)
+{
+    Lin_Isr(Lin_UnitChannel[LIN_HW_USART2]);
+}
+
+/**
+ * @brief       USART3 interrupt, raised on TC, receiver timeout, receive errors, break and wakeup of its LIN channel
+ * @param       void
+ * @return      void
+ */
+void USART3_IRQHandler(void)
+{
+    Lin_Isr(Lin_UnitChannel[LIN_HW_USART3]);
+}
+
+/**
+ * @brief       UART4 interrupt, raised on TC, receiver timeout, receive errors, break and wakeup of its LIN channel
+ * @param       void
+ * @return      void
+ */
+void UART4_IRQHandler(void)
+{
+    Lin_Isr(Lin_UnitChannel[LIN_HW_UART4]);
+}
+
+/**
+ * @brief       UART5 interrupt, raised on TC, receiver timeout, receive errors, break and wakeup of its LIN channel
+ * @param       void
+ * @return      void
+ */
+void UART5_IRQHandler(void)
+{
+    Lin_Isr(Lin_UnitChannel[LIN_HW_UART5]);
+}
+
+/**
+ * @brief       DMA1 channel 4 interrupt, USART1_TX
+ * @param       void
+ * @return      void
+ */
+void DMA1_Channel4_IRQHandler(void)
+{
+    Lin_DmaTxIsr(Lin_UnitChannel[LIN_HW_USART1]);
+}
+
+/**
+ * @brief       DMA1 channel 5 interrupt, USART1_RX
+ * @param       void
+ * @return      void
+ */
+void DMA1_Channel5_IRQHandler(void)
+{
+    Lin_DmaRxIsr(Lin_UnitChannel[LIN_HW_USART1]);
+}
+
+/**
+ * @brief       DMA1 channel 7 interrupt, USART2_TX
+ * @param       void
+ * @return      void
+ */
+void DMA1_Channel7_IRQHandler(void)
+{
+    Lin_DmaTxIsr(Lin_UnitChannel[LIN_HW_USART2]);
+}
+
+/**
+ * @brief       DMA1 channel 6 interrupt, USART2_RX
+ * @param       void
+ * @return      void
+ */
+void DMA1_Channel6_IRQHandler(void)
+{
+    Lin_DmaRxIsr(Lin_UnitChannel[LIN_HW_USART2]);
+}
+
+/**
+ * @brief       DMA1 channel 2 interrupt, USART3_TX
+ * @param       void
+ * @return      void
+ */
+void DMA1_Channel2_IRQHandler(void)
+{
+    Lin_DmaTxIsr(Lin_UnitChannel[LIN_HW_USART3]);
+}
+
+/**
+ * @brief       DMA1 channel 3 interrupt, USART3_RX
+ * @param       void
+ * @return      void
+ */
+void DMA1_Channel3_IRQHandler(void)
+{
+    Lin_DmaRxIsr(Lin_UnitChannel[LIN_HW_USART3]);
+}
+
+/**
+ * @brief       DMA2 channel 3 interrupt, UART4_TX
+ * @param       void
+ * @return      void
+ */
+void DMA2_Channel3_IRQHandler(void)
+{
+    Lin_DmaTxIsr(Lin_UnitChannel[LIN_HW_UART4]);
+}
+
+/**
+ * @brief       DMA2 channel 5 interrupt, UART4_RX
+ * @param       void
+ * @return      void
+ */
+void DMA2_Channel5_IRQHandler(void)
+{
+    Lin_DmaRxIsr(Lin_UnitChannel[LIN_HW_UART4]);
+}
+
+/**
+ * @brief       DMA2 channel 1 interrupt, UART5_TX
+ * @param       void
+ * @return      void
+ */
+void DMA2_Channel1_IRQHandler(void)
+{
+    Lin_DmaTxIsr(Lin_UnitChannel[LIN_HW_UART5]);
+}
+
+/**
+ * @brief       DMA2 channel 2 interrupt, UART5_RX
+ * @param       void
+ * @return      void
+ */
+void DMA2_Channel2_IRQHandler(void)
+{
+    Lin_DmaRxIsr(Lin_UnitChannel[LIN_HW_UART5]);
+}
@@ -17,6 +17,9 @@
  * Includes
  ************************************************************************************************************
  */
+#if defined(LIN_HOST_SIM)
+#include "Lin_Sim.h"
+#else
 #include "stm32l4xx.h"
 #include "stm32l476xx.h"
 #include "stm32l4xx_ll_rcc.h"
@@ -29,6 +32,7 @@
 #include "stm32l4xx_ll_dma.h"
 #include "stm32l4xx_ll_usart.h"
 #include "stm32l4xx_ll_gpio.h"
+#endif
 #include "Lin_GeneralTypes.h"
 
 /*
@@ -38,108 +42,94 @@
  */
 #define SYNC_FIELD 0x55
 
+/* NVIC priority of the USART and DMA interrupts. An interrupt calling Lin_SendFrame() must not preempt them:
+ * their handlers run without a critical section, so it runs at this priority too. */
+#define LIN_IRQ_PRIORITY    5u
+
+/* Protected identifier of a frame identifier: P0 = ID0 ^ ID1 ^ ID2 ^ ID4 in bit 6 and
+ * P1 = !(ID1 ^ ID3 ^ ID4 ^ ID5) in bit 7, a constant expression for a constant identifier */
+#define LIN_PID(id)         ((uint8)(((id) & 0x3Fu) | \
+                            (((((id) >> 0) ^ ((id) >> 1) ^ ((id) >> 2) ^ ((id) >> 4)) & 0x01u) << 6) | \
+                            ((~(((id) >> 1) ^ ((id) >> 3) ^ ((id) >> 4) ^ ((id) >> 5)) & 0x01u) << 7)))
+
+/* Operating modes of a LIN channel, Lin_ConfigType.Lin_Mode */
+#define LIN_MODE_MASTER     0u      /* Sends the headers, see Lin_SendFrame() */
+#define LIN_MODE_SLAVE      1u      /* Answers the headers of the master from Lin_SlaveFrames */
+
+/* USART units a LIN channel can be mapped to, see Lin_Hw_Units */
+#define LIN_HW_USART1       0u
+#define LIN_HW_USART2       1u
+#define LIN_HW_USART3       2u
+#define LIN_HW_UART4        3u
+#define LIN_HW_UART5        4u
+#define LIN_HW_LPUART1      5u      /* No LIN mode and no receiver timeout, refused by Lin_Init() */
+#define LIN_HW_UNIT_MAX     6u
+
+/**
+ * @typedef     LinChannelConfigType
+ * @brief       Hardware of a LIN channel, one entry of LinChannelConfig in Lin_Cfg.h
+ */
+typedef struct {
+    uint32 Lin_BaudRate;                        /* Baud rate for the LIN channel. */
+    FunctionalState LinChannelWakeupSupport;    /* Wake-up support (ENABLE/DISABLE). */
+    uint8 Lin_ChannelID;                        /* ID of the LIN channel. */
+    GPIO_TypeDef* Lin_Port;                     /* GPIO port for the LIN channel. */
+    uint16 Lin_TxPin;                           /* Tx pin of the LIN channel. */
+    uint16 Lin_RxPin;                           /* Rx pin of the LIN channel. */
+    uint32 Lin_Alternate;                       /* Alternate function of both pins, LL_GPIO_AF_x. */
+    uint8 Lin_HwUnit;                           /* USART of the LIN channel, LIN_HW_xxx. */
+} LinChannelConfigType;
+
 /**
  * @typedef     Lin_ConfigType
  * @brief       This is the type of the external data structure containing the overall initialization data for the LIN
- *              driver and the SFR settings affecting the LIN channels.
+ *              driver. It selects the channel and its role, the hardware of the channel (baud rate, USART, pins,
+ *              interrupts and wakeup support) is given by its entry in LinChannelConfig only.
  */
 typedef struct
 {
-    uint32 Lin_BaudRate;                /* Baud rate for the LIN channel. */
-    GPIO_TypeDef *Lin_Port;             /* GPIO port for the LIN channel, e.g., GPIOA. */
-    uint16 Lin_TxPin;                   /* Tx pin for the LIN channel, e.g., GPIO_PIN_2. */
-    uint16 Lin_RxPin;                   /* Rx pin for the LIN channel, e.g., GPIO_PIN_3. */
-    uint8 Lin_Channel;                  /* LIN channel number. */
-    FunctionalState Lin_WakeupSupport;  /* Wake-up mode support (TRUE/FALSE). */
-    IRQn_Type Lin_IRQn;                 /* Interrupt number for the LIN channel. */
-    uint32 Lin_Prescaler;               /* Prescaler value for adjusting baud rate. */
-    uint32 Lin_Mode;                    /* Operating mode of LIN (0: master, 1: slave). */
-    uint8 Lin_TimeoutDuration;          /* Timeout duration to detect errors. */
+    uint8 Lin_Channel;                  /* LIN channel number, index of LinChannelConfig. */
+    uint32 Lin_Mode;                    /* Operating mode of LIN, LIN_MODE_MASTER or LIN_MODE_SLAVE. */
+    const Lin_PduType *Lin_SlaveFrames; /* Frames of a slave channel: TX answered from SduPtr, RX copied to it. */
+    uint8 Lin_SlaveFrameCount;          /* Number of entries in Lin_SlaveFrames, at most 64 with distinct PIDs. */
 } Lin_ConfigType;
 
-/*
- ************************************************************************************************************
- * Inline functions
- ************************************************************************************************************
+/**
+ * @typedef     Lin_CpuTimeType
+ * @brief       CPU time spent on the frames of a channel, in CPU cycles counted by DWT CYCCNT: Lin_SendFrame()
+ *              plus every USART interrupt of the frame, without the exception entry and exit of the core.
  */
-inline static void LIN_SendBreak(void)
+typedef struct
 {
-	LL_USART_RequestBreakSending(USART2);
-}
+    uint32 LastCycles;                      /* CPU time of the last completed frame */
+    uint32 MaxCycles;                       /* Longest CPU time of a frame */
+    uint32 Count;                           /* Number of completed frames */
+    uint32 Interrupts;                      /* Interrupts taken by the last completed frame */
+} Lin_CpuTimeType;
 
-inline static void LIN_SendSync(void)
-{
-	// wait until TX ready
-	while (!LL_USART_IsActiveFlag_TXE(USART2));
-	// send 0x55
-	LL_USART_TransmitData8(USART2, SYNC_FIELD);
-	// wait until sending process is done
-  while (!LL_USART_IsActiveFlag_TC(USART2));
-}
-
-inline static uint8_t LIN_CalculateParity(uint8_t id)
+/**
+ * @typedef     Lin_WakeupLatencyType
+ * @brief       Time from a wakeup of a channel to its first correct frame, in CPU cycles counted by DWT CYCCNT
+ *              at the core clock running after the wakeup. The wakeup is the start bit detected in Stop mode or
+ *              the wakeup pulse sent by Lin_Wakeup(); LIN 2.x allows 100 ms before the master sends headers.
+ */
+typedef struct
 {
-	uint8_t p0 = ((id >> 0) & 0x01) ^ ((id >> 1) & 0x01) ^ ((id >> 2) & 0x01);
-  uint8_t p1 = ~(((id >> 1) & 0x01) ^ ((id >> 3) & 0x01) ^ ((id >> 4) & 0x01) ^ ((id >> 5) & 0x01));
-  return (p0 | (p1 << 1)) << 6;
-}
+    uint32 LastCycles;                      /* Latency of the last wakeup */
+    uint32 MaxCycles;                       /* Longest latency */
+    uint32 Count;                           /* Number of wakeups followed by a frame */
+} Lin_WakeupLatencyType;
 
-inline static void LIN_SendID(uint8_t id)
-{
-	uint8_t id_with_parity = id | LIN_CalculateParity(id);
-	// wait until TX ready
-	while (!LL_USART_IsActiveFlag_TXE(USART2)){}
-  LL_USART_TransmitData8(USART2, id_with_parity);
-  // wait until sending process is done
-  while (!LL_USART_IsActiveFlag_TC(USART2));
-}
-
-inline static void LIN_SendData(uint8_t *data, uint8_t length)
-{
-  for (uint8_t i = 0; i < length; i++)
-  {
-    // wait until TX ready
-		while (!LL_USART_IsActiveFlag_TXE(USART2)){}
-		LL_USART_TransmitData8(USART2, data[i]);
-		// wait until sending process is done
-		while (!LL_USART_IsActiveFlag_TC(USART2));
-  }
-}
-
-inline static void LIN_ReceiveData(uint8_t *buffer, uint8_t length)
-{
-  for (uint8_t i = 0; i < length; i++)
-  {
-		// wait until data is available
-    while (!LL_USART_IsActiveFlag_RXNE(USART2));
-		// read data
-    buffer[i] = LL_USART_ReceiveData8(USART2);;
-  }
-}
-
-inline static uint8_t LIN_CalculateChecksum(uint8_t *data, uint8_t length)
-{
-  uint16_t checksum = 0;
-  for (uint8_t i = 0; i < length; i++)
-  {
-    checksum += data[i];
-    if (checksum > 0xFF)
-    {
-      checksum -= 0xFF;
-    }
-  }
-  return ~checksum;
-}
-
-inline static void LIN_SendChecksum(uint8_t *data, uint8_t length)
+/**
+ * @typedef     Lin_ReadbackErrorType
+ * @brief       Frames aborted because a byte read back from the bus differs from the byte sent: a collision,
+ *              a bus stuck dominant or recessive, or a transceiver not echoing.
+ */
+typedef struct
 {
-  uint8_t checksum = LIN_CalculateChecksum(data, length);
-	// wait until TX ready
-	while (!LL_USART_IsActiveFlag_TXE(USART2)){}
-  LL_USART_TransmitData8(USART2, checksum);
-  // wait until sending process is done
-  while (!LL_USART_IsActiveFlag_TC(USART2));
-}
+    uint32 HeaderErrors;                    /* Break, sync field or PID, reported as LIN_TX_HEADER_ERROR */
+    uint32 ResponseErrors;                  /* Response or checksum, reported as LIN_TX_ERROR */
+} Lin_ReadbackErrorType;
 
 /*
  ************************************************************************************************************
@@ -220,7 +210,8 @@ Std_ReturnType Lin_WakeupInternal(uint8 Channel);
 /**
  * @brief       Gets the status of the LIN driver
  * @param       Channel: LIN channel to be addressed
- * @param       Lin_SduPtr: Pointer to pointer to a shadow buffer or memory mapped LIN
+ * @param       Lin_SduPtr: Pointer to pointer to a shadow buffer or memory mapped LIN, set to the received
+ *              response on LIN_RX_OK and to NULL_PTR otherwise
  * @return      Lin_StatusType
  *              LIN_NOT_OK: Development or production error occurred
  *              LIN_TX_OK: Successful transmission
@@ -238,6 +229,7 @@ Std_ReturnType Lin_WakeupInternal(uint8 Channel);
  *              - Framing error
  *              - Overrun error
  *              - Checksum error or Short response
+ *              - Response longer than TResponse_Maximum
  *              LIN_RX_NO_RESPONSE: No response byte has been received so far
  *              LIN_OPERATIONAL: Normal operation; the related LIN channel
  *              is woken up from the LIN_CH_SLEEP and no data has been sent.
@@ -246,4 +238,44 @@ Std_ReturnType Lin_WakeupInternal(uint8 Channel);
  */
 Lin_StatusType Lin_GetStatus (uint8 Channel, const uint8** Lin_SduPtr);
 
+/**
+ * @brief       Returns the CPU time spent on the frames of a channel.
+ * @param       Channel: LIN channel to be addressed
+ * @param       CpuTimePtr: Pointer to a memory location, where the CPU time will be stored.
+ * @return      Std_ReturnType
+ *              E_OK: CPU time available
+ *              E_NOT_OK: Invalid channel or pointer
+ */
+Std_ReturnType Lin_GetCpuTime(uint8 Channel, Lin_CpuTimeType *CpuTimePtr);
+
+/**
+ * @brief       Enters Stop 1 mode while every initialized channel sleeps with its wakeup armed, and returns
+ *              once an interrupt has woken the core up.
+ * @param       void
+ * @return      Std_ReturnType
+ *              E_OK: The core has been in Stop mode
+ *              E_NOT_OK: No channel can wake the core up, or a channel is awake
+ */
+Std_ReturnType Lin_EnterStopMode(void);
+
+/**
+ * @brief       Returns the time from the wakeups of a channel to its first frame.
+ * @param       Channel: LIN channel to be addressed
+ * @param       LatencyPtr: Pointer to a memory location, where the latency will be stored.
+ * @return      Std_ReturnType
+ *              E_OK: Latency available
+ *              E_NOT_OK: Invalid channel or pointer
+ */
+Std_ReturnType Lin_GetWakeupLatency(uint8 Channel, Lin_WakeupLatencyType *LatencyPtr);
+
+/**
+ * @brief       Returns the read back errors of a channel.
+ * @param       Channel: LIN channel to be addressed
+ * @param       ErrorPtr: Pointer to a memory location, where the error counters will be stored.
+ * @return      Std_ReturnType
+ *              E_OK: Counters available
+ *              E_NOT_OK: Invalid channel or pointer
+ */
+Std_ReturnType Lin_GetReadbackErrors(uint8 Channel, Lin_ReadbackErrorType *ErrorPtr);
+
 #endif /* LIN_H */
\ No newline at end of file
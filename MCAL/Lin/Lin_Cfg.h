@@ -0,0 +1,94 @@
+/**
+ * @file        Lin_Cfg.h
+ * @author      Phuc
+ * @brief       Configuration of LIN
+ * @version     1.0
+ * @date        2025-01-20
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef LIN_CFG_H
+#define LIN_CFG_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Lin.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Definition of LIN channels
+ * @details     Every channel has its own USART, DMA channels and interrupts, so the buses run in parallel.
+ */
+#define MAX_LIN_CHANNELS        4u      /* Maximum number of LIN channels. */
+
+/**
+ * @brief       CPU clock
+ * @details     Clock of the DWT cycle counter, which times the response of an RX frame against its
+ *              TResponse_Maximum. SYSCLK 80 MHz.
+ */
+#define LIN_CPU_CLOCK_HZ        80000000u
+
+#if defined(LIN_HOST_SIM)
+/* The simulated time and DWT count the same clock */
+typedef char Lin_SimClockCheck[(LIN_CPU_CLOCK_HZ == LIN_SIM_CPU_HZ) ? 1 : -1];
+#endif
+
+/**
+ * @brief       Hardware of each LIN channel
+ * @details     Lin_Hw_GetUsart() and Lin_Hw_GetDma() follow Lin_HwUnit, the interrupt handlers of a USART
+ *              and its DMA channels find the LIN channel back through the mapping built by Lin_Init(). Static
+ *              like Lin_Hw_Units, so that modules other than the driver may include Lin_Hw.h.
+ */
+static const LinChannelConfigType LinChannelConfig[MAX_LIN_CHANNELS] = {
+    {
+        .Lin_BaudRate = 19200,              /* Baud rate for the LIN channel. */
+        .LinChannelWakeupSupport = ENABLE,  /* Wake-up support. */
+        .Lin_ChannelID = 0,                 /* ID of the LIN channel. */
+        .Lin_Port = GPIOA,                  /* GPIO port used for the LIN channel. */
+        .Lin_TxPin = LL_GPIO_PIN_2,         /* USART2_TX */
+        .Lin_RxPin = LL_GPIO_PIN_3,         /* USART2_RX */
+        .Lin_Alternate = LL_GPIO_AF_7,
+        .Lin_HwUnit = LIN_HW_USART2
+    },
+    {
+        .Lin_BaudRate = 19200,
+        .LinChannelWakeupSupport = ENABLE,
+        .Lin_ChannelID = 1,
+        .Lin_Port = GPIOA,
+        .Lin_TxPin = LL_GPIO_PIN_9,         /* USART1_TX */
+        .Lin_RxPin = LL_GPIO_PIN_10,        /* USART1_RX */
+        .Lin_Alternate = LL_GPIO_AF_7,
+        .Lin_HwUnit = LIN_HW_USART1
+    },
+    {
+        .Lin_BaudRate = 19200,
+        .LinChannelWakeupSupport = ENABLE,
+        .Lin_ChannelID = 2,
+        .Lin_Port = GPIOC,
+        .Lin_TxPin = LL_GPIO_PIN_4,         /* USART3_TX */
+        .Lin_RxPin = LL_GPIO_PIN_5,         /* USART3_RX */
+        .Lin_Alternate = LL_GPIO_AF_7,
+        .Lin_HwUnit = LIN_HW_USART3
+    },
+    {
+        .Lin_BaudRate = 10417,
+        .LinChannelWakeupSupport = ENABLE,
+        .Lin_ChannelID = 3,
+        .Lin_Port = GPIOA,
+        .Lin_TxPin = LL_GPIO_PIN_0,         /* UART4_TX */
+        .Lin_RxPin = LL_GPIO_PIN_1,         /* UART4_RX */
+        .Lin_Alternate = LL_GPIO_AF_8,
+        .Lin_HwUnit = LIN_HW_UART4
+    }
+};
+
+#endif /* LIN_CFG_H */
@@ -0,0 +1,423 @@
+/**
+ * @file        Lin_Hw.h
+ * @author      Phuc
+ * @brief       USART register access of the LIN driver for STM32L476
+ * @version     1.0
+ * @date        2025-01-15
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef LIN_HW_H
+#define LIN_HW_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Lin.h"
+#include "Lin_Cfg.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define LIN_DMA_FLAGS_MASK          (DMA_ISR_GIF1 | DMA_ISR_TCIF1 | DMA_ISR_HTIF1 | DMA_ISR_TEIF1)
+#define LIN_DMA_FLAGS(ch)           (LIN_DMA_FLAGS_MASK << (4u * (ch)))     /* Flags of LL_DMA_CHANNEL_x <ch> */
+
+/**
+ * @typedef     Lin_Hw_DmaType
+ * @brief       DMA channels serving the USART of a LIN channel
+ */
+typedef struct
+{
+    DMA_TypeDef *Dma;                       /* DMA controller */
+    uint32 TxChannel;                       /* LL_DMA_CHANNEL_x writing TDR */
+    uint32 RxChannel;                       /* LL_DMA_CHANNEL_x reading RDR */
+    uint32 Request;                         /* LL_DMA_REQUEST_x selecting the USART on both channels */
+    IRQn_Type TxIRQn;                       /* Interrupt of the transmit channel */
+    IRQn_Type RxIRQn;                       /* Interrupt of the receive channel */
+} Lin_Hw_DmaType;
+
+/**
+ * @typedef     Lin_Hw_UnitType
+ * @brief       USART unit with its interrupt and DMA channels
+ */
+typedef struct
+{
+    USART_TypeDef *Usart;                   /* Register block */
+    IRQn_Type IRQn;                         /* USART interrupt */
+    Lin_Hw_DmaType Dma;                     /* DMA channels of TDR and RDR */
+    uint32 ExtiLine;                        /* LL_EXTI_LINE_x waking the core up from Stop mode */
+} Lin_Hw_UnitType;
+
+/**
+ * @brief       USART units indexed by LIN_HW_xxx, with their DMA requests on STM32L476
+ */
+static const Lin_Hw_UnitType Lin_Hw_Units[LIN_HW_UNIT_MAX] =
+{
+    {USART1,  USART1_IRQn,  {DMA1, LL_DMA_CHANNEL_4, LL_DMA_CHANNEL_5, LL_DMA_REQUEST_2, DMA1_Channel4_IRQn, DMA1_Channel5_IRQn}, LL_EXTI_LINE_26},
+    {USART2,  USART2_IRQn,  {DMA1, LL_DMA_CHANNEL_7, LL_DMA_CHANNEL_6, LL_DMA_REQUEST_2, DMA1_Channel7_IRQn, DMA1_Channel6_IRQn}, LL_EXTI_LINE_27},
+    {USART3,  USART3_IRQn,  {DMA1, LL_DMA_CHANNEL_2, LL_DMA_CHANNEL_3, LL_DMA_REQUEST_2, DMA1_Channel2_IRQn, DMA1_Channel3_IRQn}, LL_EXTI_LINE_28},
+    {UART4,   UART4_IRQn,   {DMA2, LL_DMA_CHANNEL_3, LL_DMA_CHANNEL_5, LL_DMA_REQUEST_2, DMA2_Channel3_IRQn, DMA2_Channel5_IRQn}, LL_EXTI_LINE_29},
+    {UART5,   UART5_IRQn,   {DMA2, LL_DMA_CHANNEL_1, LL_DMA_CHANNEL_2, LL_DMA_REQUEST_2, DMA2_Channel1_IRQn, DMA2_Channel2_IRQn}, LL_EXTI_LINE_30},
+    {LPUART1, LPUART1_IRQn, {DMA2, LL_DMA_CHANNEL_6, LL_DMA_CHANNEL_7, LL_DMA_REQUEST_4, DMA2_Channel6_IRQn, DMA2_Channel7_IRQn}, LL_EXTI_LINE_31}
+};
+
+/*
+ ************************************************************************************************************
+ * Inline functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Maps a LIN channel to its USART unit
+ * @param       Channel: LIN channel index
+ * @return      Pointer to the USART unit, NULL_PTR if the channel does not exist
+ */
+inline static const Lin_Hw_UnitType* Lin_Hw_GetUnit(uint8 Channel)
+{
+    if (Channel >= MAX_LIN_CHANNELS)
+    {
+        return NULL_PTR;
+    }
+
+    return &Lin_Hw_Units[LinChannelConfig[Channel].Lin_HwUnit];
+}
+
+/**
+ * @brief       Maps a LIN channel to its USART
+ * @param       Channel: LIN channel index
+ * @return      Pointer to the USART register block, NULL_PTR if the channel does not exist
+ */
+inline static USART_TypeDef* Lin_Hw_GetUsart(uint8 Channel)
+{
+    return (Channel < MAX_LIN_CHANNELS) ? Lin_Hw_Units[LinChannelConfig[Channel].Lin_HwUnit].Usart : NULL_PTR;
+}
+
+/**
+ * @brief       Maps a LIN channel to the DMA channels of its USART
+ * @param       Channel: LIN channel index, must exist
+ * @return      Pointer to the DMA mapping
+ */
+inline static const Lin_Hw_DmaType* Lin_Hw_GetDma(uint8 Channel)
+{
+    return &Lin_Hw_Units[LinChannelConfig[Channel].Lin_HwUnit].Dma;
+}
+
+/**
+ * @brief       Enables the clocks of a USART unit and of its DMA controller. The kernel clock is HSI16, the
+ *              only one with which the USART wakes the core up from Stop mode; it also keeps the baud rate
+ *              when the application changes the system clock.
+ * @param       Unit: LIN_HW_xxx
+ * @return      void
+ */
+inline static void Lin_Hw_EnableClock(uint8 Unit)
+{
+    LL_RCC_HSI_Enable();
+    while (LL_RCC_HSI_IsReady() == 0u)
+    {
+    }
+
+    switch (Unit)
+    {
+        case LIN_HW_USART1:
+            LL_RCC_SetUSARTClockSource(LL_RCC_USART1_CLKSOURCE_HSI);
+            LL_APB2_GRP1_EnableClock(LL_APB2_GRP1_PERIPH_USART1);
+            break;
+        case LIN_HW_USART2:
+            LL_RCC_SetUSARTClockSource(LL_RCC_USART2_CLKSOURCE_HSI);
+            LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_USART2);
+            break;
+        case LIN_HW_USART3:
+            LL_RCC_SetUSARTClockSource(LL_RCC_USART3_CLKSOURCE_HSI);
+            LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_USART3);
+            break;
+        case LIN_HW_UART4:
+            LL_RCC_SetUARTClockSource(LL_RCC_UART4_CLKSOURCE_HSI);
+            LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_UART4);
+            break;
+        case LIN_HW_UART5:
+            LL_RCC_SetUARTClockSource(LL_RCC_UART5_CLKSOURCE_HSI);
+            LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_UART5);
+            break;
+        default:
+            break;
+    }
+
+    LL_AHB1_GRP1_EnableClock((Lin_Hw_Units[Unit].Dma.Dma == DMA1) ? LL_AHB1_GRP1_PERIPH_DMA1 :
+                             LL_AHB1_GRP1_PERIPH_DMA2);
+}
+
+/**
+ * @brief       Enables the clock of a GPIO port
+ * @param       Port: GPIO port of the LIN pins
+ * @return      void
+ */
+inline static void Lin_Hw_EnableGpioClock(const GPIO_TypeDef* Port)
+{
+    if (Port == GPIOA)
+    {
+        LL_AHB2_GRP1_EnableClock(LL_AHB2_GRP1_PERIPH_GPIOA);
+    }
+    else if (Port == GPIOB)
+    {
+        LL_AHB2_GRP1_EnableClock(LL_AHB2_GRP1_PERIPH_GPIOB);
+    }
+    else if (Port == GPIOC)
+    {
+        LL_AHB2_GRP1_EnableClock(LL_AHB2_GRP1_PERIPH_GPIOC);
+    }
+    else if (Port == GPIOD)
+    {
+        LL_AHB2_GRP1_EnableClock(LL_AHB2_GRP1_PERIPH_GPIOD);
+    }
+    else
+    {
+        /* No LIN pin on the other ports */
+    }
+}
+
+/**
+ * @brief       Clears the flags of a DMA channel through IFCR. Going through here lets the host simulator see
+ *              the write.
+ * @param       Dma: DMA mapping of the LIN channel
+ * @param       DmaChannel: LL_DMA_CHANNEL_x whose flags are cleared
+ * @return      void
+ */
+inline static void Lin_Hw_ClearDmaFlags(const Lin_Hw_DmaType* Dma, uint32 DmaChannel)
+{
+#if defined(LIN_HOST_SIM)
+    Lin_Sim_WriteReg(&Dma->Dma->IFCR, LIN_DMA_FLAGS(DmaChannel));
+#else
+    Dma->Dma->IFCR = LIN_DMA_FLAGS(DmaChannel);
+#endif
+}
+
+/**
+ * @brief       Configures a DMA channel for byte transfers between memory and a USART data register
+ * @param       Dma: DMA mapping of the LIN channel
+ * @param       DmaChannel: LL_DMA_CHANNEL_x to configure
+ * @param       Direction: LL_DMA_DIRECTION_MEMORY_TO_PERIPH or LL_DMA_DIRECTION_PERIPH_TO_MEMORY
+ * @param       Register: Address of TDR or RDR
+ * @return      void
+ */
+inline static void Lin_Hw_InitDmaChannel(const Lin_Hw_DmaType* Dma, uint32 DmaChannel, uint32 Direction,
+                                         uintptr_t Register)
+{
+    LL_DMA_DisableChannel(Dma->Dma, DmaChannel);
+    LL_DMA_ConfigTransfer(Dma->Dma, DmaChannel, Direction | LL_DMA_PRIORITY_HIGH | LL_DMA_MODE_NORMAL |
+                          LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
+                          LL_DMA_PDATAALIGN_BYTE | LL_DMA_MDATAALIGN_BYTE);
+    LL_DMA_SetPeriphRequest(Dma->Dma, DmaChannel, Dma->Request);
+    LL_DMA_SetPeriphAddress(Dma->Dma, DmaChannel, Register);
+    LL_DMA_EnableIT_TC(Dma->Dma, DmaChannel);
+}
+
+/**
+ * @brief       Starts a DMA transfer on a configured channel, with its transfer complete interrupt
+ * @param       Dma: DMA mapping of the LIN channel
+ * @param       DmaChannel: LL_DMA_CHANNEL_x to start
+ * @param       Buffer: Memory side of the transfer
+ * @param       Length: Number of bytes
+ * @return      void
+ */
+inline static void Lin_Hw_StartDma(const Lin_Hw_DmaType* Dma, uint32 DmaChannel, const uint8* Buffer, uint32 Length)
+{
+    LL_DMA_DisableChannel(Dma->Dma, DmaChannel);
+    Lin_Hw_ClearDmaFlags(Dma, DmaChannel);
+    LL_DMA_SetMemoryAddress(Dma->Dma, DmaChannel, (uintptr_t)Buffer);
+    LL_DMA_SetDataLength(Dma->Dma, DmaChannel, Length);
+    LL_DMA_EnableIT_TC(Dma->Dma, DmaChannel);
+    LL_DMA_EnableChannel(Dma->Dma, DmaChannel);
+}
+
+/**
+ * @brief       Starts the receive DMA channel on the read back of the bytes being sent. Its transfer complete
+ *              interrupt stays disabled, the transmit side ends the frame and checks the read back.
+ * @param       Dma: DMA mapping of the LIN channel
+ * @param       Buffer: Read back of the frame
+ * @param       Length: Number of bytes sent on the bus
+ * @return      void
+ */
+inline static void Lin_Hw_StartEcho(const Lin_Hw_DmaType* Dma, uint8* Buffer, uint32 Length)
+{
+    Lin_Hw_StartDma(Dma, Dma->RxChannel, Buffer, Length);
+    LL_DMA_DisableIT_TC(Dma->Dma, Dma->RxChannel);
+}
+
+/**
+ * @brief       Stops a DMA channel and clears its flags
+ * @param       Dma: DMA mapping of the LIN channel
+ * @param       DmaChannel: LL_DMA_CHANNEL_x to stop
+ * @return      void
+ */
+inline static void Lin_Hw_StopDma(const Lin_Hw_DmaType* Dma, uint32 DmaChannel)
+{
+    LL_DMA_DisableChannel(Dma->Dma, DmaChannel);
+    Lin_Hw_ClearDmaFlags(Dma, DmaChannel);
+}
+
+/**
+ * @brief       Checks and acknowledges the transfer complete flag of a DMA channel
+ * @param       Dma: DMA mapping of the LIN channel
+ * @param       DmaChannel: LL_DMA_CHANNEL_x to check
+ * @return      TRUE if the transfer has completed, the flags are cleared, FALSE otherwise
+ */
+inline static uint8 Lin_Hw_DmaCompleted(const Lin_Hw_DmaType* Dma, uint32 DmaChannel)
+{
+    if ((Dma->Dma->ISR & (DMA_ISR_TCIF1 << (4u * DmaChannel))) == 0u)
+    {
+        return FALSE;
+    }
+
+    Lin_Hw_ClearDmaFlags(Dma, DmaChannel);
+    return TRUE;
+}
+
+/**
+ * @brief       Drops the byte waiting in RDR and the receive errors, before the response is captured
+ * @param       USARTx: USART of the channel
+ * @return      void
+ */
+inline static void Lin_Hw_FlushRx(USART_TypeDef* USARTx)
+{
+    LL_USART_RequestRxDataFlush(USARTx);
+    LL_USART_ClearFlag_ORE(USARTx);
+    LL_USART_ClearFlag_FE(USARTx);
+    LL_USART_ClearFlag_NE(USARTx);
+}
+
+/**
+ * @brief       Enables the interrupts ending a response early: receiver timeout and framing, noise or overrun
+ *              errors
+ * @param       USARTx: USART of the channel
+ * @return      void
+ */
+inline static void Lin_Hw_EnableRxIrq(USART_TypeDef* USARTx)
+{
+    LL_USART_ClearFlag_RTO(USARTx);
+    LL_USART_EnableIT_RTO(USARTx);
+    LL_USART_EnableIT_ERROR(USARTx);
+}
+
+/**
+ * @brief       Disables the interrupts enabled by Lin_Hw_EnableRxIrq()
+ * @param       USARTx: USART of the channel
+ * @return      void
+ */
+inline static void Lin_Hw_DisableRxIrq(USART_TypeDef* USARTx)
+{
+    LL_USART_DisableIT_RTO(USARTx);
+    LL_USART_DisableIT_ERROR(USARTx);
+}
+
+/**
+ * @brief       Checks for a receive error of the response
+ * @param       USARTx: USART of the channel
+ * @return      TRUE if a framing, noise or overrun error has occurred, FALSE otherwise
+ */
+inline static uint8 Lin_Hw_RxError(USART_TypeDef* USARTx)
+{
+    return ((LL_USART_IsActiveFlag_FE(USARTx) != 0u) || (LL_USART_IsActiveFlag_NE(USARTx) != 0u) ||
+            (LL_USART_IsActiveFlag_ORE(USARTx) != 0u)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief       Arms the wakeup from Stop mode of a sleeping channel: a start bit on RX, i.e. the falling edge
+ *              of a wakeup pulse or a break, starts HSI16 and raises WUF through the EXTI line of the USART
+ * @param       Unit: USART unit of the channel
+ * @return      void
+ */
+inline static void Lin_Hw_ArmWakeup(const Lin_Hw_UnitType* Unit)
+{
+    LL_USART_ClearFlag_WKUP(Unit->Usart);
+    LL_USART_EnableIT_WKUP(Unit->Usart);
+    LL_USART_EnableInStopMode(Unit->Usart);
+    LL_EXTI_EnableIT_0_31(Unit->ExtiLine);
+}
+
+/**
+ * @brief       Disarms the wakeup armed by Lin_Hw_ArmWakeup()
+ * @param       Unit: USART unit of the channel
+ * @return      void
+ */
+inline static void Lin_Hw_DisarmWakeup(const Lin_Hw_UnitType* Unit)
+{
+    LL_USART_DisableInStopMode(Unit->Usart);
+    LL_USART_DisableIT_WKUP(Unit->Usart);
+    LL_USART_ClearFlag_WKUP(Unit->Usart);
+}
+
+/**
+ * @brief       Enters Stop 1 mode until an interrupt is pending, called with interrupts masked so that a wakeup
+ *              raised just before cannot be missed. USART1..5 only wake the core up from Stop 0 and Stop 1; in
+ *              Stop 2 only LPUART1 runs, which has no LIN mode.
+ * @param       void
+ * @return      void
+ */
+inline static void Lin_Hw_EnterStop(void)
+{
+    LL_PWR_SetPowerMode(LL_PWR_MODE_STOP1);
+    LL_LPM_EnableDeepSleep();
+    __WFI();
+    LL_LPM_EnableSleep();
+}
+
+/**
+ * @brief       Masks all interrupts so that the frame state stays consistent with the USART interrupt
+ * @param       void
+ * @return      Previous PRIMASK value, to be handed back to Lin_Hw_ExitCritical()
+ */
+inline static uint32 Lin_Hw_EnterCritical(void)
+{
+    uint32 primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+/**
+ * @brief       Restores the interrupt mask saved by Lin_Hw_EnterCritical()
+ * @param       primask: Value returned by Lin_Hw_EnterCritical()
+ * @return      void
+ */
+inline static void Lin_Hw_ExitCritical(uint32 primask)
+{
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief       Starts the DWT cycle counter used to time the CPU load of a frame
+ * @param       void
+ * @return      void
+ */
+inline static void Lin_Hw_EnableCycleCounter(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief       Reads the DWT cycle counter, differences are correct across one wrap around
+ * @param       void
+ * @return      Current CPU cycle count
+ */
+inline static uint32 Lin_Hw_GetCycles(void)
+{
+    return (uint32)DWT->CYCCNT;
+}
+
+/**
+ * @brief       Stops the transmit interrupts of a channel, a byte already in TDR is still sent
+ * @param       USARTx: USART of the channel
+ * @return      void
+ */
+inline static void Lin_Hw_DisableTxIrq(USART_TypeDef* USARTx)
+{
+    LL_USART_DisableIT_TXE(USARTx);
+    LL_USART_DisableIT_TC(USARTx);
+}
+
+#endif /* LIN_HW_H */
@@ -0,0 +1,1085 @@
+/**
+ * @file        Lin_Sim.c
+ * @author      Phuc
+ * @brief       Host simulator of the USART and DMA units of the LIN driver: LIN buses carrying breaks and bytes,
+ *              read back, receiver timeout, break detection and wakeup from Stop mode
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Lin.h"
+
+#if defined(LIN_HOST_SIM)
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Model
+ * @details     A bus carries one character at a time. When it is idle, every attached USART with a break requested
+ *              (SBKF) or a byte in TDR moves it into its shift register and sends it, and the node outside the
+ *              driver sends its next byte; characters started together are combined as a wired AND. A byte lasts
+ *              10 bit times and a break 14 (13 dominant bits and the delimiter), at the bit time of BRR with the
+ *              16 MHz kernel clock. At the end of a character every attached receiver gets it: a byte sets RXNE,
+ *              or ORE if RXNE is still set; a break is received as 0x00 with FE and, in LIN mode, sets LBDF. The
+ *              start bit of a character sets WUF on a USART enabled in Stop mode. The receiver timeout counts
+ *              from the end of the last character received. A DMA channel serves the USART whose TDR or RDR is
+ *              its peripheral address, one byte per TXE or RXNE, and sets TCIF after its last byte. TIM7 counts
+ *              up from the CPU clock divided by PSC + 1; it sets UIF when CNT wraps from ARR to 0, or on UG unless
+ *              URS is set, and UG restarts CNT and the prescaler. ARR is used as written, without preload.
+ */
+#define LIN_SIM_EXTERNAL            LIN_SIM_UNIT_MAX    /* Sender index of the node outside the driver */
+#define LIN_SIM_EXTERNAL_MAX        16u     /* Bytes queued by the node outside the driver */
+#define LIN_SIM_TRACE_MAX           64u     /* Characters kept by Lin_Sim_ReadBus() */
+#define LIN_SIM_BYTE_BITS           10u     /* Start bit, 8 data bits and the stop bit */
+#define LIN_SIM_BREAK_BITS          14u     /* 13 dominant bits and the break delimiter */
+#define LIN_SIM_DEFAULT_BRR         (LIN_SIM_KERNEL_HZ / 19200u)    /* Bit time of a bus without USART */
+#define LIN_SIM_ISR_PASSES          16u     /* Interrupt rounds at one point in time before giving up */
+#define LIN_SIM_NONE                0xFFu
+
+/* Header seen by the node outside the driver, to answer it */
+#define LIN_SIM_HEADER_IDLE         0u
+#define LIN_SIM_HEADER_BREAK        1u
+#define LIN_SIM_HEADER_SYNC         2u
+
+/**
+ * @typedef     Lin_SimNodeType
+ * @brief       State of a USART beyond its register block
+ */
+typedef struct
+{
+    uint8 Bus;                              /* Bus the USART is attached to */
+    uint8 Shifting;                         /* TRUE while a character of the USART is on the bus */
+    uint8 ShiftBreak;                       /* TRUE if that character is a break */
+    uint8 RtoRunning;                       /* Receiver timeout counting since LastRx */
+    uint64 LastRx;                          /* End of the last character received */
+} Lin_SimNodeType;
+
+/**
+ * @typedef     Lin_SimBusType
+ * @brief       Character on a bus, node outside the driver and record of the traffic
+ */
+typedef struct
+{
+    uint8 Busy;
+    uint64 End;                             /* End of the character on the bus */
+    Lin_SimSymbolType Symbol;               /* Character received by every node */
+    uint8 External[LIN_SIM_EXTERNAL_MAX];   /* Bytes still to be sent by the node outside the driver */
+    uint8 ExternalCount;
+    uint8 ExternalGap;                      /* Idle bit times the node outside the driver leaves before each byte */
+    uint64 ExternalReady;                   /* Earliest start of its next byte */
+    uint8 Response[64][9];                  /* Answers of the node outside the driver, per frame identifier */
+    uint8 ResponseLength[64];
+    uint8 Header;                           /* LIN_SIM_HEADER_xxx */
+    uint8 Corrupt;                          /* TRUE while a character is to be corrupted */
+    uint8 CorruptValue;
+    uint32 CorruptAt;                       /* Index of that character in Stats.Symbols */
+    Lin_SimSymbolType Trace[LIN_SIM_TRACE_MAX];
+    uint32 TraceRead;                       /* Index in Stats.Symbols of the next character to read */
+    Lin_SimBusStatsType Stats;
+} Lin_SimBusType;
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+USART_TypeDef Lin_Sim_Usart[LIN_SIM_UNIT_MAX];
+DMA_TypeDef Lin_Sim_Dma[LIN_SIM_DMA_MAX];
+GPIO_TypeDef Lin_Sim_Gpio[4];
+TIM_TypeDef Lin_Sim_Tim7;
+
+static Lin_SimNodeType Lin_Sim_Node[LIN_SIM_UNIT_MAX];
+static Lin_SimBusType Lin_Sim_Bus[LIN_SIM_BUS_MAX];
+static uint64 Lin_Sim_Now = 0u;
+
+/* CPU cycles counted by the TIM7 prescaler towards the next tick */
+static uint64 Lin_Sim_TimPrescale = 0u;
+
+/* TIM7 interrupt handler, attached by the builds with the schedule table engine */
+static void (*Lin_Sim_TimVector)(void) = NULL_PTR;
+
+/* Interrupt vectors of Lin.c, NULL_PTR where the driver has none */
+void USART1_IRQHandler(void);
+void USART2_IRQHandler(void);
+void USART3_IRQHandler(void);
+void UART4_IRQHandler(void);
+void UART5_IRQHandler(void);
+void DMA1_Channel2_IRQHandler(void);
+void DMA1_Channel3_IRQHandler(void);
+void DMA1_Channel4_IRQHandler(void);
+void DMA1_Channel5_IRQHandler(void);
+void DMA1_Channel6_IRQHandler(void);
+void DMA1_Channel7_IRQHandler(void);
+void DMA2_Channel1_IRQHandler(void);
+void DMA2_Channel2_IRQHandler(void);
+void DMA2_Channel3_IRQHandler(void);
+void DMA2_Channel5_IRQHandler(void);
+
+static void (* const Lin_Sim_UsartVector[LIN_SIM_UNIT_MAX])(void) =
+{
+    USART1_IRQHandler, USART2_IRQHandler, USART3_IRQHandler, UART4_IRQHandler, UART5_IRQHandler, NULL_PTR
+};
+
+static void (* const Lin_Sim_DmaVector[LIN_SIM_DMA_MAX][LIN_SIM_DMA_CHANNEL_MAX])(void) =
+{
+    {NULL_PTR, DMA1_Channel2_IRQHandler, DMA1_Channel3_IRQHandler, DMA1_Channel4_IRQHandler,
+     DMA1_Channel5_IRQHandler, DMA1_Channel6_IRQHandler, DMA1_Channel7_IRQHandler},
+    {DMA2_Channel1_IRQHandler, DMA2_Channel2_IRQHandler, DMA2_Channel3_IRQHandler, NULL_PTR,
+     DMA2_Channel5_IRQHandler, NULL_PTR, NULL_PTR}
+};
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Returns the bit time of a USART, from its BRR with the 16 MHz kernel clock
+ * @param       Unit: USART index
+ * @return      CPU cycles per bit
+ */
+static uint64 Lin_Sim_BitCycles(uint8 Unit)
+{
+    uint32 brr = Lin_Sim_Usart[Unit].BRR;
+
+    return ((uint64)((brr != 0u) ? brr : LIN_SIM_DEFAULT_BRR) * LIN_SIM_CPU_HZ) / LIN_SIM_KERNEL_HZ;
+}
+
+/**
+ * @brief       Returns the bit time of a bus: the one of its first enabled USART
+ * @param       Bus: Bus index
+ * @return      CPU cycles per bit
+ */
+static uint64 Lin_Sim_BusBitCycles(uint8 Bus)
+{
+    uint8 u;
+
+    for (u = 0u; u < LIN_SIM_UNIT_MAX; u++)
+    {
+        if ((Lin_Sim_Node[u].Bus == Bus) && ((Lin_Sim_Usart[u].CR1 & USART_CR1_UE) != 0u))
+        {
+            return Lin_Sim_BitCycles(u);
+        }
+    }
+
+    return ((uint64)LIN_SIM_DEFAULT_BRR * LIN_SIM_CPU_HZ) / LIN_SIM_KERNEL_HZ;
+}
+
+/**
+ * @brief       Checks whether a USART sends or receives
+ * @param       Unit: USART index
+ * @param       Direction: USART_CR1_TE or USART_CR1_RE
+ * @return      TRUE if the USART and the direction are enabled
+ */
+static uint8 Lin_Sim_Enabled(uint8 Unit, uint32 Direction)
+{
+    uint32 cr1 = Lin_Sim_Usart[Unit].CR1;
+
+    return (((cr1 & USART_CR1_UE) != 0u) && ((cr1 & Direction) != 0u)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief       Records what the node outside the driver sees of a character, and queues its answer at the end
+ *              of a header it answers
+ * @param       Bus: Bus index
+ * @param       Symbol: Character received
+ * @return      void
+ */
+static void Lin_Sim_ExternalReceive(uint8 Bus, const Lin_SimSymbolType* Symbol)
+{
+    Lin_SimBusType *bus = &Lin_Sim_Bus[Bus];
+    uint8 id = Symbol->Value & 0x3Fu;
+    uint8 i;
+
+    if (Symbol->Break == TRUE)
+    {
+        bus->Header = LIN_SIM_HEADER_BREAK;
+    }
+    else if ((bus->Header == LIN_SIM_HEADER_BREAK) && (Symbol->Value == 0x55u))
+    {
+        bus->Header = LIN_SIM_HEADER_SYNC;
+    }
+    else
+    {
+        if ((bus->Header == LIN_SIM_HEADER_SYNC) && (Symbol->Value == LIN_PID(id)))
+        {
+            bus->ExternalReady = bus->End + (bus->ExternalGap * Lin_Sim_BusBitCycles(Bus));
+            for (i = 0u; (i < bus->ResponseLength[id]) && (bus->ExternalCount < LIN_SIM_EXTERNAL_MAX); i++)
+            {
+                bus->External[bus->ExternalCount] = bus->Response[id][i];
+                bus->ExternalCount++;
+            }
+        }
+        bus->Header = LIN_SIM_HEADER_IDLE;
+    }
+}
+
+/**
+ * @brief       Ends the character of a bus: the senders free their shift register and every receiver gets it
+ * @param       Bus: Bus index
+ * @return      void
+ */
+static void Lin_Sim_EndSymbol(uint8 Bus)
+{
+    Lin_SimBusType *bus = &Lin_Sim_Bus[Bus];
+    const Lin_SimSymbolType *symbol = &bus->Symbol;
+    USART_TypeDef *usart;
+    Lin_SimNodeType *node;
+    uint8 u;
+
+    bus->Busy = FALSE;
+    bus->Trace[(bus->Stats.Symbols - 1u) % LIN_SIM_TRACE_MAX] = *symbol;
+
+    for (u = 0u; u < LIN_SIM_UNIT_MAX; u++)
+    {
+        node = &Lin_Sim_Node[u];
+        usart = &Lin_Sim_Usart[u];
+        if (node->Bus != Bus)
+        {
+            continue;
+        }
+
+        if (node->Shifting == TRUE)
+        {
+            node->Shifting = FALSE;
+            if (node->ShiftBreak == TRUE)
+            {
+                usart->ISR &= ~USART_ISR_SBKF;
+            }
+            if (((usart->ISR & USART_ISR_TXE) != 0u) && ((usart->ISR & USART_ISR_SBKF) == 0u))
+            {
+                usart->ISR |= USART_ISR_TC;
+            }
+        }
+
+        if (Lin_Sim_Enabled(u, USART_CR1_RE) == TRUE)
+        {
+            if ((usart->ISR & USART_ISR_RXNE) != 0u)
+            {
+                usart->ISR |= USART_ISR_ORE;
+            }
+            else
+            {
+                usart->RDR = symbol->Value;
+                usart->ISR |= USART_ISR_RXNE;
+            }
+            if (symbol->Break == TRUE)
+            {
+                usart->ISR |= USART_ISR_FE;
+                if ((usart->CR2 & USART_CR2_LINEN) != 0u)
+                {
+                    usart->ISR |= USART_ISR_LBDF;
+                }
+            }
+            node->LastRx = bus->End;
+            node->RtoRunning = TRUE;
+        }
+    }
+
+    Lin_Sim_ExternalReceive(Bus, symbol);
+}
+
+/**
+ * @brief       Starts the next character on every idle bus
+ * @return      TRUE if a character has been started
+ */
+static uint8 Lin_Sim_StartSymbols(void)
+{
+    Lin_SimBusType *bus;
+    USART_TypeDef *usart;
+    Lin_SimNodeType *node;
+    Lin_SimSymbolType symbol;
+    uint64 bitCycles;
+    uint32 senders;
+    uint8 started = FALSE;
+    uint8 sender;
+    uint8 b;
+    uint8 u;
+
+    for (b = 0u; b < LIN_SIM_BUS_MAX; b++)
+    {
+        bus = &Lin_Sim_Bus[b];
+        if (bus->Busy == TRUE)
+        {
+            continue;
+        }
+
+        symbol.Value = 0xFFu;
+        symbol.Break = FALSE;
+        senders = 0u;
+        sender = LIN_SIM_NONE;
+        for (u = 0u; u < LIN_SIM_UNIT_MAX; u++)
+        {
+            node = &Lin_Sim_Node[u];
+            usart = &Lin_Sim_Usart[u];
+            if ((node->Bus != b) || (Lin_Sim_Enabled(u, USART_CR1_TE) == FALSE))
+            {
+                continue;
+            }
+            if ((usart->ISR & USART_ISR_SBKF) != 0u)
+            {
+                node->ShiftBreak = TRUE;
+                symbol.Value = 0x00u;
+                symbol.Break = TRUE;
+            }
+            else if ((usart->ISR & USART_ISR_TXE) == 0u)
+            {
+                node->ShiftBreak = FALSE;
+                symbol.Value &= (uint8)usart->TDR;
+                usart->ISR |= USART_ISR_TXE;
+            }
+            else
+            {
+                continue;
+            }
+            node->Shifting = TRUE;
+            senders++;
+            if (sender == LIN_SIM_NONE)
+            {
+                sender = u;
+            }
+        }
+        if ((bus->ExternalCount > 0u) && (bus->ExternalReady <= Lin_Sim_Now))
+        {
+            symbol.Value &= bus->External[0];
+            bus->ExternalCount--;
+            (void)memmove(&bus->External[0], &bus->External[1], bus->ExternalCount);
+            bus->ExternalReady = Lin_Sim_Now + ((LIN_SIM_BYTE_BITS + bus->ExternalGap) * Lin_Sim_BusBitCycles(b));
+            senders++;
+        }
+        if (senders == 0u)
+        {
+            continue;
+        }
+
+        if ((bus->Corrupt == TRUE) && (bus->CorruptAt == bus->Stats.Symbols))
+        {
+            bus->Corrupt = FALSE;
+            symbol.Value = bus->CorruptValue;
+            symbol.Break = FALSE;
+        }
+
+        /* The start bit stops the receiver timeouts and wakes the USARTs enabled in Stop mode up */
+        for (u = 0u; u < LIN_SIM_UNIT_MAX; u++)
+        {
+            if (Lin_Sim_Node[u].Bus != b)
+            {
+                continue;
+            }
+            Lin_Sim_Node[u].RtoRunning = FALSE;
+            if ((Lin_Sim_Usart[u].CR1 & (USART_CR1_UE | USART_CR1_UESM)) == (USART_CR1_UE | USART_CR1_UESM))
+            {
+                Lin_Sim_Usart[u].ISR |= USART_ISR_WUF;
+            }
+        }
+
+        bitCycles = (sender != LIN_SIM_NONE) ? Lin_Sim_BitCycles(sender) : Lin_Sim_BusBitCycles(b);
+        bus->Symbol = symbol;
+        bus->Busy = TRUE;
+        bus->End = Lin_Sim_Now + (bitCycles * ((symbol.Break == TRUE) ? LIN_SIM_BREAK_BITS : LIN_SIM_BYTE_BITS));
+        bus->Stats.Symbols++;
+        bus->Stats.BusyCycles += bus->End - Lin_Sim_Now;
+        if (symbol.Break == TRUE)
+        {
+            bus->Stats.Breaks++;
+        }
+        if (senders > 1u)
+        {
+            bus->Stats.Collisions++;
+        }
+        started = TRUE;
+    }
+
+    return started;
+}
+
+/**
+ * @brief       Finds the USART served by a DMA channel
+ * @param       Channel: DMA channel
+ * @return      USART index, LIN_SIM_NONE if its peripheral address is not a TDR or RDR
+ */
+static uint8 Lin_Sim_DmaUnit(const DMA_Channel_TypeDef* Channel)
+{
+    uint8 u;
+
+    for (u = 0u; u < LIN_SIM_UNIT_MAX; u++)
+    {
+        if ((Channel->CPAR == (uintptr_t)&Lin_Sim_Usart[u].TDR) || (Channel->CPAR == (uintptr_t)&Lin_Sim_Usart[u].RDR))
+        {
+            return u;
+        }
+    }
+
+    return LIN_SIM_NONE;
+}
+
+/**
+ * @brief       Moves the bytes requested by the USARTs on every enabled DMA channel
+ * @return      TRUE if a byte has been moved
+ */
+static uint8 Lin_Sim_DmaService(void)
+{
+    DMA_Channel_TypeDef *channel;
+    USART_TypeDef *usart;
+    uint8 moved = FALSE;
+    uint8 d;
+    uint8 c;
+    uint8 u;
+
+    for (d = 0u; d < LIN_SIM_DMA_MAX; d++)
+    {
+        for (c = 0u; c < LIN_SIM_DMA_CHANNEL_MAX; c++)
+        {
+            channel = &Lin_Sim_Dma[d].Channel[c];
+            u = Lin_Sim_DmaUnit(channel);
+            if (((channel->CCR & DMA_CCR_EN) == 0u) || (channel->CNDTR == 0u) || (u == LIN_SIM_NONE))
+            {
+                continue;
+            }
+            usart = &Lin_Sim_Usart[u];
+
+            if (((channel->CCR & DMA_CCR_DIR) != 0u) && ((usart->CR3 & USART_CR3_DMAT) != 0u) &&
+                ((usart->ISR & USART_ISR_TXE) != 0u))
+            {
+                LL_USART_TransmitData8(usart, *(const uint8*)channel->Next);
+            }
+            else if (((channel->CCR & DMA_CCR_DIR) == 0u) && ((usart->CR3 & USART_CR3_DMAR) != 0u) &&
+                     ((usart->ISR & USART_ISR_RXNE) != 0u))
+            {
+                *(uint8*)channel->Next = (uint8)usart->RDR;
+                usart->ISR &= ~USART_ISR_RXNE;
+            }
+            else
+            {
+                continue;
+            }
+
+            channel->Next++;
+            channel->CNDTR--;
+            if (channel->CNDTR == 0u)
+            {
+                Lin_Sim_Dma[d].ISR |= (DMA_ISR_GIF1 | DMA_ISR_TCIF1) << (4u * c);
+            }
+            moved = TRUE;
+        }
+    }
+
+    return moved;
+}
+
+/**
+ * @brief       Checks whether the interrupt of a USART is raised
+ * @param       Unit: USART index
+ * @return      TRUE if one of its flags is set and enabled
+ */
+static uint8 Lin_Sim_UsartPending(uint8 Unit)
+{
+    const USART_TypeDef *usart = &Lin_Sim_Usart[Unit];
+    uint32 isr = usart->ISR;
+    uint32 enabled = 0u;
+
+    if ((usart->CR1 & USART_CR1_TCIE) != 0u)
+    {
+        enabled |= USART_ISR_TC;
+    }
+    if ((usart->CR1 & USART_CR1_TXEIE) != 0u)
+    {
+        enabled |= USART_ISR_TXE;
+    }
+    if ((usart->CR1 & USART_CR1_RXNEIE) != 0u)
+    {
+        enabled |= USART_ISR_RXNE | USART_ISR_ORE;
+    }
+    if ((usart->CR1 & USART_CR1_RTOIE) != 0u)
+    {
+        enabled |= USART_ISR_RTOF;
+    }
+    if ((usart->CR2 & USART_CR2_LBDIE) != 0u)
+    {
+        enabled |= USART_ISR_LBDF;
+    }
+    if ((usart->CR3 & USART_CR3_EIE) != 0u)
+    {
+        enabled |= USART_ISR_FE | USART_ISR_NE | USART_ISR_ORE;
+    }
+    if ((usart->CR3 & USART_CR3_WUFIE) != 0u)
+    {
+        enabled |= USART_ISR_WUF;
+    }
+
+    return ((isr & enabled) != 0u) ? TRUE : FALSE;
+}
+
+/**
+ * @brief       Checks whether the interrupt of a DMA channel is raised
+ * @param       Dma: DMA controller index
+ * @param       Channel: Channel index
+ * @return      TRUE if its TCIF is set with TCIE
+ */
+static uint8 Lin_Sim_DmaPending(uint8 Dma, uint8 Channel)
+{
+    return (((Lin_Sim_Dma[Dma].ISR & (DMA_ISR_TCIF1 << (4u * Channel))) != 0u) &&
+            ((Lin_Sim_Dma[Dma].Channel[Channel].CCR & DMA_CCR_TCIE) != 0u)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief       Returns the TIM7 ticks from CNT to the next update event
+ * @return      Ticks until CNT wraps from ARR to 0, through 0xFFFF if CNT is already above ARR
+ */
+static uint64 Lin_Sim_TimToUpdate(void)
+{
+    const TIM_TypeDef *tim = &Lin_Sim_Tim7;
+
+    return (tim->CNT <= tim->ARR) ? ((uint64)tim->ARR - tim->CNT + 1u) :
+                                    ((uint64)TIM_CNT_CNT + 1u - tim->CNT + tim->ARR + 1u);
+}
+
+/**
+ * @brief       Returns the time of the next TIM7 update event
+ * @return      Time at which UIF is set, UINT64_MAX if the counter is stopped
+ */
+static uint64 Lin_Sim_TimDeadline(void)
+{
+    const TIM_TypeDef *tim = &Lin_Sim_Tim7;
+
+    if (((tim->CR1 & TIM_CR1_CEN) == 0u) || (tim->ARR == 0u))
+    {
+        return UINT64_MAX;
+    }
+
+    return Lin_Sim_Now + (Lin_Sim_TimToUpdate() * ((uint64)tim->PSC + 1u)) - Lin_Sim_TimPrescale;
+}
+
+/**
+ * @brief       Counts TIM7 over a span of simulated time, with an update event at every wrap from ARR
+ * @param       Cycles: CPU cycles elapsed
+ * @return      void
+ */
+static void Lin_Sim_TimCount(uint64 Cycles)
+{
+    TIM_TypeDef *tim = &Lin_Sim_Tim7;
+    uint64 ticks;
+    uint64 step;
+    uint8 update;
+
+    if (((tim->CR1 & TIM_CR1_CEN) == 0u) || (tim->ARR == 0u))
+    {
+        return;
+    }
+
+    ticks = (Lin_Sim_TimPrescale + Cycles) / ((uint64)tim->PSC + 1u);
+    Lin_Sim_TimPrescale = (Lin_Sim_TimPrescale + Cycles) % ((uint64)tim->PSC + 1u);
+    while (ticks > 0u)
+    {
+        step = Lin_Sim_TimToUpdate();
+        update = (tim->CNT <= tim->ARR) ? TRUE : FALSE;
+        if (ticks < step)
+        {
+            tim->CNT += (uint32_t)ticks;
+            break;
+        }
+        ticks -= step;
+        tim->CNT = 0u;
+        tim->SR |= (update == TRUE) ? TIM_SR_UIF : 0u;
+    }
+}
+
+/**
+ * @brief       Applies a software update event of TIM7 requested through EGR
+ * @return      TRUE if an update event has been generated
+ */
+static uint8 Lin_Sim_TimService(void)
+{
+    TIM_TypeDef *tim = &Lin_Sim_Tim7;
+
+    if ((tim->EGR & TIM_EGR_UG) == 0u)
+    {
+        return FALSE;
+    }
+
+    tim->EGR &= ~TIM_EGR_UG;
+    tim->CNT = 0u;
+    Lin_Sim_TimPrescale = 0u;
+    if ((tim->CR1 & TIM_CR1_URS) == 0u)
+    {
+        tim->SR |= TIM_SR_UIF;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief       Checks whether the interrupt of TIM7 is raised
+ * @return      TRUE if UIF is set with UIE
+ */
+static uint8 Lin_Sim_TimPending(void)
+{
+    return (((Lin_Sim_Tim7.SR & TIM_SR_UIF) != 0u) && ((Lin_Sim_Tim7.DIER & TIM_DIER_UIE) != 0u)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief       Checks whether any interrupt is raised, whatever PRIMASK
+ * @return      TRUE if an interrupt is pending
+ */
+static uint8 Lin_Sim_AnyPending(void)
+{
+    uint8 d;
+    uint8 c;
+    uint8 u;
+
+    for (u = 0u; u < LIN_SIM_UNIT_MAX; u++)
+    {
+        if (Lin_Sim_UsartPending(u) == TRUE)
+        {
+            return TRUE;
+        }
+    }
+    for (d = 0u; d < LIN_SIM_DMA_MAX; d++)
+    {
+        for (c = 0u; c < LIN_SIM_DMA_CHANNEL_MAX; c++)
+        {
+            if (Lin_Sim_DmaPending(d, c) == TRUE)
+            {
+                return TRUE;
+            }
+        }
+    }
+
+    return Lin_Sim_TimPending();
+}
+
+/**
+ * @brief       Calls the interrupt handlers of Lin.c whose interrupt is raised, in vector order within a USART
+ *              and then its DMA channels, then the handler attached for TIM7
+ * @return      TRUE if a handler has been called
+ */
+static uint8 Lin_Sim_Dispatch(void)
+{
+    uint8 called = FALSE;
+    uint8 d;
+    uint8 c;
+    uint8 u;
+
+    if (Cmsis_Sim_Primask != 0u)
+    {
+        return FALSE;
+    }
+
+    for (u = 0u; u < LIN_SIM_UNIT_MAX; u++)
+    {
+        if ((Lin_Sim_UsartPending(u) == TRUE) && (Lin_Sim_UsartVector[u] != NULL_PTR))
+        {
+            Lin_Sim_UsartVector[u]();
+            called = TRUE;
+        }
+    }
+    for (d = 0u; d < LIN_SIM_DMA_MAX; d++)
+    {
+        for (c = 0u; c < LIN_SIM_DMA_CHANNEL_MAX; c++)
+        {
+            if ((Lin_Sim_DmaPending(d, c) == TRUE) && (Lin_Sim_DmaVector[d][c] != NULL_PTR))
+            {
+                Lin_Sim_DmaVector[d][c]();
+                called = TRUE;
+            }
+        }
+    }
+    if ((Lin_Sim_TimPending() == TRUE) && (Lin_Sim_TimVector != NULL_PTR))
+    {
+        Lin_Sim_TimVector();
+        called = TRUE;
+    }
+
+    return called;
+}
+
+/**
+ * @brief       Settles the current point in time: moves the DMA bytes, raises the interrupts and starts the
+ *              characters of the idle buses until nothing changes
+ * @param       Interrupts: TRUE to call the interrupt handlers, FALSE while the core waits in Stop mode
+ * @return      void
+ */
+static void Lin_Sim_Settle(uint8 Interrupts)
+{
+    uint8 changed;
+    uint8 pass;
+
+    for (pass = 0u; pass < LIN_SIM_ISR_PASSES; pass++)
+    {
+        changed = Lin_Sim_DmaService();
+        changed |= Lin_Sim_TimService();
+        if (Interrupts == TRUE)
+        {
+            changed |= Lin_Sim_Dispatch();
+        }
+        changed |= Lin_Sim_StartSymbols();
+        if (changed == FALSE)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief       Returns the end of the receiver timeout of a USART
+ * @param       Unit: USART index
+ * @return      Time at which RTOF is set, UINT64_MAX if the timeout does not run
+ */
+static uint64 Lin_Sim_RtoDeadline(uint8 Unit)
+{
+    const USART_TypeDef *usart = &Lin_Sim_Usart[Unit];
+
+    if ((Lin_Sim_Node[Unit].RtoRunning == FALSE) || ((usart->CR2 & USART_CR2_RTOEN) == 0u))
+    {
+        return UINT64_MAX;
+    }
+
+    return Lin_Sim_Node[Unit].LastRx + ((usart->RTOR & USART_RTOR_RTO) * Lin_Sim_BitCycles(Unit));
+}
+
+/**
+ * @brief       Returns the time of the next event: the end of a character or of a receiver timeout, the next
+ *              byte of the node outside the driver after its gap, or a TIM7 update
+ * @param       Limit: Latest time to return
+ * @return      Time of the next event, Limit if there is none before
+ */
+static uint64 Lin_Sim_NextEvent(uint64 Limit)
+{
+    uint64 next = Limit;
+    uint64 deadline;
+    uint8 b;
+    uint8 u;
+
+    for (b = 0u; b < LIN_SIM_BUS_MAX; b++)
+    {
+        if ((Lin_Sim_Bus[b].Busy == TRUE) && (Lin_Sim_Bus[b].End < next))
+        {
+            next = Lin_Sim_Bus[b].End;
+        }
+        if ((Lin_Sim_Bus[b].ExternalCount > 0u) && (Lin_Sim_Bus[b].ExternalReady > Lin_Sim_Now) &&
+            (Lin_Sim_Bus[b].ExternalReady < next))
+        {
+            next = Lin_Sim_Bus[b].ExternalReady;
+        }
+    }
+    for (u = 0u; u < LIN_SIM_UNIT_MAX; u++)
+    {
+        deadline = Lin_Sim_RtoDeadline(u);
+        if (deadline < next)
+        {
+            next = deadline;
+        }
+    }
+    deadline = Lin_Sim_TimDeadline();
+    if (deadline < next)
+    {
+        next = deadline;
+    }
+
+    return (next < Lin_Sim_Now) ? Lin_Sim_Now : next;
+}
+
+/**
+ * @brief       Moves the time forward and applies the events due: ends of characters, receiver timeouts and
+ *              TIM7 updates
+ * @param       Time: New simulated time
+ * @return      void
+ */
+static void Lin_Sim_Advance(uint64 Time)
+{
+    uint8 b;
+    uint8 u;
+
+    Lin_Sim_TimCount(Time - Lin_Sim_Now);
+    Lin_Sim_Now = Time;
+    Cmsis_Sim_Dwt.CYCCNT = (uint32_t)Lin_Sim_Now;
+
+    for (b = 0u; b < LIN_SIM_BUS_MAX; b++)
+    {
+        if ((Lin_Sim_Bus[b].Busy == TRUE) && (Lin_Sim_Bus[b].End <= Lin_Sim_Now))
+        {
+            Lin_Sim_EndSymbol(b);
+        }
+    }
+    for (u = 0u; u < LIN_SIM_UNIT_MAX; u++)
+    {
+        if (Lin_Sim_RtoDeadline(u) <= Lin_Sim_Now)
+        {
+            Lin_Sim_Node[u].RtoRunning = FALSE;
+            Lin_Sim_Usart[u].ISR |= USART_ISR_RTOF;
+        }
+    }
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets every USART and DMA channel, attaches each USART to a bus of its own and sets the simulated
+ *              time to 0. Call it before Lin_Init().
+ * @param       void
+ * @return      void
+ */
+void Lin_Sim_Init(void)
+{
+    static const Lin_SimBusType idle = {0};
+    uint8 u;
+
+    (void)memset(Lin_Sim_Usart, 0, sizeof(Lin_Sim_Usart));
+    (void)memset(Lin_Sim_Dma, 0, sizeof(Lin_Sim_Dma));
+    (void)memset(Lin_Sim_Node, 0, sizeof(Lin_Sim_Node));
+    (void)memset(&Lin_Sim_Tim7, 0, sizeof(Lin_Sim_Tim7));
+    Lin_Sim_TimPrescale = 0u;
+
+    for (u = 0u; u < LIN_SIM_UNIT_MAX; u++)
+    {
+        Lin_Sim_Usart[u].ISR = USART_ISR_TXE | USART_ISR_TC;
+        Lin_Sim_Node[u].Bus = u;
+    }
+    for (u = 0u; u < LIN_SIM_BUS_MAX; u++)
+    {
+        Lin_Sim_Bus[u] = idle;
+    }
+
+    Lin_Sim_Now = 0u;
+    Cmsis_Sim_Dwt.CYCCNT = 0u;
+    Cmsis_Sim_Primask = 0u;
+}
+
+/**
+ * @brief       Attaches a USART to a bus
+ * @param       Unit: LIN_HW_xxx
+ * @param       Bus: Bus index, below LIN_SIM_BUS_MAX
+ * @return      void
+ */
+void Lin_Sim_Connect(uint8 Unit, uint8 Bus)
+{
+    if ((Unit < LIN_SIM_UNIT_MAX) && (Bus < LIN_SIM_BUS_MAX))
+    {
+        Lin_Sim_Node[Unit].Bus = Bus;
+    }
+}
+
+/**
+ * @brief       Hands the TIM7 interrupt handler to the simulator
+ * @param       Handler: TIM7_IRQHandler, NULL_PTR to detach it
+ * @return      void
+ */
+void Lin_Sim_AttachTimer(void (*Handler)(void))
+{
+    Lin_Sim_TimVector = Handler;
+}
+
+/**
+ * @brief       Advances the simulated time
+ * @param       Cycles: CPU cycles to simulate
+ * @return      void
+ */
+void Lin_Sim_Run(uint64 Cycles)
+{
+    uint64 end = Lin_Sim_Now + Cycles;
+
+    for (;;)
+    {
+        Lin_Sim_Settle(TRUE);
+        if (Lin_Sim_Now >= end)
+        {
+            break;
+        }
+        Lin_Sim_Advance(Lin_Sim_NextEvent(end));
+    }
+}
+
+/**
+ * @brief       Returns the simulated time
+ * @param       void
+ * @return      CPU cycles since Lin_Sim_Init()
+ */
+uint64 Lin_Sim_GetTime(void)
+{
+    return Lin_Sim_Now;
+}
+
+/**
+ * @brief       Applies a register write with its hardware side effects
+ * @param       Reg: Register of one of the DMA controllers
+ * @param       Value: Value written by the driver
+ * @return      void
+ */
+void Lin_Sim_WriteReg(volatile uint32_t* Reg, uint32 Value)
+{
+    uint8 d;
+
+    for (d = 0u; d < LIN_SIM_DMA_MAX; d++)
+    {
+        if (Reg == &Lin_Sim_Dma[d].IFCR)
+        {
+            Lin_Sim_Dma[d].ISR &= ~Value;
+            return;
+        }
+    }
+
+    *Reg = (uint32_t)Value;
+}
+
+/**
+ * @brief       Stands in for the WFI of the Stop mode
+ * @param       void
+ * @return      void
+ */
+void Lin_Sim_WaitForInterrupt(void)
+{
+    uint64 end = Lin_Sim_Now + LIN_SIM_WFI_CYCLES;
+
+    for (;;)
+    {
+        Lin_Sim_Settle(FALSE);
+        if ((Lin_Sim_AnyPending() == TRUE) || (Lin_Sim_Now >= end))
+        {
+            break;
+        }
+        Lin_Sim_Advance(Lin_Sim_NextEvent(end));
+    }
+}
+
+/**
+ * @brief       Makes a node outside the driver answer a header on a bus
+ * @param       Bus: Bus index
+ * @param       Id: Frame identifier (0..0x3F)
+ * @param       Bytes: Response and checksum
+ * @param       Length: Number of bytes, up to 9; 0 to stop answering the frame
+ * @return      void
+ */
+void Lin_Sim_SetResponse(uint8 Bus, uint8 Id, const uint8* Bytes, uint8 Length)
+{
+    Lin_SimBusType *bus;
+
+    if ((Bus >= LIN_SIM_BUS_MAX) || (Id > 0x3Fu) || (Length > 9u) || ((Bytes == NULL_PTR) && (Length > 0u)))
+    {
+        return;
+    }
+
+    bus = &Lin_Sim_Bus[Bus];
+    if (Length > 0u)
+    {
+        (void)memcpy(bus->Response[Id], Bytes, Length);
+    }
+    bus->ResponseLength[Id] = Length;
+}
+
+/**
+ * @brief       Makes the node outside the driver of a bus leave idle bit times before each byte it answers
+ * @param       Bus: Bus index
+ * @param       Bits: Bit times before the first byte and between two bytes, 0 to answer back to back
+ * @return      void
+ */
+void Lin_Sim_SetResponseGap(uint8 Bus, uint8 Bits)
+{
+    if (Bus < LIN_SIM_BUS_MAX)
+    {
+        Lin_Sim_Bus[Bus].ExternalGap = Bits;
+    }
+}
+
+/**
+ * @brief       Makes a node outside the driver send a wakeup pulse on a bus
+ * @param       Bus: Bus index
+ * @return      void
+ */
+void Lin_Sim_SendWakeup(uint8 Bus)
+{
+    Lin_SimBusType *bus;
+
+    if (Bus >= LIN_SIM_BUS_MAX)
+    {
+        return;
+    }
+
+    bus = &Lin_Sim_Bus[Bus];
+    if (bus->ExternalCount < LIN_SIM_EXTERNAL_MAX)
+    {
+        bus->External[bus->ExternalCount] = 0x80u;
+        bus->ExternalCount++;
+    }
+}
+
+/**
+ * @brief       Corrupts a coming character of a bus
+ * @param       Bus: Bus index
+ * @param       Index: Character to corrupt, 0 for the next one to start
+ * @param       Value: Byte received instead
+ * @return      void
+ */
+void Lin_Sim_CorruptSymbol(uint8 Bus, uint32 Index, uint8 Value)
+{
+    if (Bus < LIN_SIM_BUS_MAX)
+    {
+        Lin_Sim_Bus[Bus].Corrupt = TRUE;
+        Lin_Sim_Bus[Bus].CorruptAt = Lin_Sim_Bus[Bus].Stats.Symbols + Index;
+        Lin_Sim_Bus[Bus].CorruptValue = Value;
+    }
+}
+
+/**
+ * @brief       Returns the characters seen on a bus since the previous call, at most the last 64
+ * @param       Bus: Bus index
+ * @param       Symbols: Where the characters are stored, oldest first
+ * @param       Max: Size of Symbols
+ * @return      Number of characters stored
+ */
+uint32 Lin_Sim_ReadBus(uint8 Bus, Lin_SimSymbolType* Symbols, uint32 Max)
+{
+    Lin_SimBusType *bus;
+    uint32 ended;
+    uint32 count = 0u;
+
+    if ((Bus >= LIN_SIM_BUS_MAX) || (Symbols == NULL_PTR))
+    {
+        return 0u;
+    }
+
+    /* The character still on the bus is not complete yet */
+    bus = &Lin_Sim_Bus[Bus];
+    ended = bus->Stats.Symbols - ((bus->Busy == TRUE) ? 1u : 0u);
+    if ((ended - bus->TraceRead) > LIN_SIM_TRACE_MAX)
+    {
+        bus->TraceRead = ended - LIN_SIM_TRACE_MAX;
+    }
+    while ((bus->TraceRead < ended) && (count < Max))
+    {
+        Symbols[count] = bus->Trace[bus->TraceRead % LIN_SIM_TRACE_MAX];
+        bus->TraceRead++;
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief       Returns the activity of a bus
+ * @param       Bus: Bus index
+ * @param       StatsPtr: Where the counters are stored
+ * @return      void
+ */
+void Lin_Sim_GetBusStats(uint8 Bus, Lin_SimBusStatsType* StatsPtr)
+{
+    if ((Bus < LIN_SIM_BUS_MAX) && (StatsPtr != NULL_PTR))
+    {
+        *StatsPtr = Lin_Sim_Bus[Bus].Stats;
+    }
+}
+
+#endif /* LIN_HOST_SIM */
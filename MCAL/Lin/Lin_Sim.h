@@ -0,0 +1,814 @@
+/**
+ * @file        Lin_Sim.h
+ * @author      Phuc
+ * @brief       Host simulator of the USART and DMA units of the LIN driver, for building it on a PC
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef LIN_SIM_H
+#define LIN_SIM_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "Std_Types.h"
+#include "Cmsis_Sim.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Host build
+ * @details     Compiling Lin.c and Lin_Sim.c with LIN_HOST_SIM defined replaces the device and LL headers by this
+ *              file. The six USART units and the two DMA controllers are plain memory driven by the LL functions
+ *              below, and each USART is attached to a simulated LIN bus, by default a bus of its own. Lin_Sim_Run()
+ *              moves the buses forward, moves the bytes of the DMA channels and calls the interrupt handlers of
+ *              Lin.c whenever a flag is set and enabled. TIM7, the slot timer of the schedule table engine, counts
+ *              the same simulated time. Time is counted in CPU cycles and only advances in
+ *              Lin_Sim_Run(), so the driver code itself takes no time and two runs with the same calls give the
+ *              same result.
+ */
+#define LIN_SIM_CPU_HZ              80000000u   /* Core clock, the unit of the simulated time and of DWT */
+#define LIN_SIM_KERNEL_HZ           16000000u   /* HSI16, the kernel clock of every USART */
+#define LIN_SIM_UNIT_MAX            6u          /* USART1, USART2, USART3, UART4, UART5, LPUART1 */
+#define LIN_SIM_BUS_MAX             LIN_SIM_UNIT_MAX
+#define LIN_SIM_DMA_MAX             2u
+#define LIN_SIM_DMA_CHANNEL_MAX     7u
+#define LIN_SIM_WFI_CYCLES          LIN_SIM_CPU_HZ  /* Longest stay in Stop mode, 1 s without any interrupt */
+
+/**
+ * @typedef     Lin_SimSymbolType
+ * @brief       Character seen on a bus: a byte, or a break of 13 dominant bits
+ */
+typedef struct
+{
+    uint8 Value;                            /* Byte received, 0x00 for a break */
+    uint8 Break;                            /* TRUE for a break */
+} Lin_SimSymbolType;
+
+/**
+ * @typedef     Lin_SimBusStatsType
+ * @brief       Activity of a bus since Lin_Sim_Init()
+ */
+typedef struct
+{
+    uint32 Symbols;                         /* Characters sent, breaks included */
+    uint32 Breaks;                          /* Breaks sent */
+    uint32 Collisions;                      /* Characters started by more than one sender */
+    uint64 BusyCycles;                      /* CPU cycles during which the bus carried a character */
+} Lin_SimBusStatsType;
+
+/* GPIO, clocks and power: the pins and the clock tree are not simulated */
+typedef struct
+{
+    __IO uint32_t MODER;
+    __IO uint32_t AFR[2];
+} GPIO_TypeDef;
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Speed;
+    uint32_t OutputType;
+    uint32_t Pull;
+    uint32_t Alternate;
+} LL_GPIO_InitTypeDef;
+
+#define LL_GPIO_PIN_0               (0x1UL << 0)
+#define LL_GPIO_PIN_1               (0x1UL << 1)
+#define LL_GPIO_PIN_2               (0x1UL << 2)
+#define LL_GPIO_PIN_3               (0x1UL << 3)
+#define LL_GPIO_PIN_4               (0x1UL << 4)
+#define LL_GPIO_PIN_5               (0x1UL << 5)
+#define LL_GPIO_PIN_9               (0x1UL << 9)
+#define LL_GPIO_PIN_10              (0x1UL << 10)
+#define LL_GPIO_PIN_11              (0x1UL << 11)
+#define LL_GPIO_PIN_12              (0x1UL << 12)
+#define LL_GPIO_MODE_ALTERNATE      2u
+#define LL_GPIO_SPEED_FREQ_VERY_HIGH 3u
+#define LL_GPIO_OUTPUT_PUSHPULL     0u
+#define LL_GPIO_PULL_NO             0u
+#define LL_GPIO_AF_7                7u
+#define LL_GPIO_AF_8                8u
+
+#define LL_RCC_USART1_CLKSOURCE_HSI 0u
+#define LL_RCC_USART2_CLKSOURCE_HSI 0u
+#define LL_RCC_USART3_CLKSOURCE_HSI 0u
+#define LL_RCC_UART4_CLKSOURCE_HSI  0u
+#define LL_RCC_UART5_CLKSOURCE_HSI  0u
+#define LL_APB2_GRP1_PERIPH_USART1  (0x1UL << 14)
+#define LL_APB1_GRP1_PERIPH_TIM7    (0x1UL << 5)
+#define LL_APB1_GRP1_PERIPH_USART2  (0x1UL << 17)
+#define LL_APB1_GRP1_PERIPH_USART3  (0x1UL << 18)
+#define LL_APB1_GRP1_PERIPH_UART4   (0x1UL << 19)
+#define LL_APB1_GRP1_PERIPH_UART5   (0x1UL << 20)
+#define LL_AHB1_GRP1_PERIPH_DMA1    (0x1UL << 0)
+#define LL_AHB1_GRP1_PERIPH_DMA2    (0x1UL << 1)
+#define LL_AHB2_GRP1_PERIPH_GPIOA   (0x1UL << 0)
+#define LL_AHB2_GRP1_PERIPH_GPIOB   (0x1UL << 1)
+#define LL_AHB2_GRP1_PERIPH_GPIOC   (0x1UL << 2)
+#define LL_AHB2_GRP1_PERIPH_GPIOD   (0x1UL << 3)
+
+#define LL_PWR_MODE_STOP1           1u
+
+#define LL_EXTI_LINE_26             (0x1UL << 26)
+#define LL_EXTI_LINE_27             (0x1UL << 27)
+#define LL_EXTI_LINE_28             (0x1UL << 28)
+#define LL_EXTI_LINE_29             (0x1UL << 29)
+#define LL_EXTI_LINE_30             (0x1UL << 30)
+#define LL_EXTI_LINE_31             (0x1UL << 31)
+
+/* USART register block, same layout as stm32l476xx.h */
+typedef struct
+{
+    __IO uint32_t CR1;
+    __IO uint32_t CR2;
+    __IO uint32_t CR3;
+    __IO uint32_t BRR;
+    __IO uint32_t GTPR;
+    __IO uint32_t RTOR;
+    __IO uint32_t RQR;
+    __IO uint32_t ISR;
+    __IO uint32_t ICR;
+    __IO uint32_t RDR;
+    __IO uint32_t TDR;
+} USART_TypeDef;
+
+#define USART_CR1_UE                (0x1UL << 0)
+#define USART_CR1_UESM              (0x1UL << 1)
+#define USART_CR1_RE                (0x1UL << 2)
+#define USART_CR1_TE                (0x1UL << 3)
+#define USART_CR1_RXNEIE            (0x1UL << 5)
+#define USART_CR1_TCIE              (0x1UL << 6)
+#define USART_CR1_TXEIE             (0x1UL << 7)
+#define USART_CR1_RTOIE             (0x1UL << 26)
+#define USART_CR2_LBDL              (0x1UL << 5)
+#define USART_CR2_LBDIE             (0x1UL << 6)
+#define USART_CR2_LINEN             (0x1UL << 14)
+#define USART_CR2_RTOEN             (0x1UL << 23)
+#define USART_CR3_EIE               (0x1UL << 0)
+#define USART_CR3_DMAR              (0x1UL << 6)
+#define USART_CR3_DMAT              (0x1UL << 7)
+#define USART_CR3_DDRE              (0x1UL << 13)
+#define USART_CR3_WUS               (0x3UL << 20)
+#define USART_CR3_WUFIE             (0x1UL << 22)
+#define USART_RTOR_RTO              (0xFFFFFFUL << 0)
+#define USART_ISR_FE                (0x1UL << 1)
+#define USART_ISR_NE                (0x1UL << 2)
+#define USART_ISR_ORE               (0x1UL << 3)
+#define USART_ISR_RXNE              (0x1UL << 5)
+#define USART_ISR_TC                (0x1UL << 6)
+#define USART_ISR_TXE               (0x1UL << 7)
+#define USART_ISR_LBDF              (0x1UL << 8)
+#define USART_ISR_RTOF              (0x1UL << 11)
+#define USART_ISR_SBKF              (0x1UL << 18)
+#define USART_ISR_WUF               (0x1UL << 20)
+
+typedef struct
+{
+    uint32_t BaudRate;
+    uint32_t DataWidth;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t TransferDirection;
+    uint32_t HardwareFlowControl;
+    uint32_t OverSampling;
+} LL_USART_InitTypeDef;
+
+#define LL_USART_DATAWIDTH_8B       0u
+#define LL_USART_STOPBITS_1         0u
+#define LL_USART_PARITY_NONE        0u
+#define LL_USART_DIRECTION_TX_RX    (USART_CR1_TE | USART_CR1_RE)
+#define LL_USART_OVERSAMPLING_16    0u
+#define LL_USART_LINBREAK_DETECT_10B 0u
+#define LL_USART_WAKEUP_ON_STARTBIT (0x2UL << 20)
+#define LL_USART_DMA_REG_DATA_TRANSMIT 0u
+#define LL_USART_DMA_REG_DATA_RECEIVE  1u
+
+/* DMA controller, with its channels inside it; the address registers are as wide as a host pointer */
+typedef struct
+{
+    __IO uint32_t CCR;
+    __IO uint32_t CNDTR;
+    __IO uintptr_t CPAR;
+    __IO uintptr_t CMAR;
+    uintptr_t Next;                         /* Memory address of the next transfer, CMAR when enabled */
+} DMA_Channel_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t ISR;
+    __IO uint32_t IFCR;
+    __IO uint32_t CSELR;
+    DMA_Channel_TypeDef Channel[LIN_SIM_DMA_CHANNEL_MAX];
+} DMA_TypeDef;
+
+#define DMA_CCR_EN                  (0x1UL << 0)
+#define DMA_CCR_TCIE                (0x1UL << 1)
+#define DMA_CCR_DIR                 (0x1UL << 4)
+#define DMA_ISR_GIF1                (0x1UL << 0)
+#define DMA_ISR_TCIF1               (0x1UL << 1)
+#define DMA_ISR_HTIF1               (0x1UL << 2)
+#define DMA_ISR_TEIF1               (0x1UL << 3)
+
+#define LL_DMA_CHANNEL_1            0u
+#define LL_DMA_CHANNEL_2            1u
+#define LL_DMA_CHANNEL_3            2u
+#define LL_DMA_CHANNEL_4            3u
+#define LL_DMA_CHANNEL_5            4u
+#define LL_DMA_CHANNEL_6            5u
+#define LL_DMA_CHANNEL_7            6u
+#define LL_DMA_REQUEST_2            2u
+#define LL_DMA_REQUEST_4            4u
+#define LL_DMA_DIRECTION_PERIPH_TO_MEMORY 0u
+#define LL_DMA_DIRECTION_MEMORY_TO_PERIPH DMA_CCR_DIR
+#define LL_DMA_PRIORITY_HIGH        (0x2UL << 12)
+#define LL_DMA_MODE_NORMAL          0u
+#define LL_DMA_PERIPH_NOINCREMENT   0u
+#define LL_DMA_MEMORY_INCREMENT     (0x1UL << 7)
+#define LL_DMA_PDATAALIGN_BYTE      0u
+#define LL_DMA_MDATAALIGN_BYTE      0u
+
+/* Basic timer, its registers without their reserved words; the prescaler is counted in CPU cycles */
+typedef struct
+{
+    __IO uint32_t CR1;
+    __IO uint32_t DIER;
+    __IO uint32_t SR;
+    __IO uint32_t EGR;
+    __IO uint32_t CNT;
+    __IO uint32_t PSC;
+    __IO uint32_t ARR;
+} TIM_TypeDef;
+
+#define TIM_CR1_CEN                 (0x1UL << 0)
+#define TIM_CR1_URS                 (0x1UL << 2)
+#define TIM_CR1_ARPE                (0x1UL << 7)
+#define TIM_DIER_UIE                (0x1UL << 0)
+#define TIM_SR_UIF                  (0x1UL << 0)
+#define TIM_EGR_UG                  (0x1UL << 0)
+#define TIM_CNT_CNT                 0xFFFFUL
+
+#define LL_TIM_UPDATESOURCE_REGULAR 0u
+#define LL_TIM_UPDATESOURCE_COUNTER TIM_CR1_URS
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+extern USART_TypeDef Lin_Sim_Usart[LIN_SIM_UNIT_MAX];
+extern DMA_TypeDef Lin_Sim_Dma[LIN_SIM_DMA_MAX];
+extern GPIO_TypeDef Lin_Sim_Gpio[4];
+extern TIM_TypeDef Lin_Sim_Tim7;
+
+#define USART1                      (&Lin_Sim_Usart[0])
+#define USART2                      (&Lin_Sim_Usart[1])
+#define USART3                      (&Lin_Sim_Usart[2])
+#define UART4                       (&Lin_Sim_Usart[3])
+#define UART5                       (&Lin_Sim_Usart[4])
+#define LPUART1                     (&Lin_Sim_Usart[5])
+#define DMA1                        (&Lin_Sim_Dma[0])
+#define DMA2                        (&Lin_Sim_Dma[1])
+#define GPIOA                       (&Lin_Sim_Gpio[0])
+#define GPIOB                       (&Lin_Sim_Gpio[1])
+#define GPIOC                       (&Lin_Sim_Gpio[2])
+#define GPIOD                       (&Lin_Sim_Gpio[3])
+#define TIM7                        (&Lin_Sim_Tim7)
+
+/*
+ ************************************************************************************************************
+ * Functions declaration
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets every USART and DMA channel, attaches each USART to a bus of its own and sets the simulated
+ *              time to 0. Call it before Lin_Init().
+ * @param       void
+ * @return      void
+ */
+void Lin_Sim_Init(void);
+
+/**
+ * @brief       Attaches a USART to a bus, e.g. a master and a slave channel to the same one
+ * @param       Unit: LIN_HW_xxx
+ * @param       Bus: Bus index, below LIN_SIM_BUS_MAX
+ * @return      void
+ */
+void Lin_Sim_Connect(uint8 Unit, uint8 Bus);
+
+/**
+ * @brief       Hands the TIM7 interrupt handler to the simulator. It lives in the schedule table engine, which is
+ *              not part of every build of the driver, so Lin_Sim_Run() only calls it once it has been attached.
+ * @param       Handler: TIM7_IRQHandler, NULL_PTR to detach it
+ * @return      void
+ */
+void Lin_Sim_AttachTimer(void (*Handler)(void));
+
+/**
+ * @brief       Advances the simulated time. Characters are sent and received on every bus, the DMA channels move
+ *              them between memory and the USARTs, and the interrupt handlers of Lin.c are called whenever a flag
+ *              is set and enabled and PRIMASK is clear.
+ * @details     A transmitter starts its next character once its bus is idle; characters started at the same time
+ *              by several senders collide as a wired AND, a break winning over a byte.
+ * @param       Cycles: CPU cycles to simulate
+ * @return      void
+ */
+void Lin_Sim_Run(uint64 Cycles);
+
+/**
+ * @brief       Returns the simulated time
+ * @param       void
+ * @return      CPU cycles since Lin_Sim_Init()
+ */
+uint64 Lin_Sim_GetTime(void);
+
+/**
+ * @brief       Applies a register write with its hardware side effects: the write-1-to-clear flags of IFCR. Other
+ *              registers are written directly by the driver or through the LL functions.
+ * @param       Reg: Register of one of the DMA controllers
+ * @param       Value: Value written by the driver
+ * @return      void
+ */
+void Lin_Sim_WriteReg(volatile uint32_t* Reg, uint32 Value);
+
+/**
+ * @brief       Stands in for the WFI of the Stop mode: runs the simulation, without raising interrupts, until an
+ *              interrupt is pending or LIN_SIM_WFI_CYCLES have passed
+ * @param       void
+ * @return      void
+ */
+void Lin_Sim_WaitForInterrupt(void);
+
+/**
+ * @brief       Makes a node outside the driver answer a header on a bus, as a slave would
+ * @param       Bus: Bus index
+ * @param       Id: Frame identifier (0..0x3F); the answer follows a header with its protected identifier
+ * @param       Bytes: Response and checksum, sent as given so that wrong checksums can be tested
+ * @param       Length: Number of bytes, up to 9; 0 to stop answering the frame
+ * @return      void
+ */
+void Lin_Sim_SetResponse(uint8 Bus, uint8 Id, const uint8* Bytes, uint8 Length);
+
+/**
+ * @brief       Makes the node outside the driver of a bus leave idle bit times before each byte it answers, e.g.
+ *              a slow slave whose byte gaps stay under the receiver timeout
+ * @param       Bus: Bus index
+ * @param       Bits: Bit times before the first byte and between two bytes, 0 to answer back to back
+ * @return      void
+ */
+void Lin_Sim_SetResponseGap(uint8 Bus, uint8 Bits);
+
+/**
+ * @brief       Makes a node outside the driver send a wakeup pulse on a bus: 8 dominant bits, the byte 0x80
+ * @param       Bus: Bus index
+ * @return      void
+ */
+void Lin_Sim_SendWakeup(uint8 Bus);
+
+/**
+ * @brief       Corrupts a coming character of a bus, e.g. a collision or a bus stuck dominant: every receiver,
+ *              the sender included, gets Value instead
+ * @param       Bus: Bus index
+ * @param       Index: Character to corrupt, 0 for the next one to start
+ * @param       Value: Byte received instead
+ * @return      void
+ */
+void Lin_Sim_CorruptSymbol(uint8 Bus, uint32 Index, uint8 Value);
+
+/**
+ * @brief       Returns the characters seen on a bus since the previous call, at most the last 64
+ * @param       Bus: Bus index
+ * @param       Symbols: Where the characters are stored, oldest first
+ * @param       Max: Size of Symbols
+ * @return      Number of characters stored
+ */
+uint32 Lin_Sim_ReadBus(uint8 Bus, Lin_SimSymbolType* Symbols, uint32 Max);
+
+/**
+ * @brief       Returns the activity of a bus
+ * @param       Bus: Bus index
+ * @param       StatsPtr: Where the counters are stored
+ * @return      void
+ */
+void Lin_Sim_GetBusStats(uint8 Bus, Lin_SimBusStatsType* StatsPtr);
+
+/*
+ ************************************************************************************************************
+ * Inline functions
+ ************************************************************************************************************
+ */
+static inline void __WFI(void)
+{
+    Lin_Sim_WaitForInterrupt();
+}
+
+static inline void LL_RCC_HSI_Enable(void)
+{
+}
+
+static inline uint32_t LL_RCC_HSI_IsReady(void)
+{
+    return 1u;
+}
+
+static inline void LL_RCC_SetUSARTClockSource(uint32_t Source)
+{
+    (void)Source;
+}
+
+static inline void LL_RCC_SetUARTClockSource(uint32_t Source)
+{
+    (void)Source;
+}
+
+static inline void LL_AHB1_GRP1_EnableClock(uint32_t Periphs)
+{
+    (void)Periphs;
+}
+
+static inline void LL_AHB2_GRP1_EnableClock(uint32_t Periphs)
+{
+    (void)Periphs;
+}
+
+static inline void LL_APB1_GRP1_EnableClock(uint32_t Periphs)
+{
+    (void)Periphs;
+}
+
+static inline void LL_APB2_GRP1_EnableClock(uint32_t Periphs)
+{
+    (void)Periphs;
+}
+
+static inline uint32_t LL_GPIO_Init(GPIO_TypeDef* GPIOx, const LL_GPIO_InitTypeDef* GPIO_InitStruct)
+{
+    (void)GPIOx;
+    (void)GPIO_InitStruct;
+    return 0u;
+}
+
+static inline void LL_EXTI_EnableIT_0_31(uint32_t ExtiLine)
+{
+    (void)ExtiLine;
+}
+
+static inline void LL_PWR_SetPowerMode(uint32_t LowPowerMode)
+{
+    (void)LowPowerMode;
+}
+
+static inline void LL_LPM_EnableDeepSleep(void)
+{
+}
+
+static inline void LL_LPM_EnableSleep(void)
+{
+}
+
+/* USART: the LL functions change the register block, Lin_Sim_Run() acts on it */
+static inline uint32_t LL_USART_Init(USART_TypeDef* USARTx, const LL_USART_InitTypeDef* USART_InitStruct)
+{
+    USARTx->BRR = LIN_SIM_KERNEL_HZ / USART_InitStruct->BaudRate;
+    USARTx->CR1 = (USARTx->CR1 & ~(USART_CR1_TE | USART_CR1_RE)) | USART_InitStruct->TransferDirection;
+    return 0u;
+}
+
+static inline void LL_USART_Enable(USART_TypeDef* USARTx)
+{
+    USARTx->CR1 |= USART_CR1_UE;
+}
+
+static inline void LL_USART_SetLINBrkDetectionLen(USART_TypeDef* USARTx, uint32_t LINBDLength)
+{
+    USARTx->CR2 = (USARTx->CR2 & ~USART_CR2_LBDL) | LINBDLength;
+}
+
+static inline void LL_USART_DisableDMADeactOnRxErr(USART_TypeDef* USARTx)
+{
+    USARTx->CR3 |= USART_CR3_DDRE;
+}
+
+static inline void LL_USART_SetWKUPType(USART_TypeDef* USARTx, uint32_t Type)
+{
+    USARTx->CR3 = (USARTx->CR3 & ~USART_CR3_WUS) | Type;
+}
+
+static inline void LL_USART_ConfigLINMode(USART_TypeDef* USARTx)
+{
+    (void)USARTx;
+}
+
+static inline void LL_USART_EnableLIN(USART_TypeDef* USARTx)
+{
+    USARTx->CR2 |= USART_CR2_LINEN;
+}
+
+static inline uintptr_t LL_USART_DMA_GetRegAddr(USART_TypeDef* USARTx, uint32_t Direction)
+{
+    return (Direction == LL_USART_DMA_REG_DATA_TRANSMIT) ? (uintptr_t)&USARTx->TDR : (uintptr_t)&USARTx->RDR;
+}
+
+static inline void LL_USART_EnableDMAReq_TX(USART_TypeDef* USARTx)
+{
+    USARTx->CR3 |= USART_CR3_DMAT;
+}
+
+static inline void LL_USART_EnableDMAReq_RX(USART_TypeDef* USARTx)
+{
+    USARTx->CR3 |= USART_CR3_DMAR;
+}
+
+static inline void LL_USART_EnableRxTimeout(USART_TypeDef* USARTx)
+{
+    USARTx->CR2 |= USART_CR2_RTOEN;
+}
+
+static inline void LL_USART_SetRxTimeout(USART_TypeDef* USARTx, uint32_t Timeout)
+{
+    USARTx->RTOR = (USARTx->RTOR & ~USART_RTOR_RTO) | (Timeout & USART_RTOR_RTO);
+}
+
+static inline void LL_USART_TransmitData8(USART_TypeDef* USARTx, uint8_t Value)
+{
+    USARTx->TDR = Value;
+    USARTx->ISR &= ~(USART_ISR_TXE | USART_ISR_TC);
+}
+
+static inline void LL_USART_RequestBreakSending(USART_TypeDef* USARTx)
+{
+    USARTx->ISR |= USART_ISR_SBKF;
+}
+
+static inline void LL_USART_RequestRxDataFlush(USART_TypeDef* USARTx)
+{
+    USARTx->ISR &= ~USART_ISR_RXNE;
+}
+
+static inline void LL_USART_EnableInStopMode(USART_TypeDef* USARTx)
+{
+    USARTx->CR1 |= USART_CR1_UESM;
+}
+
+static inline void LL_USART_DisableInStopMode(USART_TypeDef* USARTx)
+{
+    USARTx->CR1 &= ~USART_CR1_UESM;
+}
+
+static inline uint32_t LL_USART_IsActiveFlag_FE(const USART_TypeDef* USARTx)
+{
+    return ((USARTx->ISR & USART_ISR_FE) != 0u) ? 1u : 0u;
+}
+
+static inline uint32_t LL_USART_IsActiveFlag_NE(const USART_TypeDef* USARTx)
+{
+    return ((USARTx->ISR & USART_ISR_NE) != 0u) ? 1u : 0u;
+}
+
+static inline uint32_t LL_USART_IsActiveFlag_ORE(const USART_TypeDef* USARTx)
+{
+    return ((USARTx->ISR & USART_ISR_ORE) != 0u) ? 1u : 0u;
+}
+
+static inline uint32_t LL_USART_IsActiveFlag_TC(const USART_TypeDef* USARTx)
+{
+    return ((USARTx->ISR & USART_ISR_TC) != 0u) ? 1u : 0u;
+}
+
+static inline uint32_t LL_USART_IsActiveFlag_LBD(const USART_TypeDef* USARTx)
+{
+    return ((USARTx->ISR & USART_ISR_LBDF) != 0u) ? 1u : 0u;
+}
+
+static inline uint32_t LL_USART_IsActiveFlag_RTO(const USART_TypeDef* USARTx)
+{
+    return ((USARTx->ISR & USART_ISR_RTOF) != 0u) ? 1u : 0u;
+}
+
+static inline uint32_t LL_USART_IsActiveFlag_WKUP(const USART_TypeDef* USARTx)
+{
+    return ((USARTx->ISR & USART_ISR_WUF) != 0u) ? 1u : 0u;
+}
+
+static inline void LL_USART_ClearFlag_FE(USART_TypeDef* USARTx)
+{
+    USARTx->ISR &= ~USART_ISR_FE;
+}
+
+static inline void LL_USART_ClearFlag_NE(USART_TypeDef* USARTx)
+{
+    USARTx->ISR &= ~USART_ISR_NE;
+}
+
+static inline void LL_USART_ClearFlag_ORE(USART_TypeDef* USARTx)
+{
+    USARTx->ISR &= ~USART_ISR_ORE;
+}
+
+static inline void LL_USART_ClearFlag_LBD(USART_TypeDef* USARTx)
+{
+    USARTx->ISR &= ~USART_ISR_LBDF;
+}
+
+static inline void LL_USART_ClearFlag_RTO(USART_TypeDef* USARTx)
+{
+    USARTx->ISR &= ~USART_ISR_RTOF;
+}
+
+static inline void LL_USART_ClearFlag_WKUP(USART_TypeDef* USARTx)
+{
+    USARTx->ISR &= ~USART_ISR_WUF;
+}
+
+static inline void LL_USART_EnableIT_TC(USART_TypeDef* USARTx)
+{
+    USARTx->CR1 |= USART_CR1_TCIE;
+}
+
+static inline void LL_USART_DisableIT_TC(USART_TypeDef* USARTx)
+{
+    USARTx->CR1 &= ~USART_CR1_TCIE;
+}
+
+static inline void LL_USART_DisableIT_TXE(USART_TypeDef* USARTx)
+{
+    USARTx->CR1 &= ~USART_CR1_TXEIE;
+}
+
+static inline void LL_USART_EnableIT_RTO(USART_TypeDef* USARTx)
+{
+    USARTx->CR1 |= USART_CR1_RTOIE;
+}
+
+static inline void LL_USART_DisableIT_RTO(USART_TypeDef* USARTx)
+{
+    USARTx->CR1 &= ~USART_CR1_RTOIE;
+}
+
+static inline void LL_USART_EnableIT_ERROR(USART_TypeDef* USARTx)
+{
+    USARTx->CR3 |= USART_CR3_EIE;
+}
+
+static inline void LL_USART_DisableIT_ERROR(USART_TypeDef* USARTx)
+{
+    USARTx->CR3 &= ~USART_CR3_EIE;
+}
+
+static inline void LL_USART_EnableIT_LBD(USART_TypeDef* USARTx)
+{
+    USARTx->CR2 |= USART_CR2_LBDIE;
+}
+
+static inline void LL_USART_DisableIT_LBD(USART_TypeDef* USARTx)
+{
+    USARTx->CR2 &= ~USART_CR2_LBDIE;
+}
+
+static inline void LL_USART_EnableIT_WKUP(USART_TypeDef* USARTx)
+{
+    USARTx->CR3 |= USART_CR3_WUFIE;
+}
+
+static inline void LL_USART_DisableIT_WKUP(USART_TypeDef* USARTx)
+{
+    USARTx->CR3 &= ~USART_CR3_WUFIE;
+}
+
+static inline uint32_t LL_USART_IsEnabledIT_WKUP(const USART_TypeDef* USARTx)
+{
+    return ((USARTx->CR3 & USART_CR3_WUFIE) != 0u) ? 1u : 0u;
+}
+
+/* DMA: the LL functions change the channel registers, Lin_Sim_Run() moves the bytes */
+static inline void LL_DMA_ConfigTransfer(DMA_TypeDef* DMAx, uint32_t Channel, uint32_t Configuration)
+{
+    DMAx->Channel[Channel].CCR = (DMAx->Channel[Channel].CCR & (DMA_CCR_EN | DMA_CCR_TCIE)) | Configuration;
+}
+
+static inline void LL_DMA_SetPeriphRequest(DMA_TypeDef* DMAx, uint32_t Channel, uint32_t Request)
+{
+    DMAx->CSELR = (DMAx->CSELR & ~(0xFUL << (4u * Channel))) | (Request << (4u * Channel));
+}
+
+static inline void LL_DMA_SetPeriphAddress(DMA_TypeDef* DMAx, uint32_t Channel, uintptr_t PeriphAddress)
+{
+    DMAx->Channel[Channel].CPAR = PeriphAddress;
+}
+
+static inline void LL_DMA_SetMemoryAddress(DMA_TypeDef* DMAx, uint32_t Channel, uintptr_t MemoryAddress)
+{
+    DMAx->Channel[Channel].CMAR = MemoryAddress;
+}
+
+static inline void LL_DMA_SetDataLength(DMA_TypeDef* DMAx, uint32_t Channel, uint32_t NbData)
+{
+    DMAx->Channel[Channel].CNDTR = NbData;
+}
+
+static inline uint32_t LL_DMA_GetDataLength(const DMA_TypeDef* DMAx, uint32_t Channel)
+{
+    return DMAx->Channel[Channel].CNDTR;
+}
+
+static inline void LL_DMA_EnableChannel(DMA_TypeDef* DMAx, uint32_t Channel)
+{
+    DMAx->Channel[Channel].Next = DMAx->Channel[Channel].CMAR;
+    DMAx->Channel[Channel].CCR |= DMA_CCR_EN;
+}
+
+static inline void LL_DMA_DisableChannel(DMA_TypeDef* DMAx, uint32_t Channel)
+{
+    DMAx->Channel[Channel].CCR &= ~DMA_CCR_EN;
+}
+
+static inline void LL_DMA_EnableIT_TC(DMA_TypeDef* DMAx, uint32_t Channel)
+{
+    DMAx->Channel[Channel].CCR |= DMA_CCR_TCIE;
+}
+
+static inline void LL_DMA_DisableIT_TC(DMA_TypeDef* DMAx, uint32_t Channel)
+{
+    DMAx->Channel[Channel].CCR &= ~DMA_CCR_TCIE;
+}
+
+/* TIM7: the LL functions change the register block, Lin_Sim_Run() counts and raises the update event */
+static inline void LL_TIM_EnableCounter(TIM_TypeDef* TIMx)
+{
+    TIMx->CR1 |= TIM_CR1_CEN;
+}
+
+static inline void LL_TIM_DisableCounter(TIM_TypeDef* TIMx)
+{
+    TIMx->CR1 &= ~TIM_CR1_CEN;
+}
+
+static inline uint32_t LL_TIM_IsEnabledCounter(const TIM_TypeDef* TIMx)
+{
+    return ((TIMx->CR1 & TIM_CR1_CEN) != 0u) ? 1u : 0u;
+}
+
+static inline void LL_TIM_DisableARRPreload(TIM_TypeDef* TIMx)
+{
+    TIMx->CR1 &= ~TIM_CR1_ARPE;
+}
+
+static inline void LL_TIM_SetUpdateSource(TIM_TypeDef* TIMx, uint32_t UpdateSource)
+{
+    TIMx->CR1 = (TIMx->CR1 & ~TIM_CR1_URS) | UpdateSource;
+}
+
+static inline void LL_TIM_SetPrescaler(TIM_TypeDef* TIMx, uint32_t Prescaler)
+{
+    TIMx->PSC = Prescaler;
+}
+
+static inline void LL_TIM_SetAutoReload(TIM_TypeDef* TIMx, uint32_t AutoReload)
+{
+    TIMx->ARR = AutoReload;
+}
+
+static inline void LL_TIM_SetCounter(TIM_TypeDef* TIMx, uint32_t Counter)
+{
+    TIMx->CNT = Counter & TIM_CNT_CNT;
+}
+
+static inline uint32_t LL_TIM_GetCounter(const TIM_TypeDef* TIMx)
+{
+    return TIMx->CNT;
+}
+
+static inline void LL_TIM_GenerateEvent_UPDATE(TIM_TypeDef* TIMx)
+{
+    TIMx->EGR |= TIM_EGR_UG;
+}
+
+static inline void LL_TIM_EnableIT_UPDATE(TIM_TypeDef* TIMx)
+{
+    TIMx->DIER |= TIM_DIER_UIE;
+}
+
+static inline uint32_t LL_TIM_IsActiveFlag_UPDATE(const TIM_TypeDef* TIMx)
+{
+    return ((TIMx->SR & TIM_SR_UIF) != 0u) ? 1u : 0u;
+}
+
+static inline void LL_TIM_ClearFlag_UPDATE(TIM_TypeDef* TIMx)
+{
+    TIMx->SR &= ~TIM_SR_UIF;
+}
+
+#endif /* LIN_SIM_H */
@@ -0,0 +1,245 @@
+/**
+ * @file        LinSch.c
+ * @author      Phuc
+ * @brief       LIN master schedule table engine source file
+ * @version     1.0
+ * @date        2025-01-18
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "LinSch.h"
+#include "LinSch_Cfg.h"
+#if (LINSCH_DIAG_TP == LINSCH_DIAG_TP_ON)
+#include "LinTp.h"
+#endif
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+/* Schedule table running, LINSCH_TABLE_NONE when stopped */
+static volatile uint8 LinSch_Table = LINSCH_TABLE_NONE;
+
+/* Schedule table to start at the next slot boundary, LinSch_Table when there is no request */
+static volatile uint8 LinSch_Request = LINSCH_TABLE_NONE;
+
+/* TRUE when the running table has been requested again, it restarts at the next slot boundary */
+static volatile uint8 LinSch_Restart = FALSE;
+
+/* Slot started at the next slot boundary */
+static uint8 LinSch_Slot;
+
+/* Delay of the slot starts */
+static LinSch_JitterType LinSch_Jitter;
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Records the delay of a slot start in the jitter histogram
+ * @param       DelayUs: Timer ticks from the slot boundary to the header request
+ * @return      void
+ */
+static void LinSch_RecordJitter(uint32 DelayUs)
+{
+    uint32 bucket = DelayUs / LINSCH_JITTER_BUCKET_US;
+
+    if (bucket >= LINSCH_JITTER_BUCKETS)
+    {
+        bucket = LINSCH_JITTER_BUCKETS - 1u;
+    }
+    LinSch_Jitter.Bucket[bucket]++;
+
+    if (DelayUs > LinSch_Jitter.MaxUs)
+    {
+        LinSch_Jitter.MaxUs = DelayUs;
+    }
+    LinSch_Jitter.Count++;
+}
+
+/**
+ * @brief       Starts the next slot at a slot boundary: switches the schedule table if requested, sets the
+ *              length of the slot and sends its header
+ * @param       void
+ * @return      void
+ */
+static void LinSch_SlotStart(void)
+{
+    const LinSch_SlotType *slot;
+    const Lin_PduType *pdu;
+#if (LINSCH_DIAG_TP == LINSCH_DIAG_TP_ON)
+    Lin_PduType diag;
+#endif
+
+    if ((LinSch_Request != LinSch_Table) || (LinSch_Restart == TRUE))
+    {
+        LinSch_Table = LinSch_Request;
+        LinSch_Slot = 0u;
+        LinSch_Restart = FALSE;
+    }
+
+    if (LinSch_Table == LINSCH_TABLE_NONE)
+    {
+        LL_TIM_DisableCounter(LINSCH_TIMER);
+        return;
+    }
+
+    slot = &LinSch_Tables[LinSch_Table].Slots[LinSch_Slot];
+
+    /* ARR is not preloaded, the counter has only just left 0 so the next update comes after this slot */
+    LL_TIM_SetAutoReload(LINSCH_TIMER, (uint32)slot->Delay - 1u);
+
+    pdu = &slot->Pdu;
+#if (LINSCH_DIAG_TP == LINSCH_DIAG_TP_ON)
+    /* The transport layer completes the diagnostic frames, or leaves their slot silent */
+    if ((pdu->Pid == LINTP_MASTER_REQUEST_ID) || (pdu->Pid == LINTP_SLAVE_RESPONSE_ID))
+    {
+        diag = *pdu;
+        pdu = (LinTp_SlotStart(&diag) == TRUE) ? &diag : NULL_PTR;
+    }
+#endif
+
+    if (pdu != NULL_PTR)
+    {
+        if (Lin_SendFrame(LINSCH_CHANNEL, pdu) != E_OK)
+        {
+            LinSch_Jitter.Rejected++;
+        }
+        LinSch_RecordJitter(LL_TIM_GetCounter(LINSCH_TIMER));
+    }
+
+    LinSch_Slot++;
+    if (LinSch_Slot >= LinSch_Tables[LinSch_Table].SlotCount)
+    {
+        LinSch_Slot = 0u;
+    }
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Initializes the slot timer, no schedule table is running afterwards.
+ * @details     The timer counts microseconds in up-counting mode without ARR preload. Every update event is a
+ *              slot boundary, its interrupt sends the header of the slot and loads the slot length into ARR.
+ * @param       void
+ * @retval      void
+ */
+void LinSch_Init(void)
+{
+    LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_TIM7);
+
+    LL_TIM_DisableCounter(LINSCH_TIMER);
+    LL_TIM_SetPrescaler(LINSCH_TIMER, (LINSCH_TIMER_CLOCK_HZ / LINSCH_TICK_HZ) - 1u);
+    LL_TIM_DisableARRPreload(LINSCH_TIMER);
+    LL_TIM_SetUpdateSource(LINSCH_TIMER, LL_TIM_UPDATESOURCE_REGULAR);
+    LL_TIM_SetAutoReload(LINSCH_TIMER, 0xFFFFu);
+    LL_TIM_ClearFlag_UPDATE(LINSCH_TIMER);
+    LL_TIM_EnableIT_UPDATE(LINSCH_TIMER);
+
+    LinSch_Table = LINSCH_TABLE_NONE;
+    LinSch_Request = LINSCH_TABLE_NONE;
+    LinSch_Restart = FALSE;
+    LinSch_Slot = 0u;
+    LinSch_Jitter = (LinSch_JitterType){0};
+
+    NVIC_SetPriority(LINSCH_TIMER_IRQn, LINSCH_IRQ_PRIORITY);
+    NVIC_EnableIRQ(LINSCH_TIMER_IRQn);
+}
+
+/**
+ * @brief       Requests a schedule table. A running table finishes its current slot first, the new table
+ *              starts with its first slot at the slot boundary. A stopped engine starts at once.
+ * @details     Requesting the running table again restarts it at its first slot, also at the slot boundary.
+ *              The request may come from a slot start itself, e.g. the transport layer switching tables.
+ * @param       Table: Index of the schedule table, LINSCH_TABLE_NONE to stop
+ * @retval      Std_ReturnType:
+ *              E_OK: Request accepted
+ *              E_NOT_OK: Unknown schedule table
+ */
+Std_ReturnType LinSch_SetTable(uint8 Table)
+{
+    if ((Table >= LINSCH_TABLE_COUNT) && (Table != LINSCH_TABLE_NONE))
+    {
+        return E_NOT_OK;
+    }
+
+    NVIC_DisableIRQ(LINSCH_TIMER_IRQn);
+
+    LinSch_Request = Table;
+    LinSch_Restart = (Table == LinSch_Table) ? TRUE : FALSE;
+
+    if ((Table != LINSCH_TABLE_NONE) && (LL_TIM_IsEnabledCounter(LINSCH_TIMER) == 0u))
+    {
+        /* The update event of UG is the first slot boundary */
+        LL_TIM_SetCounter(LINSCH_TIMER, 0u);
+        LL_TIM_EnableCounter(LINSCH_TIMER);
+        LL_TIM_GenerateEvent_UPDATE(LINSCH_TIMER);
+    }
+
+    NVIC_EnableIRQ(LINSCH_TIMER_IRQn);
+
+    return E_OK;
+}
+
+/**
+ * @brief       Returns the schedule table currently running.
+ * @param       void
+ * @retval      uint8: Index of the schedule table, LINSCH_TABLE_NONE if the engine is stopped
+ */
+uint8 LinSch_GetTable(void)
+{
+    return LinSch_Table;
+}
+
+/**
+ * @brief       Returns the jitter histogram of the slot starts.
+ * @param       JitterPtr: Pointer to a memory location, where the histogram will be stored.
+ * @retval      Std_ReturnType:
+ *              E_OK: Histogram available.
+ *              E_NOT_OK: Invalid pointer.
+ */
+Std_ReturnType LinSch_GetJitter(LinSch_JitterType* JitterPtr)
+{
+    if (JitterPtr == NULL_PTR)
+    {
+        return E_NOT_OK;
+    }
+
+    NVIC_DisableIRQ(LINSCH_TIMER_IRQn);
+    *JitterPtr = LinSch_Jitter;
+    NVIC_EnableIRQ(LINSCH_TIMER_IRQn);
+
+    return E_OK;
+}
+
+/*
+ ************************************************************************************************************
+ * Interrupt handlers
+ ************************************************************************************************************
+ */
+/**
+ * @brief       TIM7 interrupt, raised by the update event at every slot boundary
+ * @param       void
+ * @return      void
+ */
+void TIM7_IRQHandler(void)
+{
+    if (LL_TIM_IsActiveFlag_UPDATE(LINSCH_TIMER) != 0u)
+    {
+        LL_TIM_ClearFlag_UPDATE(LINSCH_TIMER);
+        LinSch_SlotStart();
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ * @file        LinSch.h
+ * @author      Phuc
+ * @brief       LIN master schedule table engine header file
+ * @version     1.0
+ * @date        2025-01-18
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef LINSCH_H
+#define LINSCH_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Lin.h"
+#if !defined(LIN_HOST_SIM)
+#include "stm32l4xx_ll_tim.h"
+#endif
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define LINSCH_TABLE_NONE           0xFFu   /* No schedule table, the engine stops at the next slot boundary */
+
+#define LINSCH_JITTER_BUCKETS       16u     /* Buckets of the jitter histogram, the last one collects the rest */
+
+/**
+ * @typedef     LinSch_SlotType
+ * @brief       Slot of a schedule table: the frame sent at the start of the slot and the length of the slot
+ */
+typedef struct
+{
+    Lin_PduType Pdu;                        /* Frame of the slot, SduPtr is only used by LIN_FRAMERESPONSE_TX */
+    uint16 Delay;                           /* Slot length in microseconds (1-65535), until the next header */
+} LinSch_SlotType;
+
+/**
+ * @typedef     LinSch_TableType
+ * @brief       Schedule table, its slots are run in order and the table starts again after the last slot
+ */
+typedef struct
+{
+    const LinSch_SlotType *Slots;           /* Slots of the table */
+    uint8 SlotCount;                        /* Number of slots (1-255) */
+} LinSch_TableType;
+
+/**
+ * @typedef     LinSch_JitterType
+ * @brief       Delay from each slot boundary, the timer update event, to the header request in Lin_SendFrame(),
+ *              in microseconds
+ */
+typedef struct
+{
+    uint32 Bucket[LINSCH_JITTER_BUCKETS];   /* Slot starts delayed by n * LINSCH_JITTER_BUCKET_US and more */
+    uint32 MaxUs;                           /* Longest delay */
+    uint32 Count;                           /* Number of slot starts with a header */
+    uint32 Rejected;                        /* Frames not accepted by Lin_SendFrame(), e.g. channel asleep */
+} LinSch_JitterType;
+
+/*
+ ************************************************************************************************************
+ * Functions declaration
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Initializes the slot timer, no schedule table is running afterwards.
+ * @param       void
+ * @retval      void
+ */
+void LinSch_Init(void);
+
+/**
+ * @brief       Requests a schedule table. A running table finishes its current slot first, the new table
+ *              starts with its first slot at the slot boundary. A stopped engine starts at once.
+ * @param       Table: Index of the schedule table, LINSCH_TABLE_NONE to stop
+ * @retval      Std_ReturnType:
+ *              E_OK: Request accepted
+ *              E_NOT_OK: Unknown schedule table
+ */
+Std_ReturnType LinSch_SetTable(uint8 Table);
+
+/**
+ * @brief       Returns the schedule table currently running.
+ * @param       void
+ * @retval      uint8: Index of the schedule table, LINSCH_TABLE_NONE if the engine is stopped
+ */
+uint8 LinSch_GetTable(void);
+
+/**
+ * @brief       Returns the jitter histogram of the slot starts.
+ * @param       JitterPtr: Pointer to a memory location, where the histogram will be stored.
+ * @retval      Std_ReturnType:
+ *              E_OK: Histogram available.
+ *              E_NOT_OK: Invalid pointer.
+ */
+Std_ReturnType LinSch_GetJitter(LinSch_JitterType* JitterPtr);
+
+#endif /* LINSCH_H */
@@ -0,0 +1,117 @@
+/**
+ * @file        LinSch_Cfg.h
+ * @author      Phuc
+ * @brief       Configuration of the LIN master schedule tables
+ * @version     1.0
+ * @date        2025-01-18
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef LINSCH_CFG_H
+#define LINSCH_CFG_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "LinSch.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @brief       LIN channel driven by the schedule tables
+ */
+#define LINSCH_CHANNEL              0u
+
+/**
+ * @brief       Slot timer
+ * @details     TIM7 is a basic timer with nothing else to do. It runs from the APB1 timer clock, SYSCLK 80 MHz
+ *              with APB1 prescaler 1, divided down to a 1 us tick.
+ */
+#define LINSCH_TIMER                TIM7
+#define LINSCH_TIMER_IRQn           TIM7_IRQn
+#define LINSCH_TIMER_CLOCK_HZ       80000000u
+#define LINSCH_TICK_HZ              1000000u
+
+#if defined(LIN_HOST_SIM)
+/* The simulated TIM7 counts CPU cycles */
+typedef char LinSch_SimClockCheck[(LINSCH_TIMER_CLOCK_HZ == LIN_SIM_CPU_HZ) ? 1 : -1];
+#endif
+
+/**
+ * @brief       Priority of the slot timer interrupt
+ * @details     Equal to the USART and DMA interrupts of the LIN driver, never above: Lin_SendFrame() aborts and
+ *              restarts the channel, and a handler it preempted would then complete the new frame. At equal
+ *              priority a slot start waits for a running LIN handler, a few microseconds at most.
+ */
+#define LINSCH_IRQ_PRIORITY         LIN_IRQ_PRIORITY
+
+/**
+ * @brief       Width of a bucket of the jitter histogram in microseconds
+ */
+#define LINSCH_JITTER_BUCKET_US     2u
+
+/**
+ * @brief       Diagnostic frames
+ * @details     With LINSCH_DIAG_TP_ON every master request (0x3C) and slave response (0x3D) slot is handed to
+ *              the LIN transport layer, which fills in the frame or leaves the slot silent when no transfer
+ *              needs it. With LINSCH_DIAG_TP_OFF they are sent like the other frames.
+ */
+#define LINSCH_DIAG_TP_OFF          0u
+#define LINSCH_DIAG_TP_ON           1u
+#define LINSCH_DIAG_TP              LINSCH_DIAG_TP_ON
+
+/**
+ * @brief       Responses of the master frames, written by the application between two slots of the frame
+ */
+uint8 LinSch_DoorCommand[4];
+uint8 LinSch_ClimateCommand[2];
+
+/**
+ * @brief       Normal schedule: door and climate commands with the status of both slaves, 40 ms cycle
+ */
+static const LinSch_SlotType LinSch_NormalSlots[] =
+{
+    {{0x10u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_TX, 4u, LinSch_DoorCommand},    10000u},
+    {{0x30u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, 4u, NULL_PTR},              10000u},
+    {{0x20u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_TX, 2u, LinSch_ClimateCommand}, 10000u},
+    {{0x31u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, 2u, NULL_PTR},              10000u}
+};
+
+/**
+ * @brief       Diagnostic schedules of the transport layer: back-to-back master requests while a request is
+ *              sent, then back-to-back slave responses until the response is complete. 10 ms covers the
+ *              longest 8-byte frame at 19200 baud, 9.04 ms.
+ */
+static const LinSch_SlotType LinSch_DiagRequestSlots[] =
+{
+    {{0x3Cu, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_TX, 8u, NULL_PTR},              10000u}
+};
+
+static const LinSch_SlotType LinSch_DiagResponseSlots[] =
+{
+    {{0x3Du, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, 8u, NULL_PTR},              10000u}
+};
+
+/**
+ * @brief       Schedule tables, selected by their index with LinSch_SetTable()
+ */
+#define LINSCH_TABLE_NORMAL         0u
+#define LINSCH_TABLE_DIAG_REQUEST   1u
+#define LINSCH_TABLE_DIAG_RESPONSE  2u
+#define LINSCH_TABLE_COUNT          3u
+
+const LinSch_TableType LinSch_Tables[LINSCH_TABLE_COUNT] =
+{
+    {LinSch_NormalSlots,       (uint8)(sizeof(LinSch_NormalSlots) / sizeof(LinSch_NormalSlots[0]))},
+    {LinSch_DiagRequestSlots,  (uint8)(sizeof(LinSch_DiagRequestSlots) / sizeof(LinSch_DiagRequestSlots[0]))},
+    {LinSch_DiagResponseSlots, (uint8)(sizeof(LinSch_DiagResponseSlots) / sizeof(LinSch_DiagResponseSlots[0]))}
+};
+
+#endif /* LINSCH_CFG_H */
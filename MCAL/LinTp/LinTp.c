@@ -0,0 +1,474 @@
+/**
+ * @file        LinTp.c
+ * @author      Phuc
+ * @brief       LIN transport layer (ISO 17987-2) source file
+ * @version     1.0
+ * @date        2025-01-24
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "LinTp.h"
+#include "LinTp_Cfg.h"
+#include "LinSch.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define LINTP_FRAME_LENGTH          8u      /* Every diagnostic frame carries 8 bytes: NAD, PCI, data, fill */
+#define LINTP_FILL                  0xFFu   /* Unused bytes of a frame */
+
+#define LINTP_PCI_TYPE_MASK         0xF0u
+#define LINTP_PCI_SF                0x00u   /* Single frame, the low nibble is the length */
+#define LINTP_PCI_FF                0x10u   /* First frame, the low nibble is bits 11..8 of the length */
+#define LINTP_PCI_CF                0x20u   /* Consecutive frame, the low nibble is the sequence number */
+
+#define LINTP_SF_DATA_MAX           6u      /* Data bytes of a single frame */
+#define LINTP_FF_DATA               5u      /* Data bytes of a first frame */
+#define LINTP_CF_DATA               6u      /* Data bytes of a consecutive frame */
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+/* State of the transfer, written last by LinTp_Request() so that the slot starts see a complete transfer */
+static volatile LinTp_StatusType LinTp_Status = LINTP_IDLE;
+
+/* Node address of the transfer */
+static uint8 LinTp_Nad;
+
+/* Request, read in place */
+static const uint8 *LinTp_TxData;
+static uint16 LinTp_TxLength;
+static uint16 LinTp_TxOffset;               /* Bytes sent and confirmed */
+static uint8 LinTp_TxPending;               /* Bytes in the frame of the previous slot */
+static uint8 LinTp_TxSn;                    /* Sequence number of the next CF */
+
+/* Response, written in place */
+static uint8 *LinTp_RxData;
+static uint16 LinTp_RxSize;
+static uint16 LinTp_RxLength;               /* Announced by the SF or FF, 0 before */
+static uint16 LinTp_RxOffset;               /* Bytes received */
+static uint8 LinTp_RxSn;                    /* Sequence number of the next CF */
+static uint16 LinTp_RxWait;                 /* Slave response slots since the last response frame */
+
+/* Frame identifier sent by the transport layer in the previous slot, 0 when the slot was silent */
+static uint8 LinTp_InFlight;
+
+/* Master request frame, copied by Lin_SendFrame() */
+static uint8 LinTp_Frame[LINTP_FRAME_LENGTH];
+
+/* Start of the current half of the transfer and the throughput of the last transfer */
+static uint32 LinTp_Start;
+static LinTp_ThroughputType LinTp_Throughput;
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Converts a payload and its duration into bytes per second
+ * @param       Bytes: Payload
+ * @param       Cycles: Duration in CPU cycles
+ * @return      uint32: Throughput, 0 for a zero duration
+ */
+static uint32 LinTp_BytesPerSecond(uint32 Bytes, uint32 Cycles)
+{
+    if (Cycles == 0u)
+    {
+        return 0u;
+    }
+
+    return (uint32)(((uint64)Bytes * LINTP_CPU_CLOCK_HZ) / Cycles);
+}
+
+/**
+ * @brief       Ends the transfer and returns the schedule to the idle table
+ * @param       Status: Final state of the transfer
+ * @return      void
+ */
+static void LinTp_Finish(LinTp_StatusType Status)
+{
+    if ((Status == LINTP_OK) && (LinTp_RxData != NULL_PTR))
+    {
+        LinTp_Throughput.ResponseBytes = LinTp_RxLength;
+        LinTp_Throughput.ResponseCycles = (uint32)DWT->CYCCNT - LinTp_Start;
+        LinTp_Throughput.ResponseBytesPerSecond = LinTp_BytesPerSecond(LinTp_Throughput.ResponseBytes,
+                                                                       LinTp_Throughput.ResponseCycles);
+    }
+
+    LinTp_Status = Status;
+    (void)LinSch_SetTable(LINTP_TABLE_IDLE);
+}
+
+/**
+ * @brief       Builds the next request frame from the caller buffer: SF for a short request, FF then CFs
+ *              for a longer one. The unused bytes are filled with 0xFF.
+ * @param       void
+ * @return      void
+ */
+static void LinTp_BuildRequest(void)
+{
+    uint16 remaining = LinTp_TxLength - LinTp_TxOffset;
+    uint8 *data;
+    uint8 count;
+    uint8 i;
+
+    LinTp_Frame[0] = LinTp_Nad;
+
+    if (LinTp_TxLength <= LINTP_SF_DATA_MAX)
+    {
+        LinTp_Frame[1] = LINTP_PCI_SF | (uint8)LinTp_TxLength;
+        data = &LinTp_Frame[2];
+        count = (uint8)LinTp_TxLength;
+    }
+    else if (LinTp_TxOffset == 0u)
+    {
+        LinTp_Frame[1] = LINTP_PCI_FF | (uint8)(LinTp_TxLength >> 8);
+        LinTp_Frame[2] = (uint8)LinTp_TxLength;
+        data = &LinTp_Frame[3];
+        count = LINTP_FF_DATA;
+    }
+    else
+    {
+        LinTp_Frame[1] = LINTP_PCI_CF | LinTp_TxSn;
+        data = &LinTp_Frame[2];
+        count = (remaining < LINTP_CF_DATA) ? (uint8)remaining : LINTP_CF_DATA;
+    }
+
+    for (i = 0u; i < count; i++)
+    {
+        data[i] = LinTp_TxData[LinTp_TxOffset + i];
+    }
+    for (i = (uint8)(data - LinTp_Frame) + count; i < LINTP_FRAME_LENGTH; i++)
+    {
+        LinTp_Frame[i] = LINTP_FILL;
+    }
+
+    LinTp_TxPending = count;
+}
+
+/**
+ * @brief       Takes a confirmed request frame into account. After the last frame the transfer goes on with
+ *              the response, or ends for a request without response.
+ * @param       void
+ * @return      void
+ */
+static void LinTp_ConfirmRequest(void)
+{
+    /* The FF or SF is followed by CF 1, then the sequence number wraps from 15 to 0 */
+    LinTp_TxSn = (LinTp_TxOffset == 0u) ? 1u : (uint8)((LinTp_TxSn + 1u) & 0x0Fu);
+    LinTp_TxOffset += LinTp_TxPending;
+
+    if (LinTp_TxOffset < LinTp_TxLength)
+    {
+        return;
+    }
+
+    LinTp_Throughput.RequestBytes = LinTp_TxLength;
+    LinTp_Throughput.RequestCycles = (uint32)DWT->CYCCNT - LinTp_Start;
+    LinTp_Throughput.RequestBytesPerSecond = LinTp_BytesPerSecond(LinTp_Throughput.RequestBytes,
+                                                                  LinTp_Throughput.RequestCycles);
+
+    if (LinTp_RxData == NULL_PTR)
+    {
+        LinTp_Finish(LINTP_OK);
+        return;
+    }
+
+    LinTp_Start = (uint32)DWT->CYCCNT;
+    LinTp_Status = LINTP_RX_BUSY;
+}
+
+/**
+ * @brief       Takes a received response frame apart and writes its data straight from the driver buffer into
+ *              the caller buffer
+ * @param       Sdu: Response of the slave response frame
+ * @return      void
+ */
+static void LinTp_ReceiveResponse(const uint8 *Sdu)
+{
+    const uint8 *data;
+    uint16 count;
+    uint16 i;
+
+    if ((LinTp_Nad != LINTP_NAD_BROADCAST) && (Sdu[0] != LinTp_Nad))
+    {
+        LinTp_Finish(LINTP_E_RX);
+        return;
+    }
+
+    switch (Sdu[1] & LINTP_PCI_TYPE_MASK)
+    {
+        case LINTP_PCI_SF:
+            count = Sdu[1] & 0x0Fu;
+            if ((LinTp_RxLength != 0u) || (count == 0u) || (count > LINTP_SF_DATA_MAX))
+            {
+                LinTp_Finish(LINTP_E_RX);
+                return;
+            }
+            LinTp_RxLength = count;
+            data = &Sdu[2];
+            break;
+
+        case LINTP_PCI_FF:
+            LinTp_RxLength = (uint16)(((uint16)(Sdu[1] & 0x0Fu) << 8) | Sdu[2]);
+            if ((LinTp_RxOffset != 0u) || (LinTp_RxLength <= LINTP_SF_DATA_MAX))
+            {
+                LinTp_Finish(LINTP_E_RX);
+                return;
+            }
+            LinTp_RxSn = 1u;
+            data = &Sdu[3];
+            count = LINTP_FF_DATA;
+            break;
+
+        case LINTP_PCI_CF:
+            if ((LinTp_RxLength <= LINTP_SF_DATA_MAX) || ((Sdu[1] & 0x0Fu) != LinTp_RxSn))
+            {
+                LinTp_Finish(LINTP_E_RX);
+                return;
+            }
+            LinTp_RxSn = (uint8)((LinTp_RxSn + 1u) & 0x0Fu);
+            data = &Sdu[2];
+            count = LinTp_RxLength - LinTp_RxOffset;
+            if (count > LINTP_CF_DATA)
+            {
+                count = LINTP_CF_DATA;
+            }
+            break;
+
+        default:
+            LinTp_Finish(LINTP_E_RX);
+            return;
+    }
+
+    if (LinTp_RxLength > LinTp_RxSize)
+    {
+        LinTp_Finish(LINTP_E_OVERFLOW);
+        return;
+    }
+
+    for (i = 0u; i < count; i++)
+    {
+        LinTp_RxData[LinTp_RxOffset + i] = data[i];
+    }
+    LinTp_RxOffset += count;
+    LinTp_RxWait = 0u;
+
+    if (LinTp_RxOffset == LinTp_RxLength)
+    {
+        LinTp_Finish(LINTP_OK);
+    }
+}
+
+/**
+ * @brief       Collects the result of the frame sent by the transport layer in the previous slot. The slot is
+ *              as long as the frame, so the driver has finished it by the start of the next slot.
+ * @param       void
+ * @return      void
+ */
+static void LinTp_CheckPrevious(void)
+{
+    const uint8 *sdu;
+    Lin_StatusType status;
+
+    if (LinTp_InFlight == 0u)
+    {
+        return;
+    }
+
+    status = Lin_GetStatus(LINTP_CHANNEL, &sdu);
+
+    if (LinTp_InFlight == LINTP_MASTER_REQUEST_ID)
+    {
+        if (status == LIN_TX_OK)
+        {
+            LinTp_ConfirmRequest();
+        }
+        else
+        {
+            LinTp_Finish(LINTP_E_TX);
+        }
+    }
+    else if (status == LIN_RX_OK)
+    {
+        LinTp_ReceiveResponse(sdu);
+    }
+    else if (status != LIN_RX_NO_RESPONSE)
+    {
+        LinTp_Finish(LINTP_E_RX);
+    }
+    else
+    {
+        /* Slave not ready yet, asked again in the next slave response slot until the timeout */
+    }
+
+    LinTp_InFlight = 0u;
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets the transport layer, no transfer is running afterwards.
+ * @param       void
+ * @retval      void
+ */
+void LinTp_Init(void)
+{
+    LinTp_Status = LINTP_IDLE;
+    LinTp_InFlight = 0u;
+    LinTp_TxData = NULL_PTR;
+    LinTp_RxData = NULL_PTR;
+    LinTp_Throughput = (LinTp_ThroughputType){0};
+}
+
+/**
+ * @brief       Starts a transfer: sends a request to a slave node, then collects its response.
+ * @details     The request table is started at the next slot boundary. Both messages stay in the caller
+ *              buffers: each request frame is built from the request, each response frame is copied from the
+ *              driver into the response buffer. The buffers must stay valid until the transfer has ended.
+ * @param       Nad: Node address of the slave, LINTP_NAD_FUNCTIONAL for a request without response
+ * @param       Request: Request message, read in place until the request has been sent
+ * @param       RequestLength: Length of the request (1-4095)
+ * @param       Response: Buffer the response is written to, NULL_PTR for a request without response
+ * @param       ResponseSize: Size of the response buffer
+ * @retval      Std_ReturnType:
+ *              E_OK: Transfer started
+ *              E_NOT_OK: Invalid parameter or a transfer is running
+ */
+Std_ReturnType LinTp_Request(uint8 Nad, const uint8* Request, uint16 RequestLength,
+                             uint8* Response, uint16 ResponseSize)
+{
+    if ((Request == NULL_PTR) || (RequestLength == 0u) || (RequestLength > LINTP_LENGTH_MAX) ||
+        ((Nad == LINTP_NAD_FUNCTIONAL) && (Response != NULL_PTR)))
+    {
+        return E_NOT_OK;
+    }
+
+    if ((LinTp_Status == LINTP_TX_BUSY) || (LinTp_Status == LINTP_RX_BUSY))
+    {
+        return E_NOT_OK;
+    }
+
+    LinTp_Nad = Nad;
+    LinTp_TxData = Request;
+    LinTp_TxLength = RequestLength;
+    LinTp_TxOffset = 0u;
+    LinTp_TxSn = 0u;
+    LinTp_RxData = Response;
+    LinTp_RxSize = ResponseSize;
+    LinTp_RxLength = 0u;
+    LinTp_RxOffset = 0u;
+    LinTp_RxWait = 0u;
+    LinTp_InFlight = 0u;
+    LinTp_Throughput = (LinTp_ThroughputType){0};
+    LinTp_Start = (uint32)DWT->CYCCNT;
+
+    LinTp_Status = LINTP_TX_BUSY;
+
+    return LinSch_SetTable(LINTP_TABLE_REQUEST);
+}
+
+/**
+ * @brief       Returns the state of the last transfer.
+ * @param       ResponseLength: Pointer to a memory location, where the response length will be stored on
+ *              LINTP_OK. May be NULL_PTR.
+ * @retval      LinTp_StatusType: State of the transfer
+ */
+LinTp_StatusType LinTp_GetStatus(uint16* ResponseLength)
+{
+    LinTp_StatusType status = LinTp_Status;
+
+    if ((status == LINTP_OK) && (ResponseLength != NULL_PTR))
+    {
+        *ResponseLength = LinTp_RxLength;
+    }
+
+    return status;
+}
+
+/**
+ * @brief       Returns the throughput of the last transfer.
+ * @param       ThroughputPtr: Pointer to a memory location, where the throughput will be stored.
+ * @retval      Std_ReturnType:
+ *              E_OK: Throughput available.
+ *              E_NOT_OK: Invalid pointer.
+ */
+Std_ReturnType LinTp_GetThroughput(LinTp_ThroughputType* ThroughputPtr)
+{
+    if (ThroughputPtr == NULL_PTR)
+    {
+        return E_NOT_OK;
+    }
+
+    *ThroughputPtr = LinTp_Throughput;
+
+    return E_OK;
+}
+
+/**
+ * @brief       Fills a master request or slave response slot of the schedule table. Called by the schedule
+ *              table engine at the start of the slot, before the header is sent.
+ * @details     The result of the frame of the previous slot is collected first, so the next request frame is
+ *              only built once the previous one has been confirmed and the transfer moves on slot by slot.
+ *              The last request frame already requests the response table, which then starts right after it.
+ * @param       Pdu: Copy of the frame of the slot, completed with the next request frame
+ * @retval      uint8:
+ *              TRUE: Send the frame
+ *              FALSE: Leave the slot silent
+ */
+uint8 LinTp_SlotStart(Lin_PduType* Pdu)
+{
+    LinTp_CheckPrevious();
+
+    if ((Pdu->Pid == LINTP_MASTER_REQUEST_ID) && (LinTp_Status == LINTP_TX_BUSY))
+    {
+        LinTp_BuildRequest();
+
+        /* Without response the request table runs one more slot, which confirms the last frame */
+        if (((LinTp_TxOffset + LinTp_TxPending) == LinTp_TxLength) && (LinTp_RxData != NULL_PTR))
+        {
+            (void)LinSch_SetTable(LINTP_TABLE_RESPONSE);
+        }
+
+        Pdu->Cs = LIN_CLASSIC_CS;
+        Pdu->Drc = LIN_FRAMERESPONSE_TX;
+        Pdu->Dl = LINTP_FRAME_LENGTH;
+        Pdu->SduPtr = LinTp_Frame;
+    }
+    else if ((Pdu->Pid == LINTP_SLAVE_RESPONSE_ID) && (LinTp_Status == LINTP_RX_BUSY))
+    {
+        LinTp_RxWait++;
+        if (LinTp_RxWait > LINTP_RESPONSE_TIMEOUT_SLOTS)
+        {
+            LinTp_Finish(LINTP_E_TIMEOUT);
+            return FALSE;
+        }
+
+        Pdu->Cs = LIN_CLASSIC_CS;
+        Pdu->Drc = LIN_FRAMERESPONSE_RX;
+        Pdu->Dl = LINTP_FRAME_LENGTH;
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    LinTp_InFlight = Pdu->Pid;
+
+    return TRUE;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file        LinTp.h
+ * @author      Phuc
+ * @brief       LIN transport layer (ISO 17987-2) header file
+ * @version     1.0
+ * @date        2025-01-24
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef LINTP_H
+#define LINTP_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Lin.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define LINTP_MASTER_REQUEST_ID     0x3Cu   /* Frame identifier of the master request frame (MRF) */
+#define LINTP_SLAVE_RESPONSE_ID     0x3Du   /* Frame identifier of the slave response frame (SRF) */
+
+#define LINTP_NAD_FUNCTIONAL        0x7Eu   /* Functional request, the slaves do not respond */
+#define LINTP_NAD_BROADCAST         0x7Fu   /* Request to any slave, the response may come from any NAD */
+
+#define LINTP_LENGTH_MAX            4095u   /* Longest message, the FF carries a 12-bit length */
+
+/**
+ * @typedef     LinTp_StatusType
+ * @brief       State of the last transfer started by LinTp_Request()
+ */
+typedef enum
+{
+    LINTP_IDLE = 0,                         /* No transfer since LinTp_Init() */
+    LINTP_TX_BUSY,                          /* Request being sent in the master request slots */
+    LINTP_RX_BUSY,                          /* Waiting for or receiving the response in the slave response slots */
+    LINTP_OK,                               /* Transfer complete, the response is in the caller buffer */
+    LINTP_E_TX,                             /* A request frame was not sent */
+    LINTP_E_RX,                             /* A response frame was corrupted, from another NAD or out of sequence */
+    LINTP_E_OVERFLOW,                       /* The response is longer than the caller buffer */
+    LINTP_E_TIMEOUT                         /* No response frame within LINTP_RESPONSE_TIMEOUT_SLOTS slots */
+} LinTp_StatusType;
+
+/**
+ * @typedef     LinTp_ThroughputType
+ * @brief       Payload and duration of both halves of the last transfer, in CPU cycles counted by DWT CYCCNT.
+ *              The request runs from LinTp_Request() to the confirmation of its last frame, the response from
+ *              there to the reception of its last frame.
+ */
+typedef struct
+{
+    uint32 RequestBytes;                    /* Length of the request */
+    uint32 RequestCycles;                   /* Duration of the request */
+    uint32 RequestBytesPerSecond;           /* Request throughput */
+    uint32 ResponseBytes;                   /* Length of the response */
+    uint32 ResponseCycles;                  /* Duration of the response */
+    uint32 ResponseBytesPerSecond;          /* Response throughput */
+} LinTp_ThroughputType;
+
+/*
+ ************************************************************************************************************
+ * Functions declaration
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets the transport layer, no transfer is running afterwards.
+ * @param       void
+ * @retval      void
+ */
+void LinTp_Init(void);
+
+/**
+ * @brief       Starts a transfer: sends a request to a slave node, then collects its response.
+ * @param       Nad: Node address of the slave, LINTP_NAD_FUNCTIONAL for a request without response
+ * @param       Request: Request message, read in place until the request has been sent
+ * @param       RequestLength: Length of the request (1-4095)
+ * @param       Response: Buffer the response is written to, NULL_PTR for a request without response
+ * @param       ResponseSize: Size of the response buffer
+ * @retval      Std_ReturnType:
+ *              E_OK: Transfer started
+ *              E_NOT_OK: Invalid parameter or a transfer is running
+ */
+Std_ReturnType LinTp_Request(uint8 Nad, const uint8* Request, uint16 RequestLength,
+                             uint8* Response, uint16 ResponseSize);
+
+/**
+ * @brief       Returns the state of the last transfer.
+ * @param       ResponseLength: Pointer to a memory location, where the response length will be stored on
+ *              LINTP_OK. May be NULL_PTR.
+ * @retval      LinTp_StatusType: State of the transfer
+ */
+LinTp_StatusType LinTp_GetStatus(uint16* ResponseLength);
+
+/**
+ * @brief       Returns the throughput of the last transfer.
+ * @param       ThroughputPtr: Pointer to a memory location, where the throughput will be stored.
+ * @retval      Std_ReturnType:
+ *              E_OK: Throughput available.
+ *              E_NOT_OK: Invalid pointer.
+ */
+Std_ReturnType LinTp_GetThroughput(LinTp_ThroughputType* ThroughputPtr);
+
+/**
+ * @brief       Fills a master request or slave response slot of the schedule table. Called by the schedule
+ *              table engine at the start of the slot, before the header is sent.
+ * @param       Pdu: Copy of the frame of the slot, completed with the next request frame
+ * @retval      uint8:
+ *              TRUE: Send the frame
+ *              FALSE: Leave the slot silent
+ */
+uint8 LinTp_SlotStart(Lin_PduType* Pdu);
+
+#endif /* LINTP_H */
@@ -0,0 +1,53 @@
+/**
+ * @file        LinTp_Cfg.h
+ * @author      Phuc
+ * @brief       Configuration of the LIN transport layer
+ * @version     1.0
+ * @date        2025-01-24
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef LINTP_CFG_H
+#define LINTP_CFG_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "LinTp.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @brief       LIN channel of the diagnostic frames, LINSCH_CHANNEL in LinSch_Cfg.h
+ */
+#define LINTP_CHANNEL               0u
+
+/**
+ * @brief       Schedule tables run during a transfer, indices of LinSch_Tables in LinSch_Cfg.h
+ * @details     The request table only holds master request slots and the response table only slave response
+ *              slots, so the frames of a segmented message follow each other in back-to-back slots. The idle
+ *              table is requested again when the transfer ends.
+ */
+#define LINTP_TABLE_IDLE            0u      /* LINSCH_TABLE_NORMAL */
+#define LINTP_TABLE_REQUEST         1u      /* LINSCH_TABLE_DIAG_REQUEST */
+#define LINTP_TABLE_RESPONSE        2u      /* LINSCH_TABLE_DIAG_RESPONSE */
+
+/**
+ * @brief       Slave response slots without response before the transfer is given up
+ * @details     100 slots of 10 ms, the 1000 ms of N_Cr and P2*.
+ */
+#define LINTP_RESPONSE_TIMEOUT_SLOTS    100u
+
+/**
+ * @brief       Frequency of DWT CYCCNT, SYSCLK 80 MHz
+ */
+#define LINTP_CPU_CLOCK_HZ          80000000u
+
+#endif /* LINTP_CFG_H */
@@ -85,8 +85,8 @@ typedef signed char         sint8;
 typedef unsigned char       uint8;
 typedef signed short        sint16;
 typedef unsigned short      uint16;
-typedef signed long         sint32;
-typedef unsigned long       uint32;
+typedef int32_t             sint32;
+typedef uint32_t            uint32;
 typedef signed long long    sint64;
 typedef unsigned long long  uint64;
 
@@ -0,0 +1,598 @@
+/**
+ * @file        Can_Bench.c
+ * @author      Phuc
+ * @brief       Benchmarks of the CAN driver on the simulated bus
+ * @version     1.0
+ * @date        2025-01-28
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include <math.h>
+#include <stdlib.h>
+#include "Test.h"
+#include "Can_TestBus.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define CAN_BENCH_SECOND            ((uint64)CAN_TESTBUS_CPU_HZ)    /* Simulated second, in CPU cycles */
+#define CAN_BENCH_TOPUP_CYCLES      8000u   /* Period of the sender task of the throughput runs, 100 us */
+#define CAN_BENCH_LATENCY_FRAMES    100u    /* Frames of the latency runs */
+#define CAN_BENCH_RX_ID             0x100u  /* First CAN ID of the receive dispatch table (0x100-0x107) */
+#define CAN_BENCH_TX_ID             0x400u  /* First CAN ID of the throughput runs, not received by any node */
+#define CAN_BENCH_TX_IDS            0x400u  /* Distinct CAN IDs of the throughput runs, none is ever replaced */
+#define CAN_BENCH_STABLE_TICKS      100u    /* CAN_BUSOFF_STABLE of Can_Cfg.h */
+#define CAN_BENCH_UNLIMITED         0xFFu   /* Mailbox limit of a run that uses the transmit queue as well */
+#define CAN_BENCH_QUEUE_SIZE        16u     /* CAN_TX_QUEUE_SIZE of Can_Cfg.h */
+#define CAN_BENCH_QUEUE_ROUNDS      4000u   /* Fill and drain rounds of a pass of the queue cost run */
+#define CAN_BENCH_PASSES            5u      /* Passes of the host cost runs, the fastest is kept */
+#define CAN_BENCH_FRAME_CYCLES      18800u  /* Mean length of the 8-byte frames on the bus, 4255 frames/s */
+#define CAN_BENCH_POLL_CYCLES       1600u   /* Longest step of the latency runs between two egress polls, 10 bits */
+#define CAN_BENCH_SAMPLES_MAX       16384u  /* Latencies kept by a load run */
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+static uint8 Can_Bench_Sdu[8];
+static uint32 Can_Bench_Random = 1u;
+static uint64 Can_Bench_Samples[CAN_BENCH_SAMPLES_MAX];
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Converts CPU cycles into microseconds
+ * @param       Cycles: CPU cycles
+ * @return      Microseconds
+ */
+static double Can_Bench_Us(uint64 Cycles)
+{
+    return ((double)Cycles * 1000000.0) / (double)CAN_TESTBUS_CPU_HZ;
+}
+
+/**
+ * @brief       Fills the transmit queue of a controller until Can_Write() reports CAN_BUSY
+ * @param       Controller: HTH of the sender
+ * @param       Length: Data length of the frames
+ * @param       Sequence: Sequence number of the next frame, advanced for every frame accepted
+ * @return      void
+ */
+static void Can_Bench_TopUp(uint8 Controller, uint8 Length, uint32* Sequence)
+{
+    Can_PduType pdu;
+
+    pdu.sdu = Can_Bench_Sdu;
+    for (;;)
+    {
+        Can_TestBus_Frame(&pdu, CAN_BENCH_TX_ID + (*Sequence % CAN_BENCH_TX_IDS), (PduIdType)*Sequence,
+                          (Length < 4u) ? 4u : Length, *Sequence);
+        pdu.length = Length;
+        if (Can_Write(Controller, &pdu) != E_OK)
+        {
+            break;
+        }
+        (*Sequence)++;
+    }
+}
+
+/**
+ * @brief       Saturated bus: the senders keep their transmit queue full for one simulated second, the other
+ *              started node only acknowledges. Reports the frame rate and the bus load seen by the simulator
+ *              and by Can_GetBusLoad().
+ * @param       Senders: Number of sending controllers, contending for the bus
+ * @param       Length: Data length of the frames
+ * @return      void
+ */
+static void Can_Bench_Throughput(uint8 Senders, uint8 Length)
+{
+    static const Can_ConfigType config = CAN_TESTBUS_CONFIG_500K;
+    Can_SimBusStatsType before;
+    Can_SimBusStatsType after;
+    Can_StatisticsType stats;
+    uint32 sequence[CAN_SIM_NODE_MAX] = {0u};
+    uint64 end;
+    uint16 load = 0u;
+    uint32 sent = 0u;
+    uint8 controller;
+
+    /* Node 0 .. Senders-1 send, node Senders acknowledges */
+    (void)Can_TestBus_Init(&config, (uint8)(Senders + 1u));
+    Can_Sim_GetBusStats(&before);
+    (void)Can_GetBusLoad(0u, &load);
+
+    end = Can_Sim_GetTime() + CAN_BENCH_SECOND;
+    while (Can_Sim_GetTime() < end)
+    {
+        for (controller = 0u; controller < Senders; controller++)
+        {
+            Can_Bench_TopUp(controller, Length, &sequence[controller]);
+        }
+        Can_TestBus_Run(CAN_BENCH_TOPUP_CYCLES);
+    }
+
+    Can_Sim_GetBusStats(&after);
+    (void)Can_GetBusLoad(0u, &load);
+    for (controller = 0u; controller < Senders; controller++)
+    {
+        (void)Can_GetStatistics(controller, &stats);
+        sent += stats.TxFrames;
+    }
+
+    printf("  %u sender(s), %u bytes: %6lu frames/s, bus busy %5.1f %%, node 0 Can_GetBusLoad %5.1f %%, "
+           "%lu arbitrations, %lu errors\n",
+           (unsigned)Senders, (unsigned)Length, (unsigned long)(after.Frames - before.Frames),
+           (100.0 * (double)(after.BusyCycles - before.BusyCycles)) / (double)CAN_BENCH_SECOND,
+           (double)load / 10.0, (unsigned long)(after.Arbitrations - before.Arbitrations),
+           (unsigned long)(after.ErrorFrames - before.ErrorFrames));
+    (void)sent;
+}
+
+/**
+ * @brief       Counts the transmit mailboxes of a controller that hold a pending request
+ * @param       Controller: CAN controller index
+ * @return      Number of pending mailboxes (0-3)
+ */
+static uint8 Can_Bench_PendingMailboxes(uint8 Controller)
+{
+    uint32 tme = Can_Sim_GetRegs(Controller)->TSR & CAN_TSR_TME;
+
+    return (uint8)(3u - (((tme >> 26u) & 1u) + ((tme >> 27u) & 1u) + ((tme >> 28u) & 1u)));
+}
+
+/**
+ * @brief       Bursty sender: a 1 ms task writes a burst of frames for one simulated second. A write is
+ *              refused once Limit mailboxes are pending, as the driver did when it only used mailbox 0 (Limit 1)
+ *              and before the transmit queue (Limit 3).
+ * @param       Burst: Frames of 8 bytes written by each run of the task
+ * @param       Limit: Pending mailboxes at which writes are refused, CAN_BENCH_UNLIMITED to use the queue
+ * @return      void
+ */
+static void Can_Bench_Mailboxes(uint8 Burst, uint8 Limit)
+{
+    static const Can_ConfigType config = CAN_TESTBUS_CONFIG_500K;
+    Can_StatisticsType stats;
+    Can_PduType pdu;
+    uint32 sequence = 0u;
+    uint32 refused = 0u;
+    uint64 end;
+    uint8 i;
+
+    (void)Can_TestBus_Init(&config, 2u);
+    pdu.sdu = Can_Bench_Sdu;
+
+    end = Can_Sim_GetTime() + CAN_BENCH_SECOND;
+    while (Can_Sim_GetTime() < end)
+    {
+        for (i = 0u; i < Burst; i++)
+        {
+            Can_TestBus_Frame(&pdu, CAN_BENCH_TX_ID + (sequence % CAN_BENCH_TX_IDS), (PduIdType)sequence, 8u, sequence);
+            if (((Limit != CAN_BENCH_UNLIMITED) && (Can_Bench_PendingMailboxes(0u) >= Limit)) ||
+                (Can_Write(0u, &pdu) != E_OK))
+            {
+                refused++;
+            }
+            else
+            {
+                sequence++;
+            }
+        }
+        Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+    }
+
+    (void)Can_GetStatistics(0u, &stats);
+    if (Limit == CAN_BENCH_UNLIMITED)
+    {
+        printf("  burst of %u, 3 mailboxes + queue: ", (unsigned)Burst);
+    }
+    else
+    {
+        printf("  burst of %u, %u mailbox(es):       ", (unsigned)Burst, (unsigned)Limit);
+    }
+    printf("%5lu frames/s sent, %5lu frames/s refused\n", (unsigned long)stats.TxFrames, (unsigned long)refused);
+}
+
+/**
+ * @brief       Returns a pseudo random number, the same sequence on every run
+ * @param       void
+ * @return      31-bit random number
+ */
+static uint32 Can_Bench_Rand(void)
+{
+    Can_Bench_Random = (Can_Bench_Random * 1103515245u) + 12345u;
+    return (Can_Bench_Random >> 1u) & 0x7FFFFFFFu;
+}
+
+/**
+ * @brief       Sorts latencies for qsort()
+ * @param       A: First latency
+ * @param       B: Second latency
+ * @return      Negative, 0 or positive as A is below, equal to or above B
+ */
+static int Can_Bench_Compare(const void* A, const void* B)
+{
+    uint64 a = *(const uint64*)A;
+    uint64 b = *(const uint64*)B;
+
+    return (a < b) ? -1 : ((a > b) ? 1 : 0);
+}
+
+/**
+ * @brief       Converts a time stamp of the driver into nanoseconds
+ * @param       TimeStamp: Time stamp
+ * @return      Nanoseconds
+ */
+static uint64 Can_Bench_Ns(const Can_TimeStampType* TimeStamp)
+{
+    return ((uint64)TimeStamp->seconds * 1000000000u) + TimeStamp->nanoseconds;
+}
+
+/**
+ * @brief       Host cost of the transmit queue. The three mailboxes hold high priority frames that never leave,
+ *              the queue is filled with CAN_BENCH_QUEUE_SIZE frames through Can_Write() and drained by the TX
+ *              interrupt, one completed mailbox at a time. Inserting a lower priority frame than every queued one
+ *              moves them all, a higher priority one moves none. Each figure is the best of CAN_BENCH_PASSES
+ *              passes, so that the host scheduler does not show up in it.
+ * @param       void
+ * @return      void
+ */
+static void Can_Bench_QueueCost(void)
+{
+    static const Can_ConfigType config = CAN_TESTBUS_CONFIG_500K;
+    CAN_TypeDef *regs = Can_Sim_GetRegs(0u);
+    Can_PduType pdu;
+    uint64 start;
+    uint64 overhead = ~(uint64)0u;
+    uint64 cost[4];                         /* Direct write, worst insert, best insert, pop: total of a pass */
+    uint64 best[4] = {~(uint64)0u, ~(uint64)0u, ~(uint64)0u, ~(uint64)0u};
+    uint32 round;
+    uint8 pass;
+    uint8 worst;
+    uint8 i;
+
+    (void)Can_TestBus_Init(&config, 2u);
+    pdu.sdu = Can_Bench_Sdu;
+
+    /* Cost of reading the host clock, taken off the single call timings */
+    for (i = 0u; i < 100u; i++)
+    {
+        start = Test_Nanoseconds();
+        start = Test_Nanoseconds() - start;
+        overhead = (start < overhead) ? start : overhead;
+    }
+
+    for (pass = 0u; pass < CAN_BENCH_PASSES; pass++)
+    {
+        cost[0] = 0u;
+        cost[1] = 0u;
+        cost[2] = 0u;
+        cost[3] = 0u;
+        for (round = 0u; round < CAN_BENCH_QUEUE_ROUNDS; round++)
+        {
+            /* Mailboxes: the first one is timed, it takes the direct path of an empty queue */
+            Can_Init(&config);
+            for (i = 0u; i < 3u; i++)
+            {
+                Can_TestBus_Frame(&pdu, CAN_BENCH_RX_ID + i, i, 8u, i);
+                start = Test_Nanoseconds();
+                (void)Can_Write(0u, &pdu);
+                cost[0] += (i == 0u) ? (Test_Nanoseconds() - start - overhead) : 0u;
+            }
+
+            /* Every other round inserts in falling priority (worst case) or in rising priority (best case) */
+            worst = (uint8)((round & 1u) == 0u);
+            start = Test_Nanoseconds();
+            for (i = 0u; i < CAN_BENCH_QUEUE_SIZE; i++)
+            {
+                Can_TestBus_Frame(&pdu, (worst == TRUE) ? (0x500u + i) : (0x5FFu - i), (PduIdType)(3u + i), 8u, i);
+                (void)Can_Write(0u, &pdu);
+            }
+            cost[(worst == TRUE) ? 1u : 2u] += Test_Nanoseconds() - start - overhead;
+
+            /* Pop: mailbox 0 completes (aborted in the simulator) and the TX interrupt reloads it from the queue */
+            for (i = 0u; i < CAN_BENCH_QUEUE_SIZE; i++)
+            {
+                Can_Sim_WriteReg(&regs->TSR, CAN_TSR_ABRQ0);
+                start = Test_Nanoseconds();
+                Can_Sim_Isr(0u, CAN_SIM_IRQ_TX);
+                cost[3] += Test_Nanoseconds() - start - overhead;
+            }
+        }
+        for (i = 0u; i < 4u; i++)
+        {
+            best[i] = (cost[i] < best[i]) ? cost[i] : best[i];
+        }
+    }
+
+    printf("  Can_Write() into an empty mailbox:        %6.1f ns\n", (double)best[0] / CAN_BENCH_QUEUE_ROUNDS);
+    printf("  Can_Write() into the queue, worst order:  %6.1f ns (each insert moves every queued frame)\n",
+           (double)best[1] / ((CAN_BENCH_QUEUE_ROUNDS / 2u) * CAN_BENCH_QUEUE_SIZE));
+    printf("  Can_Write() into the queue, best order:   %6.1f ns (no frame moved)\n",
+           (double)best[2] / ((CAN_BENCH_QUEUE_ROUNDS / 2u) * CAN_BENCH_QUEUE_SIZE));
+    printf("  TX interrupt, pop into a mailbox:         %6.1f ns\n",
+           (double)best[3] / ((uint64)CAN_BENCH_QUEUE_ROUNDS * CAN_BENCH_QUEUE_SIZE));
+}
+
+/**
+ * @brief       Latency through the queue at a given bus load: 8-byte frames with random CAN IDs arrive at random
+ *              (exponential) intervals for two simulated seconds. Each one is timed from Can_Write() to the start
+ *              of its transmission reported by Can_GetEgressTimeStamp().
+ * @param       LoadPercent: Offered bus load
+ * @return      void
+ */
+static void Can_Bench_QueueLatency(uint8 LoadPercent)
+{
+    static const Can_ConfigType config = CAN_TESTBUS_CONFIG_500K;
+    Can_SimBusStatsType before;
+    Can_SimBusStatsType after;
+    Can_TimeStampType stamp;
+    Can_PduType pdu;
+    uint64 written[256];
+    uint16 outstanding[256];
+    uint8 used[0x800];
+    Can_IdType pendingId[256];
+    uint16 pending = 0u;
+    uint32 samples = 0u;
+    uint32 refused = 0u;
+    uint32 sequence = 0u;
+    uint64 end;
+    uint64 next;
+    uint64 now;
+    uint64 step;
+    double u;
+    Can_IdType id;
+    uint16 i;
+
+    (void)Can_TestBus_Init(&config, 2u);
+    Can_Sim_GetBusStats(&before);
+    pdu.sdu = Can_Bench_Sdu;
+    Can_Bench_Random = LoadPercent;
+    for (i = 0u; i < 0x800u; i++)
+    {
+        used[i] = FALSE;
+    }
+
+    now = Can_Sim_GetTime();
+    end = now + (2u * CAN_BENCH_SECOND);
+    next = now;
+    while (now < end)
+    {
+        if (now >= next)
+        {
+            /* New frame, with a CAN ID that is not pending so that nothing gets replaced */
+            do
+            {
+                id = 0x400u + (Can_Bench_Rand() % 0x400u);
+            } while (used[id] == TRUE);
+
+            Can_TestBus_Frame(&pdu, id, (PduIdType)sequence, 8u, sequence);
+            if ((pending < 256u) && (Can_Write(0u, &pdu) == E_OK))
+            {
+                (void)Can_GetCurrentTime(0u, &stamp);
+                written[(uint8)sequence] = Can_Bench_Ns(&stamp);
+                outstanding[pending] = (uint8)sequence;
+                pendingId[pending] = id;
+                pending++;
+                used[id] = TRUE;
+                sequence++;
+            }
+            else
+            {
+                refused++;
+            }
+
+            u = ((double)Can_Bench_Rand() + 1.0) / 2147483649.0;
+            next += (uint64)((-log(u) * CAN_BENCH_FRAME_CYCLES * 100.0) / (double)LoadPercent);
+        }
+
+        step = ((next - now) < CAN_BENCH_POLL_CYCLES) ? (next - now) : CAN_BENCH_POLL_CYCLES;
+        Can_TestBus_Run((step == 0u) ? 1u : step);
+        now = Can_Sim_GetTime();
+
+        /* Egress time stamps of the last frame of each mailbox */
+        i = 0u;
+        while (i < pending)
+        {
+            if (Can_GetEgressTimeStamp((PduIdType)outstanding[i], 0u, &stamp) == E_OK)
+            {
+                if (samples < CAN_BENCH_SAMPLES_MAX)
+                {
+                    /* TIME counts whole bits, a frame that starts at once may be stamped up to a bit early */
+                    Can_Bench_Samples[samples] = (Can_Bench_Ns(&stamp) > written[outstanding[i]]) ?
+                                                 (Can_Bench_Ns(&stamp) - written[outstanding[i]]) : 0u;
+                    samples++;
+                }
+                used[pendingId[i]] = FALSE;
+                pending--;
+                outstanding[i] = outstanding[pending];
+                pendingId[i] = pendingId[pending];
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+
+    Can_Sim_GetBusStats(&after);
+    qsort(Can_Bench_Samples, samples, sizeof(Can_Bench_Samples[0]), Can_Bench_Compare);
+    if (samples != 0u)
+    {
+        printf("  %2u %% offered, bus busy %4.1f %%: %5lu frames, %lu refused, "
+               "p50 %6.1f us, p90 %6.1f us, p99 %7.1f us, max %7.1f us\n",
+               (unsigned)LoadPercent, (100.0 * (double)(after.BusyCycles - before.BusyCycles)) / (2.0 * CAN_BENCH_SECOND),
+               (unsigned long)samples, (unsigned long)refused,
+               (double)Can_Bench_Samples[samples / 2u] / 1000.0,
+               (double)Can_Bench_Samples[(samples * 90u) / 100u] / 1000.0,
+               (double)Can_Bench_Samples[(samples * 99u) / 100u] / 1000.0,
+               (double)Can_Bench_Samples[samples - 1u] / 1000.0);
+    }
+}
+
+/**
+ * @brief       Idle bus: one frame at a time, timed from Can_Write() on node 0 to its slot being available
+ *              through Can_GetRxFrame() on node 1, with the simulated time polled every microsecond
+ * @param       Length: Data length of the frames
+ * @return      void
+ */
+static void Can_Bench_Latency(uint8 Length)
+{
+    static const Can_ConfigType config = CAN_TESTBUS_CONFIG_500K;
+    const Can_RxFrameType *frame;
+    Can_PduType pdu;
+    uint64 start;
+    uint64 latency;
+    uint64 total = 0u;
+    uint64 min = ~(uint64)0u;
+    uint64 max = 0u;
+    uint32 received = 0u;
+    uint32 i;
+
+    (void)Can_TestBus_Init(&config, 2u);
+    pdu.sdu = Can_Bench_Sdu;
+
+    for (i = 0u; i < CAN_BENCH_LATENCY_FRAMES; i++)
+    {
+        Can_TestBus_Frame(&pdu, CAN_BENCH_RX_ID + (i % 8u), (PduIdType)i, 8u, i);
+        pdu.length = Length;
+        start = Can_Sim_GetTime();
+        if (Can_Write(0u, &pdu) != E_OK)
+        {
+            continue;
+        }
+
+        while ((Can_GetRxFrame(1u, &frame) != E_OK) && ((Can_Sim_GetTime() - start) < CAN_TESTBUS_TICK_CYCLES))
+        {
+            Can_TestBus_Run(CAN_TESTBUS_CPU_HZ / 1000000u);
+        }
+        if (Can_GetRxFrame(1u, &frame) == E_OK)
+        {
+            latency = Can_Sim_GetTime() - start;
+            total += latency;
+            min = (latency < min) ? latency : min;
+            max = (latency > max) ? latency : max;
+            received++;
+            Can_ReleaseRxFrame(1u);
+        }
+
+        /* Interframe space before the next one */
+        Can_TestBus_Run(CAN_TESTBUS_CPU_HZ / 100000u);
+    }
+
+    if (received != 0u)
+    {
+        printf("  %u bytes: %lu/%u received, min %.0f us, avg %.1f us, max %.0f us (%lu/%lu/%lu cycles)\n",
+               (unsigned)Length, (unsigned long)received, (unsigned)CAN_BENCH_LATENCY_FRAMES, Can_Bench_Us(min),
+               Can_Bench_Us(total / received), Can_Bench_Us(max), (unsigned long)min,
+               (unsigned long)(total / received), (unsigned long)max);
+    }
+}
+
+/**
+ * @brief       Bus-off: node 0 is driven bus-off by Can_Sim_InjectErrors() three times in a row, then once
+ *              more after the bus has been stable. Reports each recovery time from Can_GetBusOffRecovery(), which
+ *              includes the backoff delay of Can_MainFunction_BusOff() and the 128 x 11 recessive bits.
+ * @param       Abom: ENABLE for the automatic bus-off management of the hardware, DISABLE for the driver backoff
+ * @return      void
+ */
+static void Can_Bench_BusOff(FunctionalState Abom)
+{
+    Can_ConfigType config = CAN_TESTBUS_CONFIG_500K;
+    Can_BusOffRecoveryType recovery = {0};
+    const Can_RxFrameType *frame;
+    Can_PduType pdu;
+    uint64 start;
+    uint32 count = 0u;
+    uint8 run;
+
+    config.CAN_ABOM = Abom;
+    (void)Can_TestBus_Init(&config, 2u);
+    pdu.sdu = Can_Bench_Sdu;
+
+    printf("  ABOM %s:", (Abom == ENABLE) ? "on " : "off");
+    for (run = 0u; run < 4u; run++)
+    {
+        if (run == 3u)
+        {
+            /* CAN_BUSOFF_STABLE ticks on the bus reset the backoff */
+            Can_TestBus_Run((uint64)(CAN_BENCH_STABLE_TICKS + 1u) * CAN_TESTBUS_TICK_CYCLES);
+            printf(" | after %u ms stable:", (unsigned)CAN_BENCH_STABLE_TICKS);
+        }
+
+        /* 32 bit errors take TEC from 0 to 256 */
+        Can_Sim_InjectErrors(0u, 32u);
+        Can_TestBus_Frame(&pdu, CAN_BENCH_RX_ID, (PduIdType)run, 8u, run);
+        (void)Can_Write(0u, &pdu);
+
+        start = Can_Sim_GetTime();
+        while ((recovery.Count == count) && ((Can_Sim_GetTime() - start) < CAN_BENCH_SECOND))
+        {
+            Can_TestBus_Run(CAN_TESTBUS_CPU_HZ / 10000u);
+            (void)Can_GetBusOffRecovery(0u, &recovery);
+        }
+        count = recovery.Count;
+        printf(" %.2f ms", Can_Bench_Us(recovery.LastCycles) / 1000.0);
+
+        /* Let the frame go out and the receiver drain it */
+        Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+        while (Can_GetRxFrame(1u, &frame) == E_OK)
+        {
+            Can_ReleaseRxFrame(1u);
+        }
+    }
+    printf("\n");
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+int main(void)
+{
+    printf("CAN driver benchmarks, simulated bus at 500 kbit/s, CPU at 80 MHz\n");
+
+    printf("Throughput, saturated bus for 1 s:\n");
+    Can_Bench_Throughput(1u, 8u);
+    Can_Bench_Throughput(1u, 0u);
+    Can_Bench_Throughput(2u, 8u);
+    Can_Bench_Throughput(3u, 8u);
+
+    printf("Mailboxes, 1 ms task writing a burst of frames:\n");
+    Can_Bench_Mailboxes(4u, 1u);
+    Can_Bench_Mailboxes(4u, 3u);
+    Can_Bench_Mailboxes(4u, CAN_BENCH_UNLIMITED);
+    Can_Bench_Mailboxes(8u, 1u);
+    Can_Bench_Mailboxes(8u, 3u);
+    Can_Bench_Mailboxes(8u, CAN_BENCH_UNLIMITED);
+
+    printf("Transmit queue, host cost per call (simulator register writes included):\n");
+    Can_Bench_QueueCost();
+
+    printf("Transmit queue, Can_Write() to start of frame with random CAN IDs and arrival times:\n");
+    Can_Bench_QueueLatency(50u);
+    Can_Bench_QueueLatency(80u);
+    Can_Bench_QueueLatency(95u);
+
+    printf("Latency, Can_Write() on node 0 to Can_GetRxFrame() on node 1, idle bus:\n");
+    Can_Bench_Latency(0u);
+    Can_Bench_Latency(8u);
+
+    printf("Bus-off recovery, three bus-off events in a row:\n");
+    Can_Bench_BusOff(DISABLE);
+    Can_Bench_BusOff(ENABLE);
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file        Can_BenchLookup.c
+ * @author      Phuc
+ * @brief       Benchmark of the receive dispatch lookup of the CAN driver versus the number of received IDs
+ * @version     1.0
+ * @date        2025-01-28
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include <stdlib.h>
+#include "Test.h"
+#include "Can.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define CAN_BENCH_IDS_MAX           1024u   /* Largest dispatch table measured */
+#define CAN_BENCH_REPEAT            1000u   /* Lookups of each CAN ID per measurement */
+#define CAN_BENCH_RUNS              5u      /* Measurements of each CAN ID, the fastest is kept */
+
+/**
+ * @brief       Receive dispatch in place of the generated Can_FilterCfg.h
+ * @details     The table is filled here at run time, so that its size is a variable and one build measures
+ *              every size instead of a generated header per size. Can.c is compiled into this file to
+ *              reach Can_RxLookup(). Without an identifier-list FMI every lookup is a binary search.
+ */
+#define CAN_FILTERCFG_H
+#define CAN_RX_DISPATCH_COUNT       Can_Bench_IdCount
+#define CAN_RX_SEARCH_STEPS_MAX     11u
+#define CAN_RX_FMI_MAX              1u
+
+static uint16 Can_Bench_IdCount = 0u;
+
+const Can_FilterImageType Can_FilterImage =
+{
+    .FM1R = 0x00000000u,
+    .FS1R = 0x00000001u,
+    .FFA1R = 0x00000000u,
+    .FA1R = 0x00000001u,
+    .BankCount = 1u,
+    .FR = {{0x00000000u, 0x00000000u}}                          /* One 32-bit mask bank passing everything */
+};
+
+Can_RxDispatchType Can_RxDispatch[CAN_BENCH_IDS_MAX];
+
+uint16 Can_RxFmiMap[2][CAN_RX_FMI_MAX] =
+{
+    {CAN_RX_FMI_SEARCH},
+    {CAN_RX_FMI_SEARCH}
+};
+
+#include "Can.c"
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+static const Can_RxDispatchType* volatile Can_Bench_Sink;
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Fills the dispatch table with distinct standard CAN IDs, sorted as the generator does
+ * @param       Count: Number of IDs (at most 2048)
+ * @return      void
+ */
+static void Can_Bench_FillTable(uint16 Count)
+{
+    static uint8 used[0x800];
+    uint16 id;
+    uint16 i;
+    uint16 n = 0u;
+
+    srand(Count);
+    for (i = 0u; i < 0x800u; i++)
+    {
+        used[i] = FALSE;
+    }
+    while (n < Count)
+    {
+        id = (uint16)((unsigned)rand() % 0x800u);
+        if (used[id] == FALSE)
+        {
+            used[id] = TRUE;
+            n++;
+        }
+    }
+
+    n = 0u;
+    for (i = 0u; i < 0x800u; i++)
+    {
+        if (used[i] == TRUE)
+        {
+            Can_RxDispatch[n].Hw.CanId = i;
+            Can_RxDispatch[n].Hw.Hoh = 0u;
+            Can_RxDispatch[n].Hw.ControllerId = 0u;
+            Can_RxDispatch[n].PduId = (PduIdType)n;
+            n++;
+        }
+    }
+    Can_Bench_IdCount = Count;
+}
+
+/**
+ * @brief       Times CAN_BENCH_REPEAT lookups of one CAN ID, best of CAN_BENCH_RUNS runs so that the host
+ *              scheduler does not show up as a slow ID
+ * @param       Fmi: Filter match index passed to the lookup
+ * @param       CanId: CAN ID looked up
+ * @return      Nanoseconds per lookup
+ */
+static double Can_Bench_TimeLookup(uint8 Fmi, Can_IdType CanId)
+{
+    volatile Can_IdType id = CanId;
+    uint64 start;
+    uint64 elapsed;
+    uint64 best = ~(uint64)0u;
+    uint32 run;
+    uint32 i;
+
+    for (run = 0u; run < CAN_BENCH_RUNS; run++)
+    {
+        start = Test_Nanoseconds();
+        for (i = 0u; i < CAN_BENCH_REPEAT; i++)
+        {
+            Can_Bench_Sink = Can_RxLookup(0u, Fmi, id);
+        }
+        elapsed = Test_Nanoseconds() - start;
+        best = (elapsed < best) ? elapsed : best;
+    }
+
+    return (double)best / (double)CAN_BENCH_REPEAT;
+}
+
+/**
+ * @brief       Measures the lookup of every configured ID and of as many unconfigured ones
+ * @param       Count: Size of the dispatch table
+ * @return      void
+ */
+static void Can_Bench_Lookup(uint16 Count)
+{
+    double ns;
+    double hitSum = 0.0;
+    double hitMax = 0.0;
+    double missMax = 0.0;
+    uint16 steps = 0u;
+    uint16 i;
+
+    Can_Bench_FillTable(Count);
+    while ((1u << steps) <= Count)
+    {
+        steps++;
+    }
+
+    for (i = 0u; i < Count; i++)
+    {
+        ns = Can_Bench_TimeLookup(0xFFu, Can_RxDispatch[i].Hw.CanId);
+        hitSum += ns;
+        hitMax = (ns > hitMax) ? ns : hitMax;
+
+        /* The IDs above 0x7FF are never configured */
+        ns = Can_Bench_TimeLookup(0xFFu, 0x800u + i);
+        missMax = (ns > missMax) ? ns : missMax;
+    }
+
+    printf("  %4u IDs: %2u search steps, hit avg %5.1f ns, hit max %5.1f ns, miss max %5.1f ns\n",
+           (unsigned)Count, (unsigned)steps, hitSum / (double)Count, hitMax, missMax);
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+int main(void)
+{
+    uint16 count;
+
+    printf("CAN receive dispatch lookup, host nanoseconds per call\n");
+    printf("Binary search over the sorted table:\n");
+    for (count = 16u; count <= CAN_BENCH_IDS_MAX; count *= 2u)
+    {
+        Can_Bench_Lookup(count);
+    }
+
+    /* FMI of an identifier-list entry indexes the table directly, whatever its size */
+    Can_RxFmiMap[0][0] = 0u;
+    printf("FMI direct index, %u IDs: %.1f ns\n", (unsigned)Can_Bench_IdCount,
+           Can_Bench_TimeLookup(0u, Can_RxDispatch[0].Hw.CanId));
+
+    return 0;
+}
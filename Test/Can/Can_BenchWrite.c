@@ -0,0 +1,316 @@
+/**
+ * @file        Can_BenchWrite.c
+ * @author      Phuc
+ * @brief       Benchmark of Can_Write() with the former and the current packing of the transmit mailbox data
+ * @version     1.0
+ * @date        2025-01-28
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Test.h"
+#include "Can_TestBus.h"
+
+/**
+ * @brief       Mailbox writes of the driver, routed to the packing under test
+ * @details     Can.c is compiled into this file with its call of Can_Hw_WriteMailbox() replaced, so that the
+ *              same Can_Write() runs with each packing. Can_Hw.h is included first, its include guard keeps the
+ *              inline function itself out of the replacement.
+ */
+#include "Can_Hw.h"
+
+typedef void (*Can_Bench_WriteMailboxType)(CAN_TypeDef* CANx, uint8 Mailbox, const Can_PduType* PduInfo);
+
+static Can_Bench_WriteMailboxType Can_Bench_WriteMailbox = Can_Hw_WriteMailbox;
+
+#define Can_Hw_WriteMailbox(CANx, Mailbox, PduInfo)     Can_Bench_WriteMailbox((CANx), (Mailbox), (PduInfo))
+
+#include "Can.c"
+
+#undef Can_Hw_WriteMailbox
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define CAN_BENCH_PACK_CALLS        100000u /* Mailbox writes of a pass of the packing run */
+#define CAN_BENCH_WRITE_CALLS       20000u  /* Can_Write() calls of a pass of the Can_Write() run */
+#define CAN_BENCH_PASSES            5u      /* Passes of each run, the fastest is kept */
+#define CAN_BENCH_ID                0x123u  /* CAN ID of the frames */
+#define CAN_BENCH_PACKINGS          4u      /* Packings compared */
+#define CAN_BENCH_LENGTHS           3u      /* Data lengths measured */
+
+/**
+ * @typedef     Can_Bench_PackingType
+ * @brief       Packing of the mailbox data under test
+ */
+typedef struct
+{
+    const char* Name;                       /* Printed name */
+    Can_Bench_WriteMailboxType Write;       /* Mailbox write with this packing */
+} Can_Bench_PackingType;
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+/* Register block outside the simulator: the TXRQ write of the packing run is a plain store */
+static CAN_TypeDef Can_Bench_Regs;
+
+/* SDU of the frames: word aligned at offset 0, not aligned at offset 1 */
+static union
+{
+    uint32 Align;
+    uint8 Bytes[12];
+} Can_Bench_Buffer;
+
+static uint64 Can_Bench_ClockCost;
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Mailbox write of the first release: both data registers built from eight byte shifts, whatever
+ *              the length
+ * @param       CANx: CAN register block
+ * @param       Mailbox: Index of an empty transmit mailbox
+ * @param       PduInfo: L-PDU to be sent, 8 bytes of SDU are read
+ * @return      void
+ */
+static void Can_Bench_WriteBytes(CAN_TypeDef* CANx, uint8 Mailbox, const Can_PduType* PduInfo)
+{
+    CAN_TxMailBox_TypeDef *mailbox = &CANx->sTxMailBox[Mailbox];
+
+    mailbox->TDTR = (PduInfo->length & 0x0Fu);
+    mailbox->TDLR =
+                ((uint32_t)PduInfo->sdu[3] << CAN_TDL0R_DATA3_Pos) |
+                ((uint32_t)PduInfo->sdu[2] << CAN_TDL0R_DATA2_Pos) |
+                ((uint32_t)PduInfo->sdu[1] << CAN_TDL0R_DATA1_Pos) |
+                ((uint32_t)PduInfo->sdu[0] << CAN_TDL0R_DATA0_Pos);
+    mailbox->TDHR =
+                ((uint32_t)PduInfo->sdu[7] << CAN_TDH0R_DATA7_Pos) |
+                ((uint32_t)PduInfo->sdu[6] << CAN_TDH0R_DATA6_Pos) |
+                ((uint32_t)PduInfo->sdu[5] << CAN_TDH0R_DATA5_Pos) |
+                ((uint32_t)PduInfo->sdu[4] << CAN_TDH0R_DATA4_Pos);
+    Can_Hw_WriteReg(&mailbox->TIR, ((PduInfo->id & CAN_ID_STD_MASK) << CAN_TI0R_STID_Pos) | CAN_TI0R_TXRQ);
+}
+
+/**
+ * @brief       Mailbox write of the word path that was replaced: two word loads through a uint32_t pointer when
+ *              the SDU is word aligned, the byte shifts otherwise
+ * @param       CANx: CAN register block
+ * @param       Mailbox: Index of an empty transmit mailbox
+ * @param       PduInfo: L-PDU to be sent, 8 bytes of SDU are read
+ * @return      void
+ */
+static void Can_Bench_WriteWords(CAN_TypeDef* CANx, uint8 Mailbox, const Can_PduType* PduInfo)
+{
+    CAN_TxMailBox_TypeDef *mailbox = &CANx->sTxMailBox[Mailbox];
+    const uint32_t *words;
+
+    mailbox->TDTR = (PduInfo->length & 0x0Fu);
+    if (((uintptr_t)PduInfo->sdu & 0x3u) == 0u)
+    {
+        words = (const uint32_t*)(const void*)PduInfo->sdu;
+        mailbox->TDLR = words[0];
+        if (PduInfo->length > 4u)
+        {
+            mailbox->TDHR = words[1];
+        }
+    }
+    else
+    {
+        mailbox->TDLR =
+                    ((uint32_t)PduInfo->sdu[3] << CAN_TDL0R_DATA3_Pos) |
+                    ((uint32_t)PduInfo->sdu[2] << CAN_TDL0R_DATA2_Pos) |
+                    ((uint32_t)PduInfo->sdu[1] << CAN_TDL0R_DATA1_Pos) |
+                    ((uint32_t)PduInfo->sdu[0] << CAN_TDL0R_DATA0_Pos);
+        mailbox->TDHR =
+                    ((uint32_t)PduInfo->sdu[7] << CAN_TDH0R_DATA7_Pos) |
+                    ((uint32_t)PduInfo->sdu[6] << CAN_TDH0R_DATA6_Pos) |
+                    ((uint32_t)PduInfo->sdu[5] << CAN_TDH0R_DATA5_Pos) |
+                    ((uint32_t)PduInfo->sdu[4] << CAN_TDH0R_DATA4_Pos);
+    }
+    Can_Hw_WriteReg(&mailbox->TIR, ((PduInfo->id & CAN_ID_STD_MASK) << CAN_TI0R_STID_Pos) | CAN_TI0R_TXRQ);
+}
+
+/**
+ * @brief       Mailbox write of the previous fix: only the bytes within the length are read, through a memcpy()
+ *              of the length into zeroed words
+ * @param       CANx: CAN register block
+ * @param       Mailbox: Index of an empty transmit mailbox
+ * @param       PduInfo: L-PDU to be sent
+ * @return      void
+ */
+static void Can_Bench_WriteCopy(CAN_TypeDef* CANx, uint8 Mailbox, const Can_PduType* PduInfo)
+{
+    CAN_TxMailBox_TypeDef *mailbox = &CANx->sTxMailBox[Mailbox];
+    uint32_t data[2] = {0u, 0u};
+
+    mailbox->TDTR = (PduInfo->length & 0x0Fu);
+    (void)memcpy(data, PduInfo->sdu, (PduInfo->length > 8u) ? 8u : PduInfo->length);
+    mailbox->TDLR = data[0];
+    mailbox->TDHR = data[1];
+    Can_Hw_WriteReg(&mailbox->TIR, ((PduInfo->id & CAN_ID_STD_MASK) << CAN_TI0R_STID_Pos) | CAN_TI0R_TXRQ);
+}
+
+/**
+ * @brief       Mailbox write of the driver: the whole words within the length copied with a constant size, the
+ *              bytes of a partial word shifted into zeroed words
+ * @param       CANx: CAN register block
+ * @param       Mailbox: Index of an empty transmit mailbox
+ * @param       PduInfo: L-PDU to be sent
+ * @return      void
+ */
+static void Can_Bench_WriteBounded(CAN_TypeDef* CANx, uint8 Mailbox, const Can_PduType* PduInfo)
+{
+    Can_Hw_WriteMailbox(CANx, Mailbox, PduInfo);
+}
+
+/* Packings compared, the one of the driver last */
+static const Can_Bench_PackingType Can_Bench_Packings[CAN_BENCH_PACKINGS] =
+{
+    {"byte shifts (first release)", Can_Bench_WriteBytes},
+    {"uint32_t loads when aligned", Can_Bench_WriteWords},
+    {"memcpy() of the length", Can_Bench_WriteCopy},
+    {"word copies, shifts for the rest", Can_Bench_WriteBounded}
+};
+
+/**
+ * @brief       Host cost of the mailbox write alone, into a register block outside the simulator
+ * @param       Write: Mailbox write under test
+ * @param       Pdu: L-PDU written, the first data byte changes at every call
+ * @return      Nanoseconds per call
+ */
+static double Can_Bench_TimePacking(Can_Bench_WriteMailboxType Write, const Can_PduType* Pdu)
+{
+    uint64 start;
+    uint32 i;
+
+    start = Test_Nanoseconds();
+    for (i = 0u; i < CAN_BENCH_PACK_CALLS; i++)
+    {
+        Pdu->sdu[0] = (uint8)i;
+        Write(&Can_Bench_Regs, 0u, Pdu);
+    }
+
+    return (double)(Test_Nanoseconds() - start) / (double)CAN_BENCH_PACK_CALLS;
+}
+
+/**
+ * @brief       Host cost of Can_Write() into the empty mailbox 0 of a started controller, simulator register
+ *              writes included. The mailbox is aborted and emptied by the TX interrupt between two calls.
+ * @param       Write: Mailbox write under test
+ * @param       Pdu: L-PDU written
+ * @return      Nanoseconds per call
+ */
+static double Can_Bench_TimeWrite(Can_Bench_WriteMailboxType Write, const Can_PduType* Pdu)
+{
+    CAN_TypeDef *regs = Can_Sim_GetRegs(0u);
+    uint64 start;
+    uint64 elapsed = 0u;
+    uint32 i;
+
+    Can_Bench_WriteMailbox = Write;
+    for (i = 0u; i < CAN_BENCH_WRITE_CALLS; i++)
+    {
+        start = Test_Nanoseconds();
+        (void)Can_Write(0u, Pdu);
+        elapsed += Test_Nanoseconds() - start - Can_Bench_ClockCost;
+
+        Can_Sim_WriteReg(&regs->TSR, CAN_TSR_ABRQ0);
+        Can_Sim_Isr(0u, CAN_SIM_IRQ_TX);
+    }
+
+    return (double)elapsed / (double)CAN_BENCH_WRITE_CALLS;
+}
+
+/**
+ * @brief       Measures every packing at every length and alignment and prints a table. The passes go round
+ *              the packings in turn, so that a slow spell of the host does not land on one of them, and the
+ *              fastest pass is kept.
+ * @param       Timer: Can_Bench_TimePacking() or Can_Bench_TimeWrite()
+ * @return      void
+ */
+static void Can_Bench_Table(double (*Timer)(Can_Bench_WriteMailboxType Write, const Can_PduType* Pdu))
+{
+    static const uint8 lengths[CAN_BENCH_LENGTHS] = {1u, 4u, 8u};
+    double best[CAN_BENCH_PACKINGS][CAN_BENCH_LENGTHS][2];
+    double ns;
+    Can_PduType pdu;
+    uint8 pass;
+    uint8 p;
+    uint8 l;
+    uint8 offset;
+
+    pdu.id = CAN_BENCH_ID;
+    pdu.swPduHandle = 0u;
+    for (pass = 0u; pass < CAN_BENCH_PASSES; pass++)
+    {
+        for (p = 0u; p < CAN_BENCH_PACKINGS; p++)
+        {
+            for (l = 0u; l < CAN_BENCH_LENGTHS; l++)
+            {
+                pdu.length = lengths[l];
+                for (offset = 0u; offset < 2u; offset++)
+                {
+                    pdu.sdu = &Can_Bench_Buffer.Bytes[offset];
+                    ns = Timer(Can_Bench_Packings[p].Write, &pdu);
+                    best[p][l][offset] = ((pass == 0u) || (ns < best[p][l][offset])) ? ns : best[p][l][offset];
+                }
+            }
+        }
+    }
+
+    printf("  %-28s   length 1: aligned unaligned   4: aligned unaligned   8: aligned unaligned\n", "");
+    for (p = 0u; p < CAN_BENCH_PACKINGS; p++)
+    {
+        printf("  %-28s", Can_Bench_Packings[p].Name);
+        for (l = 0u; l < CAN_BENCH_LENGTHS; l++)
+        {
+            printf("        %7.2f %9.2f", best[p][l][0], best[p][l][1]);
+        }
+        printf("\n");
+    }
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+int main(void)
+{
+    static const Can_ConfigType config = CAN_TESTBUS_CONFIG_500K;
+    uint64 start;
+    uint8 i;
+
+    /* Cost of reading the host clock, taken off the single call timings */
+    Can_Bench_ClockCost = ~(uint64)0u;
+    for (i = 0u; i < 100u; i++)
+    {
+        start = Test_Nanoseconds();
+        start = Test_Nanoseconds() - start;
+        Can_Bench_ClockCost = (start < Can_Bench_ClockCost) ? start : Can_Bench_ClockCost;
+    }
+
+    printf("Packing of the transmit mailbox data, host nanoseconds per call\n");
+    printf("Mailbox write alone:\n");
+    Can_Bench_Table(Can_Bench_TimePacking);
+
+    (void)Can_TestBus_Init(&config, 1u);
+    printf("Can_Write() into an empty mailbox, simulator register writes included:\n");
+    Can_Bench_Table(Can_Bench_TimeWrite);
+
+    return 0;
+}
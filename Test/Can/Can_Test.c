@@ -0,0 +1,589 @@
+/**
+ * @file        Can_Test.c
+ * @author      Phuc
+ * @brief       Tests of the CAN driver on the simulated bus
+ * @version     1.0
+ * @date        2025-01-28
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Test.h"
+#include "Can_TestBus.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define CAN_TEST_CANCEL_MAX         8u      /* Cancellations recorded by Can_Test_CancelTxConfirmation() */
+#define CAN_TEST_BIT_CYCLES         160u    /* One bit at 500 kbit/s, in CPU cycles */
+#define CAN_TEST_BUSOFF_BITS        (128u * 11u)    /* Recessive bits counted before leaving bus-off */
+#define CAN_TEST_RING_SIZE          16u     /* CAN_RX_RING_SIZE of Can_Cfg.h */
+#define CAN_TEST_ROUTED_ID          0x3A0u  /* First CAN ID consumed by Can_Test_RxGateway() (0x3A0-0x3A3) */
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+static PduIdType Can_Test_Cancelled[CAN_TEST_CANCEL_MAX];
+static uint8 Can_Test_CancelCount = 0u;
+static uint8 Can_Test_BusOffCount = 0u;
+static Can_ControllerStateType Can_Test_Indicated = CAN_CS_UNINIT;
+static uint32 Can_Test_Routed = 0u;
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       CancelTxConfirmation callout, records the handles
+ * @param       TxPduId: Handle of the dropped L-PDU
+ * @return      void
+ */
+static void Can_Test_CancelTxConfirmation(PduIdType TxPduId)
+{
+    if (Can_Test_CancelCount < CAN_TEST_CANCEL_MAX)
+    {
+        Can_Test_Cancelled[Can_Test_CancelCount] = TxPduId;
+    }
+    Can_Test_CancelCount++;
+}
+
+/**
+ * @brief       ControllerBusOff callout, counts the bus-off events of controller 0
+ * @param       Controller: CAN controller index
+ * @return      void
+ */
+static void Can_Test_ControllerBusOff(uint8 Controller)
+{
+    if (Controller == 0u)
+    {
+        Can_Test_BusOffCount++;
+    }
+}
+
+/**
+ * @brief       ControllerModeIndication callout, records the last state reached by controller 0
+ * @param       Controller: CAN controller index
+ * @param       ControllerMode: State reached
+ * @return      void
+ */
+static void Can_Test_ModeIndication(uint8 Controller, Can_ControllerStateType ControllerMode)
+{
+    if (Controller == 0u)
+    {
+        Can_Test_Indicated = ControllerMode;
+    }
+}
+
+/**
+ * @brief       RxGateway callout, consumes the CAN IDs routed to LIN by CanLinGw_Routes.txt
+ * @param       PduInfo: Received L-PDU
+ * @param       PopCycles: DWT cycle count when the frame was taken out of its FIFO
+ * @return      TRUE if the L-PDU is consumed
+ */
+static uint8 Can_Test_RxGateway(const Can_PduType* PduInfo, uint32 PopCycles)
+{
+    (void)PopCycles;
+    if ((PduInfo->id & ~3u) == CAN_TEST_ROUTED_ID)
+    {
+        Can_Test_Routed++;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief       Starts nodes 0 and 1 with the callouts set
+ * @param       Abom: Automatic bus-off management of the hardware
+ * @return      void
+ */
+static void Can_Test_Start(FunctionalState Abom)
+{
+    static Can_ConfigType config = CAN_TESTBUS_CONFIG_500K;
+
+    config.CAN_ABOM = Abom;
+    config.ControllerModeIndication = Can_Test_ModeIndication;
+    config.ControllerBusOff = Can_Test_ControllerBusOff;
+    config.CancelTxConfirmation = Can_Test_CancelTxConfirmation;
+    config.RxGateway = Can_Test_RxGateway;
+    Can_Test_CancelCount = 0u;
+    Can_Test_Routed = 0u;
+    Can_Test_BusOffCount = 0u;
+    TEST_CHECK_EQ(Can_TestBus_Init(&config, 2u), E_OK);
+}
+
+/**
+ * @brief       Takes every frame out of the receive ring of a controller
+ * @param       Controller: CAN controller index
+ * @param       Sequences: Where the sequence numbers of the frames are stored, in order of reception
+ * @param       Size: Number of sequence numbers that fit in Sequences
+ * @return      Number of frames received
+ */
+static uint8 Can_Test_Drain(uint8 Controller, uint32* Sequences, uint8 Size)
+{
+    const Can_RxFrameType *frame;
+    uint8 count = 0u;
+
+    while (Can_GetRxFrame(Controller, &frame) == E_OK)
+    {
+        if (count < Size)
+        {
+            Sequences[count] = Can_TestBus_Sequence(frame->Pdu.sdu);
+        }
+        count++;
+        Can_ReleaseRxFrame(Controller);
+    }
+
+    return count;
+}
+
+/**
+ * @brief       A newer L-PDU with the CAN ID of one pending in a mailbox replaces it: the stale L-PDU is
+ *              reported through CancelTxConfirmation and only the new one goes out
+ * @param       void
+ * @return      void
+ */
+static void Can_Test_ReplacePending(void)
+{
+    Can_StatisticsType stats;
+    Can_PduType pdu;
+    uint8 sdu[8];
+    uint32 received[4];
+
+    Can_Test_Start(DISABLE);
+    pdu.sdu = sdu;
+
+    /* Both writes come before the simulated bus moves, the first frame has not started */
+    Can_TestBus_Frame(&pdu, 0x100u, 11u, 8u, 11u);
+    TEST_CHECK_EQ(Can_Write(0u, &pdu), E_OK);
+    Can_TestBus_Frame(&pdu, 0x100u, 22u, 8u, 22u);
+    TEST_CHECK_EQ(Can_Write(0u, &pdu), E_OK);
+
+    TEST_CHECK_EQ(Can_Test_CancelCount, 1u);
+    TEST_CHECK_EQ(Can_Test_Cancelled[0], 11u);
+
+    Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+    TEST_CHECK_EQ(Can_Test_Drain(1u, received, 4u), 1u);
+    TEST_CHECK_EQ(received[0], 22u);
+    TEST_CHECK_EQ(Can_Test_CancelCount, 1u);
+
+    (void)Can_GetStatistics(0u, &stats);
+    TEST_CHECK_EQ(stats.TxFrames, 1u);
+    TEST_CHECK_EQ(stats.TxCancelled, 1u);
+}
+
+/**
+ * @brief       A short SDU is read only up to its length, from any alignment, and the data bytes of the mailbox
+ *              past the length do not keep those of the previous frame
+ * @param       void
+ * @return      void
+ */
+static void Can_Test_WriteShortSdu(void)
+{
+    CAN_TypeDef *regs = Can_Sim_GetRegs(0u);
+    Can_PduType pdu;
+    uint8 sdu[8] = {0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu};
+    uint8 i;
+
+    Can_Test_Start(DISABLE);
+    pdu.id = 0x100u;
+    pdu.swPduHandle = 1u;
+    pdu.length = 8u;
+    pdu.sdu = sdu;
+    TEST_CHECK_EQ(Can_Write(0u, &pdu), E_OK);
+    Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+
+    /* One to three bytes at the end of the buffer, the simulated bus does not move so the mailbox can be read */
+    for (i = 1u; i <= 3u; i++)
+    {
+        sdu[8u - i] = (uint8)(0xA0u + i);
+        pdu.length = i;
+        pdu.sdu = &sdu[8u - i];
+        TEST_CHECK_EQ(Can_Write(0u, &pdu), E_OK);
+        TEST_CHECK_EQ(regs->sTxMailBox[0].TDTR & CAN_TDT0R_DLC, i);
+        TEST_CHECK_EQ(regs->sTxMailBox[0].TDLR, (i == 1u) ? 0xA1u : ((i == 2u) ? 0xA1A2u : 0xA1A2A3u));
+        TEST_CHECK_EQ(regs->sTxMailBox[0].TDHR, 0u);
+        Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+    }
+}
+
+/**
+ * @brief       A full receive ring does not stop the gateway: a routed L-PDU is still consumed, only the others
+ *              are counted as ring overflows
+ * @param       void
+ * @return      void
+ */
+static void Can_Test_GatewayRingFull(void)
+{
+    Can_RxOverrunType overrun;
+    Can_PduType pdu;
+    uint8 sdu[8];
+    uint32 received[CAN_TEST_RING_SIZE];
+    uint8 i;
+
+    Can_Test_Start(DISABLE);
+    pdu.sdu = sdu;
+
+    /* Two rounds of the eight distinct CAN IDs fill the ring of node 1 */
+    for (i = 0u; i < CAN_TEST_RING_SIZE; i++)
+    {
+        Can_TestBus_Frame(&pdu, 0x100u + (i % 8u), i, 8u, i);
+        TEST_CHECK_EQ(Can_Write(0u, &pdu), E_OK);
+        if ((i % 8u) == 7u)
+        {
+            Can_TestBus_Run(3u * CAN_TESTBUS_TICK_CYCLES);
+        }
+    }
+
+    Can_TestBus_Frame(&pdu, CAN_TEST_ROUTED_ID, 100u, 8u, 100u);
+    TEST_CHECK_EQ(Can_Write(0u, &pdu), E_OK);
+    Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+    TEST_CHECK_EQ(Can_Test_Routed, 1u);
+    (void)Can_GetRxOverrunCounters(1u, &overrun);
+    TEST_CHECK_EQ(overrun.RingOverflow, 0u);
+
+    Can_TestBus_Frame(&pdu, 0x100u, 101u, 8u, 101u);
+    TEST_CHECK_EQ(Can_Write(0u, &pdu), E_OK);
+    Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+    TEST_CHECK_EQ(Can_Test_Routed, 1u);
+    (void)Can_GetRxOverrunCounters(1u, &overrun);
+    TEST_CHECK_EQ(overrun.RingOverflow, 1u);
+
+    TEST_CHECK_EQ(Can_Test_Drain(1u, received, CAN_TEST_RING_SIZE), CAN_TEST_RING_SIZE);
+    TEST_CHECK_EQ(received[CAN_TEST_RING_SIZE - 1u], CAN_TEST_RING_SIZE - 1u);
+}
+
+/**
+ * @brief       The self-test cycles through every CAN ID of the receive dispatch table, the routed ones included:
+ *              the gateway must leave its frames to it
+ * @param       void
+ * @return      void
+ */
+static void Can_Test_GatewaySelfTest(void)
+{
+    static const Can_SelfTestConfigType test = {CAN_OPMODE_SILENT_LOOPBACK, 8u, 34u, CAN_TESTBUS_TICK_CYCLES};
+    Can_SelfTestResultType result;
+
+    Can_Test_Start(DISABLE);
+    TEST_CHECK_EQ(Can_SetControllerMode(0u, CAN_CS_STOPPED), E_OK);
+    Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+
+    TEST_CHECK_EQ(Can_SelfTest(0u, &test, &result), E_OK);
+    TEST_CHECK_EQ(result.Received, 2u * test.Frames);
+    TEST_CHECK_EQ(result.Corrupted, 0u);
+    TEST_CHECK_EQ(Can_Test_Routed, 0u);
+}
+
+/**
+ * @brief       Can_DeInit() leaves none of the interrupts enabled by Can_EnableControllerInterrupts()
+ * @param       void
+ * @return      void
+ */
+static void Can_Test_DeInit(void)
+{
+    uint8 controller;
+
+    Can_Test_Start(DISABLE);
+    TEST_CHECK(Can_Sim_GetRegs(0u)->IER != 0u);
+
+    Can_DeInit();
+    for (controller = 0u; controller < 2u; controller++)
+    {
+        TEST_CHECK_EQ(Can_Sim_GetRegs(controller)->IER, 0u);
+    }
+}
+
+/**
+ * @brief       A replacement that comes once the stale frame is on the bus cannot abort it: both go out in
+ *              order and nothing is cancelled
+ * @param       void
+ * @return      void
+ */
+static void Can_Test_ReplaceOnBus(void)
+{
+    Can_PduType pdu;
+    uint8 sdu[8];
+    uint32 received[4];
+
+    Can_Test_Start(DISABLE);
+    pdu.sdu = sdu;
+
+    Can_TestBus_Frame(&pdu, 0x100u, 11u, 8u, 11u);
+    TEST_CHECK_EQ(Can_Write(0u, &pdu), E_OK);
+    Can_TestBus_Run(20u * CAN_TEST_BIT_CYCLES);
+    Can_TestBus_Frame(&pdu, 0x100u, 22u, 8u, 22u);
+    TEST_CHECK_EQ(Can_Write(0u, &pdu), E_OK);
+
+    Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+    TEST_CHECK_EQ(Can_Test_Drain(1u, received, 4u), 2u);
+    TEST_CHECK_EQ(received[0], 11u);
+    TEST_CHECK_EQ(received[1], 22u);
+    TEST_CHECK_EQ(Can_Test_CancelCount, 0u);
+}
+
+/**
+ * @brief       After a replacement the whole transmit path is available again: three mailboxes and
+ *              CAN_TX_QUEUE_SIZE queue entries, and a higher priority L-PDU still preempts a mailbox
+ * @param       void
+ * @return      void
+ */
+static void Can_Test_ReplaceRestoresQueue(void)
+{
+    Can_StatisticsType stats;
+    Can_PduType pdu;
+    uint8 sdu[8];
+    uint32 received[32];
+    uint32 accepted = 0u;
+    uint32 sent;
+    uint8 i;
+
+    Can_Test_Start(DISABLE);
+    pdu.sdu = sdu;
+
+    Can_TestBus_Frame(&pdu, 0x107u, 11u, 8u, 11u);
+    (void)Can_Write(0u, &pdu);
+    Can_TestBus_Frame(&pdu, 0x107u, 22u, 8u, 22u);
+    (void)Can_Write(0u, &pdu);
+    Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+    (void)Can_Test_Drain(1u, received, 32u);
+
+    /* Falling priority, nothing is preempted: 3 mailboxes + CAN_TX_QUEUE_SIZE (16) queue entries */
+    for (i = 0u; i < 24u; i++)
+    {
+        Can_TestBus_Frame(&pdu, 0x500u + i, (PduIdType)(100u + i), 8u, 100u + i);
+        if (Can_Write(0u, &pdu) == E_OK)
+        {
+            accepted++;
+        }
+    }
+    TEST_CHECK_EQ(accepted, 19u);
+    Can_TestBus_Run(10u * CAN_TESTBUS_TICK_CYCLES);
+
+    /* 0x101 preempts one of the three low priority mailboxes and is the next frame on the bus. The
+       receiver only accepts 0x101 of these, the sender counts what went out. */
+    (void)Can_GetStatistics(0u, &stats);
+    sent = stats.TxFrames;
+    for (i = 0u; i < 3u; i++)
+    {
+        Can_TestBus_Frame(&pdu, 0x500u + i, (PduIdType)(150u + i), 8u, 150u + i);
+        (void)Can_Write(0u, &pdu);
+    }
+    Can_TestBus_Frame(&pdu, 0x101u, 200u, 8u, 200u);
+    TEST_CHECK_EQ(Can_Write(0u, &pdu), E_OK);
+
+    Can_TestBus_Run(140u * CAN_TEST_BIT_CYCLES);
+    (void)Can_GetStatistics(0u, &stats);
+    TEST_CHECK_EQ(stats.TxFrames - sent, 1u);
+    TEST_CHECK_EQ(Can_Test_Drain(1u, received, 32u), 1u);
+    TEST_CHECK_EQ(received[0], 200u);
+}
+
+/**
+ * @brief       Drives controller 0 bus-off with 32 bit errors on a frame and waits for the recovery
+ * @param       Sequence: Sequence number of the frame, sent once the controller is back
+ * @return      Duration of the recovery reported by Can_GetBusOffRecovery(), 0 if it did not complete
+ */
+static uint32 Can_Test_BusOff(uint32 Sequence)
+{
+    Can_BusOffRecoveryType recovery;
+    Can_ControllerStateType state;
+    Can_PduType pdu;
+    uint8 sdu[8];
+    uint32 received[4];
+    uint32 count;
+    uint8 busOff = Can_Test_BusOffCount;
+    uint8 ticks;
+
+    (void)Can_GetBusOffRecovery(0u, &recovery);
+    count = recovery.Count;
+    pdu.sdu = sdu;
+
+    /* Start right after a tick, so that every run sees the same backoff phase */
+    Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES - (Can_Sim_GetTime() % CAN_TESTBUS_TICK_CYCLES));
+
+    /* Each bit error adds 8 to TEC, bus-off at 256 */
+    Can_Sim_InjectErrors(0u, 32u);
+    Can_TestBus_Frame(&pdu, 0x100u, (PduIdType)Sequence, 8u, Sequence);
+    TEST_CHECK_EQ(Can_Write(0u, &pdu), E_OK);
+    while ((Can_Test_BusOffCount == busOff) && (Can_Sim_GetTime() < (CAN_TESTBUS_CPU_HZ * 100u)))
+    {
+        Can_TestBus_Run(10u * CAN_TEST_BIT_CYCLES);
+    }
+    TEST_CHECK_EQ(Can_Test_BusOffCount, busOff + 1u);
+    (void)Can_GetControllerMode(0u, &state);
+    TEST_CHECK_EQ(state, CAN_CS_STOPPED);
+    TEST_CHECK_EQ(Can_SetControllerMode(0u, CAN_CS_STARTED), E_NOT_OK);
+
+    Can_Test_Indicated = CAN_CS_UNINIT;
+    for (ticks = 0u; (ticks < 100u) && (recovery.Count == count); ticks++)
+    {
+        Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+        (void)Can_GetBusOffRecovery(0u, &recovery);
+    }
+    TEST_CHECK_EQ(recovery.Count, count + 1u);
+    TEST_CHECK_EQ(Can_Test_Indicated, CAN_CS_STARTED);
+    (void)Can_GetControllerMode(0u, &state);
+    TEST_CHECK_EQ(state, CAN_CS_STARTED);
+
+    /* The frame waited in its mailbox through the recovery */
+    Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+    TEST_CHECK_EQ(Can_Test_Drain(1u, received, 4u), 1u);
+    TEST_CHECK_EQ(received[0], Sequence);
+
+    return (recovery.Count == (count + 1u)) ? recovery.LastCycles : 0u;
+}
+
+/**
+ * @brief       Bus-off recovery by the driver: the first recovery takes the 128 x 11 recessive bits plus the
+ *              CAN_BUSOFF_DELAY_MIN tick of backoff and the INRQ toggle, each further bus-off in a row doubles
+ *              the backoff, and a stable bus brings it back to the minimum
+ * @param       void
+ * @return      void
+ */
+static void Can_Test_BusOffRecovery(void)
+{
+    Can_BusOffRecoveryType recovery;
+    Can_StatisticsType stats;
+    uint32 cycles[4];
+    uint8 i;
+
+    Can_Test_Start(DISABLE);
+
+    for (i = 0u; i < 3u; i++)
+    {
+        cycles[i] = Can_Test_BusOff(i);
+    }
+
+    /* CAN_BUSOFF_STABLE (100) ticks on the bus */
+    Can_TestBus_Run(101u * CAN_TESTBUS_TICK_CYCLES);
+    (void)Can_GetBusOffRecovery(0u, &recovery);
+    TEST_CHECK_EQ(recovery.Consecutive, 0u);
+    cycles[3] = Can_Test_BusOff(3u);
+
+    printf("    recovery %.2f, %.2f, %.2f ms in a row, %.2f ms after a stable bus\n",
+           (double)cycles[0] / (CAN_TESTBUS_TICK_CYCLES), (double)cycles[1] / (CAN_TESTBUS_TICK_CYCLES),
+           (double)cycles[2] / (CAN_TESTBUS_TICK_CYCLES), (double)cycles[3] / (CAN_TESTBUS_TICK_CYCLES));
+
+    /* Recessive bits + 1 tick of backoff + 1 tick for the INRQ toggle, detected at the next tick */
+    TEST_CHECK(cycles[0] >= (CAN_TEST_BUSOFF_BITS * CAN_TEST_BIT_CYCLES));
+    TEST_CHECK(cycles[0] <= ((CAN_TEST_BUSOFF_BITS * CAN_TEST_BIT_CYCLES) + (3u * CAN_TESTBUS_TICK_CYCLES)));
+    /* Backoff of 2, then 4 ticks */
+    TEST_CHECK_EQ(cycles[1] - cycles[0], 1u * CAN_TESTBUS_TICK_CYCLES);
+    TEST_CHECK_EQ(cycles[2] - cycles[1], 2u * CAN_TESTBUS_TICK_CYCLES);
+    TEST_CHECK_EQ(cycles[3], cycles[0]);
+
+    (void)Can_GetBusOffRecovery(0u, &recovery);
+    TEST_CHECK_EQ(recovery.Count, 4u);
+    TEST_CHECK_EQ(recovery.MaxCycles, cycles[2]);
+    (void)Can_GetStatistics(0u, &stats);
+    TEST_CHECK_EQ(stats.BusOff, 4u);
+}
+
+/**
+ * @brief       Bus-off recovery by the hardware (ABOM): no backoff, the recovery ends after the recessive bits
+ * @param       void
+ * @return      void
+ */
+static void Can_Test_BusOffRecoveryAbom(void)
+{
+    uint32 first;
+    uint32 second;
+
+    Can_Test_Start(ENABLE);
+
+    first = Can_Test_BusOff(1u);
+    second = Can_Test_BusOff(2u);
+    printf("    recovery %.2f, %.2f ms in a row\n", (double)first / (CAN_TESTBUS_TICK_CYCLES),
+           (double)second / (CAN_TESTBUS_TICK_CYCLES));
+
+    TEST_CHECK(first >= (CAN_TEST_BUSOFF_BITS * CAN_TEST_BIT_CYCLES));
+    TEST_CHECK(first <= ((CAN_TEST_BUSOFF_BITS * CAN_TEST_BIT_CYCLES) + CAN_TESTBUS_TICK_CYCLES));
+    TEST_CHECK_EQ(second, first);
+}
+
+/**
+ * @brief       Time stamps of the frames sent on an idle bus, where the start of frame follows Can_Write() at
+ *              once. The TTCM phase is taken from the first frame, whose stuff bits it cannot know, so the egress
+ *              time stamps of node 0 may be late by those and the interframe space, never early, and by the same
+ *              amount for every frame: across gaps longer than the 16-bit TIME counter period (131 ms at
+ *              500 kbit/s) as well. The ingress time stamps of node 1 give the same start of frame.
+ * @param       void
+ * @return      void
+ */
+static void Can_Test_TimeStamps(void)
+{
+    const Can_RxFrameType *frame;
+    Can_TimeStampType now;
+    Can_TimeStampType egress;
+    Can_PduType pdu;
+    uint8 sdu[8];
+    uint64 written;
+    uint64 sent;
+    uint64 received;
+    uint64 offset = 0u;
+    uint8 i;
+
+    Can_Test_Start(DISABLE);
+    pdu.sdu = sdu;
+
+    for (i = 0u; i < 12u; i++)
+    {
+        Can_TestBus_Frame(&pdu, 0x100u + (i % 8u), i, (uint8)(4u + (i % 5u)), i);
+        (void)Can_GetCurrentTime(0u, &now);
+        written = ((uint64)now.seconds * 1000000000u) + now.nanoseconds;
+        TEST_CHECK_EQ(Can_Write(0u, &pdu), E_OK);
+
+        Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+        TEST_CHECK_EQ(Can_GetEgressTimeStamp(i, 0u, &egress), E_OK);
+        sent = ((uint64)egress.seconds * 1000000000u) + egress.nanoseconds;
+        TEST_CHECK_EQ(Can_GetRxFrame(1u, &frame), E_OK);
+        received = (frame->TimeStamp * 1000u) / (CAN_TESTBUS_CPU_HZ / 1000000u);
+        Can_ReleaseRxFrame(1u);
+
+        /* At most (34 + 32 - 1) / 4 stuff bits of the first frame and 4 bits of end of frame, 2 us each */
+        TEST_CHECK(sent >= written);
+        TEST_CHECK(sent <= (written + (20u * 2000u)));
+        if (i == 0u)
+        {
+            offset = sent - written;
+        }
+        TEST_CHECK_EQ(sent - written, offset);
+        TEST_CHECK((received + 2000u) >= sent);
+        TEST_CHECK(received <= (sent + 2000u));
+
+        /* Every third gap is longer than the TIME counter period */
+        Can_TestBus_Run(((i % 3u) == 2u) ? (200u * CAN_TESTBUS_TICK_CYCLES) : (7u * CAN_TESTBUS_TICK_CYCLES));
+    }
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+int main(void)
+{
+    TEST_RUN(Can_Test_ReplacePending);
+    TEST_RUN(Can_Test_ReplaceOnBus);
+    TEST_RUN(Can_Test_WriteShortSdu);
+    TEST_RUN(Can_Test_ReplaceRestoresQueue);
+    TEST_RUN(Can_Test_TimeStamps);
+    TEST_RUN(Can_Test_BusOffRecovery);
+    TEST_RUN(Can_Test_BusOffRecoveryAbom);
+    TEST_RUN(Can_Test_GatewayRingFull);
+    TEST_RUN(Can_Test_GatewaySelfTest);
+    TEST_RUN(Can_Test_DeInit);
+
+    return Test_Summary();
+}
@@ -0,0 +1,133 @@
+/**
+ * @file        Can_TestBus.c
+ * @author      Phuc
+ * @brief       Simulated CAN bus shared by the host tests and benchmarks of the CAN driver
+ * @version     1.0
+ * @date        2025-01-28
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Can_TestBus.h"
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+static uint64 Can_TestBus_NextTick = 0u;   /* Simulated time of the next main function call */
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets the simulator, initializes the driver and starts the first controllers with all their
+ *              interrupts enabled. The other controllers stay in initialization mode and do not acknowledge.
+ * @param       Config: Driver configuration, kept by the driver
+ * @param       Started: Number of controllers started, from controller 0
+ * @return      E_OK when every started controller reached CAN_CS_STARTED, E_NOT_OK otherwise
+ */
+Std_ReturnType Can_TestBus_Init(const Can_ConfigType* Config, uint8 Started)
+{
+    Can_ControllerStateType state;
+    uint8 controller;
+
+    Can_Sim_Init();
+    Can_Init(Config);
+    Can_TestBus_NextTick = ((Can_Sim_GetTime() / CAN_TESTBUS_TICK_CYCLES) + 1u) * CAN_TESTBUS_TICK_CYCLES;
+
+    for (controller = 0u; controller < Started; controller++)
+    {
+        Can_EnableControllerInterrupts(controller);
+        if (Can_SetControllerMode(controller, CAN_CS_STARTED) != E_OK)
+        {
+            return E_NOT_OK;
+        }
+    }
+
+    /* Joining the bus takes 11 recessive bits, acknowledged at the next main function tick */
+    Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+
+    for (controller = 0u; controller < Started; controller++)
+    {
+        if ((Can_GetControllerMode(controller, &state) != E_OK) || (state != CAN_CS_STARTED))
+        {
+            return E_NOT_OK;
+        }
+    }
+
+    return E_OK;
+}
+
+/**
+ * @brief       Advances the simulated time, calling Can_MainFunction_Mode() and Can_MainFunction_BusOff() at
+ *              every 1 ms tick as the scheduler of the target does. The ticks fall on the multiples of
+ *              CAN_TESTBUS_TICK_CYCLES, a tick at the end of the run is included.
+ * @param       Cycles: CPU cycles to simulate
+ * @return      void
+ */
+void Can_TestBus_Run(uint64 Cycles)
+{
+    uint64 end = Can_Sim_GetTime() + Cycles;
+    uint64 now = Can_Sim_GetTime();
+
+    while (now < end)
+    {
+        if (Can_TestBus_NextTick <= end)
+        {
+            Can_Sim_Run(Can_TestBus_NextTick - now);
+            Can_TestBus_NextTick += CAN_TESTBUS_TICK_CYCLES;
+            Can_MainFunction_Mode();
+            Can_MainFunction_BusOff();
+        }
+        else
+        {
+            Can_Sim_Run(end - now);
+        }
+        now = Can_Sim_GetTime();
+    }
+}
+
+/**
+ * @brief       Builds a data frame whose first four bytes carry a sequence number
+ * @param       Pdu: L-PDU to fill, its sdu has to point to 8 bytes
+ * @param       Id: CAN ID
+ * @param       Handle: PDU handle
+ * @param       Length: Data length (4-8 bytes)
+ * @param       Sequence: Sequence number
+ * @return      void
+ */
+void Can_TestBus_Frame(Can_PduType* Pdu, Can_IdType Id, PduIdType Handle, uint8 Length, uint32 Sequence)
+{
+    uint8 i;
+
+    Pdu->id = Id;
+    Pdu->swPduHandle = Handle;
+    Pdu->length = Length;
+    Pdu->sdu[0] = (uint8)(Sequence >> 24u);
+    Pdu->sdu[1] = (uint8)(Sequence >> 16u);
+    Pdu->sdu[2] = (uint8)(Sequence >> 8u);
+    Pdu->sdu[3] = (uint8)Sequence;
+    for (i = 4u; i < Length; i++)
+    {
+        Pdu->sdu[i] = (uint8)(Sequence + i);
+    }
+}
+
+/**
+ * @brief       Returns the sequence number carried by a frame built with Can_TestBus_Frame()
+ * @param       Sdu: Data of the frame
+ * @return      Sequence number
+ */
+uint32 Can_TestBus_Sequence(const uint8* Sdu)
+{
+    return ((uint32)Sdu[0] << 24u) | ((uint32)Sdu[1] << 16u) | ((uint32)Sdu[2] << 8u) | (uint32)Sdu[3];
+}
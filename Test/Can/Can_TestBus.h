@@ -0,0 +1,78 @@
+/**
+ * @file        Can_TestBus.h
+ * @author      Phuc
+ * @brief       Simulated CAN bus shared by the host tests and benchmarks of the CAN driver
+ * @version     1.0
+ * @date        2025-01-28
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef CAN_TESTBUS_H
+#define CAN_TESTBUS_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Can.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define CAN_TESTBUS_CPU_HZ          80000000u                   /* CAN_CPU_CLOCK_HZ of Can_Cfg.h */
+#define CAN_TESTBUS_TICK_CYCLES     (CAN_TESTBUS_CPU_HZ / 1000u) /* Period of the main functions, 1 ms */
+
+/**
+ * @brief       500 kbit/s at 80 MHz: prescaler 10, 16 tq with the sample point at 87.5 %
+ */
+#define CAN_TESTBUS_CONFIG_500K     { 10u, CAN_OPMODE_NORMAL, 1u, 13u, 2u, \
+                                      DISABLE, DISABLE, DISABLE, DISABLE, DISABLE, DISABLE, \
+                                      NULL_PTR, NULL_PTR, NULL_PTR, NULL_PTR }
+
+/*
+ ************************************************************************************************************
+ * Functions declaration
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets the simulator, initializes the driver and starts the first controllers with all their
+ *              interrupts enabled. The other controllers stay in initialization mode and do not acknowledge.
+ * @param       Config: Driver configuration, kept by the driver
+ * @param       Started: Number of controllers started, from controller 0
+ * @return      E_OK when every started controller reached CAN_CS_STARTED, E_NOT_OK otherwise
+ */
+Std_ReturnType Can_TestBus_Init(const Can_ConfigType* Config, uint8 Started);
+
+/**
+ * @brief       Advances the simulated time, calling Can_MainFunction_Mode() and Can_MainFunction_BusOff() at
+ *              every 1 ms tick as the scheduler of the target does. The ticks fall on the multiples of
+ *              CAN_TESTBUS_TICK_CYCLES, a tick at the end of the run is included.
+ * @param       Cycles: CPU cycles to simulate
+ * @return      void
+ */
+void Can_TestBus_Run(uint64 Cycles);
+
+/**
+ * @brief       Builds a data frame whose first four bytes carry a sequence number
+ * @param       Pdu: L-PDU to fill, its sdu has to point to 8 bytes
+ * @param       Id: CAN ID
+ * @param       Handle: PDU handle
+ * @param       Length: Data length (4-8 bytes)
+ * @param       Sequence: Sequence number
+ * @return      void
+ */
+void Can_TestBus_Frame(Can_PduType* Pdu, Can_IdType Id, PduIdType Handle, uint8 Length, uint32 Sequence);
+
+/**
+ * @brief       Returns the sequence number carried by a frame built with Can_TestBus_Frame()
+ * @param       Sdu: Data of the frame
+ * @return      Sequence number
+ */
+uint32 Can_TestBus_Sequence(const uint8* Sdu);
+
+#endif /* CAN_TESTBUS_H */
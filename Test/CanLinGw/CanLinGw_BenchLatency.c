@@ -0,0 +1,205 @@
+/**
+ * @file        CanLinGw_BenchLatency.c
+ * @author      Phuc
+ * @brief       Benchmark of the latency of the CAN to LIN gateway, from the receive FIFO of the simulated bxCAN to
+ *              the published LIN response, with every LIN frame then sent and checked on the simulated LIN bus
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Test.h"
+#include "CanLinGw_TestBus.h"
+
+/**
+ * @brief       Cycle counters of the CAN driver and the gateway, routed to the host clock
+ * @details     DWT CYCCNT of the simulators follows the simulated time, which does not advance while the drivers
+ *              run, so CanLinGw_GetLatency() would report 0. Can.c and CanLinGw.c are compiled into this file with
+ *              their reads of the cycle counter replaced by the host clock: the FIFO pop time and LastCycles are
+ *              then host nanoseconds. Can_Hw.h and Lin_Hw.h are included first, their include guards keep the
+ *              inline functions themselves out of the replacement.
+ */
+#include "Can_Hw.h"
+#include "Lin_Hw.h"
+
+#define Can_Hw_GetCycles()          ((uint32)Test_Nanoseconds())
+#define Lin_Hw_GetCycles()          ((uint32)Test_Nanoseconds())
+
+#include "Can.c"
+#include "CanLinGw.c"
+
+#undef Can_Hw_GetCycles
+#undef Lin_Hw_GetCycles
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define CANLINGW_BENCH_ROUNDS       200u    /* Rounds over the routed CAN frames */
+#define CANLINGW_BENCH_PDUS         7u      /* Routed CAN frames, see CanLinGw_Routes.txt */
+
+/**
+ * @typedef     CanLinGw_Bench_PduType
+ * @brief       Routed CAN frame and the latency measured for it
+ */
+typedef struct
+{
+    Can_IdType Id;                          /* CAN ID */
+    uint8 Length;                           /* Data length */
+    uint8 Routes;                           /* Routes of the frame */
+    uint32 Count;                           /* Frames routed */
+    uint64 Ns;                              /* Sum of LastCycles, without the clock read */
+    uint32 MaxNs;                           /* Longest LastCycles, without the clock read */
+} CanLinGw_Bench_PduType;
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+static CanLinGw_Bench_PduType CanLinGw_Bench_Pdus[CANLINGW_BENCH_PDUS] =
+{
+    {0x3A0u, 1u, 1u, 0u, 0u, 0u},
+    {0x3A1u, 1u, 1u, 0u, 0u, 0u},
+    {0x3A2u, 1u, 1u, 0u, 0u, 0u},
+    {0x3A3u, 1u, 1u, 0u, 0u, 0u},
+    {0x200u, 2u, 2u, 0u, 0u, 0u},
+    {0x210u, 3u, 1u, 0u, 0u, 0u},
+    {0x2F0u, 3u, 1u, 0u, 0u, 0u}
+};
+static CanLinGw_TestBus_SignalsType CanLinGw_Bench_Signals;
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Keeps the data of a routed CAN frame as the signals the LIN frames must carry
+ * @param       Pdu: Index in CanLinGw_Bench_Pdus
+ * @param       Data: Data bytes of the CAN frame
+ * @return      void
+ */
+static void CanLinGw_Bench_Keep(uint8 Pdu, const uint8* Data)
+{
+    if (Pdu < 4u)
+    {
+        CanLinGw_Bench_Signals.Door[Pdu] = Data[0];
+    }
+    else if (Pdu == 4u)
+    {
+        (void)memcpy(CanLinGw_Bench_Signals.Climate, Data, 2u);
+    }
+    else if (Pdu == 5u)
+    {
+        CanLinGw_Bench_Signals.Blower = Data[2];
+    }
+    else
+    {
+        (void)memcpy(CanLinGw_Bench_Signals.Light, Data, 3u);
+    }
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+int main(void)
+{
+    CanLinGw_Bench_PduType *pdu;
+    CanLinGw_LatencyType latency;
+    uint64 clockCost;
+    uint64 start;
+    uint64 ns;
+    uint32 mismatches = 0u;
+    uint32 lost = 0u;
+    uint32 count = 0u;
+    uint32 round;
+    uint32 i;
+    uint8 expected[8];
+    uint8 response[8];
+    uint8 data[8];
+    uint8 length;
+    uint8 frame;
+    uint8 p;
+
+    /* Cost of reading the host clock, taken off every interval timed by the gateway */
+    clockCost = ~(uint64)0u;
+    for (i = 0u; i < 100u; i++)
+    {
+        start = Test_Nanoseconds();
+        start = Test_Nanoseconds() - start;
+        clockCost = (start < clockCost) ? start : clockCost;
+    }
+
+    if (CanLinGw_TestBus_Init() != E_OK)
+    {
+        return 1;
+    }
+    (void)memset(&CanLinGw_Bench_Signals, 0, sizeof(CanLinGw_Bench_Signals));
+
+    for (round = 0u; round < CANLINGW_BENCH_ROUNDS; round++)
+    {
+        for (p = 0u; p < CANLINGW_BENCH_PDUS; p++)
+        {
+            pdu = &CanLinGw_Bench_Pdus[p];
+            for (i = 0u; i < 8u; i++)
+            {
+                data[i] = (uint8)((round * 31u) + (p * 7u) + (i * 3u) + 1u);
+            }
+            (void)CanLinGw_TestBus_SendCan(pdu->Id, data, pdu->Length);
+            CanLinGw_Bench_Keep(p, data);
+
+            (void)CanLinGw_GetLatency(&latency);
+            if (latency.Count != (count + 1u))
+            {
+                lost++;
+                count = latency.Count;
+                continue;
+            }
+            count = latency.Count;
+            ns = (latency.LastCycles > clockCost) ? (latency.LastCycles - clockCost) : 0u;
+            pdu->Count++;
+            pdu->Ns += ns;
+            pdu->MaxNs = ((uint32)ns > pdu->MaxNs) ? (uint32)ns : pdu->MaxNs;
+        }
+
+        for (frame = 0u; frame < CANLINGW_TESTBUS_FRAMES; frame++)
+        {
+            length = CanLinGw_TestBus_Expected(&CanLinGw_Bench_Signals, frame, expected);
+            if ((CanLinGw_TestBus_SendLin(frame, response) != length) || (memcmp(response, expected, length) != 0))
+            {
+                mismatches++;
+            }
+        }
+    }
+
+    printf("CAN to LIN gateway, %u rounds of the routed CAN frames, each round then sends the %u LIN frames\n",
+           (unsigned)CANLINGW_BENCH_ROUNDS, (unsigned)CANLINGW_TESTBUS_FRAMES);
+    printf("Latency is CanLinGw_GetLatency() from the receive FIFO pop to the published LIN response, in host\n");
+    printf("nanoseconds without the clock read (%lu ns): it does not predict the target.\n", (unsigned long)clockCost);
+    printf("  CAN ID   bytes  routes   frames   mean ns    max ns\n");
+    for (p = 0u; p < CANLINGW_BENCH_PDUS; p++)
+    {
+        pdu = &CanLinGw_Bench_Pdus[p];
+        printf("  0x%03lX   %5u  %6u   %6lu   %7.1f   %7lu\n", (unsigned long)pdu->Id, (unsigned)pdu->Length,
+               (unsigned)pdu->Routes, (unsigned long)pdu->Count,
+               (pdu->Count > 0u) ? ((double)pdu->Ns / (double)pdu->Count) : 0.0, (unsigned long)pdu->MaxNs);
+    }
+    (void)CanLinGw_GetLatency(&latency);
+    printf("  all: %lu frames routed, %lu not routed, max %lu ns, %lu LIN responses wrong, %lu short frames\n",
+           (unsigned long)latency.Count, (unsigned long)lost,
+           (unsigned long)((latency.MaxCycles > clockCost) ? (latency.MaxCycles - clockCost) : 0u),
+           (unsigned long)mismatches, (unsigned long)latency.ShortFrames);
+
+    return ((lost == 0u) && (mismatches == 0u)) ? 0 : 1;
+}
@@ -0,0 +1,232 @@
+/**
+ * @file        CanLinGw_Test.c
+ * @author      Phuc
+ * @brief       Tests of the CAN to LIN gateway from the simulated bxCAN receive interrupt to the frames sent on the
+ *              simulated LIN bus
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Test.h"
+#include "CanLinGw_TestBus.h"
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+static CanLinGw_TestBus_SignalsType CanLinGw_Test_Signals;
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Sends every LIN frame of the gateway and checks its response against the signals
+ * @return      void
+ */
+static void CanLinGw_Test_CheckFrames(void)
+{
+    uint8 expected[8];
+    uint8 response[8];
+    uint8 length;
+    uint8 frame;
+
+    for (frame = 0u; frame < CANLINGW_TESTBUS_FRAMES; frame++)
+    {
+        length = CanLinGw_TestBus_Expected(&CanLinGw_Test_Signals, frame, expected);
+        TEST_CHECK_EQ(CanLinGw_TestBus_SendLin(frame, response), length);
+        TEST_CHECK(memcmp(response, expected, length) == 0);
+    }
+}
+
+/**
+ * @brief       Counts the frames left in the receive ring of controller 1 and empties it
+ * @param       LastId: Where the ID of the last frame is stored, untouched when the ring is empty
+ * @return      Number of frames
+ */
+static uint8 CanLinGw_Test_DrainRing(Can_IdType* LastId)
+{
+    const Can_RxFrameType *frame;
+    uint8 count = 0u;
+
+    while (Can_GetRxFrame(1u, &frame) == E_OK)
+    {
+        *LastId = frame->Pdu.id;
+        count++;
+        Can_ReleaseRxFrame(1u);
+    }
+
+    return count;
+}
+
+/**
+ * @brief       Every routed CAN frame reaches its LIN frame, none of them is left in the receive ring
+ * @return      void
+ */
+static void CanLinGw_Test_Routing(void)
+{
+    static const uint8 door[4][1] = {{0x11u}, {0x22u}, {0x33u}, {0x44u}};
+    static const uint8 climate[2] = {0xA5u, 0xFFu};
+    static const uint8 blower[3] = {0x00u, 0x00u, 0x13u};
+    static const uint8 light[3] = {0x5Au, 0xC3u, 0x0Fu};
+    CanLinGw_LatencyType latency;
+    Can_IdType id = 0u;
+    uint8 response[8];
+    uint8 i;
+
+    TEST_CHECK_EQ(CanLinGw_TestBus_Init(), E_OK);
+    (void)memset(&CanLinGw_Test_Signals, 0, sizeof(CanLinGw_Test_Signals));
+
+    /* Nothing routed yet, the frames carry zeros */
+    CanLinGw_Test_CheckFrames();
+
+    for (i = 0u; i < 4u; i++)
+    {
+        TEST_CHECK_EQ(CanLinGw_TestBus_SendCan(0x3A0u + i, door[i], 1u), E_OK);
+        CanLinGw_Test_Signals.Door[i] = door[i][0];
+    }
+    TEST_CHECK_EQ(CanLinGw_TestBus_SendCan(0x200u, climate, 2u), E_OK);
+    TEST_CHECK_EQ(CanLinGw_TestBus_SendCan(0x210u, blower, 3u), E_OK);
+    TEST_CHECK_EQ(CanLinGw_TestBus_SendCan(0x2F0u, light, 3u), E_OK);
+    (void)memcpy(CanLinGw_Test_Signals.Climate, climate, 2u);
+    CanLinGw_Test_Signals.Blower = blower[2];
+    (void)memcpy(CanLinGw_Test_Signals.Light, light, 3u);
+
+    CanLinGw_Test_CheckFrames();
+    TEST_CHECK_EQ(CanLinGw_TestBus_SendLin(1u, response), 2u);
+    TEST_CHECK_EQ(response[0], 0xFAu);
+    TEST_CHECK_EQ(response[1], 0x9Fu);
+
+    /* The drain and the gateway take no simulated time */
+    TEST_CHECK_EQ(CanLinGw_GetLatency(&latency), E_OK);
+    TEST_CHECK_EQ(latency.Count, 7u);
+    TEST_CHECK_EQ(latency.LastCycles, 0u);
+    TEST_CHECK_EQ(latency.MaxCycles, 0u);
+    TEST_CHECK_EQ(latency.ShortFrames, 0u);
+    TEST_CHECK_EQ(CanLinGw_Test_DrainRing(&id), 0u);
+}
+
+/**
+ * @brief       A CAN frame updates its own signals only, the rest of the LIN frame keeps its last value
+ * @return      void
+ */
+static void CanLinGw_Test_Update(void)
+{
+    static const uint8 climate[2] = {0x3Cu, 0x81u};
+    static const uint8 blower[3] = {0xFFu, 0xFFu, 0xEAu};
+    static const uint8 door[1] = {0x99u};
+    CanLinGw_LatencyType latency;
+
+    TEST_CHECK_EQ(CanLinGw_TestBus_Init(), E_OK);
+    (void)memset(&CanLinGw_Test_Signals, 0, sizeof(CanLinGw_Test_Signals));
+
+    TEST_CHECK_EQ(CanLinGw_TestBus_SendCan(0x210u, blower, 3u), E_OK);
+    CanLinGw_Test_Signals.Blower = blower[2];
+    CanLinGw_Test_CheckFrames();
+
+    TEST_CHECK_EQ(CanLinGw_TestBus_SendCan(0x200u, climate, 2u), E_OK);
+    (void)memcpy(CanLinGw_Test_Signals.Climate, climate, 2u);
+    CanLinGw_Test_CheckFrames();
+
+    /* The third door module and the climate signals again, each LIN frame is sent twice after it */
+    TEST_CHECK_EQ(CanLinGw_TestBus_SendCan(0x3A2u, door, 1u), E_OK);
+    CanLinGw_Test_Signals.Door[2] = door[0];
+    TEST_CHECK_EQ(CanLinGw_TestBus_SendCan(0x200u, blower, 2u), E_OK);
+    (void)memcpy(CanLinGw_Test_Signals.Climate, blower, 2u);
+    CanLinGw_Test_CheckFrames();
+    CanLinGw_Test_CheckFrames();
+
+    TEST_CHECK_EQ(CanLinGw_GetLatency(&latency), E_OK);
+    TEST_CHECK_EQ(latency.Count, 4u);
+}
+
+/**
+ * @brief       Routes the CAN frame is too short for are skipped and counted, a frame with none of its routes
+ *              applied is left in the receive ring, and so is a CAN frame without routes
+ * @return      void
+ */
+static void CanLinGw_Test_ShortAndUnrouted(void)
+{
+    static const uint8 climate[2] = {0xF0u, 0x7Fu};
+    static const uint8 data[8] = {1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u};
+    CanLinGw_LatencyType latency;
+    Can_IdType id = 0u;
+
+    TEST_CHECK_EQ(CanLinGw_TestBus_Init(), E_OK);
+    (void)memset(&CanLinGw_Test_Signals, 0, sizeof(CanLinGw_Test_Signals));
+
+    /* One byte of 0x200 carries bits 4-7 only, the 7 bits of its second byte stay at zero */
+    TEST_CHECK_EQ(CanLinGw_TestBus_SendCan(0x200u, climate, 1u), E_OK);
+    CanLinGw_Test_Signals.Climate[0] = climate[0];
+    CanLinGw_Test_CheckFrames();
+    TEST_CHECK_EQ(CanLinGw_GetLatency(&latency), E_OK);
+    TEST_CHECK_EQ(latency.Count, 1u);
+    TEST_CHECK_EQ(latency.ShortFrames, 1u);
+    TEST_CHECK_EQ(CanLinGw_Test_DrainRing(&id), 0u);
+
+    /* Two bytes of 0x210 do not reach the third one, nothing is routed */
+    TEST_CHECK_EQ(CanLinGw_TestBus_SendCan(0x210u, data, 2u), E_OK);
+    CanLinGw_Test_CheckFrames();
+    TEST_CHECK_EQ(CanLinGw_GetLatency(&latency), E_OK);
+    TEST_CHECK_EQ(latency.Count, 1u);
+    TEST_CHECK_EQ(latency.ShortFrames, 2u);
+    TEST_CHECK_EQ(CanLinGw_Test_DrainRing(&id), 1u);
+    TEST_CHECK_EQ(id, 0x210u);
+
+    /* 0x100 has no route */
+    TEST_CHECK_EQ(CanLinGw_TestBus_SendCan(0x100u, data, 8u), E_OK);
+    CanLinGw_Test_CheckFrames();
+    TEST_CHECK_EQ(CanLinGw_GetLatency(&latency), E_OK);
+    TEST_CHECK_EQ(latency.Count, 1u);
+    TEST_CHECK_EQ(CanLinGw_Test_DrainRing(&id), 1u);
+    TEST_CHECK_EQ(id, 0x100u);
+}
+
+/**
+ * @brief       Wrong arguments are refused, and CanLinGw_GetLatency() gives the interrupt mask back as it found it
+ * @return      void
+ */
+static void CanLinGw_Test_Parameters(void)
+{
+    CanLinGw_LatencyType latency;
+    uint8 response[8];
+
+    TEST_CHECK_EQ(CanLinGw_TestBus_Init(), E_OK);
+
+    TEST_CHECK_EQ(CanLinGw_SendFrame(CANLINGW_TESTBUS_FRAMES), E_NOT_OK);
+    TEST_CHECK_EQ(CanLinGw_TestBus_SendLin(CANLINGW_TESTBUS_FRAMES, response), 0u);
+    TEST_CHECK_EQ(CanLinGw_GetLatency(NULL_PTR), E_NOT_OK);
+    TEST_CHECK_EQ(CanLinGw_RxIndication(NULL_PTR, 0u), FALSE);
+
+    __set_PRIMASK(1u);
+    TEST_CHECK_EQ(CanLinGw_GetLatency(&latency), E_OK);
+    TEST_CHECK_EQ(__get_PRIMASK(), 1u);
+    __set_PRIMASK(0u);
+    TEST_CHECK_EQ(CanLinGw_GetLatency(&latency), E_OK);
+    TEST_CHECK_EQ(__get_PRIMASK(), 0u);
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+int main(void)
+{
+    TEST_RUN(CanLinGw_Test_Routing);
+    TEST_RUN(CanLinGw_Test_Update);
+    TEST_RUN(CanLinGw_Test_ShortAndUnrouted);
+    TEST_RUN(CanLinGw_Test_Parameters);
+
+    return Test_Summary();
+}
@@ -0,0 +1,147 @@
+/**
+ * @file        CanLinGw_TestBus.c
+ * @author      Phuc
+ * @brief       Simulated CAN and LIN buses around the CAN to LIN gateway, shared by its host test and benchmark
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "CanLinGw_TestBus.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define CANLINGW_TESTBUS_SYMBOLS_MAX    64u     /* Whole trace of a LIN bus */
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets both simulators, starts CAN nodes 0 and 1 with the gateway as RxGateway of the driver,
+ *              starts LIN channel 0 as an awake master and clears the gateway
+ * @param       void
+ * @return      E_OK when both CAN controllers reached CAN_CS_STARTED, E_NOT_OK otherwise
+ */
+Std_ReturnType CanLinGw_TestBus_Init(void)
+{
+    static Can_ConfigType config = CAN_TESTBUS_CONFIG_500K;
+    Lin_ConfigType lin = {CANLINGW_TESTBUS_LIN_CHANNEL, LIN_MODE_MASTER, NULL_PTR, 0u};
+    Std_ReturnType result;
+
+    config.RxGateway = CanLinGw_RxIndication;
+    result = Can_TestBus_Init(&config, 2u);
+
+    Lin_Sim_Init();
+    Lin_Init(&lin);
+    (void)Lin_WakeupInternal(CANLINGW_TESTBUS_LIN_CHANNEL);
+
+    CanLinGw_Init();
+
+    return result;
+}
+
+/**
+ * @brief       Sends a data frame from CAN node 0 and runs the CAN bus for 1 ms, long enough for node 1 to
+ *              receive it and hand it to the gateway
+ * @param       Id: CAN ID
+ * @param       Data: Data bytes
+ * @param       Length: Data length (0-8 bytes)
+ * @return      E_OK when Can_Write() accepted the frame
+ */
+Std_ReturnType CanLinGw_TestBus_SendCan(Can_IdType Id, const uint8* Data, uint8 Length)
+{
+    uint8 sdu[8] = {0u};
+    Can_PduType pdu = {0u, Length, Id, sdu};
+    Std_ReturnType result;
+
+    (void)memcpy(sdu, Data, Length);
+    result = Can_Write(0u, &pdu);
+    Can_TestBus_Run(CAN_TESTBUS_TICK_CYCLES);
+
+    return result;
+}
+
+/**
+ * @brief       Sends a gateway LIN frame with CanLinGw_SendFrame() and runs the LIN bus for 10 ms
+ * @param       Frame: Index of the LIN frame
+ * @param       Response: Where the response bytes seen on the bus are stored, 8 bytes
+ * @return      Number of response bytes seen on the bus without the checksum, 0 when the frame was refused
+ *              or did not end in LIN_TX_OK
+ */
+uint8 CanLinGw_TestBus_SendLin(uint8 Frame, uint8* Response)
+{
+    Lin_SimSymbolType bus[CANLINGW_TESTBUS_SYMBOLS_MAX];
+    const uint8 *sdu;
+    uint32 count;
+    uint32 i;
+
+    (void)Lin_Sim_ReadBus(CANLINGW_TESTBUS_LIN_BUS, bus, CANLINGW_TESTBUS_SYMBOLS_MAX);
+    if (CanLinGw_SendFrame(Frame) != E_OK)
+    {
+        return 0u;
+    }
+    Lin_Sim_Run(CANLINGW_TESTBUS_LIN_CYCLES);
+    if (Lin_GetStatus(CANLINGW_TESTBUS_LIN_CHANNEL, &sdu) != LIN_TX_OK)
+    {
+        return 0u;
+    }
+
+    /* Break, sync field and PID, then the response and its checksum */
+    count = Lin_Sim_ReadBus(CANLINGW_TESTBUS_LIN_BUS, bus, CANLINGW_TESTBUS_SYMBOLS_MAX);
+    if ((count < 5u) || (count > 12u))
+    {
+        return 0u;
+    }
+    for (i = 3u; (i + 1u) < count; i++)
+    {
+        Response[i - 3u] = bus[i].Value;
+    }
+
+    return (uint8)(count - 4u);
+}
+
+/**
+ * @brief       Builds the response a LIN frame must carry after the routed CAN frames, from the signal
+ *              layout of CanLinGw_Routes.txt rather than from the generated tables
+ * @param       Signals: Last data of the routed CAN frames
+ * @param       Frame: Index of the LIN frame
+ * @param       Response: Where the expected response is stored, 8 bytes
+ * @return      Response length
+ */
+uint8 CanLinGw_TestBus_Expected(const CanLinGw_TestBus_SignalsType* Signals, uint8 Frame, uint8* Response)
+{
+    uint16 climate;
+
+    switch (Frame)
+    {
+        case 0u:
+            /* 0x10: one byte of each door module */
+            (void)memcpy(Response, Signals->Door, 4u);
+            return 4u;
+
+        case 1u:
+            /* 0x20: 0x200 bits 4-7 at bit 0, 0x200 bits 8-14 at bit 4, 0x210 bits 16-20 at bit 11 */
+            climate = (uint16)((Signals->Climate[0] >> 4) | ((uint16)(Signals->Climate[1] & 0x7Fu) << 4) |
+                               ((uint16)(Signals->Blower & 0x1Fu) << 11));
+            Response[0] = (uint8)climate;
+            Response[1] = (uint8)(climate >> 8);
+            return 2u;
+
+        default:
+            /* 0x21: the first three bytes of 0x2F0 */
+            (void)memcpy(Response, Signals->Light, 3u);
+            return 3u;
+    }
+}
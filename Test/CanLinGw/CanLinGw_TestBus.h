@@ -0,0 +1,87 @@
+/**
+ * @file        CanLinGw_TestBus.h
+ * @author      Phuc
+ * @brief       Simulated CAN and LIN buses around the CAN to LIN gateway, shared by its host test and benchmark
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef CANLINGW_TESTBUS_H
+#define CANLINGW_TESTBUS_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Can_TestBus.h"
+#include "CanLinGw.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define CANLINGW_TESTBUS_LIN_CHANNEL    0u              /* LIN channel of every gateway frame */
+#define CANLINGW_TESTBUS_LIN_BUS        LIN_HW_USART2   /* Bus of LIN channel 0 */
+#define CANLINGW_TESTBUS_LIN_CYCLES     (CAN_TESTBUS_CPU_HZ / 100u)     /* 10 ms, longer than any LIN frame */
+#define CANLINGW_TESTBUS_FRAMES         3u              /* CANLINGW_FRAME_COUNT of CanLinGw_Cfg.h */
+
+/**
+ * @typedef     CanLinGw_TestBus_SignalsType
+ * @brief       Last data of the routed CAN frames, see CanLinGw_Routes.txt
+ */
+typedef struct
+{
+    uint8 Door[4];                          /* First byte of 0x3A0 to 0x3A3 */
+    uint8 Climate[2];                       /* First two bytes of 0x200 */
+    uint8 Blower;                           /* Third byte of 0x210 */
+    uint8 Light[3];                         /* First three bytes of 0x2F0 */
+} CanLinGw_TestBus_SignalsType;
+
+/*
+ ************************************************************************************************************
+ * Functions declaration
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets both simulators, starts CAN nodes 0 and 1 with the gateway as RxGateway of the driver,
+ *              starts LIN channel 0 as an awake master and clears the gateway
+ * @param       void
+ * @return      E_OK when both CAN controllers reached CAN_CS_STARTED, E_NOT_OK otherwise
+ */
+Std_ReturnType CanLinGw_TestBus_Init(void);
+
+/**
+ * @brief       Sends a data frame from CAN node 0 and runs the CAN bus for 1 ms, long enough for node 1 to
+ *              receive it and hand it to the gateway
+ * @param       Id: CAN ID
+ * @param       Data: Data bytes
+ * @param       Length: Data length (0-8 bytes)
+ * @return      E_OK when Can_Write() accepted the frame
+ */
+Std_ReturnType CanLinGw_TestBus_SendCan(Can_IdType Id, const uint8* Data, uint8 Length);
+
+/**
+ * @brief       Sends a gateway LIN frame with CanLinGw_SendFrame() and runs the LIN bus for 10 ms
+ * @param       Frame: Index of the LIN frame
+ * @param       Response: Where the response bytes seen on the bus are stored, 8 bytes
+ * @return      Number of response bytes seen on the bus without the checksum, 0 when the frame was refused
+ *              or did not end in LIN_TX_OK
+ */
+uint8 CanLinGw_TestBus_SendLin(uint8 Frame, uint8* Response);
+
+/**
+ * @brief       Builds the response a LIN frame must carry after the routed CAN frames, from the signal
+ *              layout of CanLinGw_Routes.txt rather than from the generated tables
+ * @param       Signals: Last data of the routed CAN frames
+ * @param       Frame: Index of the LIN frame
+ * @param       Response: Where the expected response is stored, 8 bytes
+ * @return      Response length
+ */
+uint8 CanLinGw_TestBus_Expected(const CanLinGw_TestBus_SignalsType* Signals, uint8 Frame, uint8* Response);
+
+#endif /* CANLINGW_TESTBUS_H */
@@ -0,0 +1,189 @@
+/**
+ * @file        Lin_BenchChecksum.c
+ * @author      Phuc
+ * @brief       Benchmark of the LIN checksum and protected identifier versus the byte loop and the parity
+ *              computed bit by bit
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Test.h"
+
+/* Compiled together with the driver, for Lin_Checksum() and Lin_PidTable */
+#include "Lin.c"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define LIN_BENCH_RESPONSES         256u    /* Responses checked in turn, so that no result can be hoisted */
+#define LIN_BENCH_REPEAT            2000u   /* Rounds over the responses per measurement */
+#define LIN_BENCH_PASSES            5u      /* Measurements of each variant, interleaved, the fastest is kept */
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+static uint8 Lin_Bench_Data[LIN_BENCH_RESPONSES][8];
+static volatile uint8 Lin_Bench_Sink;
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Checksum of the driver before the word loads: one addition and one carry test per byte
+ * @param       Data: Response
+ * @param       Dl: Response length (1-8 bytes)
+ * @param       Seed: PID for the enhanced checksum, 0 for the classic one
+ * @return      Inverted sum with carry
+ */
+static uint8 Lin_Bench_ChecksumBytes(const uint8* Data, uint8 Dl, uint8 Seed)
+{
+    uint16 checksum = Seed;
+    uint8 i;
+
+    for (i = 0u; i < Dl; i++)
+    {
+        checksum += Data[i];
+        if (checksum > 0xFFu)
+        {
+            checksum -= 0xFFu;
+        }
+    }
+
+    return (uint8)~checksum;
+}
+
+/**
+ * @brief       Protected identifier of the driver before Lin_PidTable: both parity bits computed from the ID
+ * @param       Id: Frame identifier (0..0x3F)
+ * @return      Identifier with its parity bits
+ */
+static uint8 Lin_Bench_PidBits(uint8 Id)
+{
+    uint8 p0 = (uint8)(((Id >> 0) ^ (Id >> 1) ^ (Id >> 2) ^ (Id >> 4)) & 1u);
+    uint8 p1 = (uint8)(~((Id >> 1) ^ (Id >> 3) ^ (Id >> 4) ^ (Id >> 5)) & 1u);
+
+    return (uint8)(Id | (p0 << 6) | (p1 << 7));
+}
+
+/**
+ * @brief       Times one pass of a checksum over every response
+ * @param       Words: TRUE for Lin_Checksum(), FALSE for the byte loop
+ * @param       Dl: Response length
+ * @return      Nanoseconds of the pass
+ */
+static uint64 Lin_Bench_TimeChecksum(uint8 Words, uint8 Dl)
+{
+    uint64 start = Test_Nanoseconds();
+    uint32 round;
+    uint32 i;
+    uint8 acc = 0u;
+
+    for (round = 0u; round < LIN_BENCH_REPEAT; round++)
+    {
+        for (i = 0u; i < LIN_BENCH_RESPONSES; i++)
+        {
+            if (Words == TRUE)
+            {
+                acc ^= Lin_Checksum(Lin_Bench_Data[i], Dl, Lin_PidTable[i & 0x3Fu]);
+            }
+            else
+            {
+                acc ^= Lin_Bench_ChecksumBytes(Lin_Bench_Data[i], Dl, Lin_PidTable[i & 0x3Fu]);
+            }
+        }
+    }
+    Lin_Bench_Sink = acc;
+
+    return Test_Nanoseconds() - start;
+}
+
+/**
+ * @brief       Times one pass of a protected identifier over every ID
+ * @param       Table: TRUE for Lin_PidTable, FALSE for the parity bits
+ * @return      Nanoseconds of the pass
+ */
+static uint64 Lin_Bench_TimePid(uint8 Table)
+{
+    uint64 start = Test_Nanoseconds();
+    uint32 round;
+    uint32 i;
+    uint8 acc = 0u;
+
+    for (round = 0u; round < LIN_BENCH_REPEAT; round++)
+    {
+        for (i = 0u; i < LIN_BENCH_RESPONSES; i++)
+        {
+            acc ^= (Table == TRUE) ? Lin_PidTable[(i ^ acc) & 0x3Fu] : Lin_Bench_PidBits((uint8)((i ^ acc) & 0x3Fu));
+        }
+    }
+    Lin_Bench_Sink = acc;
+
+    return Test_Nanoseconds() - start;
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+int main(void)
+{
+    const double calls = (double)LIN_BENCH_REPEAT * (double)LIN_BENCH_RESPONSES;
+    uint64 best[2];
+    uint64 ns;
+    uint32 pass;
+    uint32 i;
+    uint8 variant;
+    uint8 dl;
+
+    for (i = 0u; i < (LIN_BENCH_RESPONSES * 8u); i++)
+    {
+        Lin_Bench_Data[i / 8u][i % 8u] = (uint8)((i * 167u) + 13u);
+    }
+
+    printf("LIN enhanced checksum, host nanoseconds per call\n");
+    printf("  Dl   byte loop   word loads\n");
+    for (dl = 1u; dl <= 8u; dl++)
+    {
+        best[0] = ~(uint64)0u;
+        best[1] = ~(uint64)0u;
+        for (pass = 0u; pass < LIN_BENCH_PASSES; pass++)
+        {
+            for (variant = 0u; variant < 2u; variant++)
+            {
+                ns = Lin_Bench_TimeChecksum(variant, dl);
+                best[variant] = (ns < best[variant]) ? ns : best[variant];
+            }
+        }
+        printf("  %2u   %9.2f   %10.2f\n", (unsigned)dl, (double)best[0] / calls, (double)best[1] / calls);
+    }
+
+    best[0] = ~(uint64)0u;
+    best[1] = ~(uint64)0u;
+    for (pass = 0u; pass < LIN_BENCH_PASSES; pass++)
+    {
+        for (variant = 0u; variant < 2u; variant++)
+        {
+            ns = Lin_Bench_TimePid(variant);
+            best[variant] = (ns < best[variant]) ? ns : best[variant];
+        }
+    }
+    printf("LIN protected identifier: parity bits %.2f ns, Lin_PidTable %.2f ns\n", (double)best[0] / calls,
+           (double)best[1] / calls);
+
+    return 0;
+}
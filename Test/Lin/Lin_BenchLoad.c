@@ -0,0 +1,221 @@
+/**
+ * @file        Lin_BenchLoad.c
+ * @author      Phuc
+ * @brief       Benchmark of the interrupts and the CPU time per frame of the LIN driver with 1, 2 and 4 channels
+ *              sending frames at the same time
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Test.h"
+
+/**
+ * @brief       Cycle counter of the driver, routed to the host clock
+ * @details     DWT CYCCNT of the simulator follows the simulated time, which does not advance while the driver
+ *              runs, so Lin_GetCpuTime() would report 0. Lin.c is compiled into this file with its reads of the
+ *              cycle counter replaced by the host clock: LastCycles and MaxCycles are then host nanoseconds.
+ *              The response deadline is timed on the host clock too, the few microseconds a response takes
+ *              here stay far under it.
+ *              Lin_Hw.h is included first, its include guard keeps the inline function itself out of the
+ *              replacement.
+ */
+#include "Lin_Hw.h"
+
+#define Lin_Hw_GetCycles()          ((uint32)Test_Nanoseconds())
+
+#include "Lin.c"
+
+#undef Lin_Hw_GetCycles
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define LIN_BENCH_FRAMES            200u    /* Frames of each channel, TX and RX in turn */
+#define LIN_BENCH_STEP              4165u   /* One bit at 19200 baud in CPU cycles, the frames are polled this often */
+#define LIN_BENCH_NS_PER_CYCLE      12.5    /* Simulated CPU at 80 MHz */
+#define LIN_BENCH_ENTRY_EXIT_CYCLES 24u     /* Cortex-M4 exception entry and return without FP context, 12 each */
+
+/**
+ * @typedef     Lin_Bench_ChannelType
+ * @brief       Frames of a channel over a run
+ */
+typedef struct
+{
+    uint32 Sent;                            /* Frames started */
+    uint32 Done;                            /* Frames completed, seen through Lin_GetCpuTime() */
+    uint32 Interrupts;                      /* Sum of Interrupts of the completed frames */
+    uint64 Ns;                              /* Sum of LastCycles of the completed frames, without the clock reads */
+    uint32 Errors;                          /* Frames not ending in LIN_TX_OK or LIN_RX_OK */
+    uint64 BusCycles;                       /* Simulated time from the first frame to the end of the last one */
+} Lin_Bench_ChannelType;
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+static uint8 Lin_Bench_Sdu[8] = {0x01u, 0x23u, 0x45u, 0x67u, 0x89u, 0xABu, 0xCDu, 0xEFu};
+static uint64 Lin_Bench_ClockCost;
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets the simulator and initializes the channels as masters, each one on its own bus with a node
+ *              answering its RX frame
+ * @param       Channels: Number of channels, from channel 0
+ * @return      void
+ */
+static void Lin_Bench_Start(uint8 Channels)
+{
+    Lin_ConfigType config = {0u, LIN_MODE_MASTER, NULL_PTR, 0u};
+    uint8 response[9];
+    uint8 ch;
+
+    Lin_Sim_Init();
+    for (ch = 0u; ch < MAX_LIN_CHANNELS; ch++)
+    {
+        LinChannelState[ch] = LIN_NOT_OK;
+    }
+
+    memcpy(response, Lin_Bench_Sdu, 8u);
+    for (ch = 0u; ch < Channels; ch++)
+    {
+        config.Lin_Channel = ch;
+        Lin_Init(&config);
+        (void)Lin_WakeupInternal(ch);
+        memset(&Lin_CpuTime[ch], 0, sizeof(Lin_CpuTime[ch]));
+
+        response[8] = Lin_Checksum(response, 8u, LIN_PID(0x20u + ch));
+        Lin_Sim_SetResponse(LinChannelConfig[ch].Lin_HwUnit, 0x20u + ch, response, 9u);
+    }
+}
+
+/**
+ * @brief       Sends LIN_BENCH_FRAMES frames of 8 bytes on each channel, back to back, and adds up what
+ *              Lin_GetCpuTime() reports after each one
+ * @param       Channels: Number of channels sending at the same time
+ * @param       Stats: Totals of each channel
+ * @return      void
+ */
+static void Lin_Bench_Run(uint8 Channels, Lin_Bench_ChannelType* Stats)
+{
+    Lin_PduType pdu = {0u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_TX, 8u, Lin_Bench_Sdu};
+    Lin_CpuTimeType cpu;
+    const uint8 *sdu;
+    Lin_StatusType status;
+    uint64 start;
+    uint8 busy = TRUE;
+    uint8 ch;
+
+    Lin_Bench_Start(Channels);
+    memset(Stats, 0, Channels * sizeof(Lin_Bench_ChannelType));
+    start = Lin_Sim_GetTime();
+
+    while (busy == TRUE)
+    {
+        busy = FALSE;
+        for (ch = 0u; ch < Channels; ch++)
+        {
+            if (Lin_Frame[ch].Phase != LIN_FRAME_IDLE)
+            {
+                busy = TRUE;
+                continue;
+            }
+
+            (void)Lin_GetCpuTime(ch, &cpu);
+            if (cpu.Count > Stats[ch].Done)
+            {
+                status = Lin_GetStatus(ch, &sdu);
+                Stats[ch].Errors += ((status == LIN_TX_OK) || (status == LIN_RX_OK)) ? 0u : 1u;
+                Stats[ch].Done = cpu.Count;
+                Stats[ch].Interrupts += cpu.Interrupts;
+                Stats[ch].Ns += cpu.LastCycles - ((uint64)cpu.Interrupts + 1u) * Lin_Bench_ClockCost;
+                Stats[ch].BusCycles = Lin_Sim_GetTime() - start;
+            }
+
+            if (Stats[ch].Sent < LIN_BENCH_FRAMES)
+            {
+                pdu.Pid = 0x20u + ch;
+                pdu.Drc = ((Stats[ch].Sent & 1u) == 0u) ? LIN_FRAMERESPONSE_TX : LIN_FRAMERESPONSE_RX;
+                (void)Lin_SendFrame(ch, &pdu);
+                Stats[ch].Sent++;
+                busy = TRUE;
+            }
+        }
+        Lin_Sim_Run(LIN_BENCH_STEP);
+    }
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+int main(void)
+{
+    static const uint8 counts[3] = {1u, 2u, 4u};
+    Lin_Bench_ChannelType stats[MAX_LIN_CHANNELS];
+    double busNs;
+    double rate;
+    double hostShare;
+    double totalRate;
+    double totalHostShare;
+    uint64 start;
+    uint8 run;
+    uint8 ch;
+    uint32 i;
+
+    /* Cost of reading the host clock, taken off every interval timed by the driver */
+    Lin_Bench_ClockCost = ~(uint64)0u;
+    for (i = 0u; i < 100u; i++)
+    {
+        start = Test_Nanoseconds();
+        start = Test_Nanoseconds() - start;
+        Lin_Bench_ClockCost = (start < Lin_Bench_ClockCost) ? start : Lin_Bench_ClockCost;
+    }
+
+    printf("LIN frames of 8 bytes, TX and RX in turn, back to back on every channel\n");
+    printf("Interrupts are counted by the driver. Host time is the x86 time of Lin_SendFrame() and the handlers,\n");
+    printf("as Lin_GetCpuTime() reports it here, over the simulated bus time: it does not predict the target.\n");
+    printf("Target entry/exit is the exception entry and return alone at 80 MHz, %u cycles per interrupt.\n",
+           (unsigned)LIN_BENCH_ENTRY_EXIT_CYCLES);
+    for (run = 0u; run < 3u; run++)
+    {
+        Lin_Bench_Run(counts[run], stats);
+        totalRate = 0.0;
+        totalHostShare = 0.0;
+
+        printf("%u channel%s:\n", (unsigned)counts[run], (counts[run] > 1u) ? "s" : "");
+        for (ch = 0u; ch < counts[run]; ch++)
+        {
+            busNs = (double)stats[ch].BusCycles * LIN_BENCH_NS_PER_CYCLE;
+            rate = (double)stats[ch].Interrupts * 1e9 / busNs;
+            hostShare = (double)stats[ch].Ns * 100.0 / busNs;
+            printf("  channel %u (%-6s %5lu baud): %3lu frames, %lu errors, %.2f interrupts/frame, "
+                   "%5.1f interrupts/s, host %6.1f ns/frame = %.4f %% of bus time\n",
+                   (unsigned)ch, (ch == 0u) ? "USART2" : (ch == 1u) ? "USART1" : (ch == 2u) ? "USART3" : "UART4",
+                   (unsigned long)LinChannelConfig[ch].Lin_BaudRate, (unsigned long)stats[ch].Done,
+                   (unsigned long)stats[ch].Errors, (double)stats[ch].Interrupts / (double)stats[ch].Done,
+                   rate, (double)stats[ch].Ns / (double)stats[ch].Done, hostShare);
+            totalRate += rate;
+            totalHostShare += hostShare;
+        }
+        printf("  all channels: %.1f interrupts/s, target entry/exit %.4f %% of the CPU, host %.4f %% of bus time\n",
+               totalRate, totalRate * LIN_BENCH_ENTRY_EXIT_CYCLES * LIN_BENCH_NS_PER_CYCLE * 1e-7, totalHostShare);
+    }
+
+    return 0;
+}
@@ -0,0 +1,657 @@
+/**
+ * @file        Lin_Test.c
+ * @author      Phuc
+ * @brief       Tests of the LIN driver on the simulated USARTs and buses
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Test.h"
+
+/* Compiled together with the driver, for its checksum and PID table */
+#include "Lin.c"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define LIN_TEST_MASTER             0u      /* LIN channel 0, USART2 */
+#define LIN_TEST_SLAVE              1u      /* LIN channel 1, USART1 */
+#define LIN_TEST_BUS                LIN_HW_USART2   /* Bus of the master, the slave is moved onto it */
+#define LIN_TEST_BIT_CYCLES         4165u   /* One bit at 19200 baud with BRR = 833, in CPU cycles */
+#define LIN_TEST_FRAME_CYCLES       (200u * LIN_TEST_BIT_CYCLES)    /* Longer than any frame and its timeout */
+#define LIN_TEST_SYMBOLS_MAX        64u     /* Whole trace of a bus */
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+static uint32 Lin_Test_Random = 1u;
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Returns a pseudo random byte
+ * @return      Next value of a linear congruential generator
+ */
+static uint8 Lin_Test_NextRandom(void)
+{
+    Lin_Test_Random = (Lin_Test_Random * 1103515245u) + 12345u;
+    return (uint8)(Lin_Test_Random >> 16);
+}
+
+/**
+ * @brief       Reference checksum: adds the seed and the bytes one by one, subtracting 255 on every carry
+ * @param       Data: Response
+ * @param       Dl: Response length (1-8 bytes)
+ * @param       Seed: PID for the enhanced checksum, 0 for the classic one
+ * @return      Inverted sum with carry
+ */
+static uint8 Lin_Test_ChecksumBytes(const uint8* Data, uint8 Dl, uint8 Seed)
+{
+    uint32 sum = Seed;
+    uint8 i;
+
+    for (i = 0u; i < Dl; i++)
+    {
+        sum += Data[i];
+        if (sum > 0xFFu)
+        {
+            sum -= 0xFFu;
+        }
+    }
+
+    return (uint8)~sum;
+}
+
+/**
+ * @brief       Reference protected identifier, bit by bit as in LIN 2.2A section 2.3.1.3
+ * @param       Id: Frame identifier (0..0x3F)
+ * @return      Identifier with its parity bits
+ */
+static uint8 Lin_Test_Pid(uint8 Id)
+{
+    uint8 bit[6];
+    uint8 p0;
+    uint8 p1;
+    uint8 i;
+
+    for (i = 0u; i < 6u; i++)
+    {
+        bit[i] = (uint8)((Id >> i) & 1u);
+    }
+    p0 = (uint8)(bit[0] ^ bit[1] ^ bit[2] ^ bit[4]);
+    p1 = (uint8)((bit[1] ^ bit[3] ^ bit[4] ^ bit[5]) ^ 1u);
+
+    return (uint8)(Id | (p0 << 6) | (p1 << 7));
+}
+
+/**
+ * @brief       Initializes one more channel, awake
+ * @param       Channel: LIN channel to initialize
+ * @param       Mode: LIN_MODE_MASTER or LIN_MODE_SLAVE
+ * @param       Frames: Slave frames, NULL_PTR for a master
+ * @param       Count: Number of slave frames
+ * @return      void
+ */
+static void Lin_Test_Init(uint8 Channel, uint32 Mode, const Lin_PduType* Frames, uint8 Count)
+{
+    Lin_ConfigType config;
+
+    config.Lin_Channel = Channel;
+    config.Lin_Mode = Mode;
+    config.Lin_SlaveFrames = Frames;
+    config.Lin_SlaveFrameCount = Count;
+    Lin_Init(&config);
+    (void)Lin_WakeupInternal(Channel);
+}
+
+/**
+ * @brief       Resets the simulator and every channel, then initializes a channel
+ * @param       Channel: LIN channel to initialize
+ * @param       Mode: LIN_MODE_MASTER or LIN_MODE_SLAVE
+ * @param       Frames: Slave frames, NULL_PTR for a master
+ * @param       Count: Number of slave frames
+ * @return      void
+ */
+static void Lin_Test_Start(uint8 Channel, uint32 Mode, const Lin_PduType* Frames, uint8 Count)
+{
+    uint8 ch;
+
+    Lin_Sim_Init();
+    for (ch = 0u; ch < MAX_LIN_CHANNELS; ch++)
+    {
+        LinChannelState[ch] = LIN_NOT_OK;
+        Lin_SlaveFrames[ch] = NULL_PTR;
+    }
+    Lin_Test_Random = 1u;
+
+    Lin_Test_Init(Channel, Mode, Frames, Count);
+}
+
+/**
+ * @brief       Sends a frame from the master channel and runs the bus until it has ended
+ * @param       Id: Frame identifier
+ * @param       Cs: Checksum model
+ * @param       Drc: Direction of the response
+ * @param       Sdu: Response of a TX frame
+ * @param       Dl: Response length
+ * @return      Channel status at the end
+ */
+static Lin_StatusType Lin_Test_Frame(uint8 Id, Lin_FrameCsModelType Cs, Lin_FrameResponseType Drc, uint8* Sdu,
+                                     uint8 Dl)
+{
+    Lin_PduType pdu = {Id, Cs, Drc, Dl, Sdu};
+    const uint8 *sdu;
+
+    TEST_CHECK_EQ(Lin_SendFrame(LIN_TEST_MASTER, &pdu), E_OK);
+    Lin_Sim_Run(LIN_TEST_FRAME_CYCLES);
+
+    return Lin_GetStatus(LIN_TEST_MASTER, &sdu);
+}
+
+/**
+ * @brief       The enhanced checksum example of LIN 2.2A section 2.8.3: PID 0x4A, data 55 93 E5, checksum E6
+ * @return      void
+ */
+static void Lin_Test_ChecksumVector(void)
+{
+    uint8 data[8] = {0x55u, 0x93u, 0xE5u, 0xAAu, 0xAAu, 0xAAu, 0xAAu, 0xAAu};
+
+    TEST_CHECK_EQ(Lin_Checksum(data, 3u, 0x4Au), 0xE6u);
+    TEST_CHECK_EQ(Lin_Test_ChecksumBytes(data, 3u, 0x4Au), 0xE6u);
+
+    /* Classic checksum of the same data: 0x55 + 0x93 + 0xE5 = 0x1CD, 0xCE with the carry, inverted 0x31 */
+    TEST_CHECK_EQ(Lin_Checksum(data, 3u, 0u), 0x31u);
+}
+
+/**
+ * @brief       The parity bits of all 64 frame identifiers, in Lin_PidTable and LIN_PID()
+ * @return      void
+ */
+static void Lin_Test_PidParity(void)
+{
+    uint8 id;
+
+    for (id = 0u; id < 64u; id++)
+    {
+        TEST_CHECK_EQ(Lin_PidTable[id], Lin_Test_Pid(id));
+        TEST_CHECK_EQ(LIN_PID(id), Lin_Test_Pid(id));
+    }
+
+    /* Identifiers of LIN 2.2A Table 2.4 */
+    TEST_CHECK_EQ(Lin_PidTable[0x00u], 0x80u);
+    TEST_CHECK_EQ(Lin_PidTable[0x3Cu], 0x3Cu);
+    TEST_CHECK_EQ(Lin_PidTable[0x3Du], 0x7Du);
+}
+
+/**
+ * @brief       The word checksum against the byte loop: every length, classic and every enhanced seed, every
+ *              alignment, random data and the largest sums
+ * @return      void
+ */
+static void Lin_Test_ChecksumByteLoop(void)
+{
+    uint8 buffer[16];
+    uint32 mismatches = 0u;
+    uint32 round;
+    uint8 offset;
+    uint8 dl;
+    uint8 id;
+    uint8 seed;
+    uint8 i;
+
+    for (round = 0u; round < 64u; round++)
+    {
+        for (i = 0u; i < sizeof(buffer); i++)
+        {
+            buffer[i] = (round == 0u) ? 0xFFu : Lin_Test_NextRandom();
+        }
+        for (offset = 0u; offset < 8u; offset++)
+        {
+            for (dl = 1u; dl <= 8u; dl++)
+            {
+                for (id = 0u; id <= 64u; id++)
+                {
+                    seed = (id == 64u) ? 0u : Lin_PidTable[id];
+                    if (Lin_Checksum(&buffer[offset], dl, seed) != Lin_Test_ChecksumBytes(&buffer[offset], dl, seed))
+                    {
+                        mismatches++;
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_CHECK_EQ(mismatches, 0u);
+}
+
+/**
+ * @brief       A TX frame of the master: break, sync, PID, response and enhanced checksum on the bus, two
+ *              interrupts
+ * @return      void
+ */
+static void Lin_Test_MasterTx(void)
+{
+    uint8 sdu[8] = {0x01u, 0x23u, 0x45u, 0x67u, 0x89u, 0xABu, 0xCDu, 0xEFu};
+    Lin_SimSymbolType bus[LIN_TEST_SYMBOLS_MAX];
+    Lin_CpuTimeType cpu;
+    uint8 i;
+
+    Lin_Test_Start(LIN_TEST_MASTER, LIN_MODE_MASTER, NULL_PTR, 0u);
+
+    TEST_CHECK_EQ(Lin_Test_Frame(0x10u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_TX, sdu, 8u), LIN_TX_OK);
+    TEST_CHECK_EQ(Lin_Sim_ReadBus(LIN_TEST_BUS, bus, LIN_TEST_SYMBOLS_MAX), 12u);
+    TEST_CHECK_EQ(bus[0].Break, TRUE);
+    TEST_CHECK_EQ(bus[1].Value, SYNC_FIELD);
+    TEST_CHECK_EQ(bus[2].Value, LIN_PID(0x10u));
+    for (i = 0u; i < 8u; i++)
+    {
+        TEST_CHECK_EQ(bus[3u + i].Value, sdu[i]);
+    }
+    TEST_CHECK_EQ(bus[11].Value, Lin_Test_ChecksumBytes(sdu, 8u, LIN_PID(0x10u)));
+
+    TEST_CHECK_EQ(Lin_GetCpuTime(LIN_TEST_MASTER, &cpu), E_OK);
+    TEST_CHECK_EQ(cpu.Count, 1u);
+    TEST_CHECK_EQ(cpu.Interrupts, 2u);
+}
+
+/**
+ * @brief       An RX frame of the master answered by a node on the bus: the response is returned once its
+ *              checksum is verified, three interrupts
+ * @return      void
+ */
+static void Lin_Test_MasterRx(void)
+{
+    uint8 response[5] = {0x11u, 0x22u, 0x33u, 0x44u, 0x00u};
+    const uint8 *sdu;
+    Lin_CpuTimeType cpu;
+
+    Lin_Test_Start(LIN_TEST_MASTER, LIN_MODE_MASTER, NULL_PTR, 0u);
+    response[4] = Lin_Test_ChecksumBytes(response, 4u, LIN_PID(0x20u));
+    Lin_Sim_SetResponse(LIN_TEST_BUS, 0x20u, response, 5u);
+
+    TEST_CHECK_EQ(Lin_Test_Frame(0x20u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_RX, NULL_PTR, 4u), LIN_RX_OK);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_MASTER, &sdu), LIN_RX_OK);
+    TEST_CHECK(sdu != NULL_PTR);
+    if (sdu != NULL_PTR)
+    {
+        TEST_CHECK(memcmp(sdu, response, 4u) == 0);
+    }
+
+    TEST_CHECK_EQ(Lin_GetCpuTime(LIN_TEST_MASTER, &cpu), E_OK);
+    TEST_CHECK_EQ(cpu.Interrupts, 3u);
+}
+
+/**
+ * @brief       The ends of an RX frame other than a correct response: busy while it arrives, no response, a
+ *              wrong checksum and a short response
+ * @return      void
+ */
+static void Lin_Test_MasterRxErrors(void)
+{
+    uint8 response[5] = {0x11u, 0x22u, 0x33u, 0x44u, 0x00u};
+    Lin_PduType pdu = {0x21u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, 4u, NULL_PTR};
+    const uint8 *sdu;
+
+    Lin_Test_Start(LIN_TEST_MASTER, LIN_MODE_MASTER, NULL_PTR, 0u);
+
+    /* Silence after the header */
+    TEST_CHECK_EQ(Lin_Test_Frame(0x21u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, NULL_PTR, 4u), LIN_RX_NO_RESPONSE);
+
+    /* Busy from the first byte on: header of 34 bits, then one byte and a half */
+    response[4] = Lin_Test_ChecksumBytes(response, 4u, 0u);
+    Lin_Sim_SetResponse(LIN_TEST_BUS, 0x21u, response, 5u);
+    TEST_CHECK_EQ(Lin_SendFrame(LIN_TEST_MASTER, &pdu), E_OK);
+    Lin_Sim_Run(40u * LIN_TEST_BIT_CYCLES);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_MASTER, &sdu), LIN_RX_NO_RESPONSE);
+    Lin_Sim_Run(9u * LIN_TEST_BIT_CYCLES);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_MASTER, &sdu), LIN_RX_BUSY);
+    TEST_CHECK(sdu == NULL_PTR);
+    Lin_Sim_Run(LIN_TEST_FRAME_CYCLES);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_MASTER, &sdu), LIN_RX_OK);
+
+    /* Wrong checksum */
+    response[4] ^= 0x01u;
+    Lin_Sim_SetResponse(LIN_TEST_BUS, 0x21u, response, 5u);
+    TEST_CHECK_EQ(Lin_Test_Frame(0x21u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, NULL_PTR, 4u), LIN_RX_ERROR);
+
+    /* Two bytes, then the receiver timeout */
+    Lin_Sim_SetResponse(LIN_TEST_BUS, 0x21u, response, 2u);
+    TEST_CHECK_EQ(Lin_Test_Frame(0x21u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, NULL_PTR, 4u), LIN_RX_ERROR);
+}
+
+/**
+ * @brief       A slow slave whose byte gaps stay under the receiver timeout: a response ending within
+ *              TResponse_Maximum is taken, a longer one is an error, and polling cuts it off at its deadline
+ * @return      void
+ */
+static void Lin_Test_MasterRxSlow(void)
+{
+    uint8 response[5] = {0x11u, 0x22u, 0x33u, 0x44u, 0x00u};
+    Lin_PduType pdu = {0x21u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, 4u, NULL_PTR};
+    Lin_SimSymbolType bus[LIN_TEST_SYMBOLS_MAX];
+    const uint8 *sdu;
+    Lin_StatusType status;
+    uint32 bits;
+
+    Lin_Test_Start(LIN_TEST_MASTER, LIN_MODE_MASTER, NULL_PTR, 0u);
+    response[4] = Lin_Test_ChecksumBytes(response, 4u, 0u);
+    Lin_Sim_SetResponse(LIN_TEST_BUS, 0x21u, response, 5u);
+
+    /* 5 bytes of 13 bits: 65 bits, within the 70 bits of TResponse_Maximum */
+    Lin_Sim_SetResponseGap(LIN_TEST_BUS, 3u);
+    TEST_CHECK_EQ(Lin_Test_Frame(0x21u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, NULL_PTR, 4u), LIN_RX_OK);
+
+    /* 5 bytes of 22 bits: 110 bits, and every gap of 12 bits far under the 70 bits of the receiver timeout */
+    Lin_Sim_SetResponseGap(LIN_TEST_BUS, 12u);
+    TEST_CHECK_EQ(Lin_Test_Frame(0x21u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, NULL_PTR, 4u), LIN_RX_ERROR);
+
+    /* Polled once per bit, the response is cut off after its 70 bits, before its fourth byte has ended */
+    (void)Lin_Sim_ReadBus(LIN_TEST_BUS, bus, LIN_TEST_SYMBOLS_MAX);
+    TEST_CHECK_EQ(Lin_SendFrame(LIN_TEST_MASTER, &pdu), E_OK);
+    status = LIN_TX_BUSY;
+    for (bits = 0u; (bits < 200u) && ((status == LIN_TX_BUSY) || (status == LIN_RX_NO_RESPONSE) ||
+                                      (status == LIN_RX_BUSY)); bits++)
+    {
+        Lin_Sim_Run(LIN_TEST_BIT_CYCLES);
+        status = Lin_GetStatus(LIN_TEST_MASTER, &sdu);
+    }
+    TEST_CHECK_EQ(status, LIN_RX_ERROR);
+    TEST_CHECK(sdu == NULL_PTR);
+    TEST_CHECK_EQ(Lin_Sim_ReadBus(LIN_TEST_BUS, bus, LIN_TEST_SYMBOLS_MAX), 6u);
+
+    /* The rest of the response is ignored, the next frame is taken */
+    Lin_Sim_Run(LIN_TEST_FRAME_CYCLES);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_MASTER, &sdu), LIN_RX_ERROR);
+    Lin_Sim_SetResponseGap(LIN_TEST_BUS, 0u);
+    TEST_CHECK_EQ(Lin_Test_Frame(0x21u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, NULL_PTR, 4u), LIN_RX_OK);
+}
+
+/**
+ * @brief       A byte read back different from the byte sent: in the break or the PID it is a header error, in
+ *              the response a response error, reported before the last byte has left the USART
+ * @return      void
+ */
+static void Lin_Test_Readback(void)
+{
+    uint8 sdu[8] = {0x01u, 0x02u, 0x03u, 0x04u, 0x05u, 0x06u, 0x07u, 0x08u};
+    Lin_PduType pdu = {0x05u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_TX, 8u, sdu};
+    const uint8 *data;
+    uint32 bits;
+    Lin_SimSymbolType bus[LIN_TEST_SYMBOLS_MAX];
+    Lin_ReadbackErrorType errors;
+
+    Lin_Test_Start(LIN_TEST_MASTER, LIN_MODE_MASTER, NULL_PTR, 0u);
+
+    /* Break read back as a byte */
+    Lin_Sim_CorruptSymbol(LIN_TEST_BUS, 0u, 0xF0u);
+    TEST_CHECK_EQ(Lin_Test_Frame(0x05u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_TX, sdu, 8u), LIN_TX_HEADER_ERROR);
+
+    /* PID overwritten by another node */
+    Lin_Sim_CorruptSymbol(LIN_TEST_BUS, 2u, 0x00u);
+    TEST_CHECK_EQ(Lin_Test_Frame(0x05u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_TX, sdu, 8u), LIN_TX_HEADER_ERROR);
+
+    /* Second data byte, caught when the last byte is handed to the USART, before the frame has ended */
+    (void)Lin_Sim_ReadBus(LIN_TEST_BUS, bus, LIN_TEST_SYMBOLS_MAX);
+    Lin_Sim_CorruptSymbol(LIN_TEST_BUS, 4u, 0x00u);
+    TEST_CHECK_EQ(Lin_SendFrame(LIN_TEST_MASTER, &pdu), E_OK);
+    for (bits = 0u; (bits < 200u) && (Lin_GetStatus(LIN_TEST_MASTER, &data) == LIN_TX_BUSY); bits++)
+    {
+        Lin_Sim_Run(LIN_TEST_BIT_CYCLES);
+    }
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_MASTER, &data), LIN_TX_ERROR);
+    TEST_CHECK(Lin_Sim_ReadBus(LIN_TEST_BUS, bus, LIN_TEST_SYMBOLS_MAX) < 12u);
+    Lin_Sim_Run(LIN_TEST_FRAME_CYCLES);
+
+    TEST_CHECK_EQ(Lin_GetReadbackErrors(LIN_TEST_MASTER, &errors), E_OK);
+    TEST_CHECK_EQ(errors.HeaderErrors, 2u);
+    TEST_CHECK_EQ(errors.ResponseErrors, 1u);
+
+    /* A clean frame afterwards */
+    TEST_CHECK_EQ(Lin_Test_Frame(0x05u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_TX, sdu, 8u), LIN_TX_OK);
+}
+
+/**
+ * @brief       The go-to-sleep command: master request frame 0x3C with 00 FF .. FF, the channel sleeps after it
+ * @return      void
+ */
+static void Lin_Test_GoToSleep(void)
+{
+    Lin_PduType pdu = {0x05u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, 1u, NULL_PTR};
+    Lin_SimSymbolType bus[LIN_TEST_SYMBOLS_MAX];
+    const uint8 *sdu;
+    uint8 i;
+
+    Lin_Test_Start(LIN_TEST_MASTER, LIN_MODE_MASTER, NULL_PTR, 0u);
+
+    TEST_CHECK_EQ(Lin_GoToSleep(LIN_TEST_MASTER), E_OK);
+    Lin_Sim_Run(LIN_TEST_FRAME_CYCLES);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_MASTER, &sdu), LIN_CH_SLEEP);
+
+    TEST_CHECK_EQ(Lin_Sim_ReadBus(LIN_TEST_BUS, bus, LIN_TEST_SYMBOLS_MAX), 12u);
+    TEST_CHECK_EQ(bus[2].Value, 0x3Cu);
+    TEST_CHECK_EQ(bus[3].Value, 0x00u);
+    for (i = 4u; i < 11u; i++)
+    {
+        TEST_CHECK_EQ(bus[i].Value, 0xFFu);
+    }
+
+    /* A sleeping channel sends no frame */
+    TEST_CHECK_EQ(Lin_SendFrame(LIN_TEST_MASTER, &pdu), E_NOT_OK);
+}
+
+/**
+ * @brief       A slave channel on the bus of the master channel: it answers its TX frame, takes the response of
+ *              its RX frame and leaves the other frames alone
+ * @return      void
+ */
+static void Lin_Test_Slave(void)
+{
+    uint8 slaveTx[4] = {0xDEu, 0xADu, 0xBEu, 0xEFu};
+    uint8 slaveRx[2] = {0u, 0u};
+    uint8 masterTx[2] = {0xA5u, 0x5Au};
+    const Lin_PduType frames[2] =
+    {
+        {0x10u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_TX, 4u, slaveTx},
+        {0x11u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, 2u, slaveRx}
+    };
+    Lin_PduType pdu = {0x10u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_RX, 4u, NULL_PTR};
+    const uint8 *sdu;
+
+    Lin_Test_Start(LIN_TEST_MASTER, LIN_MODE_MASTER, NULL_PTR, 0u);
+    Lin_Sim_Connect(LIN_HW_USART1, LIN_TEST_BUS);
+    Lin_Test_Init(LIN_TEST_SLAVE, LIN_MODE_SLAVE, frames, 2u);
+
+    /* Response of the slave */
+    TEST_CHECK_EQ(Lin_Test_Frame(0x10u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_RX, NULL_PTR, 4u), LIN_RX_OK);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_MASTER, &sdu), LIN_RX_OK);
+    TEST_CHECK((sdu != NULL_PTR) && (memcmp(sdu, slaveTx, 4u) == 0));
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_SLAVE, &sdu), LIN_TX_OK);
+
+    /* Response of the master copied to the slave frame */
+    TEST_CHECK_EQ(Lin_Test_Frame(0x11u, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_TX, masterTx, 2u), LIN_TX_OK);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_SLAVE, &sdu), LIN_RX_OK);
+    TEST_CHECK_EQ(slaveRx[0], 0xA5u);
+    TEST_CHECK_EQ(slaveRx[1], 0x5Au);
+
+    /* Frame without an entry: no response */
+    TEST_CHECK_EQ(Lin_Test_Frame(0x12u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_RX, NULL_PTR, 4u), LIN_RX_NO_RESPONSE);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_SLAVE, &sdu), LIN_RX_OK);
+
+    /* Only the master sends headers */
+    TEST_CHECK_EQ(Lin_SendFrame(LIN_TEST_SLAVE, &pdu), E_NOT_OK);
+    TEST_CHECK_EQ(Lin_GoToSleep(LIN_TEST_SLAVE), E_NOT_OK);
+}
+
+/**
+ * @brief       Slave frames: 64 distinct identifiers fill the index, more frames or a repeated identifier are
+ *              refused by Lin_Init()
+ * @return      void
+ */
+static void Lin_Test_SlaveFrames(void)
+{
+    static Lin_PduType frames[65];
+    static uint8 response[65];
+    const uint8 *sdu;
+    uint8 i;
+
+    for (i = 0u; i < 65u; i++)
+    {
+        response[i] = i;
+        frames[i].Pid = LIN_PID(i & 0x3Fu);
+        frames[i].Cs = LIN_CLASSIC_CS;
+        frames[i].Drc = LIN_FRAMERESPONSE_TX;
+        frames[i].Dl = 1u;
+        frames[i].SduPtr = &response[i];
+    }
+
+    /* 65 entries, the last one repeats identifier 0 */
+    Lin_Test_Start(LIN_TEST_MASTER, LIN_MODE_MASTER, NULL_PTR, 0u);
+    Lin_Sim_Connect(LIN_HW_USART1, LIN_TEST_BUS);
+    Lin_Test_Init(LIN_TEST_SLAVE, LIN_MODE_SLAVE, frames, 65u);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_SLAVE, &sdu), LIN_NOT_OK);
+    TEST_CHECK(Lin_SlaveFrames[LIN_TEST_SLAVE] == NULL_PTR);
+
+    /* A repeated identifier among fewer entries */
+    frames[1].Pid = frames[0].Pid;
+    Lin_Test_Init(LIN_TEST_SLAVE, LIN_MODE_SLAVE, frames, 2u);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_SLAVE, &sdu), LIN_NOT_OK);
+    frames[1].Pid = LIN_PID(1u);
+
+    /* One entry per identifier, the last index answers its frame */
+    Lin_Test_Init(LIN_TEST_SLAVE, LIN_MODE_SLAVE, frames, 64u);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_SLAVE, &sdu), LIN_OPERATIONAL);
+    TEST_CHECK_EQ(Lin_SlaveIndex[LIN_TEST_SLAVE][0x3Bu], 0x3Bu);
+    TEST_CHECK_EQ(Lin_Test_Frame(0x3Bu, LIN_CLASSIC_CS, LIN_FRAMERESPONSE_RX, NULL_PTR, 1u), LIN_RX_OK);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_MASTER, &sdu), LIN_RX_OK);
+    TEST_CHECK((sdu != NULL_PTR) && (sdu[0] == 0x3Bu));
+}
+
+/**
+ * @brief       A wakeup pulse from another node wakes a sleeping channel up, and the first frame after it ends the
+ *              wakeup latency
+ * @return      void
+ */
+static void Lin_Test_WakeupFromBus(void)
+{
+    uint8 sdu[1] = {0x42u};
+    Lin_WakeupLatencyType latency;
+    const uint8 *data;
+
+    Lin_Test_Start(LIN_TEST_MASTER, LIN_MODE_MASTER, NULL_PTR, 0u);
+    TEST_CHECK_EQ(Lin_GoToSleepInternal(LIN_TEST_MASTER), E_OK);
+    TEST_CHECK_EQ(Lin_CheckWakeup(LIN_TEST_MASTER), E_NOT_OK);
+
+    Lin_Sim_SendWakeup(LIN_TEST_BUS);
+    Lin_Sim_Run(20u * LIN_TEST_BIT_CYCLES);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_MASTER, &data), LIN_OPERATIONAL);
+    TEST_CHECK_EQ(Lin_CheckWakeup(LIN_TEST_MASTER), E_OK);
+    TEST_CHECK_EQ(Lin_CheckWakeup(LIN_TEST_MASTER), E_NOT_OK);
+
+    TEST_CHECK_EQ(Lin_Test_Frame(0x01u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_TX, sdu, 1u), LIN_TX_OK);
+    TEST_CHECK_EQ(Lin_GetWakeupLatency(LIN_TEST_MASTER, &latency), E_OK);
+    TEST_CHECK_EQ(latency.Count, 1u);
+    TEST_CHECK(latency.LastCycles > (20u * LIN_TEST_BIT_CYCLES));
+    TEST_CHECK(latency.LastCycles < (20u * LIN_TEST_BIT_CYCLES) + LIN_TEST_FRAME_CYCLES);
+}
+
+/**
+ * @brief       The wakeup pulse of Lin_Wakeup() wakes the other node up, not the sender
+ * @return      void
+ */
+static void Lin_Test_WakeupPulse(void)
+{
+    uint8 slaveTx[1] = {0u};
+    const Lin_PduType frames[1] = {{0x10u, LIN_ENHANCED_CS, LIN_FRAMERESPONSE_TX, 1u, slaveTx}};
+    const uint8 *sdu;
+
+    Lin_Test_Start(LIN_TEST_MASTER, LIN_MODE_MASTER, NULL_PTR, 0u);
+    Lin_Sim_Connect(LIN_HW_USART1, LIN_TEST_BUS);
+    Lin_Test_Init(LIN_TEST_SLAVE, LIN_MODE_SLAVE, frames, 1u);
+    TEST_CHECK_EQ(Lin_GoToSleepInternal(LIN_TEST_MASTER), E_OK);
+    TEST_CHECK_EQ(Lin_GoToSleepInternal(LIN_TEST_SLAVE), E_OK);
+
+    TEST_CHECK_EQ(Lin_Wakeup(LIN_TEST_MASTER), E_OK);
+    TEST_CHECK_EQ(Lin_Wakeup(LIN_TEST_MASTER), E_NOT_OK);
+    Lin_Sim_Run(20u * LIN_TEST_BIT_CYCLES);
+
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_MASTER, &sdu), LIN_OPERATIONAL);
+    TEST_CHECK_EQ(Lin_GetStatus(LIN_TEST_SLAVE, &sdu), LIN_OPERATIONAL);
+    TEST_CHECK_EQ(Lin_CheckWakeup(LIN_TEST_MASTER), E_NOT_OK);
+    TEST_CHECK_EQ(Lin_CheckWakeup(LIN_TEST_SLAVE), E_OK);
+}
+
+/**
+ * @brief       Stop mode is only entered while every initialized channel sleeps, and a wakeup pulse ends it
+ * @return      void
+ */
+static void Lin_Test_StopMode(void)
+{
+    uint64 start;
+    uint8 ch;
+
+    Lin_Test_Start(LIN_TEST_MASTER, LIN_MODE_MASTER, NULL_PTR, 0u);
+    for (ch = 1u; ch < MAX_LIN_CHANNELS; ch++)
+    {
+        Lin_Test_Init(ch, LIN_MODE_MASTER, NULL_PTR, 0u);
+    }
+
+    /* A channel awake keeps the core running */
+    TEST_CHECK_EQ(Lin_EnterStopMode(), E_NOT_OK);
+    for (ch = 0u; ch < MAX_LIN_CHANNELS; ch++)
+    {
+        TEST_CHECK_EQ(Lin_GoToSleepInternal(ch), E_OK);
+    }
+
+    /* Woken up by the pulse at once, the channel is handed its wakeup once interrupts are unmasked */
+    Lin_Sim_SendWakeup(LIN_HW_UART4);
+    start = Lin_Sim_GetTime();
+    TEST_CHECK_EQ(Lin_EnterStopMode(), E_OK);
+    TEST_CHECK(Lin_Sim_GetTime() - start < (uint64)LIN_TEST_BIT_CYCLES * 10u);
+    TEST_CHECK_EQ(Lin_CheckWakeup(3u), E_NOT_OK);
+    Lin_Sim_Run(0u);
+    TEST_CHECK_EQ(Lin_CheckWakeup(3u), E_OK);
+    TEST_CHECK_EQ(Lin_CheckWakeup(LIN_TEST_MASTER), E_NOT_OK);
+
+    /* Channel 3 is awake now */
+    TEST_CHECK_EQ(Lin_EnterStopMode(), E_NOT_OK);
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+int main(void)
+{
+    TEST_RUN(Lin_Test_ChecksumVector);
+    TEST_RUN(Lin_Test_PidParity);
+    TEST_RUN(Lin_Test_ChecksumByteLoop);
+    TEST_RUN(Lin_Test_MasterTx);
+    TEST_RUN(Lin_Test_MasterRx);
+    TEST_RUN(Lin_Test_MasterRxErrors);
+    TEST_RUN(Lin_Test_MasterRxSlow);
+    TEST_RUN(Lin_Test_Readback);
+    TEST_RUN(Lin_Test_GoToSleep);
+    TEST_RUN(Lin_Test_Slave);
+    TEST_RUN(Lin_Test_SlaveFrames);
+    TEST_RUN(Lin_Test_WakeupFromBus);
+    TEST_RUN(Lin_Test_WakeupPulse);
+    TEST_RUN(Lin_Test_StopMode);
+
+    return Test_Summary();
+}
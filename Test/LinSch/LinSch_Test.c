@@ -0,0 +1,269 @@
+/**
+ * @file        LinSch_Test.c
+ * @author      Phuc
+ * @brief       Tests of the LIN schedule table engine on the simulated TIM7, USARTs and buses
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Test.h"
+
+/* Compiled together with the engine, for the slot index and the pending restart */
+#include "LinSch.c"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define LINSCH_TEST_BUS             LIN_HW_USART2   /* Bus of LINSCH_CHANNEL, channel 0 */
+#define LINSCH_TEST_SLOT_CYCLES     (10000u * (LIN_SIM_CPU_HZ / LINSCH_TICK_HZ))    /* Slot of 10 ms */
+#define LINSCH_TEST_SYMBOLS_MAX     64u     /* Whole trace of a bus */
+#define LINSCH_TEST_SILENT          0xFFu   /* No header in a slot */
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Classic checksum of a response, computed bit by bit as the reference
+ * @param       Data: Response
+ * @param       Dl: Response length
+ * @return      Inverted sum with carry
+ */
+static uint8 LinSch_Test_Checksum(const uint8* Data, uint8 Dl)
+{
+    uint16 sum = 0u;
+    uint8 i;
+
+    for (i = 0u; i < Dl; i++)
+    {
+        sum += Data[i];
+        sum = (sum > 0xFFu) ? (uint16)(sum - 0xFFu) : sum;
+    }
+
+    return (uint8)~sum;
+}
+
+/**
+ * @brief       Resets the simulator, the master channel, the engine and the transport layer; the slaves answer
+ *              the status frames 0x30 and 0x31 of the normal table
+ * @return      void
+ */
+static void LinSch_Test_Start(void)
+{
+    Lin_ConfigType config = {LINSCH_CHANNEL, LIN_MODE_MASTER, NULL_PTR, 0u};
+    uint8 door[5] = {0x01u, 0x02u, 0x03u, 0x04u, 0x00u};
+    uint8 climate[3] = {0x21u, 0x22u, 0x00u};
+
+    Lin_Sim_Init();
+    Lin_Sim_AttachTimer(TIM7_IRQHandler);
+    Lin_Init(&config);
+    (void)Lin_WakeupInternal(LINSCH_CHANNEL);
+
+    door[4] = LinSch_Test_Checksum(door, 4u);
+    climate[2] = LinSch_Test_Checksum(climate, 2u);
+    Lin_Sim_SetResponse(LINSCH_TEST_BUS, 0x30u, door, 5u);
+    Lin_Sim_SetResponse(LINSCH_TEST_BUS, 0x31u, climate, 3u);
+
+    LinSch_Init();
+    LinTp_Init();
+}
+
+/**
+ * @brief       Runs the bus and returns the header sent meanwhile
+ * @param       Cycles: CPU cycles to simulate
+ * @param       Symbols: Where the number of characters seen is stored, may be NULL_PTR
+ * @return      Frame identifier of the only header, LINSCH_TEST_SILENT without header
+ */
+static uint8 LinSch_Test_Run(uint64 Cycles, uint32* Symbols)
+{
+    Lin_SimSymbolType bus[LINSCH_TEST_SYMBOLS_MAX];
+    uint8 id = LINSCH_TEST_SILENT;
+    uint32 headers = 0u;
+    uint32 count;
+    uint32 i;
+
+    Lin_Sim_Run(Cycles);
+    count = Lin_Sim_ReadBus(LINSCH_TEST_BUS, bus, LINSCH_TEST_SYMBOLS_MAX);
+    for (i = 0u; (i + 2u) < count; i++)
+    {
+        if ((bus[i].Break == TRUE) && (bus[i + 1u].Value == 0x55u))
+        {
+            id = bus[i + 2u].Value & 0x3Fu;
+            headers++;
+        }
+    }
+    TEST_CHECK(headers <= 1u);
+    if (Symbols != NULL_PTR)
+    {
+        *Symbols = count;
+    }
+
+    return id;
+}
+
+/**
+ * @brief       Requests a table on a stopped engine and runs half a slot, so that the next runs of a whole slot
+ *              each cross one slot boundary
+ * @param       Table: Schedule table
+ * @return      Frame identifier of the header of its first slot
+ */
+static uint8 LinSch_Test_Begin(uint8 Table)
+{
+    TEST_CHECK_EQ(LinSch_SetTable(Table), E_OK);
+
+    return LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES / 2u, NULL_PTR);
+}
+
+/**
+ * @brief       The slots of the normal table in order, one header at each slot boundary, every 10 ms
+ * @return      void
+ */
+static void LinSch_Test_SlotOrder(void)
+{
+    static const uint8 order[4] = {0x10u, 0x30u, 0x20u, 0x31u};
+    LinSch_JitterType jitter;
+    Lin_SimBusStatsType stats;
+    const uint8 *sdu;
+    uint32 symbols;
+    uint8 slot;
+
+    LinSch_Test_Start();
+    TEST_CHECK_EQ(LinSch_GetTable(), LINSCH_TABLE_NONE);
+
+    /* A stopped engine starts at once */
+    TEST_CHECK_EQ(LinSch_Test_Begin(LINSCH_TABLE_NORMAL), 0x10u);
+    TEST_CHECK_EQ(LinSch_GetTable(), LINSCH_TABLE_NORMAL);
+
+    for (slot = 1u; slot < 12u; slot++)
+    {
+        TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES, &symbols), order[slot % 4u]);
+        /* Header and the 4 or 2 bytes of the response with their checksum */
+        TEST_CHECK_EQ(symbols, ((slot % 4u) < 2u) ? 8u : 6u);
+        if ((slot % 2u) == 1u)
+        {
+            TEST_CHECK_EQ(Lin_GetStatus(LINSCH_CHANNEL, &sdu), LIN_RX_OK);
+        }
+    }
+
+    /* The next break starts on the slot boundary, not a cycle before */
+    Lin_Sim_GetBusStats(LINSCH_TEST_BUS, &stats);
+    TEST_CHECK_EQ(stats.Breaks, 12u);
+    Lin_Sim_Run((LINSCH_TEST_SLOT_CYCLES / 2u) - 1u);
+    Lin_Sim_GetBusStats(LINSCH_TEST_BUS, &stats);
+    TEST_CHECK_EQ(stats.Breaks, 12u);
+    Lin_Sim_Run(1u);
+    Lin_Sim_GetBusStats(LINSCH_TEST_BUS, &stats);
+    TEST_CHECK_EQ(stats.Breaks, 13u);
+
+    /* Every header requested on its slot boundary */
+    TEST_CHECK_EQ(LinSch_GetJitter(&jitter), E_OK);
+    TEST_CHECK_EQ(jitter.Count, 13u);
+    TEST_CHECK_EQ(jitter.Bucket[0], 13u);
+    TEST_CHECK_EQ(jitter.MaxUs, 0u);
+    TEST_CHECK_EQ(jitter.Rejected, 0u);
+    TEST_CHECK_EQ(LinSch_GetJitter(NULL_PTR), E_NOT_OK);
+}
+
+/**
+ * @brief       A new table starts with its first slot at the slot boundary, after the frame of the current slot;
+ *              a stop request stops the timer at the boundary
+ * @return      void
+ */
+static void LinSch_Test_Switch(void)
+{
+    const uint8 *sdu;
+    uint32 symbols;
+
+    LinSch_Test_Start();
+    TEST_CHECK_EQ(LinSch_Test_Begin(LINSCH_TABLE_NORMAL), 0x10u);
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES / 2u, NULL_PTR), LINSCH_TEST_SILENT);
+
+    /* Requested while the header of 0x30 is on the bus: its response is still received */
+    Lin_Sim_Run(LINSCH_TEST_SLOT_CYCLES / 1000u);
+    TEST_CHECK_EQ(LinSch_SetTable(LINSCH_TABLE_DIAG_REQUEST), E_OK);
+    TEST_CHECK_EQ(LinSch_GetTable(), LINSCH_TABLE_NORMAL);
+    Lin_Sim_Run((LINSCH_TEST_SLOT_CYCLES / 2u) - (LINSCH_TEST_SLOT_CYCLES / 1000u) - 1u);
+    TEST_CHECK_EQ(Lin_GetStatus(LINSCH_CHANNEL, &sdu), LIN_RX_OK);
+    TEST_CHECK_EQ(LinSch_GetTable(), LINSCH_TABLE_NORMAL);
+
+    /* At the boundary: the master request slot stays silent without a transfer */
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES + 1u, &symbols), 0x30u);
+    TEST_CHECK_EQ(symbols, 8u);
+    TEST_CHECK_EQ(LinSch_GetTable(), LINSCH_TABLE_DIAG_REQUEST);
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES, NULL_PTR), LINSCH_TEST_SILENT);
+
+    /* Back to the normal table, from its first slot */
+    TEST_CHECK_EQ(LinSch_SetTable(LINSCH_TABLE_NORMAL), E_OK);
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES, NULL_PTR), 0x10u);
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES, NULL_PTR), 0x30u);
+
+    /* Unknown table: refused, the running table goes on */
+    TEST_CHECK_EQ(LinSch_SetTable(LINSCH_TABLE_COUNT), E_NOT_OK);
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES, NULL_PTR), 0x20u);
+
+    /* Stop at the boundary, then a request starts the engine at once */
+    TEST_CHECK_EQ(LinSch_SetTable(LINSCH_TABLE_NONE), E_OK);
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES, NULL_PTR), LINSCH_TEST_SILENT);
+    TEST_CHECK_EQ(LinSch_GetTable(), LINSCH_TABLE_NONE);
+    TEST_CHECK_EQ(LL_TIM_IsEnabledCounter(LINSCH_TIMER), 0u);
+    TEST_CHECK_EQ(LinSch_Test_Run(3u * LINSCH_TEST_SLOT_CYCLES, NULL_PTR), LINSCH_TEST_SILENT);
+    TEST_CHECK_EQ(LinSch_Test_Begin(LINSCH_TABLE_NORMAL), 0x10u);
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES, NULL_PTR), 0x30u);
+}
+
+/**
+ * @brief       Requesting the running table again restarts it at its first slot on the slot boundary, the slot
+ *              in progress is left alone
+ * @return      void
+ */
+static void LinSch_Test_Restart(void)
+{
+    uint32 symbols;
+
+    LinSch_Test_Start();
+    TEST_CHECK_EQ(LinSch_Test_Begin(LINSCH_TABLE_NORMAL), 0x10u);
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES, NULL_PTR), 0x30u);
+
+    /* Slot 1 is in progress, slot 2 would be next */
+    TEST_CHECK_EQ(LinSch_Slot, 2u);
+    TEST_CHECK_EQ(LinSch_SetTable(LINSCH_TABLE_NORMAL), E_OK);
+    TEST_CHECK_EQ(LinSch_Slot, 2u);
+    TEST_CHECK_EQ(LinSch_Restart, TRUE);
+
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES, &symbols), 0x10u);
+    TEST_CHECK_EQ(symbols, 8u);
+    TEST_CHECK_EQ(LinSch_Restart, FALSE);
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES, NULL_PTR), 0x30u);
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES, NULL_PTR), 0x20u);
+
+    /* Another table requested, then the running one again: the request is withdrawn and the table restarts */
+    TEST_CHECK_EQ(LinSch_SetTable(LINSCH_TABLE_DIAG_REQUEST), E_OK);
+    TEST_CHECK_EQ(LinSch_SetTable(LINSCH_TABLE_NORMAL), E_OK);
+    TEST_CHECK_EQ(LinSch_Test_Run(LINSCH_TEST_SLOT_CYCLES, NULL_PTR), 0x10u);
+    TEST_CHECK_EQ(LinSch_GetTable(), LINSCH_TABLE_NORMAL);
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+int main(void)
+{
+    TEST_RUN(LinSch_Test_SlotOrder);
+    TEST_RUN(LinSch_Test_Switch);
+    TEST_RUN(LinSch_Test_Restart);
+
+    return Test_Summary();
+}
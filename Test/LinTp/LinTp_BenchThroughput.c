@@ -0,0 +1,103 @@
+/**
+ * @file        LinTp_BenchThroughput.c
+ * @author      Phuc
+ * @brief       Benchmark of the throughput of the LIN transport layer on the schedule table engine, from a single
+ *              frame to the 4095 bytes of the longest message, against the bound set by the 10 ms slots
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Test.h"
+#include "LinTp_TestSlave.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define LINTP_BENCH_NAD             0x0Au   /* Node address of the slave */
+#define LINTP_BENCH_SLOTS_MAX       2000u   /* Slots run at most by a transfer */
+#define LINTP_BENCH_SIZES           6u      /* Message lengths measured */
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+static uint8 LinTp_Bench_Request[LINTP_LENGTH_MAX];
+static uint8 LinTp_Bench_Response[LINTP_LENGTH_MAX];
+static uint8 LinTp_Bench_Buffer[LINTP_LENGTH_MAX];
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Number of frames of a message: a SF, or a FF with 5 bytes and CFs with 6
+ * @param       Length: Message length
+ * @return      Frames
+ */
+static uint32 LinTp_Bench_Frames(uint16 Length)
+{
+    return (Length <= 6u) ? 1u : (1u + (((uint32)Length - 5u + (6u - 1u)) / 6u));
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+int main(void)
+{
+    static const uint16 sizes[LINTP_BENCH_SIZES] = {6u, 7u, 64u, 512u, 1024u, LINTP_LENGTH_MAX};
+    LinTp_ThroughputType throughput;
+    uint16 length = 0u;
+    LinTp_StatusType status;
+    double bound;
+    uint32 slots;
+    uint32 i;
+    uint8 run;
+
+    for (i = 0u; i < LINTP_LENGTH_MAX; i++)
+    {
+        LinTp_Bench_Request[i] = (uint8)((i * 7u) + 1u);
+        LinTp_Bench_Response[i] = (uint8)((i * 13u) + 5u);
+    }
+
+    printf("LIN transport layer, request and response of the same length, one frame per 10 ms slot\n");
+    printf("Measured by LinTp_GetThroughput() on the simulated DWT CYCCNT. The bound is the payload over the\n");
+    printf("slots of its frames alone; the request also waits for the first slot boundary, one more slot.\n");
+    printf("  bytes  frames   request B/s   response B/s   bound B/s   slots  status\n");
+    for (run = 0u; run < LINTP_BENCH_SIZES; run++)
+    {
+        LinTp_TestSlave_Init();
+        LinTp_TestSlave_Respond(LINTP_BENCH_NAD, LinTp_Bench_Response, sizes[run]);
+        (void)LinTp_Request(LINTP_BENCH_NAD, LinTp_Bench_Request, sizes[run], LinTp_Bench_Buffer,
+                            sizeof(LinTp_Bench_Buffer));
+        slots = LinTp_TestSlave_Transfer(LINTP_BENCH_SLOTS_MAX);
+
+        status = LinTp_GetStatus(&length);
+        (void)LinTp_GetThroughput(&throughput);
+        bound = (double)sizes[run] * 100.0 / (double)LinTp_Bench_Frames(sizes[run]);
+        printf("  %5u  %6lu   %11lu   %12lu   %9.1f   %5lu  %s\n", (unsigned)sizes[run],
+               (unsigned long)LinTp_Bench_Frames(sizes[run]), (unsigned long)throughput.RequestBytesPerSecond,
+               (unsigned long)throughput.ResponseBytesPerSecond, bound, (unsigned long)slots,
+               ((status == LINTP_OK) && (length == sizes[run]) &&
+                (memcmp(LinTp_Bench_Buffer, LinTp_Bench_Response, sizes[run]) == 0)) ? "OK" : "FAILED");
+        if (status != LINTP_OK)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,527 @@
+/**
+ * @file        LinTp_Test.c
+ * @author      Phuc
+ * @brief       Tests of the LIN transport layer on the schedule table engine, the simulated TIM7, USARTs and buses
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "Test.h"
+#include "LinTp_TestSlave.h"
+
+/* Compiled together with the transport layer, for its sequence numbers and slot counters */
+#include "LinTp.c"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define LINTP_TEST_NAD              0x0Au   /* Node address of the slave */
+#define LINTP_TEST_SLOTS_MAX        1000u   /* Slots run at most by a transfer */
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+static uint8 LinTp_Test_Request[LINTP_LENGTH_MAX];
+static uint8 LinTp_Test_Response[LINTP_LENGTH_MAX];
+static uint8 LinTp_Test_Buffer[LINTP_LENGTH_MAX];
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Fills the request and response messages with distinct patterns
+ * @return      void
+ */
+static void LinTp_Test_Fill(void)
+{
+    uint32 i;
+
+    for (i = 0u; i < LINTP_LENGTH_MAX; i++)
+    {
+        LinTp_Test_Request[i] = (uint8)((i * 7u) + 1u);
+        LinTp_Test_Response[i] = (uint8)((i * 13u) + 5u);
+    }
+    (void)memset(LinTp_Test_Buffer, 0xA5, sizeof(LinTp_Test_Buffer));
+}
+
+/**
+ * @brief       Runs slots until the first one of a schedule table, e.g. until the request or the response
+ *              table has started
+ * @param       Id: Frame identifier of the first slot
+ * @return      Slots run before it
+ */
+static uint32 LinTp_Test_RunUntil(uint8 Id)
+{
+    uint32 slots = 0u;
+
+    while ((slots < LINTP_TEST_SLOTS_MAX) && (LinTp_TestSlave_Slot() != Id))
+    {
+        slots++;
+    }
+    TEST_CHECK(slots < LINTP_TEST_SLOTS_MAX);
+
+    return slots;
+}
+
+/**
+ * @brief       Checks the request frames recorded by the slave against the reference segmentation: a SF, or
+ *              a FF and CFs with their sequence numbers wrapping from 15 to 0, unused bytes filled with 0xFF
+ * @param       Nad: Node address of the request
+ * @param       Length: Request length
+ * @return      void
+ */
+static void LinTp_Test_CheckRequest(uint8 Nad, uint16 Length)
+{
+    const uint8 *frame;
+    uint32 index = 0u;
+    uint16 offset = 0u;
+    uint8 pci;
+    uint8 first;
+    uint8 count;
+    uint8 b;
+
+    while (offset < Length)
+    {
+        frame = LinTp_TestSlave_Request(index);
+        TEST_CHECK(frame != NULL_PTR);
+        if (frame == NULL_PTR)
+        {
+            return;
+        }
+
+        if (Length <= 6u)
+        {
+            pci = (uint8)Length;
+            first = 2u;
+            count = (uint8)Length;
+        }
+        else if (offset == 0u)
+        {
+            pci = (uint8)(0x10u | (Length >> 8));
+            TEST_CHECK_EQ(frame[2], (uint8)Length);
+            first = 3u;
+            count = 5u;
+        }
+        else
+        {
+            pci = (uint8)(0x20u | (index & 0x0Fu));
+            first = 2u;
+            count = ((uint16)(Length - offset) < 6u) ? (uint8)(Length - offset) : 6u;
+        }
+
+        TEST_CHECK_EQ(frame[0], Nad);
+        TEST_CHECK_EQ(frame[1], pci);
+        for (b = 0u; b < count; b++)
+        {
+            TEST_CHECK_EQ(frame[first + b], LinTp_Test_Request[offset + b]);
+        }
+        for (b = first + count; b < 8u; b++)
+        {
+            TEST_CHECK_EQ(frame[b], 0xFFu);
+        }
+
+        offset += count;
+        index++;
+    }
+
+    /* No frame after the last one */
+    TEST_CHECK(LinTp_TestSlave_Request(index) == NULL_PTR);
+}
+
+/**
+ * @brief       Single frame request and response, and the slots around them
+ * @return      void
+ */
+static void LinTp_Test_SingleFrame(void)
+{
+    LinTp_ThroughputType throughput;
+    uint32 responses;
+    uint16 length = 0u;
+
+    LinTp_TestSlave_Init();
+    LinTp_Test_Fill();
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_IDLE);
+
+    LinTp_TestSlave_Respond(LINTP_TEST_NAD, LinTp_Test_Response, 5u);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 3u, LinTp_Test_Buffer, 16u), E_OK);
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_TX_BUSY);
+
+    /* The idle table runs out its slot, the request table starts at the next boundary */
+    TEST_CHECK(LinTp_TestSlave_Slot() != LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_RX_BUSY);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_SLAVE_RESPONSE_ID);
+    TEST_CHECK_EQ(LinTp_GetStatus(&length), LINTP_OK);
+    TEST_CHECK_EQ(length, 5u);
+    TEST_CHECK(memcmp(LinTp_Test_Buffer, LinTp_Test_Response, 5u) == 0);
+    TEST_CHECK_EQ(LinTp_Test_Buffer[5], 0xA5u);
+
+    /* The response table leaves its next slot silent, then the idle table is back */
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_TESTSLAVE_SILENT);
+    TEST_CHECK_EQ(LinSch_GetTable(), LINTP_TABLE_IDLE);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), 0x10u);
+
+    LinTp_Test_CheckRequest(LINTP_TEST_NAD, 3u);
+    TEST_CHECK_EQ(LinTp_TestSlave_Count(&responses), 1u);
+    TEST_CHECK_EQ(responses, 1u);
+
+    /* One slot of 10 ms for each half */
+    TEST_CHECK_EQ(LinTp_GetThroughput(&throughput), E_OK);
+    TEST_CHECK_EQ(throughput.RequestBytes, 3u);
+    TEST_CHECK_EQ(throughput.ResponseBytes, 5u);
+    TEST_CHECK_EQ(throughput.ResponseCycles, LINTP_TESTSLAVE_SLOT_CYCLES);
+    TEST_CHECK_EQ(throughput.ResponseBytesPerSecond, 500u);
+    TEST_CHECK_EQ(LinTp_GetThroughput(NULL_PTR), E_NOT_OK);
+
+    /* A request of exactly 6 bytes still fits a SF */
+    LinTp_TestSlave_Respond(LINTP_TEST_NAD, LinTp_Test_Response, 6u);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 6u, LinTp_Test_Buffer, 6u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Transfer(LINTP_TEST_SLOTS_MAX), 1u);
+    TEST_CHECK_EQ(LinTp_GetStatus(&length), LINTP_OK);
+    TEST_CHECK_EQ(length, 6u);
+    TEST_CHECK_EQ(LinTp_TestSlave_Request(1u)[1], 0x06u);
+}
+
+/**
+ * @brief       Segmented request and response: FF, then CFs with the sequence number wrapping from 15 to 0;
+ *              the response table starts in the slot right after the last request frame
+ * @return      void
+ */
+static void LinTp_Test_MultiFrame(void)
+{
+    uint32 responses;
+    uint16 length = 0u;
+    uint32 frames;
+
+    LinTp_TestSlave_Init();
+    LinTp_Test_Fill();
+
+    /* 105 bytes: FF with 5, 16 CFs with 6 and a last CF with 4 */
+    LinTp_TestSlave_Respond(LINTP_TEST_NAD, LinTp_Test_Response, 200u);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 105u, LinTp_Test_Buffer, 200u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+
+    for (frames = 1u; frames < 18u; frames++)
+    {
+        TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_MASTER_REQUEST_ID);
+        TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), (frames < 17u) ? LINTP_TX_BUSY : LINTP_RX_BUSY);
+    }
+    TEST_CHECK_EQ(LinTp_TxSn, 2u);
+
+    /* 200 bytes: FF with 5, then 33 CFs, the sequence number wraps twice */
+    for (frames = 0u; frames < 34u; frames++)
+    {
+        TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_SLAVE_RESPONSE_ID);
+    }
+    TEST_CHECK_EQ(LinTp_GetStatus(&length), LINTP_OK);
+    TEST_CHECK_EQ(length, 200u);
+    TEST_CHECK(memcmp(LinTp_Test_Buffer, LinTp_Test_Response, 200u) == 0);
+    TEST_CHECK_EQ(LinTp_Test_Buffer[200], 0xA5u);
+    TEST_CHECK_EQ(LinTp_RxSn, 2u);
+
+    LinTp_Test_CheckRequest(LINTP_TEST_NAD, 105u);
+    TEST_CHECK_EQ(LinTp_TestSlave_Count(&responses), 18u);
+    TEST_CHECK_EQ(responses, 34u);
+
+    /* A response of 7 bytes, the shortest FF, into a buffer of exactly its size */
+    LinTp_TestSlave_Respond(LINTP_TEST_NAD, LinTp_Test_Response, 7u);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 1u, LinTp_Test_Buffer, 7u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Transfer(LINTP_TEST_SLOTS_MAX), 2u);
+    TEST_CHECK_EQ(LinTp_GetStatus(&length), LINTP_OK);
+    TEST_CHECK_EQ(length, 7u);
+    TEST_CHECK(memcmp(LinTp_Test_Buffer, LinTp_Test_Response, 7u) == 0);
+}
+
+/**
+ * @brief       Response frames from another node or out of sequence end the transfer with LINTP_E_RX, except
+ *              for a broadcast request which accepts any NAD
+ * @return      void
+ */
+static void LinTp_Test_ResponseErrors(void)
+{
+    uint8 frame[8] = {LINTP_TEST_NAD, 0x10u, 0x14u, 0x01u, 0x02u, 0x03u, 0x04u, 0x05u};
+    uint16 length = 0u;
+
+    LinTp_TestSlave_Init();
+    LinTp_Test_Fill();
+
+    /* NAD mismatch */
+    LinTp_TestSlave_Respond(LINTP_TEST_NAD + 1u, LinTp_Test_Response, 4u);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 16u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Transfer(LINTP_TEST_SLOTS_MAX), 1u);
+    TEST_CHECK_EQ(LinTp_GetStatus(&length), LINTP_E_RX);
+    TEST_CHECK_EQ(length, 0u);
+    TEST_CHECK_EQ(LinTp_Test_Buffer[0], 0xA5u);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_TESTSLAVE_SILENT);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), 0x10u);
+
+    /* A broadcast request takes the response of any node */
+    LinTp_TestSlave_Respond(LINTP_TEST_NAD + 1u, LinTp_Test_Response, 4u);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_NAD_BROADCAST, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 16u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Transfer(LINTP_TEST_SLOTS_MAX), 1u);
+    TEST_CHECK_EQ(LinTp_GetStatus(&length), LINTP_OK);
+    TEST_CHECK_EQ(length, 4u);
+
+    /* NAD mismatch in a CF */
+    LinTp_TestSlave_Queue(frame);
+    frame[0] = LINTP_TEST_NAD + 1u;
+    frame[1] = 0x21u;
+    LinTp_TestSlave_Queue(frame);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 32u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Transfer(LINTP_TEST_SLOTS_MAX), 2u);
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_E_RX);
+
+    /* CF 2 after the FF */
+    frame[0] = LINTP_TEST_NAD;
+    frame[1] = 0x10u;
+    LinTp_TestSlave_Queue(frame);
+    frame[1] = 0x22u;
+    LinTp_TestSlave_Queue(frame);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 32u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Transfer(LINTP_TEST_SLOTS_MAX), 2u);
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_E_RX);
+
+    /* CF before any FF */
+    frame[1] = 0x21u;
+    LinTp_TestSlave_Queue(frame);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 32u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Transfer(LINTP_TEST_SLOTS_MAX), 1u);
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_E_RX);
+
+    /* FF announcing a length that fits a SF */
+    frame[1] = 0x10u;
+    frame[2] = 0x06u;
+    LinTp_TestSlave_Queue(frame);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 32u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Transfer(LINTP_TEST_SLOTS_MAX), 1u);
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_E_RX);
+    TEST_CHECK_EQ(LinSch_GetTable(), LINTP_TABLE_RESPONSE);
+    (void)LinTp_TestSlave_Slot();
+    TEST_CHECK_EQ(LinSch_GetTable(), LINTP_TABLE_IDLE);
+}
+
+/**
+ * @brief       A response longer than the caller buffer ends the transfer with LINTP_E_OVERFLOW at its SF or FF,
+ *              before any byte is written
+ * @return      void
+ */
+static void LinTp_Test_Overflow(void)
+{
+    uint16 length = 0u;
+
+    LinTp_TestSlave_Init();
+    LinTp_Test_Fill();
+
+    /* FF of 50 bytes into 20 */
+    LinTp_TestSlave_Respond(LINTP_TEST_NAD, LinTp_Test_Response, 50u);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 20u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Transfer(LINTP_TEST_SLOTS_MAX), 1u);
+    TEST_CHECK_EQ(LinTp_GetStatus(&length), LINTP_E_OVERFLOW);
+    TEST_CHECK_EQ(length, 0u);
+    TEST_CHECK_EQ(LinTp_Test_Buffer[0], 0xA5u);
+
+    /* The response table is left at the next boundary, the rest of the response is never asked for */
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_TESTSLAVE_SILENT);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), 0x10u);
+
+    /* SF of 6 bytes into 5 */
+    LinTp_TestSlave_Init();
+    LinTp_TestSlave_Respond(LINTP_TEST_NAD, LinTp_Test_Response, 6u);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 5u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Transfer(LINTP_TEST_SLOTS_MAX), 1u);
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_E_OVERFLOW);
+    TEST_CHECK_EQ(LinTp_Test_Buffer[0], 0xA5u);
+}
+
+/**
+ * @brief       Slave response slots without response: the transfer ends after LINTP_RESPONSE_TIMEOUT_SLOTS of
+ *              them, and every response frame starts the count again
+ * @return      void
+ */
+static void LinTp_Test_Timeout(void)
+{
+    uint8 frame[8];
+    uint32 headers = 0u;
+    uint16 length = 0u;
+    uint8 id;
+
+    LinTp_TestSlave_Init();
+    LinTp_Test_Fill();
+
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 16u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    do
+    {
+        id = LinTp_TestSlave_Slot();
+        headers += (id == LINTP_SLAVE_RESPONSE_ID) ? 1u : 0u;
+    } while ((id == LINTP_SLAVE_RESPONSE_ID) && (headers < LINTP_TEST_SLOTS_MAX));
+
+    /* The slot after the last header is already silent */
+    TEST_CHECK_EQ(headers, LINTP_RESPONSE_TIMEOUT_SLOTS);
+    TEST_CHECK_EQ(id, LINTP_TESTSLAVE_SILENT);
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_E_TIMEOUT);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), 0x10u);
+
+    /* A slow slave: the FF after 60 slots, the CFs after 99 more */
+    LinTp_TestSlave_Init();
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 16u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    for (headers = 0u; headers < 60u; headers++)
+    {
+        TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_SLAVE_RESPONSE_ID);
+    }
+    /* Counted at the start of each slot, the 61st has started */
+    TEST_CHECK_EQ(LinTp_RxWait, 61u);
+
+    frame[0] = LINTP_TEST_NAD;
+    frame[1] = 0x10u;
+    frame[2] = 16u;
+    (void)memcpy(&frame[3], &LinTp_Test_Response[0], 5u);
+    LinTp_TestSlave_Queue(frame);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_SLAVE_RESPONSE_ID);
+    TEST_CHECK_EQ(LinTp_RxWait, 1u);
+    TEST_CHECK_EQ(LinTp_RxOffset, 5u);
+
+    /* The last of the 100 slots still takes the CF */
+    for (headers = 1u; headers < LINTP_RESPONSE_TIMEOUT_SLOTS; headers++)
+    {
+        TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_SLAVE_RESPONSE_ID);
+    }
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_RX_BUSY);
+
+    frame[1] = 0x21u;
+    (void)memcpy(&frame[2], &LinTp_Test_Response[5], 6u);
+    LinTp_TestSlave_Queue(frame);
+    frame[1] = 0x22u;
+    (void)memcpy(&frame[2], &LinTp_Test_Response[11], 5u);
+    frame[7] = 0xFFu;
+    LinTp_TestSlave_Queue(frame);
+    TEST_CHECK_EQ(LinTp_TestSlave_Transfer(LINTP_TEST_SLOTS_MAX), 2u);
+    TEST_CHECK_EQ(LinTp_GetStatus(&length), LINTP_OK);
+    TEST_CHECK_EQ(length, 16u);
+    TEST_CHECK(memcmp(LinTp_Test_Buffer, LinTp_Test_Response, 16u) == 0);
+}
+
+/**
+ * @brief       A functional request has no response: the request table runs one more, silent slot to confirm
+ *              the last frame, then the idle table is back without any slave response slot
+ * @return      void
+ */
+static void LinTp_Test_Functional(void)
+{
+    LinTp_ThroughputType throughput;
+
+    LinTp_TestSlave_Init();
+    LinTp_Test_Fill();
+
+    TEST_CHECK_EQ(LinTp_Request(LINTP_NAD_FUNCTIONAL, LinTp_Test_Request, 20u, NULL_PTR, 0u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_TX_BUSY);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_MASTER_REQUEST_ID);
+
+    /* Confirmed at the start of the extra slot, which stays silent */
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_OK);
+    TEST_CHECK_EQ(LinSch_GetTable(), LINTP_TABLE_REQUEST);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_TESTSLAVE_SILENT);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), 0x10u);
+    LinTp_Test_CheckRequest(LINTP_NAD_FUNCTIONAL, 20u);
+
+    TEST_CHECK_EQ(LinTp_GetThroughput(&throughput), E_OK);
+    TEST_CHECK_EQ(throughput.RequestBytes, 20u);
+    TEST_CHECK_EQ(throughput.ResponseBytes, 0u);
+}
+
+/**
+ * @brief       A request frame not sent ends the transfer with LINTP_E_TX
+ * @return      void
+ */
+static void LinTp_Test_TxError(void)
+{
+    LinTp_TestSlave_Init();
+    LinTp_Test_Fill();
+
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 20u, LinTp_Test_Buffer, 16u), E_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+
+    /* Third data byte of the first CF, its break is already on the bus */
+    Lin_Sim_CorruptSymbol(LINTP_TESTSLAVE_BUS, 4u, 0x00u);
+    (void)LinTp_TestSlave_Slot();
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_E_TX);
+    TEST_CHECK_EQ(LinTp_TxOffset, 5u);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), LINTP_TESTSLAVE_SILENT);
+    TEST_CHECK_EQ(LinTp_TestSlave_Slot(), 0x10u);
+}
+
+/**
+ * @brief       Invalid requests and a request during a transfer are rejected
+ * @return      void
+ */
+static void LinTp_Test_Parameters(void)
+{
+    LinTp_TestSlave_Init();
+    LinTp_Test_Fill();
+
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, NULL_PTR, 2u, LinTp_Test_Buffer, 16u), E_NOT_OK);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 0u, LinTp_Test_Buffer, 16u), E_NOT_OK);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, LINTP_LENGTH_MAX + 1u, LinTp_Test_Buffer, 16u),
+                  E_NOT_OK);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_NAD_FUNCTIONAL, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 16u), E_NOT_OK);
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_IDLE);
+
+    LinTp_TestSlave_Respond(LINTP_TEST_NAD, LinTp_Test_Response, 4u);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 16u), E_OK);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 16u), E_NOT_OK);
+    (void)LinTp_Test_RunUntil(LINTP_MASTER_REQUEST_ID);
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_RX_BUSY);
+    TEST_CHECK_EQ(LinTp_Request(LINTP_TEST_NAD, LinTp_Test_Request, 2u, LinTp_Test_Buffer, 16u), E_NOT_OK);
+    TEST_CHECK_EQ(LinTp_TestSlave_Transfer(LINTP_TEST_SLOTS_MAX), 1u);
+    TEST_CHECK_EQ(LinTp_GetStatus(NULL_PTR), LINTP_OK);
+
+    /* Once ended, the next transfer may start */
+    TEST_CHECK_EQ(LinTp_Request(LINTP_NAD_FUNCTIONAL, LinTp_Test_Request, 2u, NULL_PTR, 0u), E_OK);
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+int main(void)
+{
+    TEST_RUN(LinTp_Test_SingleFrame);
+    TEST_RUN(LinTp_Test_MultiFrame);
+    TEST_RUN(LinTp_Test_ResponseErrors);
+    TEST_RUN(LinTp_Test_Overflow);
+    TEST_RUN(LinTp_Test_Timeout);
+    TEST_RUN(LinTp_Test_Functional);
+    TEST_RUN(LinTp_Test_TxError);
+    TEST_RUN(LinTp_Test_Parameters);
+
+    return Test_Summary();
+}
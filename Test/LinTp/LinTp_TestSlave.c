@@ -0,0 +1,263 @@
+/**
+ * @file        LinTp_TestSlave.c
+ * @author      Phuc
+ * @brief       Diagnostic slave node on the simulated LIN bus, shared by the host tests and benchmarks of the
+ *              LIN transport layer
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include <string.h>
+#include "LinTp_TestSlave.h"
+#include "LinTp_Cfg.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define LINTP_TESTSLAVE_FRAME       8u      /* Bytes of a diagnostic frame without its checksum */
+#define LINTP_TESTSLAVE_SYMBOLS_MAX 64u     /* Whole trace of a bus */
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+/* Response frames to send, and the next one */
+static uint8 LinTp_TestSlave_Responses[LINTP_TESTSLAVE_FRAMES_MAX][LINTP_TESTSLAVE_FRAME];
+static uint32 LinTp_TestSlave_ResponseCount;
+static uint32 LinTp_TestSlave_ResponseNext;
+
+/* Master request frames seen on the bus */
+static uint8 LinTp_TestSlave_Requests[LINTP_TESTSLAVE_FRAMES_MAX][LINTP_TESTSLAVE_FRAME];
+static uint32 LinTp_TestSlave_RequestCount;
+
+/* Interrupt vector of LinSch.c */
+void TIM7_IRQHandler(void);
+
+/*
+ ************************************************************************************************************
+ * Static functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Classic checksum of a frame
+ * @param       Data: Response
+ * @param       Dl: Response length
+ * @return      Inverted sum with carry
+ */
+static uint8 LinTp_TestSlave_Checksum(const uint8* Data, uint8 Dl)
+{
+    uint16 sum = 0u;
+    uint8 i;
+
+    for (i = 0u; i < Dl; i++)
+    {
+        sum += Data[i];
+        sum = (sum > 0xFFu) ? (uint16)(sum - 0xFFu) : sum;
+    }
+
+    return (uint8)~sum;
+}
+
+/*
+ ************************************************************************************************************
+ * Function definition
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets the simulator, initializes the master channel, the schedule table engine and the transport
+ *              layer, starts the idle table and runs one cycle past its first slot boundary, so that every slot
+ *              run next holds the whole frame of one slot and ends one cycle after the start of the next one. The
+ *              slave has no response queued.
+ * @param       void
+ * @return      void
+ */
+void LinTp_TestSlave_Init(void)
+{
+    Lin_ConfigType config = {LINTP_CHANNEL, LIN_MODE_MASTER, NULL_PTR, 0u};
+
+    Lin_Sim_Init();
+    Lin_Sim_AttachTimer(TIM7_IRQHandler);
+    Lin_Init(&config);
+    (void)Lin_WakeupInternal(LINTP_CHANNEL);
+    LinSch_Init();
+    LinTp_Init();
+
+    LinTp_TestSlave_ResponseCount = 0u;
+    LinTp_TestSlave_ResponseNext = 0u;
+    LinTp_TestSlave_RequestCount = 0u;
+
+    (void)LinSch_SetTable(LINTP_TABLE_IDLE);
+    Lin_Sim_Run(1u);
+}
+
+/**
+ * @brief       Queues a response message: a SF, or a FF and its CFs, filled with 0xFF
+ * @param       Nad: Node address sent in every frame
+ * @param       Data: Message
+ * @param       Length: Message length (1-4095)
+ * @return      void
+ */
+void LinTp_TestSlave_Respond(uint8 Nad, const uint8* Data, uint16 Length)
+{
+    uint8 frame[LINTP_TESTSLAVE_FRAME];
+    uint16 offset = 0u;
+    uint8 sn = 1u;
+    uint8 count;
+
+    (void)memset(frame, 0xFF, sizeof(frame));
+    frame[0] = Nad;
+    if (Length <= 6u)
+    {
+        frame[1] = (uint8)Length;
+        (void)memcpy(&frame[2], Data, Length);
+        LinTp_TestSlave_Queue(frame);
+        return;
+    }
+
+    frame[1] = (uint8)(0x10u | (Length >> 8));
+    frame[2] = (uint8)Length;
+    (void)memcpy(&frame[3], Data, 5u);
+    LinTp_TestSlave_Queue(frame);
+    offset = 5u;
+
+    while (offset < Length)
+    {
+        (void)memset(frame, 0xFF, sizeof(frame));
+        count = ((uint16)(Length - offset) < 6u) ? (uint8)(Length - offset) : 6u;
+        frame[0] = Nad;
+        frame[1] = (uint8)(0x20u | sn);
+        (void)memcpy(&frame[2], &Data[offset], count);
+        LinTp_TestSlave_Queue(frame);
+        offset += count;
+        sn = (uint8)((sn + 1u) & 0x0Fu);
+    }
+}
+
+/**
+ * @brief       Queues one response frame as given, e.g. a wrong NAD or sequence number
+ * @param       Frame: NAD, PCI and the 6 other bytes
+ * @return      void
+ */
+void LinTp_TestSlave_Queue(const uint8* Frame)
+{
+    if (LinTp_TestSlave_ResponseCount < LINTP_TESTSLAVE_FRAMES_MAX)
+    {
+        (void)memcpy(LinTp_TestSlave_Responses[LinTp_TestSlave_ResponseCount], Frame, LINTP_TESTSLAVE_FRAME);
+        LinTp_TestSlave_ResponseCount++;
+    }
+}
+
+/**
+ * @brief       Runs one slot. A slave response header is answered with the next queued frame and its classic
+ *              checksum, or left without response once the queue is empty. A master request frame is recorded.
+ * @param       void
+ * @return      Frame identifier of the header of the slot, LINTP_TESTSLAVE_SILENT without header
+ */
+uint8 LinTp_TestSlave_Slot(void)
+{
+    Lin_SimSymbolType bus[LINTP_TESTSLAVE_SYMBOLS_MAX];
+    uint8 response[LINTP_TESTSLAVE_FRAME + 1u];
+    uint8 id = LINTP_TESTSLAVE_SILENT;
+    uint32 count;
+    uint32 i;
+    uint8 b;
+
+    if (LinTp_TestSlave_ResponseNext < LinTp_TestSlave_ResponseCount)
+    {
+        (void)memcpy(response, LinTp_TestSlave_Responses[LinTp_TestSlave_ResponseNext], LINTP_TESTSLAVE_FRAME);
+        response[LINTP_TESTSLAVE_FRAME] = LinTp_TestSlave_Checksum(response, LINTP_TESTSLAVE_FRAME);
+        Lin_Sim_SetResponse(LINTP_TESTSLAVE_BUS, LINTP_SLAVE_RESPONSE_ID, response, LINTP_TESTSLAVE_FRAME + 1u);
+    }
+    else
+    {
+        Lin_Sim_SetResponse(LINTP_TESTSLAVE_BUS, LINTP_SLAVE_RESPONSE_ID, NULL_PTR, 0u);
+    }
+
+    Lin_Sim_Run(LINTP_TESTSLAVE_SLOT_CYCLES);
+
+    count = Lin_Sim_ReadBus(LINTP_TESTSLAVE_BUS, bus, LINTP_TESTSLAVE_SYMBOLS_MAX);
+    for (i = 0u; (i + 2u) < count; i++)
+    {
+        if ((bus[i].Break == TRUE) && (bus[i + 1u].Value == SYNC_FIELD))
+        {
+            id = bus[i + 2u].Value & 0x3Fu;
+            break;
+        }
+    }
+
+    if ((id == LINTP_MASTER_REQUEST_ID) && ((i + 3u + LINTP_TESTSLAVE_FRAME) <= count) &&
+        (LinTp_TestSlave_RequestCount < LINTP_TESTSLAVE_FRAMES_MAX))
+    {
+        for (b = 0u; b < LINTP_TESTSLAVE_FRAME; b++)
+        {
+            LinTp_TestSlave_Requests[LinTp_TestSlave_RequestCount][b] = bus[i + 3u + b].Value;
+        }
+        LinTp_TestSlave_RequestCount++;
+    }
+    else if ((id == LINTP_SLAVE_RESPONSE_ID) && (LinTp_TestSlave_ResponseNext < LinTp_TestSlave_ResponseCount))
+    {
+        LinTp_TestSlave_ResponseNext++;
+    }
+    else
+    {
+        /* Frame of the idle table, or a silent slot */
+    }
+
+    return id;
+}
+
+/**
+ * @brief       Runs slots until the transfer has ended
+ * @param       MaxSlots: Slots run at most
+ * @return      Slots run
+ */
+uint32 LinTp_TestSlave_Transfer(uint32 MaxSlots)
+{
+    LinTp_StatusType status = LinTp_GetStatus(NULL_PTR);
+    uint32 slots = 0u;
+
+    while ((slots < MaxSlots) && ((status == LINTP_TX_BUSY) || (status == LINTP_RX_BUSY)))
+    {
+        (void)LinTp_TestSlave_Slot();
+        status = LinTp_GetStatus(NULL_PTR);
+        slots++;
+    }
+
+    return slots;
+}
+
+/**
+ * @brief       Returns a master request frame recorded since LinTp_TestSlave_Init()
+ * @param       Index: Frame index, 0 for the first one
+ * @return      NAD, PCI and the 6 other bytes, NULL_PTR past the last frame
+ */
+const uint8* LinTp_TestSlave_Request(uint32 Index)
+{
+    return (Index < LinTp_TestSlave_RequestCount) ? LinTp_TestSlave_Requests[Index] : NULL_PTR;
+}
+
+/**
+ * @brief       Returns the number of master request frames recorded and of response frames sent
+ * @param       Responses: Where the number of response frames sent is stored, may be NULL_PTR
+ * @return      Number of master request frames
+ */
+uint32 LinTp_TestSlave_Count(uint32* Responses)
+{
+    if (Responses != NULL_PTR)
+    {
+        *Responses = LinTp_TestSlave_ResponseNext;
+    }
+
+    return LinTp_TestSlave_RequestCount;
+}
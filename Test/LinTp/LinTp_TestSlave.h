@@ -0,0 +1,94 @@
+/**
+ * @file        LinTp_TestSlave.h
+ * @author      Phuc
+ * @brief       Diagnostic slave node on the simulated LIN bus, shared by the host tests and benchmarks of the
+ *              LIN transport layer
+ * @version     1.0
+ * @date        2025-01-30
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef LINTP_TESTSLAVE_H
+#define LINTP_TESTSLAVE_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include "LinTp.h"
+#include "LinSch.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+#define LINTP_TESTSLAVE_BUS         LIN_HW_USART2   /* Bus of LINTP_CHANNEL, channel 0 */
+#define LINTP_TESTSLAVE_SLOT_CYCLES (10000u * (LIN_SIM_CPU_HZ / 1000000u))  /* Slots of LinSch_Cfg.h, 10 ms */
+#define LINTP_TESTSLAVE_FRAMES_MAX  700u    /* Frames of the longest message, FF and 682 CFs */
+#define LINTP_TESTSLAVE_SILENT      0xFFu   /* No header in a slot */
+
+/*
+ ************************************************************************************************************
+ * Functions declaration
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Resets the simulator, initializes the master channel, the schedule table engine and the transport
+ *              layer, starts the idle table and runs one cycle past its first slot boundary, so that every slot
+ *              run next holds the whole frame of one slot and ends one cycle after the start of the next one. The
+ *              slave has no response queued.
+ * @param       void
+ * @return      void
+ */
+void LinTp_TestSlave_Init(void);
+
+/**
+ * @brief       Queues a response message: a SF, or a FF and its CFs, filled with 0xFF
+ * @param       Nad: Node address sent in every frame
+ * @param       Data: Message
+ * @param       Length: Message length (1-4095)
+ * @return      void
+ */
+void LinTp_TestSlave_Respond(uint8 Nad, const uint8* Data, uint16 Length);
+
+/**
+ * @brief       Queues one response frame as given, e.g. a wrong NAD or sequence number
+ * @param       Frame: NAD, PCI and the 6 other bytes
+ * @return      void
+ */
+void LinTp_TestSlave_Queue(const uint8* Frame);
+
+/**
+ * @brief       Runs one slot. A slave response header is answered with the next queued frame and its classic
+ *              checksum, or left without response once the queue is empty. A master request frame is recorded.
+ * @param       void
+ * @return      Frame identifier of the header of the slot, LINTP_TESTSLAVE_SILENT without header
+ */
+uint8 LinTp_TestSlave_Slot(void);
+
+/**
+ * @brief       Runs slots until the transfer has ended
+ * @param       MaxSlots: Slots run at most
+ * @return      Slots run
+ */
+uint32 LinTp_TestSlave_Transfer(uint32 MaxSlots);
+
+/**
+ * @brief       Returns a master request frame recorded since LinTp_TestSlave_Init()
+ * @param       Index: Frame index, 0 for the first one
+ * @return      NAD, PCI and the 6 other bytes, NULL_PTR past the last frame
+ */
+const uint8* LinTp_TestSlave_Request(uint32 Index);
+
+/**
+ * @brief       Returns the number of master request frames recorded and of response frames sent
+ * @param       Responses: Where the number of response frames sent is stored, may be NULL_PTR
+ * @return      Number of master request frames
+ */
+uint32 LinTp_TestSlave_Count(uint32* Responses);
+
+#endif /* LINTP_TESTSLAVE_H */
@@ -0,0 +1,109 @@
+/**
+ * @file        Test.h
+ * @author      Phuc
+ * @brief       Checks and timing of the host tests and benchmarks
+ * @version     1.0
+ * @date        2025-01-28
+ *
+ * @copyright   Copyright (c) 2025
+ *
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+/*
+ ************************************************************************************************************
+ * Includes
+ ************************************************************************************************************
+ */
+#include <stdio.h>
+#include <time.h>
+#include "Std_Types.h"
+
+/*
+ ************************************************************************************************************
+ * Types and Defines
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Checks a condition, a failure is reported with its location and counted in Test_Failures
+ */
+#define TEST_CHECK(cond)                                                                \
+    do                                                                                  \
+    {                                                                                   \
+        Test_Checks++;                                                                  \
+        if (!(cond))                                                                    \
+        {                                                                               \
+            Test_Failures++;                                                            \
+            printf("%s:%d: %s: check failed: %s\n", __FILE__, __LINE__, __func__, #cond); \
+        }                                                                               \
+    } while (0)
+
+/**
+ * @brief       Checks that two integers are equal, both values are reported on failure
+ */
+#define TEST_CHECK_EQ(actual, expected)                                                 \
+    do                                                                                  \
+    {                                                                                   \
+        unsigned long long test_a = (unsigned long long)(actual);                       \
+        unsigned long long test_e = (unsigned long long)(expected);                     \
+        Test_Checks++;                                                                  \
+        if (test_a != test_e)                                                           \
+        {                                                                               \
+            Test_Failures++;                                                            \
+            printf("%s:%d: %s: %s is %llu (0x%llX), expected %llu (0x%llX)\n", __FILE__, __LINE__, \
+                   __func__, #actual, test_a, test_a, test_e, test_e);                  \
+        }                                                                               \
+    } while (0)
+
+/**
+ * @brief       Runs a test function and reports it
+ */
+#define TEST_RUN(test)                                                                  \
+    do                                                                                  \
+    {                                                                                   \
+        uint32 test_before = Test_Failures;                                             \
+        test();                                                                         \
+        printf("%-50s %s\n", #test, (Test_Failures == test_before) ? "ok" : "FAILED");  \
+    } while (0)
+
+/*
+ ************************************************************************************************************
+ * Static variables
+ ************************************************************************************************************
+ */
+static uint32 Test_Checks = 0u;
+static uint32 Test_Failures = 0u;
+
+/*
+ ************************************************************************************************************
+ * Inline functions
+ ************************************************************************************************************
+ */
+/**
+ * @brief       Prints the summary of the checks
+ * @param       void
+ * @return      Process exit code: 0 when every check passed, 1 otherwise
+ */
+static inline int Test_Summary(void)
+{
+    printf("%lu checks, %lu failed\n", (unsigned long)Test_Checks, (unsigned long)Test_Failures);
+    return (Test_Failures == 0u) ? 0 : 1;
+}
+
+/**
+ * @brief       Reads the monotonic host clock, used to time the driver code itself: the simulated cycle
+ *              counters only advance on the bus, never while the driver runs.
+ * @param       void
+ * @return      Nanoseconds since an arbitrary origin
+ */
+static inline uint64 Test_Nanoseconds(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64)now.tv_sec * 1000000000u) + (uint64)now.tv_nsec;
+}
+
+#endif /* TEST_H */